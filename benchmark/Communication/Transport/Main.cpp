@@ -0,0 +1,180 @@
+#include "Communication/Client/TransportConnectivityManager/ITransportConnectivityManager.h"
+#include "Communication/Client/TransportConnectivityManager/ITransportConnection.h"
+#include "Communication/Server/TransportConnectivityManager/ITransportConnectivityManager.h"
+#include "Communication/Server/TransportConnectivityManager/ITransportConnection.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Server = Challenge::Communication::Server;
+namespace Client = Challenge::Communication::Client;
+
+namespace {
+
+    constexpr auto LOCAL_SOCKET_PATH = "/tmp/challenge.benchmark.socket";
+    constexpr auto SHARED_MEMORY_SOCKET_PATH = "/tmp/challenge.benchmark.shm.socket";
+
+    //! Size of SendEvent packet with short text
+    constexpr std::size_t MESSAGE_SIZE = 64;
+    constexpr auto WARM_UP_ROUND_TRIPS = 1000;
+    constexpr auto MEASURED_ROUND_TRIPS = 10000;
+
+    struct Transport {
+        std::string name;
+        std::function<std::unique_ptr<Server::ITransportConnectivityManager>()> createServer;
+        std::function<std::shared_ptr<Client::ITransportConnectivityManager>()> createClient;
+    };
+
+    //! Server side sending back everything it receives, it lives in own thread with own event loop
+    class EchoServer {
+    public:
+        explicit EchoServer( const Transport& _transport ) {
+            m_context.moveToThread( &m_thread );
+            m_thread.start();
+
+            runInServerThread( [this, &_transport]{
+                m_connectivityManager = _transport.createServer();
+                if ( !m_connectivityManager ) {
+                    return;
+                }
+
+                m_connectivityManager->registerNewConnectionCallback( [this]( std::shared_ptr<Server::ITransportConnection> _connection ) {
+                    auto connection = _connection.get();
+                    connection->registerNewDataReadyToReadCallback( [connection]{
+                        Server::ITransportConnection::Payload buffer;
+                        while ( connection->receiveInto( buffer ).value_or( 0 ) > 0 ) {
+                        }
+
+                        if ( !buffer.empty() ) {
+                            connection->send( buffer );
+                        }
+                    });
+                    m_connections.push_back( std::move( _connection ) );
+                });
+            });
+        }
+
+        ~EchoServer() {
+            // connections are released in the thread which serves them
+            runInServerThread( [this]{
+                m_connections.clear();
+                m_connectivityManager.reset();
+            });
+            m_thread.quit();
+            m_thread.wait();
+        }
+
+        bool isListening() const { return m_connectivityManager != nullptr; }
+
+    private:
+        void runInServerThread( std::function<void()> _task ) {
+            std::promise<void> isDone;
+            QTimer::singleShot( 0, &m_context, [&_task, &isDone]{
+                _task();
+                isDone.set_value();
+            });
+            isDone.get_future().wait();
+        }
+
+    private:
+        QThread m_thread;
+        QObject m_context;
+        std::unique_ptr<Server::ITransportConnectivityManager> m_connectivityManager;
+        std::vector<std::shared_ptr<Server::ITransportConnection>> m_connections;
+    };
+
+    //! Measures round trip of one message, client busy polls its connection like protocol executor in event loop
+    /*!
+     * @return round trips in microseconds, sorted
+     */
+    std::vector<double> measureRoundTrips( Client::ITransportConnection& _connection ) {
+        using namespace std::chrono;
+
+        const Client::ITransportConnection::Payload message( MESSAGE_SIZE, std::byte('A') );
+        Client::ITransportConnection::Payload buffer;
+        buffer.reserve( MESSAGE_SIZE );
+
+        std::vector<double> roundTrips;
+        roundTrips.reserve( MEASURED_ROUND_TRIPS );
+
+        for ( auto roundTrip = 0; roundTrip < WARM_UP_ROUND_TRIPS + MEASURED_ROUND_TRIPS; ++roundTrip ) {
+            buffer.clear();
+
+            auto start = steady_clock::now();
+            _connection.send( message );
+            while ( buffer.size() < MESSAGE_SIZE ) {
+                // flush of coalesced sends and reading of Qt sockets are done in event loop
+                QCoreApplication::processEvents();
+                if ( !_connection.receiveInto( buffer ) ) {
+                    return {};
+                }
+            }
+            auto elapsed = steady_clock::now() - start;
+
+            if ( roundTrip >= WARM_UP_ROUND_TRIPS ) {
+                roundTrips.push_back( duration_cast<duration<double, std::micro>>( elapsed ).count() );
+            }
+        }
+
+        std::sort( roundTrips.begin(), roundTrips.end() );
+        return roundTrips;
+    }
+
+} // namespace
+
+int32_t main( int32_t _argc, char** _argv ) {
+    QCoreApplication application( _argc, _argv );
+
+    const std::vector<Transport> transports = {
+        { "TCP"
+        , []{ return Server::ITransportConnectivityManager::create(); }
+        , []{ return Client::ITransportConnectivityManager::create(); } },
+        { "UDS"
+        , []{ return Server::ITransportConnectivityManager::create( Server::LocalSocketEngine{ LOCAL_SOCKET_PATH } ); }
+        , []{ return Client::ITransportConnectivityManager::create( Client::LocalSocketEngine{ LOCAL_SOCKET_PATH } ); } },
+        { "SHM"
+        , []{ return Server::ITransportConnectivityManager::create( Server::SharedMemoryEngine{ SHARED_MEMORY_SOCKET_PATH } ); }
+        , []{ return Client::ITransportConnectivityManager::create( Client::SharedMemoryEngine{ SHARED_MEMORY_SOCKET_PATH } ); } },
+    };
+
+    std::cout << "Round trip of " << MESSAGE_SIZE << " bytes [us]" << std::endl;
+    std::cout << std::setw(12) << "transport" << std::setw(12) << "median" << std::setw(12) << "p99" << std::endl;
+
+    for ( const auto& transport : transports ) {
+        EchoServer server( transport );
+        if ( !server.isListening() ) {
+            std::cout << std::setw(12) << transport.name << "  cannot start server" << std::endl;
+            continue;
+        }
+
+        auto connection = transport.createClient()->connectToServer();
+        if ( !connection ) {
+            std::cout << std::setw(12) << transport.name << "  cannot connect to server" << std::endl;
+            continue;
+        }
+
+        const auto roundTrips = measureRoundTrips( *connection );
+        if ( roundTrips.empty() ) {
+            std::cout << std::setw(12) << transport.name << "  connection lost" << std::endl;
+            continue;
+        }
+
+        std::cout << std::setw(12) << transport.name << std::fixed << std::setprecision(2)
+                  << std::setw(12) << roundTrips[ roundTrips.size() / 2 ]
+                  << std::setw(12) << roundTrips[ roundTrips.size() * 99 / 100 ] << std::endl;
+    }
+
+    return 0;
+}
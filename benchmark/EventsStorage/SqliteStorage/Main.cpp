@@ -0,0 +1,222 @@
+#include "SqliteStorage.h"
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <experimental/filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace Challenge::EventsStorage;
+
+namespace {
+
+    constexpr auto MEASURED_INSERTS = 1000;
+
+    constexpr auto PROFILE_DB_PATH = "/tmp/challenge.benchmark.db";
+    //! Inserts are committed one by one, so each of them pays for sync of journal
+    constexpr auto PROFILE_INSERTS = 1000;
+    constexpr uint64_t PROFILE_READ_EVENTS = 100'000;
+    constexpr auto PROFILE_READS = 10;
+
+    //! Fills storage up to given number of events
+    void fillStorage( SqliteStorage& _storage, uint64_t _numberOfEvents ) {
+        Challenge::EventData event{ std::chrono::system_clock::now(), "benchmark event text", 1 };
+        while ( _storage.getNumberOfEvents().value() < _numberOfEvents ) {
+            _storage.saveEvent( event );
+        }
+    }
+
+    //! Measures average cost of insert, when every client is notified about number of events after insert
+    /*!
+     *  It simulates Server::ProtocolExecutorV1 which sends NEW_EVENTS_NOTIFICATION with number of events to
+     *  each connected client, notifications are fired on own thread of storage
+     * @return average insert time in microseconds
+     */
+    double measureInsert( SqliteStorage& _storage, uint32_t _numberOfClients ) {
+        using namespace std::chrono;
+
+        std::vector<int> clients( _numberOfClients );
+        std::atomic<uint64_t> notifiedNumberOfEvents{ 0 };
+        for ( auto& client : clients ) {
+            _storage.registerEventAddedCallback( [&notifiedNumberOfEvents]( uint64_t _numberOfEvents ){
+                notifiedNumberOfEvents += _numberOfEvents;
+            }, &client );
+        }
+
+        Challenge::EventData event{ system_clock::now(), "benchmark event text", 1 };
+        auto start = steady_clock::now();
+        for ( auto insert = 0; insert < MEASURED_INSERTS; ++insert ) {
+            _storage.saveEvent( event );
+        }
+        auto elapsed = steady_clock::now() - start;
+
+        for ( auto& client : clients ) {
+            _storage.registerEventAddedCallback( nullptr, &client );
+        }
+
+        return duration_cast<duration<double, std::micro>>( elapsed ).count() / MEASURED_INSERTS;
+    }
+
+    //! Measures single inserts per second, every insert is committed in own transaction
+    double measureInsertsPerSecond( SqliteStorage& _storage ) {
+        using namespace std::chrono;
+
+        Challenge::EventData event{ system_clock::now(), "benchmark event text", 1 };
+        auto start = steady_clock::now();
+        for ( auto insert = 0; insert < PROFILE_INSERTS; ++insert ) {
+            _storage.saveEvent( event );
+        }
+        auto elapsed = duration_cast<duration<double>>( steady_clock::now() - start ).count();
+
+        return PROFILE_INSERTS / elapsed;
+    }
+
+    //! Measures reading of the whole range of events, size of event is size of its text, timestamp and priority
+    double measureRangeReadMBps( SqliteStorage& _storage ) {
+        using namespace std::chrono;
+
+        uint64_t readBytes = 0;
+        auto start = steady_clock::now();
+        for ( auto read = 0; read < PROFILE_READS; ++read ) {
+            auto events = _storage.getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER );
+            for ( const auto& event : events.value() ) {
+                readBytes += event.text.size() + sizeof( uint64_t ) + sizeof( event.priority );
+            }
+        }
+        auto elapsed = duration_cast<duration<double>>( steady_clock::now() - start ).count();
+
+        return readBytes / elapsed / ( 1024 * 1024 );
+    }
+
+    //! Measures inserts and range reads of database file opened with each tuning profile
+    void measureTuningProfiles() {
+        using Tuning = SqliteStorage::TuningSettings;
+        const std::vector<std::pair<std::string, Tuning>> profiles = {
+            { "compatible", Tuning::compatible() },
+            { "durable", Tuning::durable() },
+            { "fast", Tuning::fast() }
+        };
+
+        std::cout << "Tuning profiles ( database file " << PROFILE_DB_PATH << " )" << std::endl;
+        std::cout << std::setw(12) << "profile" << std::setw(16) << "inserts/s" << std::setw(16) << "range read MB/s" << std::endl;
+
+        for ( const auto& [name, tuning] : profiles ) {
+            std::experimental::filesystem::remove( PROFILE_DB_PATH );
+            {
+                SqliteStorage storage( PROFILE_DB_PATH, SqliteStorage::GroupCommitSettings{}, tuning );
+                const auto insertsPerSecond = measureInsertsPerSecond( storage );
+
+                // events of range are written in big transactions, so filling does not depend on sync of journal
+                IEventsStorage::Events events( 10'000, Challenge::EventData{ std::chrono::system_clock::now(), "benchmark event text", 1 } );
+                while ( storage.getNumberOfEvents().value() < PROFILE_READ_EVENTS ) {
+                    storage.saveEvents( events );
+                }
+
+                std::cout << std::setw(12) << name << std::fixed << std::setprecision(0)
+                          << std::setw(16) << insertsPerSecond
+                          << std::setw(16) << measureRangeReadMBps( storage ) << std::endl;
+            }
+            std::experimental::filesystem::remove( PROFILE_DB_PATH );
+        }
+    }
+
+    constexpr uint64_t CONCURRENCY_READ_EVENTS = 10'000;
+    constexpr auto CONCURRENCY_DURATION = std::chrono::seconds( 2 );
+
+    //! Measures range reads of clients in parallel threads, while one thread inserts events
+    /*!
+     *  Each client reads the same range again and again, like Server::ProtocolExecutorV1 answering history requests
+     *  of many clients. Without readers all reads and the writer share one connection.
+     */
+    void measureConcurrentReads() {
+        using namespace std::chrono;
+
+        const std::vector<std::size_t> numbersOfReaders = { 0, 4 };
+        const std::vector<uint32_t> numbersOfClients = { 1, 4, 8 };
+
+        std::cout << "Concurrent range reads of " << CONCURRENCY_READ_EVENTS << " events during inserts ( fast profile )" << std::endl;
+        std::cout << std::setw(12) << "readers" << std::setw(12) << "clients" << std::setw(16) << "range reads/s" << std::setw(16) << "inserts/s" << std::endl;
+
+        for ( auto numberOfReaders : numbersOfReaders ) {
+            for ( auto numberOfClients : numbersOfClients ) {
+                std::experimental::filesystem::remove( PROFILE_DB_PATH );
+                {
+                    auto tuning = SqliteStorage::TuningSettings::fast();
+                    tuning.numberOfReaders = numberOfReaders;
+                    SqliteStorage storage( PROFILE_DB_PATH, SqliteStorage::GroupCommitSettings{}, tuning );
+
+                    IEventsStorage::Events events( CONCURRENCY_READ_EVENTS, Challenge::EventData{ system_clock::now(), "benchmark event text", 1 } );
+                    storage.saveEvents( events );
+
+                    std::atomic<bool> isStopped{ false };
+                    std::atomic<uint64_t> numberOfReads{ 0 };
+                    std::vector<std::thread> clients;
+                    for ( uint32_t client = 0; client < numberOfClients; ++client ) {
+                        clients.emplace_back( [&storage, &isStopped, &numberOfReads]{
+                            while ( !isStopped ) {
+                                storage.getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, CONCURRENCY_READ_EVENTS - 1 );
+                                ++numberOfReads;
+                            }
+                        });
+                    }
+
+                    uint64_t numberOfInserts = 0;
+                    Challenge::EventData event{ system_clock::now(), "benchmark event text", 1 };
+                    auto start = steady_clock::now();
+                    while ( steady_clock::now() - start < CONCURRENCY_DURATION ) {
+                        storage.saveEvent( event );
+                        ++numberOfInserts;
+                    }
+                    auto elapsed = duration_cast<duration<double>>( steady_clock::now() - start ).count();
+
+                    isStopped = true;
+                    for ( auto& client : clients ) {
+                        client.join();
+                    }
+
+                    std::cout << std::setw(12) << numberOfReaders << std::setw(12) << numberOfClients << std::fixed << std::setprecision(0)
+                              << std::setw(16) << numberOfReads / elapsed
+                              << std::setw(16) << numberOfInserts / elapsed << std::endl;
+                }
+                std::experimental::filesystem::remove( PROFILE_DB_PATH );
+            }
+        }
+    }
+
+} // namespace
+
+int32_t main( int32_t, char** ) {
+    const std::vector<uint64_t> tableSizes = { 0, 10'000, 100'000, 1'000'000 };
+    const std::vector<uint32_t> numbersOfClients = { 1, 10, 100 };
+
+    std::cout << "Insert cost [us] with NEW_EVENTS_NOTIFICATION fan-out (in memory database)" << std::endl;
+    std::cout << std::setw(12) << "events";
+    for ( auto clients : numbersOfClients ) {
+        std::cout << std::setw(12) << (std::to_string(clients) + " clients");
+    }
+    std::cout << std::endl;
+
+    SqliteStorage storage;
+    for ( auto tableSize : tableSizes ) {
+        fillStorage( storage, tableSize );
+
+        std::cout << std::setw(12) << tableSize;
+        for ( auto clients : numbersOfClients ) {
+            std::cout << std::setw(12) << std::fixed << std::setprecision(2) << measureInsert( storage, clients );
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << std::endl;
+    measureTuningProfiles();
+
+    std::cout << std::endl;
+    measureConcurrentReads();
+
+    return 0;
+}
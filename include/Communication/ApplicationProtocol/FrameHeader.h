@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace Challenge::Communication::ApplicationProtocol {
@@ -18,4 +19,22 @@ namespace Challenge::Communication::ApplicationProtocol {
         uint16_t nboProtocolVersion;
     };
 
+    //! Header of packets which may be longer than 65535 bytes
+    /*!
+     *  PacketHeader::nboPacketLength is 0 and real length follows PacketHeader. Receiver which does not know
+     *  extended header considers packet as malformed, because its length is shorter than PacketHeader.
+     */
+    struct ExtendedPacketHeader {
+        PacketHeader packetHeader;
+
+        //! Total length of packet in bytes (includes sizeof(ExtendedPacketHeader), represented in Network Bytes Order
+        uint32_t nboPacketLength;
+    };
+
+    //! Value of PacketHeader::nboPacketLength which means that ExtendedPacketHeader is used
+    constexpr uint16_t EXTENDED_PACKET_LENGTH = 0;
+
+    //! Maximal length of packet, longer packets are considered as malformed, so peer cannot exhaust memory
+    constexpr std::size_t MAX_PACKET_LENGTH = 64 * 1024 * 1024;
+
 } // namespace ApplicationProtocol
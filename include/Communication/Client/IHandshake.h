@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -26,6 +27,9 @@ namespace Challenge::Communication::Client {
 
         virtual ITransportConnection& connection() const = 0;
 
+        //! Returns version of application protocol negotiated during handshake
+        virtual uint16_t protocolVersion() const = 0;
+
         //! Factory method, must be implemented in shared library together with handshake execution process
         /*!
          * Creates IHandshake - starts handshake process
@@ -45,6 +45,15 @@ namespace Challenge::Communication::Client {
          */
         virtual bool sendEvent( const std::string& _eventText, uint32_t _priority )  = 0;
 
+        //! Sends batch of events to server
+        /*!
+         *  Events are saved by server in order, time stamps of events are assigned by server
+         * @param _events events to send, only text and priority are used
+         * @return number of events saved by server, they are always the first events of batch, nullopt when server
+         * did not respond
+         */
+        virtual std::optional<std::size_t> sendEvents( const Events& _events ) = 0;
+
         //! Registered callback for new saved events
         /*!
          *
@@ -69,5 +78,29 @@ namespace Challenge::Communication::Client {
          * @return future with number of saved events
          */
         virtual std::optional<uint64_t> getNumberOfSavedEvents()  = 0;
+
+        //! Sends event to server without waiting for response
+        /*!
+         *  Many requests may wait for responses at the same time, responses are matched by client message id and
+         *  they are received when transport reports new data, so future is not resolved by waiting on it
+         *  in the thread which delivers transport notifications. Request which is not answered in time is cancelled.
+         * @return future with true when server confirmed that event was saved, false when server did not save it,
+         *  request failed, response did not arrive in time or executor was destroyed before response arrived
+         */
+        virtual std::future<bool> sendEventAsync( const std::string& _eventText, uint32_t _priority ) = 0;
+
+        //! Gets range of saved events without waiting for response
+        /*!
+         * @return future with events, nullopt when request failed, next packet of response did not arrive in time
+         *  or executor was destroyed before whole response arrived
+         */
+        virtual std::future<std::optional<Events>> getSavedEventsAsync( uint64_t _firstEvent, uint64_t _lastEvent ) = 0;
+
+        //! Gets number of saved events without waiting for response
+        /*!
+         * @return future with number of saved events, nullopt when request failed, response did not arrive in
+         *  time or executor was destroyed before response arrived
+         */
+        virtual std::future<std::optional<uint64_t>> getNumberOfSavedEventsAsync() = 0;
     };
 } // namespace Challenge::Communication::Client
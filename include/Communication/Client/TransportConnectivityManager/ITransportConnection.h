@@ -59,6 +59,31 @@ namespace Challenge::Communication::Client {
 
         virtual std::optional<Payload> receive() = 0;
         virtual std::optional<uint32_t> send( const Payload& _payload ) = 0;
+
+        //! Appends received data to given buffer
+        /*!
+         *  Caller keeps one buffer for whole connection, so transport can write received bytes directly into it, without
+         *  intermediate payload. Default implementation appends payload returned by receive
+         * @param _buffer received bytes are appended to it
+         * @return std::nullopt in case of error, otherwise number of appended bytes which can be zero
+         */
+        virtual std::optional<std::size_t> receiveInto( Payload& _buffer ) {
+            auto payload = receive();
+            if ( !payload.has_value() ) {
+                return std::nullopt;
+            }
+
+            _buffer.insert( _buffer.end(), payload->begin(), payload->end() );
+            return payload->size();
+        }
+
+        //! Writes data queued by send without waiting
+        /*!
+         *  Transport may coalesce sent data and write them later together, flush is for latency sensitive messages.
+         *  Default implementation is for transports which write data already in send
+         * @return false in case of error
+         */
+        virtual bool flush() { return true; }
     };
 } // namespace Challenge::Communication::Client
 
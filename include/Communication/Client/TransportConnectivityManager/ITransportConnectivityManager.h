@@ -1,17 +1,36 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 namespace Challenge::Communication::Client {
 
     class ITransportConnection;
 
+    //! Tag for ITransportConnectivityManager::create, selects connection to server over local ( Unix domain ) socket
+    struct LocalSocketEngine {
+        //! Path of the socket on which server listens
+        std::string path;
+    };
+
+    //! Tag for ITransportConnectivityManager::create, selects connection over rings in memory shared with server
+    struct SharedMemoryEngine {
+        //! Path of local socket on which server passes shared memory
+        std::string path;
+    };
+
     class ITransportConnectivityManager {
     public:
         virtual ~ITransportConnectivityManager() = default;
 
         //! Factory method, must be implemented in shared library together with class implementation
-        static std::shared_ptr<ITransportConnectivityManager> create();
+        /*!
+         *  create() connects over TCP, create(LocalSocketEngine) connects to server on the same host over local socket
+         *  and create(SharedMemoryEngine) connects to server on the same host over shared memory
+         * @return nullptr in case of fail
+         */
+        template<typename... _Args>
+        static std::shared_ptr<ITransportConnectivityManager> create(_Args...);
 
         //! Starts connection with server
         /*!
@@ -22,4 +41,3 @@ namespace Challenge::Communication::Client {
         virtual std::shared_ptr<ITransportConnection> connectToServer() const = 0;
     };
 } // namespace Challenge::Communication::Client
-
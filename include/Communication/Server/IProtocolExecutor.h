@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace Challenge::EventsStorage {
     class IEventsStorage;
@@ -13,8 +15,18 @@ namespace Challenge::Communication::Server {
 
     class IProtocolExecutor {
     public:
+        using Payload = std::vector<std::byte>;
+
         virtual bool isValid() const = 0;
 
+        //! Sends notification about new saved events
+        /*!
+         *  Notification is encoded once by server and the same buffer is passed to all executors
+         * @param _notification NEW_EVENTS_NOTIFICATION encoded for any handshake, executor sends it with its own
+         * handshake id
+         */
+        virtual void notifyNewEvents( const Payload& _notification ) = 0;
+
         //! Factory method
         /*!
          *
@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 
 namespace Challenge {
 namespace Communication {
@@ -9,12 +10,37 @@ namespace Server {
 
             class ITransportConnection;
 
+            //! Tag for ITransportConnectivityManager::create, selects transport on non-blocking sockets and epoll
+            struct EpollEngine {
+                //! Listening port is opened with SO_REUSEPORT, so kernel shares connections among several managers
+                bool isPortShared = false;
+            };
+
+            //! Tag for ITransportConnectivityManager::create, selects transport on local ( Unix domain ) socket
+            struct LocalSocketEngine {
+                //! Path of the socket in file system, stale socket file left by previous run is removed
+                std::string path;
+            };
+
+            //! Tag for ITransportConnectivityManager::create, selects transport on rings in shared memory
+            struct SharedMemoryEngine {
+                //! Path of local socket on which clients ask for shared memory, stale socket file is removed
+                std::string path;
+            };
+
             class ITransportConnectivityManager {
             public:
                 using NewConnectionCallback = std::function<void(std::shared_ptr<ITransportConnection>)>;
 
                 //! Factory method to implement in the shared library
-                static std::unique_ptr<ITransportConnectivityManager> create();
+                /*!
+                 *  create() listens with QTcpServer, create(EpollEngine) listens with own epoll based transport and
+                 *  create(LocalSocketEngine) listens with QLocalServer, create(SharedMemoryEngine) passes shared memory to
+                 *  clients connected to local socket
+                 * @return nullptr in case of fail
+                 */
+                template<typename... _Args>
+                static std::unique_ptr<ITransportConnectivityManager> create(_Args...);
 
                 virtual ~ITransportConnectivityManager() = default;
 
@@ -1,4 +1,25 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
 constexpr auto SERVER_IP = "0.0.0.0";
 constexpr uint16_t SERVER_PORT = 54321;
+
+//! Maximal number of events written by storage in one transaction
+constexpr std::size_t STORAGE_GROUP_COMMIT_MAX_BATCH_SIZE = 64;
+//! Time the first event of a batch waits for next events, with 0 batch collects only events arrived during previous commit
+constexpr std::chrono::microseconds STORAGE_GROUP_COMMIT_MAX_DELAY{ 0 };
+
+//! Maximal number of events waiting for writer thread of storage, when queue is full new events are not accepted
+constexpr std::size_t STORAGE_WRITER_QUEUE_SIZE = 4096;
+
+//! Maximal size of events kept in memory by tail cache of storage, when server uses it
+constexpr std::size_t STORAGE_TAIL_CACHE_MAX_BYTES = 16 * 1024 * 1024;
+
+//! Maximal size of events kept encoded for responses of clients, when server uses cache of encoded events
+constexpr std::size_t ENCODED_EVENTS_CACHE_MAX_BYTES = 16 * 1024 * 1024;
+
+//! Directory of events storage, when server uses append only log storage
+constexpr auto LOG_STORAGE_DIRECTORY = "/tmp/challenge.log";
@@ -2,19 +2,77 @@
 
 #include "Event/EventData.h"
 
+#include <cassert>
 #include <cinttypes>
 #include <functional>
 #include <limits>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 namespace Challenge::EventsStorage {
 
+    class IEventsStorage;
+
+    //! Tag for IEventsStorage::create, selects append only log storage kept in given directory
+    struct AppendLogEngine {
+        std::string absPathToDirectory;
+    };
+
+    //! What happens with saved events, when queue of events waiting for writer is full
+    enum class FullQueuePolicy {
+        //! Caller waits until writer makes space in queue
+        Block,
+        //! Events are not saved
+        Reject,
+        //! Queued events with lower priority value are dropped to make space, events are rejected if there are none
+        ShedLowPriority
+    };
+
+    //! Tag for IEventsStorage::create, selects sqlite storage, its writer thread takes events from bounded queue
+    struct SqliteEngine {
+        //! Maximal number of events waiting for writer
+        std::size_t maxQueueSize = 4096;
+        FullQueuePolicy policy = FullQueuePolicy::Block;
+    };
+
+    //! Tag for IEventsStorage::create, wraps storage by decorator which writes events on own thread
+    struct AsyncWriterEngine {
+        //! Storage which saves events, it is used only by writer thread and by readers
+        std::shared_ptr<IEventsStorage> storage;
+        //! Maximal number of events waiting for writer
+        std::size_t maxQueueSize = 4096;
+        FullQueuePolicy policy = FullQueuePolicy::Block;
+    };
+
+    //! Tag for IEventsStorage::create, wraps storage by decorator which keeps the newest events in memory
+    struct TailCacheEngine {
+        //! Storage which saves events, all events have to be saved through the decorator
+        std::shared_ptr<IEventsStorage> storage;
+        //! Maximal number of cached events
+        std::size_t maxEvents = 4096;
+        //! Maximal size of cached events, size of event is size of EventData and of its text
+        std::size_t maxBytes = 4 * 1024 * 1024;
+    };
+
     class IEventsStorage {
         public:
             using Events = std::vector<EventData>;
-            using EventSavedCallback = std::function<void()>;
+            //! Callback of saved events, it receives number of saved events
+            using EventSavedCallback = std::function<void(uint64_t _numberOfEvents)>;
+            //! Runs task which fires callbacks, e.g. posts it to event loop
+            using CallbackExecutor = std::function<void(std::function<void()> _task)>;
+            //! Completion of asynchronous save, it receives number of saved events ( first events of saved batch )
+            using SaveCompletion = std::function<void(std::size_t _numberOfSavedEvents)>;
+
+            //! Visitor of chunk of saved events
+            /*!
+             * @param _events chunk of events, it is valid only during the call
+             * @param _isLastChunk true when there are no more events in requested range
+             * @return false when reading has to be stopped
+             */
+            using EventsChunkVisitor = std::function<bool(const Events& _events, bool _isLastChunk)>;
             static constexpr uint64_t FIRST_EVENT_NUMBER = 0;
             static constexpr uint64_t LAST_EVENT_NUMBER = std::numeric_limits<uint64_t>::max();
 
@@ -22,7 +80,9 @@ namespace Challenge::EventsStorage {
 
             //! Factory method, must be implemented in shared library
             /*!
-             *
+             *  create() and create(SqliteEngine) open sqlite storage, create(AppendLogEngine) opens append only log storage,
+             *  create(AsyncWriterEngine) wraps given storage by asynchronous writer, create(TailCacheEngine) wraps given
+             *  storage by cache of the newest events
              * @return nullptr in case if fail
              */
              template<typename... _Args>
@@ -36,6 +96,34 @@ namespace Challenge::EventsStorage {
              */
             virtual bool saveEvent( const EventData& _event ) = 0;
 
+            //! Saves batch of events to storage
+            /*!
+             *  Events are saved in order, so saved events are always the first events of batch. Default implementation
+             *  saves events one by one, storage should override it to write whole batch at once.
+             * @param _events events to save
+             * @return number of saved events
+             */
+            virtual std::size_t saveEvents( const Events& _events );
+
+            //! Saves event without waiting for write
+            /*!
+             *  Completion is fired when write of event is finished, on thread which writes it, so caller has to pass
+             *  it to own thread. Event rejected by full queue of writer is completed with 0 before return. Default
+             *  implementation saves event by saveEvent and fires completion before return.
+             * @param _event event to save
+             * @param _completion function to invoke with number of saved events, 1 or 0
+             */
+            virtual void saveEventAsync( EventData _event, SaveCompletion _completion );
+
+            //! Saves batch of events without waiting for write
+            /*!
+             *  Completion is fired in the same way as by saveEventAsync. Default implementation saves events by
+             *  saveEvents and fires completion before return.
+             * @param _events events to save
+             * @param _completion function to invoke with number of saved events
+             */
+            virtual void saveEventsAsync( Events _events, SaveCompletion _completion );
+
             //! Saves events to storage
             /*!
              *
@@ -45,8 +133,23 @@ namespace Challenge::EventsStorage {
              */
             virtual std::optional<Events> getSavedEvents(uint64_t _firstEvent, uint64_t _lastEvent) const = 0;
 
+            //! Reads range of saved events chunk by chunk
+            /*!
+             *  Events are passed to visitor as they are read, so memory usage is bounded by chunk size, not by size of
+             *  range. Visitor is called at least once, and last call has _isLastChunk set (chunk may be empty).
+             *  Default implementation reads whole range with getSavedEvents, storage should override it.
+             * @param _firstEvent start range of events
+             * @param _lastEvent end range of events
+             * @param _chunkSize maximal number of events in one chunk, must be greater than 0
+             * @param _visitor function to invoke for each chunk
+             * @return false in case of error, true when range was read or visitor stopped reading
+             */
+            virtual bool visitSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent, std::size_t _chunkSize, EventsChunkVisitor _visitor ) const;
+
             //! Get total naumber of saved events
             /*!
+             *  It is called for every connected client after each saved event, so implementations shall answer it
+             *  in constant time, without scanning saved events
              *
              * @return nullopt in case of error, or number of events
              */
@@ -54,13 +157,81 @@ namespace Challenge::EventsStorage {
 
             //! Register callback for new event saved
             /*!
-             *  Callback will be fired when new event is saved
+             *  Callback will be fired asynchronously after new event is saved, by executor set with setCallbackExecutor.
+             *  Events saved before callbacks are fired are notified once, with the latest number of events.
              * @param _callback function to invoke, or nullptr when callback for given key has to be removed
              * @param _key index of callback, it is used to distinguish betwwen subsribed callbacks, the best to use this
              * of registed class
              * @return true in case when callback override alreade registered callback
              */
             virtual bool registerEventAddedCallback( EventSavedCallback _callback, void* _key ) = 0;
+
+            //! Sets executor of callbacks
+            /*!
+             * @param _executor executor of callbacks, nullptr means that callbacks are fired on own thread of storage
+             */
+            virtual void setCallbackExecutor( CallbackExecutor _executor ) = 0;
+
+        protected:
+            //! Passes events read at once to visitor chunk by chunk, as visitSavedEvents does
+            static bool visitInChunks( Events _events, std::size_t _chunkSize, const EventsChunkVisitor& _visitor );
     };
 
+    inline std::size_t IEventsStorage::saveEvents( const Events& _events ) {
+        std::size_t numberOfSavedEvents = 0;
+        for ( const auto& event : _events ) {
+            if ( !saveEvent( event ) ) {
+                break;
+            }
+            ++numberOfSavedEvents;
+        }
+        return numberOfSavedEvents;
+    }
+
+    inline void IEventsStorage::saveEventAsync( EventData _event, SaveCompletion _completion ) {
+        assert( _completion );
+        _completion( saveEvent( _event ) ? 1 : 0 );
+    }
+
+    inline void IEventsStorage::saveEventsAsync( Events _events, SaveCompletion _completion ) {
+        assert( _completion );
+        _completion( saveEvents( _events ) );
+    }
+
+    inline bool IEventsStorage::visitSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent, std::size_t _chunkSize, EventsChunkVisitor _visitor ) const {
+        assert( _chunkSize > 0 );
+        assert( _visitor );
+
+        auto events = getSavedEvents( _firstEvent, _lastEvent );
+        if ( !events.has_value() ) {
+            return false;
+        }
+        return visitInChunks( std::move( events.value() ), _chunkSize, _visitor );
+    }
+
+    inline bool IEventsStorage::visitInChunks( Events _events, std::size_t _chunkSize, const EventsChunkVisitor& _visitor ) {
+        assert( _chunkSize > 0 );
+        assert( _visitor );
+
+        if ( _events.size() <= _chunkSize ) {
+            _visitor( _events, true );
+            return true;
+        }
+
+        Events chunk;
+        chunk.reserve( _chunkSize );
+        for ( std::size_t eventIndex = 0; eventIndex < _events.size(); ++eventIndex ) {
+            chunk.push_back( std::move( _events[eventIndex] ) );
+
+            const bool isLastEvent = eventIndex + 1 == _events.size();
+            if ( chunk.size() == _chunkSize || isLastEvent ) {
+                if ( !_visitor( chunk, isLastEvent ) ) {
+                    return true;
+                }
+                chunk.clear();
+            }
+        }
+        return true;
+    }
+
 } // namespace Challenge::EventsStorage
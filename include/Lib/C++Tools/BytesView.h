@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Challenge {
+
+    //! Non owning view of contiguous bytes, replacement of std::span which is not available in C++17
+    class BytesView {
+    public:
+        using const_iterator = const std::byte*;
+
+        constexpr BytesView() = default;
+        constexpr BytesView( const std::byte* _data, std::size_t _size ) : m_data(_data), m_size(_size) {}
+        BytesView( const std::vector<std::byte>& _bytes ) : m_data(_bytes.data()), m_size(_bytes.size()) {}
+
+        constexpr const std::byte* data() const { return m_data; }
+        constexpr std::size_t size() const { return m_size; }
+        constexpr bool empty() const { return m_size == 0; }
+
+        constexpr const_iterator begin() const { return m_data; }
+        constexpr const_iterator end() const { return m_data + m_size; }
+
+        constexpr const std::byte& operator[]( std::size_t _index ) const { return m_data[_index]; }
+
+        //! Copies bytes, when they have to outlive viewed buffer
+        std::vector<std::byte> toBytes() const { return std::vector<std::byte>( begin(), end() ); }
+
+    private:
+        const std::byte* m_data = nullptr;
+        std::size_t m_size = 0;
+    };
+
+    inline bool operator==( BytesView _left, BytesView _right ) {
+        return _left.size() == _right.size() && std::equal( _left.begin(), _left.end(), _right.begin() );
+    }
+
+    inline bool operator!=( BytesView _left, BytesView _right ) {
+        return !( _left == _right );
+    }
+
+} // namespace Challenge
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace Challenge {
+
+    //! Cache of events in their wire representation, shared by all connections of server
+    /*!
+     *  Event read from storage is encoded only once, responses for next requests of the same range are created by
+     *  copying cached bytes. Cache keeps continuous range of events, entry of event which follows the range is
+     *  appended and the oldest entries are evicted when limit of count or of bytes is exceeded. Entries are shared
+     *  pointers, so evicted entry lives until the last response which uses it is created.
+     */
+    class EncodedEventsCache {
+    public:
+        using Entry = std::shared_ptr<const std::vector<std::byte>>;
+        using Entries = std::vector<Entry>;
+
+        //! Counters of reads, read of range is hit when the whole range is cached
+        struct Statistics {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+        };
+
+        //! Constructor
+        /*!
+         *
+         * @param _maxEvents maximal number of cached entries
+         * @param _maxBytes maximal size of cached entries
+         * @throw std::runtime_error if any limit is 0
+         */
+        EncodedEventsCache( std::size_t _maxEvents, std::size_t _maxBytes );
+
+        EncodedEventsCache( const EncodedEventsCache& ) = delete;
+        EncodedEventsCache& operator=( const EncodedEventsCache& ) = delete;
+
+        //! Returns entries of events [_firstEvent, _lastEvent] when all of them are cached, counts hit or miss
+        std::optional<Entries> get( uint64_t _firstEvent, uint64_t _lastEvent ) const;
+
+        //! Puts entry of event
+        /*!
+         *  Entry which follows cached range is appended, entry of event behind the range starts the range again.
+         *  Other entries are ignored, cached entry of event is never changed.
+         */
+        void put( uint64_t _event, Entry _entry );
+
+        Statistics getStatistics() const;
+
+    private:
+        void evictOldest();
+
+    private:
+        const std::size_t m_maxEvents;
+        const std::size_t m_maxBytes;
+
+        std::deque<Entry> m_entries;
+        //! Number of event of the first entry
+        uint64_t m_firstEvent = 0;
+        std::size_t m_cachedBytes = 0;
+
+        mutable Statistics m_statistics;
+        mutable std::mutex m_mutex;
+    };
+
+} // namespace Challenge
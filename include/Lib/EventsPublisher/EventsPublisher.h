@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+namespace Challenge {
+
+    //! Publishes number of saved events to subscribers asynchronously
+    /*!
+     *  Write path only stores the number of events and schedules dispatch, subscribers are called later by executor.
+     *  Numbers published before dispatch runs are coalesced, so every subscriber receives only the latest number
+     *  once per dispatch.
+     */
+    class EventsPublisher {
+    public:
+        using Subscriber = std::function<void(uint64_t _numberOfEvents)>;
+
+        //! Runs task of dispatch, e.g. posts it to event loop
+        using Executor = std::function<void(std::function<void()> _task)>;
+
+        //! Constructor
+        /*!
+         * @param _executor runs dispatch, nullptr means dispatch on own thread of publisher
+         */
+        explicit EventsPublisher( Executor _executor = nullptr );
+        ~EventsPublisher();
+
+        EventsPublisher( const EventsPublisher& ) = delete;
+        EventsPublisher& operator=( const EventsPublisher& ) = delete;
+
+        //! Sets executor of next dispatches, nullptr means dispatch on own thread of publisher
+        void setExecutor( Executor _executor );
+
+        //! Publishes number of saved events, it does not wait for subscribers
+        void publish( uint64_t _numberOfEvents );
+
+        //! Subscribes for published number of events
+        /*!
+         *  Subscribers are called without lock, so they may publish, but they must not subscribe or unsubscribe.
+         *  When subscriber is removed, call returns after running dispatch, so subscriber is not called after removal.
+         * @param _subscriber function to invoke, or nullptr when subscriber for given key has to be removed
+         * @param _key index of subscriber
+         * @return true in case when subscriber for given key was not registered
+         */
+        bool subscribe( Subscriber _subscriber, void* _key );
+
+    private:
+        class State;
+        std::shared_ptr<State> m_state;
+    };
+
+} // namespace Challenge
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Lib/C++Tools/BytesView.h"
+
 #include <cstddef>
 #include <optional>
 #include <vector>
@@ -7,15 +9,50 @@
 namespace Challenge::PacketCoderV1 {
 
     //! Class implements bytes stream packetization
+    /*!
+     *  Stream is kept for whole connection, bytes of incomplete packet wait in stream for next received bytes.
+     *  Packets are returned as views into buffer of stream, consumed bytes are dropped only when new bytes are pushed,
+     *  so buffer is not shifted for every packet.
+     *  Stream splits packets of all versions of protocol, it reads length from PacketHeader or ExtendedPacketHeader.
+     */
     class BytesStream {
     public:
         using Bytes = std::vector< std::byte >;
-        void pushBytes( const Bytes& _bytes );
-        std::optional< Bytes > getPacket();
+
+        //! Appends received bytes, it invalidates views returned by getPacket
+        void pushBytes( BytesView _bytes );
+
+        //! Lets _reader append bytes directly to buffer of stream, it invalidates views returned by getPacket
+        /*!
+         *  Bytes are not copied through intermediate buffer, e.g. transport receives them straight into the stream
+         * @param _reader callable appending bytes to given Bytes, like ITransportConnection::receiveInto
+         * @return result of _reader
+         */
+        template< typename _Reader >
+        auto pushBytesFrom( _Reader&& _reader ) {
+            dropReturnedPackets();
+            return _reader( m_stream );
+        }
+
+        //! Returns next complete packet
+        /*!
+         * @return view of packet valid until next pushBytes, or nullopt when there is no complete packet
+         */
+        std::optional< BytesView > getPacket();
+
+        //! Number of bytes which were not returned as packets yet
+        std::size_t size() const;
+
+        void clear();
+
+    private:
+        //! Releases space of packets already returned by getPacket
+        void dropReturnedPackets();
 
     private:
         Bytes m_stream;
+        //! Beginning of first not returned packet
+        std::size_t m_readOffset = 0;
     };
 
 } // namespace Challenge::PacketCoderV1
-
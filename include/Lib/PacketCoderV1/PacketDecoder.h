@@ -2,27 +2,39 @@
 
 #include "Packets.h"
 
+#include "Lib/C++Tools/BytesView.h"
+
 #include <cstddef>
-#include <memory>
 #include <optional>
 #include <variant>
 #include <vector>
 
 namespace Challenge::PacketCoderV1 {
-    class DecodedPacket final {
-    public:
-        using PacketBytes = std::vector<std::byte>;
 
-        using PacketVariant = std::variant<
-                  const Client::HandshakeInvite*
-                , const Client::SendEvent*
-                , const Client::SavedEventsRequest*
-                , const Client::NumberOfSavedEventsRequest*
-                , const Server::Ack*
-                , const Server::NumberOfSavedEventsResponse*
-                , const Server::SavedEventsResponse*
-                , const Server::NewEventsNotification*
-        >;
+    using PacketVariant = std::variant<
+              const Client::HandshakeInvite*
+            , const Client::SendEvent*
+            , const Client::SavedEventsRequest*
+            , const Client::NumberOfSavedEventsRequest*
+            , const Server::Ack*
+            , const Server::NumberOfSavedEventsResponse*
+            , const Server::SavedEventsResponse*
+            , const Server::NewEventsNotification*
+            , const Client::SendEvents*
+            , const Server::SendEventsAck*
+            , const Client::SavedEventsPackedRequest*
+            , const Server::SavedEventsPackedResponse*
+            , const Server::Nack*
+    >;
+
+    //! Decoded packet over borrowed bytes
+    /*!
+     *  It does not copy nor allocate, packet pointed by variant is valid as long as decoded bytes are valid,
+     *  e.g. until next BytesStream::pushBytes.
+     */
+    class DecodedPacketView final {
+    public:
+        using PacketVariant = PacketCoderV1::PacketVariant;
 
         //! Constructor
         /*!
@@ -30,9 +42,11 @@ namespace Challenge::PacketCoderV1 {
          * @param _bytes bytes to decode
          * @throw std::runtime_error in case of decode error
          */
-        explicit DecodedPacket( PacketBytes _bytes );
+        explicit DecodedPacketView( BytesView _bytes );
 
-        const PacketVariant& decodedPacket() const;
+        const PacketVariant& decodedPacket() const { return m_decodedPacketVariant; }
+
+        BytesView bytes() const { return m_bytes; }
 
     private:
         bool setup();
@@ -45,16 +59,49 @@ namespace Challenge::PacketCoderV1 {
         template<typename _PacketType>
         bool setupVariant();
 
+        //! Checks if entries fill packet from offset up to its end
+        template<typename _EntryType>
+        bool areEntriesValid( std::size_t _offset, uint16_t _numberOfEntries ) const;
+
     private:
-        const PacketBytes m_bytes;
-        std::shared_ptr< PacketVariant > m_decodedPacketVariant;
+        BytesView m_bytes;
+        PacketVariant m_decodedPacketVariant;
+    };
 
+    //! Decoded packet which owns its bytes, for packets which have to outlive received bytes
+    class DecodedPacket final {
+    public:
+        using PacketBytes = std::vector<std::byte>;
+        using PacketVariant = PacketCoderV1::PacketVariant;
+
+        //! Constructor
+        /*!
+         * Decodes bytes to packets
+         * @param _bytes bytes to decode
+         * @throw std::runtime_error in case of decode error
+         */
+        explicit DecodedPacket( PacketBytes _bytes );
+
+        //! Copies bytes of already decoded packet
+        explicit DecodedPacket( const DecodedPacketView& _packet );
+
+        // variant points to own bytes, so it is decoded again for copied bytes
+        DecodedPacket( const DecodedPacket& _packet );
+        DecodedPacket( DecodedPacket&& _packet );
+        DecodedPacket& operator=( const DecodedPacket& _packet );
+        DecodedPacket& operator=( DecodedPacket&& _packet );
+
+        const PacketVariant& decodedPacket() const { return m_view.decodedPacket(); }
+
+        const DecodedPacketView& view() const { return m_view; }
+
+    private:
+        PacketBytes m_bytes;
+        DecodedPacketView m_view;
     };
 
     template< typename _PacketType >
-    inline bool DecodedPacket::isPacketValid() const {
-        auto packet = reinterpret_cast<const _PacketType* >(m_bytes.data());
-
+    inline bool DecodedPacketView::isPacketValid() const {
         if ( sizeof(_PacketType) > m_bytes.size() ) {
             return false;
         }
@@ -69,7 +116,11 @@ namespace Challenge::PacketCoderV1 {
     }
 
     template<>
-    inline bool DecodedPacket::isPacketValid<Client::SendEvent>() const {
+    inline bool DecodedPacketView::isPacketValid<Client::SendEvent>() const {
+        if ( sizeof(Client::SendEvent) > m_bytes.size() ) {
+            return false;
+        }
+
         auto packet = reinterpret_cast<const Client::SendEvent* >(m_bytes.data());
 
         auto expectedSize = sizeof(Client::SendEvent) + ntohs(packet->nboLengthOfText);
@@ -82,7 +133,11 @@ namespace Challenge::PacketCoderV1 {
     }
 
     template<>
-    inline bool DecodedPacket::isPacketValid<Server::SavedEventsResponse>() const {
+    inline bool DecodedPacketView::isPacketValid<Server::SavedEventsResponse>() const {
+        if ( sizeof(Server::SavedEventsResponse) > m_bytes.size() ) {
+            return false;
+        }
+
         auto packet = reinterpret_cast<const Server::SavedEventsResponse* >(m_bytes.data());
 
         auto expectedSize = sizeof(Server::SavedEventsResponse) + ntohs(packet->nboLengthOfText);
@@ -94,17 +149,81 @@ namespace Challenge::PacketCoderV1 {
         return true;
     }
 
+    template<typename _EntryType>
+    inline bool DecodedPacketView::areEntriesValid( std::size_t _offset, uint16_t _numberOfEntries ) const {
+        // every entry has to fit into packet, and entries have to fill packet up to its end
+        for ( auto entryIndex = 0; entryIndex < _numberOfEntries; ++entryIndex ) {
+            if ( _offset + sizeof(_EntryType) > m_bytes.size() ) {
+                return false;
+            }
+
+            auto entry = reinterpret_cast<const _EntryType* >(m_bytes.data() + _offset);
+            _offset += sizeof(_EntryType) + ntohs(entry->nboLengthOfText);
+        }
+
+        return _offset == m_bytes.size();
+    }
+
+    template<>
+    inline bool DecodedPacketView::isPacketValid<Client::SendEvents>() const {
+        if ( sizeof(Client::SendEvents) > m_bytes.size() ) {
+            return false;
+        }
+
+        auto packet = reinterpret_cast<const Client::SendEvents* >(m_bytes.data());
+        return areEntriesValid<Client::SendEventsEntry>( sizeof(Client::SendEvents), ntohs(packet->nboNumberOfEvents) );
+    }
+
+    template<>
+    inline bool DecodedPacketView::isPacketValid<Server::SavedEventsPackedResponse>() const {
+        if ( sizeof(Server::SavedEventsPackedResponse) > m_bytes.size() ) {
+            return false;
+        }
+
+        auto packet = reinterpret_cast<const Server::SavedEventsPackedResponse* >(m_bytes.data());
+        return areEntriesValid<Server::SavedEventsEntry>( sizeof(Server::SavedEventsPackedResponse), ntohs(packet->nboNumberOfEvents) );
+    }
+
     template<typename _PacketType>
-    inline bool DecodedPacket::setupVariant() {
+    inline bool DecodedPacketView::setupVariant() {
         if (!isPacketValid<_PacketType>()) {
             return false;
         }
 
-        auto packet = reinterpret_cast<const _PacketType* >( m_bytes.data() );
-        m_decodedPacketVariant.reset( new PacketVariant( packet ) );
+        m_decodedPacketVariant = reinterpret_cast<const _PacketType* >( m_bytes.data() );
         return true;
     }
 
 
 
+    //! Invokes visitor for each of entries, which follow each other without padding
+    template<typename _EntryType, typename _Visitor>
+    inline void visitEntries( const std::byte* _entries, uint16_t _numberOfEntries, _Visitor _visitor ) {
+        for ( auto entryIndex = 0; entryIndex < _numberOfEntries; ++entryIndex ) {
+            auto entry = reinterpret_cast<const _EntryType* >(_entries);
+            _visitor( *entry );
+            _entries += sizeof(_EntryType) + ntohs(entry->nboLengthOfText);
+        }
+    }
+
+    //! Invokes visitor for each event of decoded SendEvents packet
+    /*!
+     * @param _packet packet validated by DecodedPacketView
+     * @param _visitor function invoked with const Client::SendEventsEntry&
+     */
+    template<typename _Visitor>
+    inline void visitEntries( const Client::SendEvents& _packet, _Visitor _visitor ) {
+        visitEntries<Client::SendEventsEntry>( _packet.events, ntohs(_packet.nboNumberOfEvents), _visitor );
+    }
+
+    //! Invokes visitor for each event of decoded SavedEventsPackedResponse packet
+    /*!
+     * @param _packet packet validated by DecodedPacketView
+     * @param _visitor function invoked with const Server::SavedEventsEntry&
+     */
+    template<typename _Visitor>
+    inline void visitEntries( const Server::SavedEventsPackedResponse& _packet, _Visitor _visitor ) {
+        visitEntries<Server::SavedEventsEntry>( _packet.events, ntohs(_packet.nboNumberOfEvents), _visitor );
+    }
+
 } // namespace Challenge::PacketCoderV1
@@ -2,6 +2,8 @@
 
 #include "Lib/PacketCoderV1/Packets.h"
 
+#include "Event/EventData.h"
+
 #include <cstddef>
 #include <optional>
 #include <vector>
@@ -11,17 +13,45 @@ namespace Challenge::PacketCoderV1 {
     class PacketFactory {
         public:
             using PacketBytes = std::vector<std::byte>;
+            using Events = std::vector<EventData>;
 
             PacketBytes createHandshakeInvite(uint32_t _packetNumber);
+            //! Creates invite which proposes the highest version of protocol known by client
+            PacketBytes createHandshakeInvite(uint32_t _packetNumber, uint16_t _maxProtocolVersion);
             //! return nullopt in case when packet cannot be created because iit is to long
             std::optional<PacketBytes> createSendEvent( uint32_t _packetNumber, HandshakeId _handshakeId,  const std::string& _eventText, uint32_t _priority );
+            //! Creates packet with events [_firstEvent, _lastEvent), time stamps of events are not sent
+            /*!
+             * @return nullopt when events do not fit into one packet, see countEventsFittingSendEvents
+             */
+            std::optional<PacketBytes> createSendEvents( uint32_t _packetNumber, HandshakeId _handshakeId, Events::const_iterator _firstEvent, Events::const_iterator _lastEvent );
             PacketBytes createAck( uint32_t _packetNumber, HandshakeId _handshakeId );
+            //! Creates ack for invite with version, it contains version of protocol chosen by server
+            PacketBytes createAck( uint32_t _packetNumber, HandshakeId _handshakeId, uint16_t _protocolVersion );
+            //! Creates negative response for SendEvent, event was not saved
+            PacketBytes createNack( uint32_t _packetNumber, HandshakeId _handshakeId );
+            PacketBytes createSendEventsAck( uint32_t _packetNumber, HandshakeId _handshakeId, uint16_t _numberOfSavedEvents );
             PacketBytes createNumberOfEventsRequest( uint32_t _packetNumber, HandshakeId _handshakeId );
             PacketBytes createNumberOfEventsResponse( uint32_t _packetNumber, HandshakeId _handshakeId, uint64_t _numberOfSavedEvents );
             PacketBytes createSavedEventsRequest( uint32_t _packetNumber, HandshakeId _handshakeId, uint64_t _firstEvent, uint64_t _lastEvent );
             //! return nullopt in case when packet cannot be created because iit is to long
             std::optional<PacketFactory::PacketBytes> createSavedEventsResponse( uint32_t _packetNumber, HandshakeId _handshakeId, bool _isLast,  uint64_t _timestamp, uint32_t _priority, const std::string& _text );
+            PacketBytes createSavedEventsPackedRequest( uint32_t _packetNumber, HandshakeId _handshakeId, uint64_t _firstEvent, uint64_t _lastEvent );
+            //! Creates packet with events [_firstEvent, _lastEvent)
+            /*!
+             * @return nullopt when events do not fit into one packet, see countEventsFittingSavedEventsPackedResponse
+             */
+            std::optional<PacketBytes> createSavedEventsPackedResponse( uint32_t _packetNumber, HandshakeId _handshakeId, bool _isLast, Events::const_iterator _firstEvent, Events::const_iterator _lastEvent );
             PacketBytes createNewEventsNotification( HandshakeId _handshakeId, uint64_t _numberOfEvents );
+
+            //! Returns number of events, starting from _firstEvent, which fit into one SendEvents packet
+            static std::size_t countEventsFittingSendEvents( Events::const_iterator _firstEvent, Events::const_iterator _lastEvent );
+
+            //! Returns number of events, starting from _firstEvent, which fit into one SavedEventsPackedResponse packet
+            static std::size_t countEventsFittingSavedEventsPackedResponse( Events::const_iterator _firstEvent, Events::const_iterator _lastEvent );
+
+            //! Replaces handshake id in packet sent by server, so packet encoded once can be sent to many connections
+            static void setServerPacketHandshakeId( PacketBytes& _serverPacket, HandshakeId _handshakeId );
     };
 
 } // namespace Challenge::PacketCoderV1
@@ -43,7 +43,12 @@ enum class EventsTypes : uint8_t {
     NUMBER_OF_SAVED_EVENTS_RESPONSE,
     SAVED_EVENTS_REQUEST,
     SAVED_EVENTS_RESPONSE,
-    NEW_EVENTS_NOTIFICATION
+    NEW_EVENTS_NOTIFICATION,
+    SEND_EVENTS,
+    SEND_EVENTS_ACK,
+    SAVED_EVENTS_PACKED_REQUEST,
+    SAVED_EVENTS_PACKED_RESPONSE,
+    NACK
 };
 
 constexpr uint16_t VERSION_1 = 1;
@@ -75,6 +80,14 @@ namespace Client {
         PacketHeader<EventsTypes::HANDSHAKE_INVITE> packetHeader;
     };
 
+    //! HandshakeInvite of client which knows newer versions of protocol, server which knows only version 1 ignores it
+    struct HandshakeInviteWithVersion {
+        PacketHeader<EventsTypes::HANDSHAKE_INVITE> packetHeader;
+
+        //! The highest version of protocol known by client (NBO)
+        uint16_t nboMaxProtocolVersion;
+    };
+
     struct SendEvent {
         PacketHeaderWitHandshake<EventsTypes::SEND_EVENT> clientV1HeaderWithHandshake;
 
@@ -88,6 +101,28 @@ namespace Client {
         std::byte text[];
     };
 
+    //! Event carried by SendEvents, events follow each other without padding
+    struct SendEventsEntry {
+        //! Priority (NBO)
+        uint32_t nboPriority;
+
+        //! Size of text (NBO)
+        uint16_t nboLengthOfText;
+
+        //! Text in form of bytes
+        std::byte text[];
+    };
+
+    struct SendEvents {
+        PacketHeaderWitHandshake<EventsTypes::SEND_EVENTS> clientV1HeaderWithHandshake;
+
+        //! Number of events in packet (NBO)
+        uint16_t nboNumberOfEvents;
+
+        //! Events in form of SendEventsEntry
+        std::byte events[];
+    };
+
     struct NumberOfSavedEventsRequest {
         PacketHeaderWitHandshake<EventsTypes::NUMBER_OF_SAVED_EVENTS_REQUEST> clientV1HeaderWithHandshake;
     };
@@ -102,6 +137,17 @@ namespace Client {
         uint64_t nboLastEvent;
     };
 
+    //! Request of saved events, which are sent back in SavedEventsPackedResponse
+    struct SavedEventsPackedRequest {
+        PacketHeaderWitHandshake<EventsTypes::SAVED_EVENTS_PACKED_REQUEST> clientV1HeaderWithHandshake;
+
+        //! First event to get
+        uint64_t nboFirstEvent;
+
+        //! Last event to get
+        uint64_t nboLastEvent;
+    };
+
 } //namespace Client
 
 namespace Server {
@@ -124,6 +170,19 @@ namespace Server {
         ResponsePacketHeader<EventsTypes::ACK> serverResponsePacketHeader;
     };
 
+    //! Response for SendEvent which was not saved, e.g. because queue of storage writer is full
+    struct Nack {
+        ResponsePacketHeader<EventsTypes::NACK> serverResponsePacketHeader;
+    };
+
+    //! Ack for HandshakeInviteWithVersion
+    struct AckWithVersion {
+        ResponsePacketHeader<EventsTypes::ACK> serverResponsePacketHeader;
+
+        //! Version of protocol chosen by server for the connection (NBO)
+        uint16_t nboProtocolVersion;
+    };
+
     struct NumberOfSavedEventsResponse {
         ResponsePacketHeader<EventsTypes::NUMBER_OF_SAVED_EVENTS_REQUEST> serverResponsePacketHeader;
 
@@ -144,6 +203,36 @@ namespace Server {
         std::byte text[];
     };
 
+    //! Response for SendEvents
+    struct SendEventsAck {
+        ResponsePacketHeader<EventsTypes::SEND_EVENTS_ACK> serverResponsePacketHeader;
+
+        //! Number of saved events, events are saved in order, so they are the first events of request (NBO)
+        uint16_t nboNumberOfSavedEvents;
+    };
+
+    //! Event carried by SavedEventsPackedResponse, events follow each other without padding
+    struct SavedEventsEntry {
+        uint64_t nboMillisecondsFromEpoch;
+        uint32_t nboPriority;
+        uint16_t nboLengthOfText;
+        std::byte text[];
+    };
+
+    //! Response for SavedEventsPackedRequest, it contains as many events as fit into one packet
+    struct SavedEventsPackedResponse {
+        ResponsePacketHeader<EventsTypes::SAVED_EVENTS_PACKED_RESPONSE> serverResponsePacketHeader;
+
+        //! Information if it is a last packet of response: 0 - not last, 1 - last
+        uint8_t isLastPacket;
+
+        //! Number of events in packet (NBO), last packet may be empty
+        uint16_t nboNumberOfEvents;
+
+        //! Events in form of SavedEventsEntry
+        std::byte events[];
+    };
+
     struct NewEventsNotification {
         PacketHeader<EventsTypes::NEW_EVENTS_NOTIFICATION> serverPacketHeader;
         uint64_t nboNumberOfEvents;
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Lib/PacketCoderV2/Packets.h"
+
+#include "Event/EventData.h"
+
+#include "Lib/C++Tools/BytesView.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Challenge::PacketCoderV2 {
+
+    class PacketFactory {
+        public:
+            using PacketBytes = std::vector<std::byte>;
+            using Events = std::vector<EventData>;
+            //! Event encoded once as Server::SavedEventsEntry, it is shared by responses of many clients
+            using EncodedEntry = std::shared_ptr<const PacketBytes>;
+            using EncodedEntries = std::vector<EncodedEntry>;
+
+            //! return nullopt in case when packet cannot be created because it is longer than MAX_PACKET_LENGTH
+            std::optional<PacketBytes> createSendEvent( uint32_t _packetNumber, HandshakeId _handshakeId, const std::string& _eventText, uint32_t _priority );
+            //! Creates packet with events [_firstEvent, _lastEvent), time stamps of events are not sent
+            /*!
+             * @return nullopt when events do not fit into one packet, see countEventsFittingSendEvents
+             */
+            std::optional<PacketBytes> createSendEvents( uint32_t _packetNumber, HandshakeId _handshakeId, Events::const_iterator _firstEvent, Events::const_iterator _lastEvent );
+            PacketBytes createSendEventsAck( uint32_t _packetNumber, HandshakeId _handshakeId, uint32_t _numberOfSavedEvents );
+            //! Creates packet with events [_firstEvent, _lastEvent)
+            /*!
+             * @return nullopt when events do not fit into one packet, see countEventsFittingSavedEventsPackedResponse
+             */
+            std::optional<PacketBytes> createSavedEventsPackedResponse( uint32_t _packetNumber, HandshakeId _handshakeId, bool _isLast, Events::const_iterator _firstEvent, Events::const_iterator _lastEvent );
+
+            //! Returns number of events, starting from _firstEvent, which fit into one SendEvents packet
+            /*!
+             * @param _maxPacketLength maximal length of packet, it is not greater than MAX_PACKET_LENGTH
+             */
+            static std::size_t countEventsFittingSendEvents( Events::const_iterator _firstEvent, Events::const_iterator _lastEvent, std::size_t _maxPacketLength );
+            //! Returns number of events, starting from _firstEvent, which fit into one SavedEventsPackedResponse packet
+            /*!
+             * @param _maxPacketLength maximal length of packet, it is not greater than MAX_PACKET_LENGTH
+             */
+            static std::size_t countEventsFittingSavedEventsPackedResponse( Events::const_iterator _firstEvent, Events::const_iterator _lastEvent, std::size_t _maxPacketLength );
+
+            //! Encodes event as Server::SavedEventsEntry, responses are then created from entries only by copying
+            /*!
+             *  Entry of version 2 carries text of any length, so one encoding serves responses of both versions, only
+             *  length of text is narrowed for version 1
+             */
+            static PacketBytes createSavedEventsEntry( const EventData& _event );
+            //! Creates packet with encoded entries [_firstEntry, _lastEntry)
+            /*!
+             * @return nullopt when entries do not fit into one packet, see countEntriesFittingSavedEventsPackedResponse
+             */
+            std::optional<PacketBytes> createSavedEventsPackedResponse( uint32_t _packetNumber, HandshakeId _handshakeId, bool _isLast, EncodedEntries::const_iterator _firstEntry, EncodedEntries::const_iterator _lastEntry );
+            //! Returns number of entries, starting from _firstEntry, which fit into one SavedEventsPackedResponse packet
+            /*!
+             * @param _maxPacketLength maximal length of packet, it is not greater than MAX_PACKET_LENGTH
+             */
+            static std::size_t countEntriesFittingSavedEventsPackedResponse( EncodedEntries::const_iterator _firstEntry, EncodedEntries::const_iterator _lastEntry, std::size_t _maxPacketLength );
+
+            //! Creates PacketCoderV1::Server::SavedEventsResponse from encoded entry
+            /*!
+             *  Text which does not fit into packet of version 1 is truncated, so every entry can be sent
+             */
+            std::optional<PacketBytes> createSavedEventsResponseV1( uint32_t _packetNumber, HandshakeId _handshakeId, bool _isLast, BytesView _entry );
+            //! Creates PacketCoderV1::Server::SavedEventsPackedResponse with encoded entries [_firstEntry, _lastEntry)
+            /*!
+             * @return nullopt when entries do not fit into one packet, see countEntriesFittingSavedEventsPackedResponseV1
+             */
+            std::optional<PacketBytes> createSavedEventsPackedResponseV1( uint32_t _packetNumber, HandshakeId _handshakeId, bool _isLast, EncodedEntries::const_iterator _firstEntry, EncodedEntries::const_iterator _lastEntry );
+            //! Returns number of entries, starting from _firstEntry, which fit into one PacketCoderV1::Server::SavedEventsPackedResponse
+            /*!
+             *  Texts are truncated as by createSavedEventsResponseV1, so at least one entry fits, if there is any
+             */
+            static std::size_t countEntriesFittingSavedEventsPackedResponseV1( EncodedEntries::const_iterator _firstEntry, EncodedEntries::const_iterator _lastEntry );
+    };
+
+} // namespace Challenge::PacketCoderV2
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "Communication/ApplicationProtocol/FrameHeader.h"
+#include "Lib/PacketCoderV1/Packets.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <arpa/inet.h>
+
+//! Version 2 of application protocol
+/*!
+ *  Version 2 contains only messages whose size depends on events, they use ExtendedPacketHeader, so they are not
+ *  limited to 65535 bytes. Fixed size messages are exchanged in version 1 format also on connections which negotiated
+ *  version 2. Types of messages have the same values as in version 1.
+ */
+namespace Challenge::PacketCoderV2 {
+
+using PacketCoderV1::PacketSequenceNumber;
+using PacketCoderV1::HandshakeId;
+using PacketCoderV1::EventsTypes;
+
+constexpr uint16_t VERSION_2 = 2;
+
+#pragma pack(push)
+#pragma pack(1)
+
+template< EventsTypes _EventType >
+struct PacketHeader {
+    Challenge::Communication::ApplicationProtocol::ExtendedPacketHeader appPacketHeader;
+    const uint8_t type = static_cast<uint8_t>(_EventType);
+};
+
+namespace Client {
+    template< EventsTypes _EventType >
+    struct PacketHeader {
+        PacketCoderV2::PacketHeader<_EventType> v2PacketHeader;
+        PacketSequenceNumber nboClientPacketNumber;
+    };
+
+    template< EventsTypes _EventType >
+    struct PacketHeaderWitHandshake {
+        PacketHeader<_EventType> clientV2PacketHeader;
+        //! Handshake id (NBO)
+        HandshakeId nboHandshakeId;
+    };
+
+    struct SendEvent {
+        PacketHeaderWitHandshake<EventsTypes::SEND_EVENT> clientV2HeaderWithHandshake;
+
+        //! Priority (NBO)
+        uint32_t nboPriority;
+
+        //! Size of text (NBO)
+        uint32_t nboLengthOfText;
+
+        //! Text in form of bytes
+        std::byte text[];
+    };
+
+    //! Event carried by SendEvents, events follow each other without padding
+    struct SendEventsEntry {
+        //! Priority (NBO)
+        uint32_t nboPriority;
+
+        //! Size of text (NBO)
+        uint32_t nboLengthOfText;
+
+        //! Text in form of bytes
+        std::byte text[];
+    };
+
+    struct SendEvents {
+        PacketHeaderWitHandshake<EventsTypes::SEND_EVENTS> clientV2HeaderWithHandshake;
+
+        //! Number of events in packet (NBO)
+        uint32_t nboNumberOfEvents;
+
+        //! Events in form of SendEventsEntry
+        std::byte events[];
+    };
+
+} //namespace Client
+
+namespace Server {
+    template<EventsTypes _EventType>
+    struct PacketHeader {
+        PacketCoderV2::PacketHeader<_EventType> v2PacketHeader;
+
+        //! unique handshake id allocated by server (NBO)
+        HandshakeId nboHandshakeId;
+    };
+
+    template<EventsTypes _EventType>
+    struct ResponsePacketHeader {
+        PacketHeader<_EventType> serverV2PacketHeader;
+        //! Number of client packet which is responded for (NBO)
+        PacketSequenceNumber nboClientPacketNumber;
+    };
+
+    //! Response for SendEvents
+    struct SendEventsAck {
+        ResponsePacketHeader<EventsTypes::SEND_EVENTS_ACK> serverResponsePacketHeader;
+
+        //! Number of saved events, events are saved in order, so they are the first events of request (NBO)
+        uint32_t nboNumberOfSavedEvents;
+    };
+
+    //! Event carried by SavedEventsPackedResponse, events follow each other without padding
+    struct SavedEventsEntry {
+        uint64_t nboMillisecondsFromEpoch;
+        uint32_t nboPriority;
+        uint32_t nboLengthOfText;
+        std::byte text[];
+    };
+
+    //! Response for PacketCoderV1::Client::SavedEventsPackedRequest on connection which negotiated version 2
+    struct SavedEventsPackedResponse {
+        ResponsePacketHeader<EventsTypes::SAVED_EVENTS_PACKED_RESPONSE> serverResponsePacketHeader;
+
+        //! Information if it is a last packet of response: 0 - not last, 1 - last
+        uint8_t isLastPacket;
+
+        //! Number of events in packet (NBO), last packet may be empty
+        uint32_t nboNumberOfEvents;
+
+        //! Events in form of SavedEventsEntry
+        std::byte events[];
+    };
+} //namespace Server
+
+#pragma pack(pop)
+
+// layout of packets is part of protocol, so it must not depend on padding of compiler
+static_assert( sizeof(PacketHeader<EventsTypes::SEND_EVENT>) == 9 );
+static_assert( sizeof(Client::SendEvent) == 25 );
+static_assert( sizeof(Client::SendEventsEntry) == 8 );
+static_assert( sizeof(Client::SendEvents) == 21 );
+static_assert( sizeof(Server::SendEventsAck) == 21 );
+static_assert( sizeof(Server::SavedEventsEntry) == 16 );
+static_assert( sizeof(Server::SavedEventsPackedResponse) == 22 );
+
+} //namespace Challenge::PacketCoderV2
@@ -4,6 +4,7 @@
 
 #include <QByteArray>
 #include <QDataStream>
+#include <QLocalSocket>
 #include <QTcpSocket>
 #include <QPointer>
 
@@ -11,9 +12,11 @@
 #include <mutex>
 #include <cstddef>
 #include <optional>
+#include <vector>
 
 namespace Challenge {
 
+    //! Connection on Qt socket, it serves TCP sockets and local ( Unix domain ) sockets in the same way
     class QtTcpConnectionHelper : public QObject {
                 Q_OBJECT
             public:
@@ -21,29 +24,55 @@ namespace Challenge {
                 using ConnectionExpiredCallback = std::function<void(void)>;
                 using NewDataReadyToReadCallback = std::function<void(void)>;
 
+                //! Queued bytes, which are written at once without waiting for next iteration of event loop
+                static constexpr std::size_t FLUSH_THRESHOLD = 64 * 1024;
+
                 QtTcpConnectionHelper(QPointer<QTcpSocket> _socket);
+                QtTcpConnectionHelper(QPointer<QLocalSocket> _socket);
                 ~QtTcpConnectionHelper() override;
 
                 bool isValid() const;
                 bool registerConnectionExpiredCallback(ConnectionExpiredCallback _callback);
                 bool registerNewDataReadyToReadCallback(NewDataReadyToReadCallback _callback);
                 std::optional<Payload> receive();
+                //! Appends received bytes to _buffer, returns number of appended bytes or std::nullopt in case of error
+                std::optional<std::size_t> receiveInto( Payload& _buffer );
+                //! Queues data, queue is written once per event loop iteration or when it exceeds FLUSH_THRESHOLD
+                /*!
+                 * @return std::nullopt in case of error or number of queued bytes
+                 */
                 std::optional<uint32_t> send( const Payload& _payload );
+                //! Writes queued data immediately
+                bool flush();
 
             private slots:
                 void onDataArrived();
                 void onDisconnected();
 
             private:
-                QPointer<QTcpSocket> m_connectedSocket;
+                //! Connects signals of socket and binds operations, which QTcpSocket and QLocalSocket do not share in QIODevice
+                template< typename _Socket >
+                void initialize( QPointer<_Socket> _socket );
+                //! Writes queue with one gather write when possible, it has to be called with locked queue
+                bool flushOutboundQueue();
+
+            private:
+                QPointer<QIODevice> m_connectedSocket;
                 QDataStream m_dataStream;
 
+                std::function<bool()> m_isSocketConnected;
+                std::function<void()> m_flushSocket;
+                std::function<qintptr()> m_socketDescriptor;
+
                 ConnectionExpiredCallback m_connectionExpiredCallback;
                 NewDataReadyToReadCallback m_newDataReadyToReadCallback;
 
-                QByteArray m_rawDataFromSocket;
+                std::vector<Payload> m_outboundQueue;
+                std::size_t m_outboundQueueSize = 0;
+                bool m_isFlushScheduled = false;
+                std::mutex m_outboundQueueMutex;
 
-                std::mutex m_rawDataMutex;
+                std::mutex m_receiveMutex;
                 std::recursive_mutex m_callbacksMutex;
             };
 
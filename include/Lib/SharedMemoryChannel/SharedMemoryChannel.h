@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Lib/SharedMemoryChannel/SharedMemoryRing.h"
+
+#include <QObject>
+#include <QSocketNotifier>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace Challenge {
+
+    //! Duplex connection over two SharedMemoryRing in one shared memory segment
+    /*!
+     *  Server creates the segment ( memfd ) and two eventfd descriptors for wake ups and passes them to client over
+     *  connected Unix domain socket ( SCM_RIGHTS ). The socket is kept only to detect that peer is gone, data go
+     *  through rings. Sent bytes are copied to ring without syscall, peer is woken once per flush.
+     */
+    class SharedMemoryChannel : public QObject {
+        Q_OBJECT
+    public:
+        using Payload = std::vector<std::byte>;
+        using ConnectionExpiredCallback = std::function<void(void)>;
+        using NewDataReadyToReadCallback = std::function<void(void)>;
+
+        //! Server creates shared memory, client receives it
+        enum class Side {
+            Server,
+            Client
+        };
+
+        //! Capacity of ring in each direction
+        static constexpr std::size_t RING_CAPACITY = 1024 * 1024;
+        //! Maximal number of bytes waiting for space in ring, connection becomes invalid when it would be exceeded
+        static constexpr std::size_t MAX_PENDING_SIZE = 64 * 1024 * 1024;
+        //! Time for client to receive shared memory from server
+        static constexpr int SETUP_TIMEOUT_MS = 3000;
+
+        //! Constructor
+        /*!
+         *
+         * @param _socket connected Unix domain socket, channel takes ownership of it, also when constructor throws
+         * @param _side side of the channel
+         * @throw std::runtime_error if shared memory cannot be created or received
+         */
+        SharedMemoryChannel( int _socket, Side _side );
+        ~SharedMemoryChannel() override;
+
+        SharedMemoryChannel(const SharedMemoryChannel &) = delete;
+        SharedMemoryChannel(SharedMemoryChannel &&) = delete;
+        SharedMemoryChannel &operator=(SharedMemoryChannel &) = delete;
+        SharedMemoryChannel &operator=(SharedMemoryChannel &&) = delete;
+
+        bool isValid() const;
+        bool registerConnectionExpiredCallback(ConnectionExpiredCallback _callback);
+        bool registerNewDataReadyToReadCallback(NewDataReadyToReadCallback _callback);
+        //! Returns received data, data written by peer before it closed connection are returned as well
+        std::optional<Payload> receive();
+        //! Appends received bytes to _buffer, returns number of appended bytes or std::nullopt in case of error
+        std::optional<std::size_t> receiveInto( Payload& _buffer );
+        //! Writes data to ring, bytes which do not fit wait in pending buffer
+        /*!
+         *  Peer is woken by flush, flush is scheduled to next iteration of event loop, when it is not called before
+         * @return std::nullopt in case of error or number of accepted bytes
+         */
+        std::optional<uint32_t> send( const Payload& _payload );
+        //! Wakes up peer, if anything was written since last wake up
+        bool flush();
+
+    private:
+        void createSharedMemory();
+        void receiveSharedMemory();
+        void mapSharedMemory( int _memoryDescriptor );
+        void closeDescriptors();
+
+        //! Moves pending bytes to ring, it has to be called with locked outbound buffer
+        void writePending();
+        //! Peer moved counter of ring out of bounds, connection cannot be used anymore
+        void markRingCorrupted();
+        void wakeUpPeer();
+        //! Reads the socket, peer never writes to it after setup, so only closing is detected
+        bool isPeerConnected();
+
+        void onWakeUp();
+        void onSocketEvent();
+
+    private:
+        const int m_socket;
+        int m_wakeUpEvent = -1;
+        int m_peerWakeUpEvent = -1;
+        void* m_segment = nullptr;
+
+        std::unique_ptr<SharedMemoryRing> m_inbound;
+        std::unique_ptr<SharedMemoryRing> m_outbound;
+
+        std::atomic<bool> m_isValid{ true };
+        bool m_isExpirationNotified = false;
+
+        std::mutex m_inboundMutex;
+
+        Payload m_pending;
+        //! Number of bytes at the beginning of pending buffer which are already written to ring
+        std::size_t m_pendingOffset = 0;
+        bool m_isPeerWakeUpPending = false;
+        bool m_isFlushScheduled = false;
+        std::mutex m_outboundMutex;
+
+        std::unique_ptr<QSocketNotifier> m_wakeUpNotifier;
+        std::unique_ptr<QSocketNotifier> m_socketNotifier;
+
+        ConnectionExpiredCallback m_connectionExpiredCallback;
+        NewDataReadyToReadCallback m_newDataReadyToReadCallback;
+        std::recursive_mutex m_callbacksMutex;
+    };
+
+} // namespace Challenge
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Lib/C++Tools/BytesView.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Challenge {
+
+    //! Single producer single consumer ring of bytes placed in memory shared by two processes
+    /*!
+     *  Ring does not own its memory, Control and data are placed in shared segment and both processes have own view.
+     *  Producer only moves head and consumer only moves tail, so ring is lock free and no syscall is done in
+     *  write or read. Waking up of the other process is left to the owner of the ring.
+     *  Peer may write anything to the shared memory, so each side keeps own copy of the counter it moves and counter
+     *  of peer is accepted only when it leaves at most capacity bytes in the ring, otherwise the ring is corrupted.
+     */
+    class SharedMemoryRing {
+    public:
+        //! State of ring in shared memory, indexes are counters of bytes, they are not wrapped to capacity
+        struct Control {
+            //! Moved by producer, each counter is in own cache line, so producer and consumer do not share the line
+            alignas(64) std::atomic<uint64_t> head{ 0 };
+            //! Moved by consumer
+            alignas(64) std::atomic<uint64_t> tail{ 0 };
+            //! Set by producer which found the ring full, consumer wakes it when it frees space
+            alignas(64) std::atomic<bool> isProducerWaiting{ false };
+        };
+
+        static_assert( std::atomic<uint64_t>::is_always_lock_free, "Atomic in shared memory must be lock free" );
+        static_assert( std::atomic<bool>::is_always_lock_free, "Atomic in shared memory must be lock free" );
+
+        //! Constructor
+        /*!
+         * @param _control state of ring in shared memory
+         * @param _data buffer of ring in shared memory
+         * @param _capacity size of buffer
+         * @throw std::runtime_error if capacity is not power of two
+         */
+        SharedMemoryRing( Control& _control, std::byte* _data, std::size_t _capacity );
+
+        //! Writes as many bytes as fit into ring, it is called only by producer
+        /*!
+         * @return number of written bytes
+         */
+        std::size_t write( BytesView _bytes );
+
+        //! Appends all bytes available in ring to _buffer, it is called only by consumer
+        /*!
+         * @return number of read bytes
+         */
+        std::size_t readInto( std::vector<std::byte>& _buffer );
+
+        //! Checks if there is anything to read, it is called only by consumer
+        bool isEmpty() const;
+
+        //! Producer announces that it waits for space, it is called after write did not take all bytes
+        /*!
+         *  Consumer could free space between write and the announcement, so producer has to try again when true
+         *  is returned, otherwise it waits for wake up by consumer
+         * @return true if there is free space already
+         */
+        bool waitForSpace();
+
+        //! Consumer checks, if producer waits for space freed by the last read and clears the announcement
+        bool takeWaitingProducer();
+
+        //! Checks if peer moved its counter out of bounds, corrupted ring neither writes nor reads anything
+        bool isCorrupted() const;
+
+        std::size_t capacity() const;
+
+    private:
+        Control& m_control;
+        std::byte* const m_data;
+        const std::size_t m_capacity;
+        //! Counters moved by this side, counters in shared memory are only published copies of them
+        uint64_t m_head;
+        uint64_t m_tail;
+        bool m_isCorrupted = false;
+    };
+
+} // namespace Challenge
@@ -12,7 +12,8 @@ namespace Challenge::Tests {
             return result;
         }
 
-        void fireCallback() { if ( m_callback ){ m_callback(); } }
+        template<typename... _Args>
+        void fireCallback( _Args... _args ) { if ( m_callback ){ m_callback( _args... ); } }
 
         bool isValid() const { return m_callback != nullptr; }
 
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "EventsStorage/IEventsStorage.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace Challenge {
+
+    //! Bounded queue of saves waiting for writer thread of storage
+    /*!
+     *  Queue is not synchronized, it is guarded by mutex of its owner, which is passed to push, so blocked saver
+     *  waits for space without holding it. Completions are never fired by queue, writes which are not queued are
+     *  returned to owner, which fires them with 0 after it unlocks the mutex.
+     */
+    class WritesQueue {
+    public:
+        using Events = EventsStorage::IEventsStorage::Events;
+        using SaveCompletion = EventsStorage::IEventsStorage::SaveCompletion;
+
+        //! Events of one save, completion is fired when they are written
+        struct PendingWrite {
+            Events events;
+            SaveCompletion completion;
+            //! Time until which the write waits for next writes to share its transaction, used by group commit
+            std::chrono::steady_clock::time_point deadline;
+            //! The highest priority of events, write with lower priority is shed first
+            uint32_t priority = 0;
+        };
+
+        //! Constructor
+        /*!
+         * @param _maxNumberOfEvents maximal number of queued events, write bigger than queue is accepted only by empty
+         *  queue
+         * @param _policy what happens with pushed write, when queue is full
+         * @throw std::runtime_error if size of queue is 0
+         */
+        WritesQueue( std::size_t _maxNumberOfEvents, EventsStorage::FullQueuePolicy _policy );
+
+        //! Queues write or applies full queue policy
+        /*!
+         * @param _write write with at least one event, its priority is computed by queue
+         * @param _lock lock of mutex which guards the queue, blocked saver waits on it
+         * @param _notFullCondition condition notified by owner, when it takes writes from queue
+         * @return writes which were not queued ( rejected or shed ), their completions have to be fired with 0
+         */
+        std::vector<PendingWrite> push( PendingWrite _write, std::unique_lock<std::mutex>& _lock, std::condition_variable& _notFullCondition );
+
+        //! Moves writes from front of queue, until they have at most given number of events ( at least one write )
+        void takeBatch( std::size_t _maxNumberOfEvents, std::vector<PendingWrite>& _writes );
+
+        bool isEmpty() const { return m_writes.empty(); }
+        const PendingWrite& front() const { return m_writes.front(); }
+        std::size_t getNumberOfEvents() const { return m_numberOfEvents; }
+
+    private:
+        bool isSpaceFor( std::size_t _numberOfEvents ) const;
+        //! Removes queued writes with lower priority, until events fit into queue
+        /*!
+         * @return removed writes, nothing is removed when events would not fit into queue anyway
+         */
+        std::vector<PendingWrite> shedLowerPriority( uint32_t _priority, std::size_t _numberOfEvents );
+
+    private:
+        const std::size_t m_maxNumberOfEvents;
+        const EventsStorage::FullQueuePolicy m_policy;
+
+        std::deque<PendingWrite> m_writes;
+        std::size_t m_numberOfEvents = 0;
+    };
+
+} // namespace Challenge
@@ -4,6 +4,7 @@
 #include "Lib/C++Tools/ScopedAction.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
 
 #include <cinttypes>
 #include <stdexcept>
@@ -17,7 +18,21 @@ int32_t  main( int32_t _argc, char** _argv) try {
     Challenge::ScopedAction scopedAction( []{closelog();} );
 
     QApplication application(_argc, _argv);
-    Challenge::Application::MainWindow mainWindow;
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption localSocketOption( "local-socket", "Connect to server on the same host over local socket with given path", "path" );
+    parser.addOption( localSocketOption );
+    QCommandLineOption sharedMemoryOption( "shared-memory", "Connect to server on the same host over shared memory, local socket with given path is used to set it up", "path" );
+    parser.addOption( sharedMemoryOption );
+    parser.process( application );
+
+    if ( parser.isSet( localSocketOption ) && parser.isSet( sharedMemoryOption ) ) {
+        throw std::runtime_error( "Local socket and shared memory cannot be used together" );
+    }
+
+    Challenge::Application::MainWindow mainWindow( parser.value( localSocketOption ).toStdString()
+                                                 , parser.value( sharedMemoryOption ).toStdString() );
     mainWindow.show();
 
     return QApplication::exec();
@@ -17,10 +17,18 @@
 
 namespace Challenge::Application {
 
-MainWindow::MainWindow(QWidget* _parent ) : QMainWindow(_parent) {
+MainWindow::MainWindow(const std::string& _localSocketPath, const std::string& _sharedMemorySocketPath, QWidget* _parent )
+    : QMainWindow(_parent) {
     m_ui.setupUi(this);
 
-    m_connectivityManager = Communication::Client::ITransportConnectivityManager::create();
+    using Communication::Client::ITransportConnectivityManager;
+    if ( !_sharedMemorySocketPath.empty() ) {
+        m_connectivityManager = ITransportConnectivityManager::create( Communication::Client::SharedMemoryEngine{ _sharedMemorySocketPath } );
+    } else {
+        m_connectivityManager = _localSocketPath.empty()
+                ? ITransportConnectivityManager::create()
+                : ITransportConnectivityManager::create( Communication::Client::LocalSocketEngine{ _localSocketPath } );
+    }
 
     if ( !m_connectivityManager ) {
         throw std::runtime_error( "Cannot create connectivity manager" );
@@ -9,6 +9,7 @@
 #include <QPointer>
 
 #include <memory>
+#include <string>
 
 namespace Challenge {
 
@@ -32,10 +33,14 @@ namespace Application {
             //! Constructor
             /*!
              *
+             * @param _localSocketPath when not empty, connects to server over local socket with this path instead of TCP
+             * @param _sharedMemorySocketPath when not empty, exchanges data with server over shared memory, which is
+             *  received on local socket with this path
              * @param _parent parent window
              * @throw std::runtime_error in case of error
              */
-            explicit MainWindow(QWidget *_parent = nullptr);
+            explicit MainWindow(const std::string& _localSocketPath = {}, const std::string& _sharedMemorySocketPath = {}
+                              , QWidget *_parent = nullptr);
 
         public slots:
             void onButtonConnectClicked();
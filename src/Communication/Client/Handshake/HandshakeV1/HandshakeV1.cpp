@@ -5,8 +5,10 @@
 #include "Lib/PacketCoderV1/PacketDecoder.h"
 #include "Lib/PacketCoderV1/PacketFactory.h"
 #include "Lib/PacketCoderV1/BytesStream.h"
+#include "Lib/PacketCoderV2/Packets.h"
 #include "Lib/Log/Logger.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <chrono>
 #include <thread>
@@ -37,11 +39,13 @@ HandshakeV1::HandshakeV1( std::shared_ptr<ITransportConnection> _connection ) :
     }
 
     PacketCoderV1::PacketFactory packetFactory;
-    auto handshakeInvite = packetFactory.createHandshakeInvite( 0 );
+    // server which knows only version 1 responds with Ack without version
+    auto handshakeInvite = packetFactory.createHandshakeInvite( 0, PacketCoderV2::VERSION_2 );
 
     // wait 1s fo response
     for ( auto i = 0; i < 10; i++, std::this_thread::sleep_for( 100ms ) ) {
         auto sendResult = m_connection->send( handshakeInvite );
+        m_connection->flush();
         if (!sendResult.has_value() || sendResult.value() != handshakeInvite.size() ) {
             throw std::runtime_error("Cannot send handshake invite");
         }
@@ -56,7 +60,7 @@ HandshakeV1::HandshakeV1( std::shared_ptr<ITransportConnection> _connection ) :
 
         for ( auto rawPacket = stream.getPacket(); rawPacket.has_value(); rawPacket = stream.getPacket() ) {
             try {
-                PacketCoderV1::DecodedPacket decodedPacket(rawPacket.value());
+                PacketCoderV1::DecodedPacketView decodedPacket(rawPacket.value());
 
                 if (!std::holds_alternative<const PacketCoderV1::Server::Ack *>(decodedPacket.decodedPacket())) {
                     continue;
@@ -69,6 +73,11 @@ HandshakeV1::HandshakeV1( std::shared_ptr<ITransportConnection> _connection ) :
                         ntohl(packet->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId)
                 );
 
+                if ( rawPacket->size() >= sizeof(PacketCoderV1::Server::AckWithVersion) ) {
+                    auto ackWithVersion = reinterpret_cast<const PacketCoderV1::Server::AckWithVersion*>( rawPacket->data() );
+                    m_protocolVersion = std::clamp( ntohs(ackWithVersion->nboProtocolVersion), uint16_t{1}, PacketCoderV2::VERSION_2 );
+                }
+
                 LOG_INFORMATION("Handshake completed");
 
                 return;
@@ -98,4 +107,9 @@ HandshakeV1::connection() const {
    return *m_connection;
 }
 
+uint16_t
+HandshakeV1::protocolVersion() const {
+    return m_protocolVersion;
+}
+
 } // namespace Challenge::Communication::Client
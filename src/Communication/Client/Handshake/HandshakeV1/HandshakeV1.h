@@ -24,10 +24,12 @@ namespace Challenge::Communication::Client {
 
             const Identifier& identifier() const override;
             ITransportConnection& connection() const override;
+            uint16_t protocolVersion() const override;
 
         private:
             Identifier m_identifier;
             std::shared_ptr<ITransportConnection> m_connection;
+            uint16_t m_protocolVersion = 1;
     };
 } // namespace Challenge::Communication::Client
 
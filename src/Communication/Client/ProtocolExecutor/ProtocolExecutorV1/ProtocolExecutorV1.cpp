@@ -5,16 +5,64 @@
 
 #include "Lib/PacketCoderV1/PacketFactory.h"
 #include "Lib/PacketCoderV1/BytesStream.h"
+#include "Lib/PacketCoderV2/PacketFactory.h"
 #include "Lib/C++Tools/ScopedAction.h"
 #include "Lib/Log/Logger.h"
 #include "Lib/Uint64/BytsOrderUint64.h"
 
 #include <cassert>
+#include <chrono>
 #include <stdexcept>
 #include <variant>
 
 namespace Challenge::Communication::Client {
 
+//! Maximal length of SendEvents of version 2, it limits memory used by one request
+constexpr std::size_t SEND_EVENTS_V2_MAX_LENGTH = 1024 * 1024;
+
+//! Time in which response of asynchronous request ( or its next packet ) has to arrive, as synchronous requests wait
+constexpr std::chrono::milliseconds ASYNC_RESPONSE_TIMEOUT{ 2000 };
+
+namespace {
+    //! Appends events of SavedEventsPackedResponse of any version
+    /*!
+     * @return if it was the last packet of response, nullopt when message is not SavedEventsPackedResponse
+     */
+    template<typename _ServerMessage>
+    std::optional<bool> appendSavedEvents( const _ServerMessage& _message, IProtocolExecutor::Events& _events ) {
+        using namespace std::chrono;
+
+        if (auto packet = _message.template get<PacketCoderV1::Server::SavedEventsPackedResponse>()) {
+            PacketCoderV1::visitEntries( *packet, [&_events]( const PacketCoderV1::Server::SavedEventsEntry& _entry ) {
+                time_point<system_clock> timeStamp( milliseconds( ntohll( _entry.nboMillisecondsFromEpoch ) ) );
+                std::string text(reinterpret_cast<const char*>(_entry.text), ntohs(_entry.nboLengthOfText));
+                _events.push_back( EventData{
+                      timeStamp
+                    , text
+                    , ntohl( _entry.nboPriority )
+                } );
+            });
+            return packet->isLastPacket != 0;
+        }
+
+        if (auto packet = _message.template get<PacketCoderV2::Server::SavedEventsPackedResponse>()) {
+            // server answers in version 2 when it was negotiated
+            PacketCoderV2::visitEntries( *packet, [&_events]( const PacketCoderV2::Server::SavedEventsEntry& _entry ) {
+                time_point<system_clock> timeStamp( milliseconds( ntohll( _entry.nboMillisecondsFromEpoch ) ) );
+                std::string text(reinterpret_cast<const char*>(_entry.text), ntohl(_entry.nboLengthOfText));
+                _events.push_back( EventData{
+                      timeStamp
+                    , text
+                    , ntohl( _entry.nboPriority )
+                } );
+            });
+            return packet->isLastPacket != 0;
+        }
+
+        return std::nullopt;
+    }
+} // namespace
+
 template<>
 std::shared_ptr<IProtocolExecutor> IProtocolExecutor::create(std::shared_ptr<IHandshake> _handshake ) try {
     return std::shared_ptr<IProtocolExecutor>(new ApplicationProtocolV1(_handshake) );
@@ -39,6 +87,13 @@ ApplicationProtocolV1::ApplicationProtocolV1(std::shared_ptr<IHandshake> _handsh
     connectEventsCallback();
 }
 
+ApplicationProtocolV1::~ApplicationProtocolV1() {
+    disconnectEventsCallback();
+
+    // futures of requests which wait for responses are resolved
+    m_serverResponses->cancelAllResponses();
+}
+
 bool
 ApplicationProtocolV1::sendEvent(const std::string& _eventText, uint32_t _priority ) {
     assert(m_handshake);
@@ -51,17 +106,8 @@ ApplicationProtocolV1::sendEvent(const std::string& _eventText, uint32_t _priori
     if (!m_handshake->isValid()) {
         return false;
     }
-    auto packetCounter = 0;
-    {
-        std::lock_guard guard(m_packetCounterMutex);
-        packetCounter = ++m_packetCounter;
-    }
-
-    PacketCoderV1::HandshakeId handshakeId
-        = PacketCoderV1::byteVectorToHandshakeId( m_handshake->identifier() ).value();
-
-    PacketCoderV1::PacketFactory packetFactory;
-    auto sendEvent = packetFactory.createSendEvent(packetCounter, handshakeId, _eventText, _priority);
+    const auto packetCounter = nextPacketNumber();
+    auto sendEvent = createSendEvent(packetCounter, _eventText, _priority);
 
     if (!sendEvent.has_value()) {
         return false;
@@ -72,6 +118,8 @@ ApplicationProtocolV1::sendEvent(const std::string& _eventText, uint32_t _priori
             [this, packetCounter] { m_serverResponses->stopExpectingResponseForClientMessage(packetCounter); });
 
     auto sendResult = m_handshake->connection().send(sendEvent.value());
+    // server response is awaited, so request cannot wait for next iteration of event loop
+    m_handshake->connection().flush();
 
     if (!sendResult.has_value()) {
         return false;
@@ -88,9 +136,13 @@ ApplicationProtocolV1::sendEvent(const std::string& _eventText, uint32_t _priori
         assert(serverResponse.has_value());
 
         for (auto &response : serverResponse.value()) {
-            if (std::holds_alternative<const PacketCoderV1::Server::Ack *>(response.decodedPacket())) {
+            if (response.get<PacketCoderV1::Server::Ack>()) {
                 return true;
             }
+            if (response.get<PacketCoderV1::Server::Nack>()) {
+                // server did not save the event
+                return false;
+            }
         }
 
         std::this_thread::sleep_for(1ms);
@@ -99,6 +151,92 @@ ApplicationProtocolV1::sendEvent(const std::string& _eventText, uint32_t _priori
     return false;
 }
 
+std::optional<std::size_t>
+ApplicationProtocolV1::sendEvents( const Events& _events ) {
+    assert(m_handshake);
+
+    disconnectEventsCallback();
+    ScopedAction scopedCallbackAction( [this]{ connectEventsCallback(); tryToGetServerMessages(); } );
+
+    std::size_t numberOfSavedEvents = 0;
+    for ( auto firstEvent = _events.begin(); firstEvent != _events.end(); ) {
+        const auto numberOfEventsInPacket = isProtocolV2()
+                ? PacketCoderV2::PacketFactory::countEventsFittingSendEvents( firstEvent, _events.end(), SEND_EVENTS_V2_MAX_LENGTH )
+                : PacketCoderV1::PacketFactory::countEventsFittingSendEvents( firstEvent, _events.end() );
+        if ( numberOfEventsInPacket == 0 ) {
+            // event is too long to be sent
+            return numberOfSavedEvents;
+        }
+
+        const auto lastEvent = firstEvent + numberOfEventsInPacket;
+        auto savedInPacket = sendEventsPacket( firstEvent, lastEvent );
+
+        if ( !savedInPacket.has_value() ) {
+            return numberOfSavedEvents == 0 ? std::nullopt : std::optional<std::size_t>( numberOfSavedEvents );
+        }
+
+        numberOfSavedEvents += savedInPacket.value();
+
+        // next events are not sent, so saved events are always the first events of batch
+        if ( savedInPacket.value() != numberOfEventsInPacket ) {
+            return numberOfSavedEvents;
+        }
+
+        firstEvent = lastEvent;
+    }
+
+    return numberOfSavedEvents;
+}
+
+std::optional<std::size_t>
+ApplicationProtocolV1::sendEventsPacket( Events::const_iterator _firstEvent, Events::const_iterator _lastEvent ) {
+    using namespace std::chrono_literals;
+
+    if (!m_handshake->isValid()) {
+        return std::nullopt;
+    }
+    const auto packetCounter = nextPacketNumber();
+
+    auto sendEvents = isProtocolV2()
+            ? PacketCoderV2::PacketFactory().createSendEvents(packetCounter, getHandshakeId(), _firstEvent, _lastEvent)
+            : PacketCoderV1::PacketFactory().createSendEvents(packetCounter, getHandshakeId(), _firstEvent, _lastEvent);
+
+    if (!sendEvents.has_value()) {
+        return std::nullopt;
+    }
+
+    m_serverResponses->expectResponseForClientMessage(packetCounter);
+    ScopedAction scopedAction(
+            [this, packetCounter] { m_serverResponses->stopExpectingResponseForClientMessage(packetCounter); });
+
+    auto sendResult = m_handshake->connection().send(sendEvents.value());
+    m_handshake->connection().flush();
+
+    if (!sendResult.has_value() || sendResult.value() != sendEvents.value().size()) {
+        return std::nullopt;
+    }
+
+    // Wait 1 second
+    for (auto iteration = 0; iteration < 1000; ++iteration) {
+        tryToGetServerMessages();
+        auto serverResponse = m_serverResponses->moveReceivedMessages(packetCounter);
+        assert(serverResponse.has_value());
+
+        for (auto &response : serverResponse.value()) {
+            if (auto packet = response.get<PacketCoderV1::Server::SendEventsAck>()) {
+                return ntohs(packet->nboNumberOfSavedEvents);
+            }
+            if (auto packet = response.get<PacketCoderV2::Server::SendEventsAck>()) {
+                return ntohl(packet->nboNumberOfSavedEvents);
+            }
+        }
+
+        std::this_thread::sleep_for(1ms);
+    }
+
+    return std::nullopt;
+}
+
 void
 ApplicationProtocolV1::connectEventsCallback() {
     assert(m_handshake);
@@ -126,25 +264,33 @@ ApplicationProtocolV1::tryToGetServerMessages() {
     std::lock_guard lock(m_receiveDataMutex);
     //for ( ;; ){
         if ( !m_handshake->isValid() ) {
+            // responses will never arrive, futures of asynchronous requests are resolved now
+            m_serverResponses->cancelAllResponses();
             return;
         }
 
-        auto message = m_handshake->connection().receive();
+        // transport receives bytes straight into the stream, incomplete packet stays there until rest of it is received
+        auto& connection = m_handshake->connection();
+        auto numberOfReceived = m_receivedStream.pushBytesFrom( [&connection]( auto& _buffer ){ return connection.receiveInto( _buffer ); } );
 
-        if ( !message.has_value() ) {
+        if ( !numberOfReceived.has_value() ) {
             return;
         }
 
-        if ( message.value().size() == 0 ) {
+        if ( numberOfReceived.value() == 0 ) {
             return;
         }
 
-        PacketCoderV1::BytesStream stream;
-        stream.pushBytes( message.value() );
-
-        for ( auto packet = stream.getPacket(); packet.has_value(); packet = stream.getPacket() ) {
+        for ( auto packet = m_receivedStream.getPacket(); packet.has_value(); packet = m_receivedStream.getPacket() ) {
             try {
-                PacketCoderV1::DecodedPacket decodedPacket(packet.value());
+                if ( PacketCoderV2::isPacketV2( packet.value() ) ) {
+                    // server sends only responses in version 2
+                    m_serverResponses->saveMessage( PacketCoderV2::DecodedPacketView( packet.value() ) );
+                    continue;
+                }
+
+                // decoded in place, only responses waited for are copied by container
+                PacketCoderV1::DecodedPacketView decodedPacket(packet.value());
 
                 if (!m_serverResponses->saveMessage(decodedPacket)) {
                     fireNewEventCallback(decodedPacket);
@@ -169,7 +315,6 @@ std::optional<IProtocolExecutor::Events>
 ApplicationProtocolV1::getSavedEvents(uint64_t _firstEvent, uint64_t _lastEvent)  {
     assert(m_handshake);
     using namespace std::chrono_literals;
-    using namespace std::chrono;
 
     disconnectEventsCallback();
     ScopedAction scopedCallbackAction( [this]{ connectEventsCallback(); tryToGetServerMessages(); } );
@@ -178,23 +323,21 @@ ApplicationProtocolV1::getSavedEvents(uint64_t _firstEvent, uint64_t _lastEvent)
     if (!m_handshake->isValid()) {
         return std::nullopt;
     }
-    auto packetCounter = 0;
-    {
-        std::lock_guard guard(m_packetCounterMutex);
-        packetCounter = ++m_packetCounter;
-    }
+    const auto packetCounter = nextPacketNumber();
 
     PacketCoderV1::HandshakeId handshakeId =
             PacketCoderV1::byteVectorToHandshakeId( m_handshake->identifier() ).value();
 
     PacketCoderV1::PacketFactory packetFactory;
-    auto payload = packetFactory.createSavedEventsRequest(packetCounter, handshakeId, _firstEvent, _lastEvent);
+    // events are sent back packed, as many as fit into one packet
+    auto payload = packetFactory.createSavedEventsPackedRequest(packetCounter, handshakeId, _firstEvent, _lastEvent);
 
     m_serverResponses->expectResponseForClientMessage(packetCounter);
     ScopedAction scopedAction(
             [this, packetCounter] { m_serverResponses->stopExpectingResponseForClientMessage(packetCounter); });
 
     auto sendResult = m_handshake->connection().send(payload);
+    m_handshake->connection().flush();
 
     if (!sendResult.has_value()) {
         return std::nullopt;;
@@ -212,26 +355,18 @@ ApplicationProtocolV1::getSavedEvents(uint64_t _firstEvent, uint64_t _lastEvent)
         assert(serverResponse.has_value());
 
         for (auto &response : serverResponse.value()) {
-            if (std::holds_alternative<const PacketCoderV1::Server::SavedEventsResponse*>(response.decodedPacket())) {
-                auto packet = std::get<const PacketCoderV1::Server::SavedEventsResponse*>(response.decodedPacket());
-
-                time_point<system_clock> timeStamp( milliseconds( ntohll( packet->nboMillisecondsFromEpoch ) ) );
-                std::string text(reinterpret_cast<const char*>(packet->text), ntohs(packet->nboLengthOfText));
-                EventData eventData{
-                      timeStamp
-                    , text
-                    , ntohl( packet->nboPriority )
-                };
-
-                events.push_back(eventData);
+            auto isLastPacket = appendSavedEvents( response, events );
 
-                if ( packet->isLastEvent ) {
-                    return std::move(events);
-                }
+            if ( !isLastPacket.has_value() ) {
+                continue;
+            }
 
-                // little tricky, start to wait again 1s for next packet
-                iteration = 0;
+            if ( isLastPacket.value() ) {
+                return std::move(events);
             }
+
+            // little tricky, start to wait again 1s for next packet
+            iteration = 0;
         }
 
         std::this_thread::sleep_for(1ms);
@@ -251,11 +386,7 @@ ApplicationProtocolV1::getNumberOfSavedEvents() {
     if (!m_handshake->isValid()) {
         return std::nullopt;
     }
-    auto packetCounter = 0;
-    {
-        std::lock_guard guard(m_packetCounterMutex);
-        packetCounter = ++m_packetCounter;
-    }
+    const auto packetCounter = nextPacketNumber();
 
     PacketCoderV1::HandshakeId handshakeId = PacketCoderV1::byteVectorToHandshakeId( m_handshake->identifier() ).value();
 
@@ -267,6 +398,7 @@ ApplicationProtocolV1::getNumberOfSavedEvents() {
             [this, packetCounter] { m_serverResponses->stopExpectingResponseForClientMessage(packetCounter); });
 
     auto sendResult = m_handshake->connection().send(payload);
+    m_handshake->connection().flush();
 
     if (!sendResult.has_value()) {
         return std::nullopt;
@@ -283,10 +415,7 @@ ApplicationProtocolV1::getNumberOfSavedEvents() {
         assert(serverResponse.has_value());
 
         for (auto &response : serverResponse.value()) {
-            if (std::holds_alternative<const PacketCoderV1::Server::NumberOfSavedEventsResponse*>(response.decodedPacket())) {
-                auto packet = std::get<const PacketCoderV1::Server::NumberOfSavedEventsResponse *>(
-                        response.decodedPacket());
-
+            if (auto packet = response.get<PacketCoderV1::Server::NumberOfSavedEventsResponse>()) {
                 return ntohll(packet->nboNumberOfSavedEvents);
             }
         }
@@ -296,8 +425,135 @@ ApplicationProtocolV1::getNumberOfSavedEvents() {
     return std::nullopt;
 }
 
+std::future<bool>
+ApplicationProtocolV1::sendEventAsync( const std::string& _eventText, uint32_t _priority ) {
+    auto result = std::make_shared<std::promise<bool>>();
+    auto future = result->get_future();
+
+    const auto packetCounter = nextPacketNumber();
+    auto sendEvent = createSendEvent( packetCounter, _eventText, _priority );
+
+    if ( !sendEvent.has_value() ) {
+        result->set_value( false );
+        return future;
+    }
+
+    sendRequest( packetCounter, sendEvent.value(), [result]( const ServerMessageView* _response ) {
+        if ( !_response ) {
+            result->set_value( false );
+            return true;
+        }
+
+        if ( _response->get<PacketCoderV1::Server::Nack>() ) {
+            result->set_value( false );
+            return true;
+        }
+
+        if ( !_response->get<PacketCoderV1::Server::Ack>() ) {
+            return false;
+        }
+
+        result->set_value( true );
+        return true;
+    });
+
+    return future;
+}
+
+std::future<std::optional<IProtocolExecutor::Events>>
+ApplicationProtocolV1::getSavedEventsAsync( uint64_t _firstEvent, uint64_t _lastEvent ) {
+    auto result = std::make_shared<std::promise<std::optional<Events>>>();
+    auto future = result->get_future();
+
+    const auto packetCounter = nextPacketNumber();
+    auto request = PacketCoderV1::PacketFactory().createSavedEventsPackedRequest( packetCounter, getHandshakeId(), _firstEvent, _lastEvent );
+
+    // events are collected until the last packet of response arrives
+    auto events = std::make_shared<Events>();
+    sendRequest( packetCounter, request, [result, events]( const ServerMessageView* _response ) {
+        if ( !_response ) {
+            result->set_value( std::nullopt );
+            return true;
+        }
+
+        auto isLastPacket = appendSavedEvents( *_response, *events );
+        if ( !isLastPacket.value_or( false ) ) {
+            return false;
+        }
+
+        result->set_value( std::move( *events ) );
+        return true;
+    });
+
+    return future;
+}
+
+std::future<std::optional<uint64_t>>
+ApplicationProtocolV1::getNumberOfSavedEventsAsync() {
+    auto result = std::make_shared<std::promise<std::optional<uint64_t>>>();
+    auto future = result->get_future();
+
+    const auto packetCounter = nextPacketNumber();
+    auto request = PacketCoderV1::PacketFactory().createNumberOfEventsRequest( packetCounter, getHandshakeId() );
+
+    sendRequest( packetCounter, request, [result]( const ServerMessageView* _response ) {
+        if ( !_response ) {
+            result->set_value( std::nullopt );
+            return true;
+        }
+
+        auto packet = _response->get<PacketCoderV1::Server::NumberOfSavedEventsResponse>();
+        if ( !packet ) {
+            return false;
+        }
+
+        result->set_value( ntohll( packet->nboNumberOfSavedEvents ) );
+        return true;
+    });
+
+    return future;
+}
+
+void
+ApplicationProtocolV1::sendRequest( uint32_t _packetNumber, const std::vector<std::byte>& _request, ServerMessagesContainer::ResponseHandler _handler ) {
+    assert(m_handshake);
+
+    // handler is registered before sending, because response may be received before send returns
+    m_serverResponses->expectResponseForClientMessage( _packetNumber, std::move( _handler ), ASYNC_RESPONSE_TIMEOUT );
+
+    if ( !m_handshake->isValid() ) {
+        m_serverResponses->cancelResponse( _packetNumber );
+        return;
+    }
+
+    auto sendResult = m_handshake->connection().send( _request );
+    m_handshake->connection().flush();
+
+    if ( !sendResult.has_value() || sendResult.value() != _request.size() ) {
+        m_serverResponses->cancelResponse( _packetNumber );
+    }
+}
+
+std::optional<std::vector<std::byte>>
+ApplicationProtocolV1::createSendEvent( uint32_t _packetNumber, const std::string& _eventText, uint32_t _priority ) const {
+    auto sendEvent = PacketCoderV1::PacketFactory().createSendEvent(_packetNumber, getHandshakeId(), _eventText, _priority);
+
+    if (!sendEvent.has_value() && isProtocolV2()) {
+        // text does not fit into packet of version 1
+        sendEvent = PacketCoderV2::PacketFactory().createSendEvent(_packetNumber, getHandshakeId(), _eventText, _priority);
+    }
+
+    return sendEvent;
+}
+
+uint32_t
+ApplicationProtocolV1::nextPacketNumber() {
+    std::lock_guard guard(m_packetCounterMutex);
+    return ++m_packetCounter;
+}
+
 void
-ApplicationProtocolV1::fireNewEventCallback(Challenge::PacketCoderV1::DecodedPacket _packet) {
+ApplicationProtocolV1::fireNewEventCallback(const Challenge::PacketCoderV1::DecodedPacketView& _packet) {
     if (!std::holds_alternative<const Challenge::PacketCoderV1::Server::NewEventsNotification*>( _packet.decodedPacket() ) ) {
         return;
     }
@@ -312,7 +568,9 @@ ApplicationProtocolV1::fireNewEventCallback(Challenge::PacketCoderV1::DecodedPac
         return;
     }
 
-    m_registeredNewEventCallback( ntohll(packet->nboNumberOfEvents) );
+    // packet points into received stream, so it is not touched after user code runs
+    auto numberOfEvents = ntohll(packet->nboNumberOfEvents);
+    m_registeredNewEventCallback( numberOfEvents );
 }
 
 PacketCoderV1::HandshakeId
@@ -321,5 +579,11 @@ ApplicationProtocolV1::getHandshakeId() const {
     return PacketCoderV1::byteVectorToHandshakeId( m_handshake->identifier() ).value();
 }
 
+bool
+ApplicationProtocolV1::isProtocolV2() const {
+    assert(m_handshake);
+    return m_handshake->protocolVersion() >= PacketCoderV2::VERSION_2;
+}
+
 
 } // namespace Challenge::Communication::Client
@@ -3,6 +3,8 @@
 #include "Communication/Client/IProtocolExecutor.h"
 #include "ServerMessagesContainer.h"
 
+#include "Lib/PacketCoderV1/BytesStream.h"
+
 #include <mutex>
 
 namespace Challenge::Communication::Client {
@@ -15,24 +17,46 @@ namespace Challenge::Communication::Client {
          * @throw std::runtime_error in case of error
          */
         ApplicationProtocolV1( std::shared_ptr<IHandshake> _handshake );
-        ~ApplicationProtocolV1() override = default;
+        //! Resolves futures of requests which still wait for responses
+        ~ApplicationProtocolV1() override;
 
         bool sendEvent(const std::string& _eventText, uint32_t _priority ) override;
 
+        //! Sends events in packets as big as possible, next packet is sent when previous one is confirmed
+        /*!
+         *  When version 2 was negotiated packets are not limited to 65535 bytes
+         */
+        std::optional<std::size_t> sendEvents( const Events& _events ) override;
+
         bool registerNewEventAddedCallback(NewEventAddedCallback _callback) override;
 
         std::optional<IProtocolExecutor::Events> getSavedEvents(uint64_t _firstEvent, uint64_t _lastEvent) override;
 
         std::optional<uint64_t> getNumberOfSavedEvents() override;
 
+        std::future<bool> sendEventAsync( const std::string& _eventText, uint32_t _priority ) override;
+        std::future<std::optional<Events>> getSavedEventsAsync( uint64_t _firstEvent, uint64_t _lastEvent ) override;
+        std::future<std::optional<uint64_t>> getNumberOfSavedEventsAsync() override;
+
     private:
+        //! Sends one packet with events, return number of saved events
+        std::optional<std::size_t> sendEventsPacket( Events::const_iterator _firstEvent, Events::const_iterator _lastEvent );
+
+        //! Sends request, responses are passed to handler when they are received
+        void sendRequest( uint32_t _packetNumber, const std::vector<std::byte>& _request, ServerMessagesContainer::ResponseHandler _handler );
+        //! Creates SendEvent of version 1, or version 2 when text does not fit into version 1
+        std::optional<std::vector<std::byte>> createSendEvent( uint32_t _packetNumber, const std::string& _eventText, uint32_t _priority ) const;
+        uint32_t nextPacketNumber();
+
         void connectEventsCallback();
         void disconnectEventsCallback();
         void onSpontaneusEventArrived();
         void tryToGetServerMessages();
-        void fireNewEventCallback(Challenge::PacketCoderV1::DecodedPacket _packet);
+        void fireNewEventCallback(const Challenge::PacketCoderV1::DecodedPacketView& _packet);
 
         PacketCoderV1::HandshakeId getHandshakeId() const;
+        //! Returns true when version 2 was negotiated, so events may be sent in packets of version 2
+        bool isProtocolV2() const;
 
     private:
         std::shared_ptr<IHandshake> m_handshake;
@@ -44,6 +68,8 @@ namespace Challenge::Communication::Client {
 
         NewEventAddedCallback m_registeredNewEventCallback;
         std::recursive_mutex m_receiveDataMutex;
+        //! Received bytes of connection, guarded by m_receiveDataMutex
+        PacketCoderV1::BytesStream m_receivedStream;
     };
 
 } // namespace Challenge::Communication::Client
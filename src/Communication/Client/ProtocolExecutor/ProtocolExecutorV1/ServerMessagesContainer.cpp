@@ -2,10 +2,37 @@
 
 #include "Lib/Uint64/BytsOrderUint64.h"
 
+#include <algorithm>
 #include <cassert>
+#include <optional>
 
 namespace Challenge::Communication::Client {
 
+namespace {
+    ServerMessage toServerMessage( const PacketCoderV1::DecodedPacketView& _message ) {
+        return ServerMessage( PacketCoderV1::DecodedPacket( _message ) );
+    }
+
+    ServerMessage toServerMessage( const PacketCoderV2::DecodedPacketView& _message ) {
+        return ServerMessage( PacketCoderV2::DecodedPacket( _message ) );
+    }
+} // namespace
+
+ServerMessagesContainer::ServerMessagesContainer( PacketCoderV1::HandshakeId _handshakeId ) : m_handshakeId(_handshakeId) {
+    m_deadlinesWatcher = std::thread( [this]{ watchDeadlines(); } );
+}
+
+ServerMessagesContainer::~ServerMessagesContainer() {
+    {
+        std::lock_guard lock(m_messagesMutex);
+        m_isStopped = true;
+    }
+    m_deadlinesCondition.notify_one();
+    m_deadlinesWatcher.join();
+
+    cancelAllResponses();
+}
+
 void ServerMessagesContainer::expectResponseForClientMessage(
         ServerMessagesContainer::ClientRequestMessageId _clientMessageId) {
     std::lock_guard lock(m_messagesMutex);
@@ -13,6 +40,84 @@ void ServerMessagesContainer::expectResponseForClientMessage(
     m_serverMessages[ _clientMessageId ] = ServerMessages();
 }
 
+void ServerMessagesContainer::expectResponseForClientMessage(
+        ServerMessagesContainer::ClientRequestMessageId _clientMessageId, ResponseHandler _handler, std::chrono::milliseconds _timeout) {
+    assert( _handler );
+    {
+        std::lock_guard lock(m_messagesMutex);
+        m_responseHandlers[ _clientMessageId ] = PendingResponse{ std::move( _handler ), _timeout, std::chrono::steady_clock::now() + _timeout };
+    }
+    m_deadlinesCondition.notify_one();
+}
+
+void ServerMessagesContainer::cancelResponse(
+        ServerMessagesContainer::ClientRequestMessageId _clientMessageId) {
+    ResponseHandler handler;
+    {
+        std::lock_guard lock(m_messagesMutex);
+        auto foundHandler = m_responseHandlers.find( _clientMessageId );
+
+        if ( foundHandler == m_responseHandlers.end() ) {
+            return;
+        }
+
+        handler = std::move( foundHandler->second.handler );
+        m_responseHandlers.erase( foundHandler );
+    }
+
+    handler( nullptr );
+}
+
+void ServerMessagesContainer::cancelAllResponses() {
+    std::unordered_map< ClientRequestMessageId, PendingResponse > handlers;
+    {
+        std::lock_guard lock(m_messagesMutex);
+        handlers.swap( m_responseHandlers );
+    }
+
+    for ( auto& handler : handlers ) {
+        handler.second.handler( nullptr );
+    }
+}
+
+void ServerMessagesContainer::watchDeadlines() {
+    std::vector<ResponseHandler> expiredHandlers;
+
+    std::unique_lock lock(m_messagesMutex);
+    while ( !m_isStopped ) {
+        const auto now = std::chrono::steady_clock::now();
+        std::optional<std::chrono::steady_clock::time_point> nextDeadline;
+
+        for ( auto handler = m_responseHandlers.begin(); handler != m_responseHandlers.end(); ) {
+            if ( handler->second.deadline <= now ) {
+                expiredHandlers.push_back( std::move( handler->second.handler ) );
+                handler = m_responseHandlers.erase( handler );
+                continue;
+            }
+            nextDeadline = std::min( nextDeadline.value_or( handler->second.deadline ), handler->second.deadline );
+            ++handler;
+        }
+
+        if ( !expiredHandlers.empty() ) {
+            // handlers are called without lock, as by cancelResponse
+            lock.unlock();
+            for ( auto& handler : expiredHandlers ) {
+                handler( nullptr );
+            }
+            expiredHandlers.clear();
+            lock.lock();
+            continue;
+        }
+
+        // new handler or stop wakes watcher up before the deadline
+        if ( nextDeadline.has_value() ) {
+            m_deadlinesCondition.wait_until( lock, nextDeadline.value() );
+        } else {
+            m_deadlinesCondition.wait( lock );
+        }
+    }
+}
+
 void ServerMessagesContainer::stopExpectingResponseForClientMessage(
         ServerMessagesContainer::ClientRequestMessageId _clientMessageId) {
     std::lock_guard lock(m_messagesMutex);
@@ -32,7 +137,7 @@ ServerMessagesContainer::moveReceivedMessages(ServerMessagesContainer::ClientReq
     return std::optional<ServerMessages>( std::move( (*fountId).second ) );
 }
 
-bool ServerMessagesContainer::saveMessage(const PacketCoderV1::DecodedPacket &_message) {
+bool ServerMessagesContainer::saveMessage(const PacketCoderV1::DecodedPacketView &_message) {
 
     auto eventTypeDispatcher = [this, &_message](auto&& _packetType) {
         using EventType = std::decay_t<decltype(_packetType)>;
@@ -43,6 +148,21 @@ bool ServerMessagesContainer::saveMessage(const PacketCoderV1::DecodedPacket &_m
                 return false;
             }
             return saveMessage( ntohl(_packetType->serverResponsePacketHeader.nboClientPacketNumber), _message );
+        } else if constexpr (std::is_same_v<EventType, const PacketCoderV1::Server::SavedEventsPackedResponse* >) {
+            if ( ntohl(_packetType->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId) != m_handshakeId ) {
+                return false;
+            }
+            return saveMessage( ntohl(_packetType->serverResponsePacketHeader.nboClientPacketNumber), _message );
+        } else if constexpr (std::is_same_v<EventType, const PacketCoderV1::Server::SendEventsAck* >) {
+            if ( ntohl(_packetType->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId) != m_handshakeId ) {
+                return false;
+            }
+            return saveMessage( ntohl(_packetType->serverResponsePacketHeader.nboClientPacketNumber), _message );
+        } else if constexpr (std::is_same_v<EventType, const PacketCoderV1::Server::Nack* >) {
+            if ( ntohl(_packetType->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId) != m_handshakeId ) {
+                return false;
+            }
+            return saveMessage( ntohl(_packetType->serverResponsePacketHeader.nboClientPacketNumber), _message );
         } else if constexpr (std::is_same_v<EventType, const PacketCoderV1::Server::Ack* >) {
             if ( ntohl(_packetType->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId) != m_handshakeId ) {
                 return false;
@@ -63,17 +183,54 @@ bool ServerMessagesContainer::saveMessage(const PacketCoderV1::DecodedPacket &_m
     return std::visit( eventTypeDispatcher, _message.decodedPacket() );
 }
 
+bool ServerMessagesContainer::saveMessage(const PacketCoderV2::DecodedPacketView &_message) {
+
+    auto eventTypeDispatcher = [this, &_message](auto&& _packetType) {
+        using EventType = std::decay_t<decltype(_packetType)>;
+
+        if constexpr (std::is_same_v<EventType, const PacketCoderV2::Server::SavedEventsPackedResponse* >) {
+            if ( ntohl(_packetType->serverResponsePacketHeader.serverV2PacketHeader.nboHandshakeId) != m_handshakeId ) {
+                return false;
+            }
+            return saveMessage( ntohl(_packetType->serverResponsePacketHeader.nboClientPacketNumber), _message );
+        } else if constexpr (std::is_same_v<EventType, const PacketCoderV2::Server::SendEventsAck* >) {
+            if ( ntohl(_packetType->serverResponsePacketHeader.serverV2PacketHeader.nboHandshakeId) != m_handshakeId ) {
+                return false;
+            }
+            return saveMessage( ntohl(_packetType->serverResponsePacketHeader.nboClientPacketNumber), _message );
+        }
+
+        return false;
+    };
+
+    return std::visit( eventTypeDispatcher, _message.decodedPacket() );
+}
+
+template<typename _DecodedPacketView>
 bool ServerMessagesContainer::saveMessage(ServerMessagesContainer::ClientRequestMessageId _clientMessageId,
-                                          const PacketCoderV1::DecodedPacket &_message) {
+                                          const _DecodedPacketView &_message) {
     std::lock_guard lock( m_messagesMutex );
 
+    auto foundHandler = m_responseHandlers.find( _clientMessageId );
+    if ( foundHandler != m_responseHandlers.end() ) {
+        // response of asynchronous request is handled in place, without copy
+        const ServerMessageView message( _message );
+        if ( foundHandler->second.handler( &message ) ) {
+            m_responseHandlers.erase( foundHandler );
+        } else {
+            // response of many packets is cancelled only when next packet does not arrive in time
+            foundHandler->second.deadline = std::chrono::steady_clock::now() + foundHandler->second.timeout;
+        }
+        return true;
+    }
+
     auto fountId = m_serverMessages.find( _clientMessageId );
 
     if ( fountId == m_serverMessages.end() ) {
         return false;
     }
 
-    fountId->second.push_back( _message );
+    fountId->second.push_back( toServerMessage( _message ) );
     return true;
 }
 } // namespace Challenge::Communication::Client
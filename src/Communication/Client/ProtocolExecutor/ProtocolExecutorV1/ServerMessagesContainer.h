@@ -1,47 +1,145 @@
 #pragma once
 
 #include "Lib/PacketCoderV1/PacketDecoder.h"
+#include "Lib/PacketCoderV2/PacketDecoder.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <mutex>
+#include <variant>
 #include <vector>
 
 namespace Challenge::Communication::Client {
 
+    //! Server response of any version of protocol
+    /*!
+     * @tparam _DecodedPackets decoded packets of all versions of protocol
+     */
+    template<typename... _DecodedPackets>
+    class BasicServerMessage {
+    public:
+        template<typename _DecodedPacket, typename = std::enable_if_t< !std::is_same_v< std::decay_t<_DecodedPacket>, BasicServerMessage > > >
+        explicit BasicServerMessage( _DecodedPacket&& _packet ) : m_packet( std::forward<_DecodedPacket>( _packet ) ) {}
+
+        //! Returns packet of given type, or nullptr when message is other packet
+        template<typename _PacketType>
+        const _PacketType* get() const;
+
+    private:
+        template<typename _Type, typename _Variant>
+        struct IsAlternative;
+
+        template<typename _Type, typename... _Alternatives>
+        struct IsAlternative< _Type, std::variant<_Alternatives...> > : std::disjunction< std::is_same<_Type, _Alternatives>... > {};
+
+    private:
+        std::variant< _DecodedPackets... > m_packet;
+    };
+
+    template<typename... _DecodedPackets>
+    template<typename _PacketType>
+    inline const _PacketType* BasicServerMessage<_DecodedPackets...>::get() const {
+        return std::visit( []( const auto& _decodedPacket ) -> const _PacketType* {
+            using PacketVariant = typename std::decay_t<decltype(_decodedPacket)>::PacketVariant;
+
+            if constexpr ( IsAlternative<const _PacketType*, PacketVariant>::value ) {
+                auto packet = std::get_if<const _PacketType*>( &_decodedPacket.decodedPacket() );
+                return packet ? *packet : nullptr;
+            } else {
+                return nullptr;
+            }
+        }, m_packet );
+    }
+
+    //! Server response which owns bytes of the packet
+    using ServerMessage = BasicServerMessage< PacketCoderV1::DecodedPacket, PacketCoderV2::DecodedPacket >;
+
+    //! Server response over received bytes, it is valid only until next bytes are received
+    using ServerMessageView = BasicServerMessage< PacketCoderV1::DecodedPacketView, PacketCoderV2::DecodedPacketView >;
+
     //! Class is responsible to collect server responses for client requests
+    /*!
+     *  Handlers of asynchronous requests have deadline, it is watched by own thread of container, so request is
+     *  cancelled also when server never responds and no data is received anymore.
+     */
     class ServerMessagesContainer {
     public:
-        using ServerMessage = Challenge::PacketCoderV1::DecodedPacket;
         using ServerMessages = std::vector<ServerMessage>;
         using ClientRequestMessageId = Challenge::PacketCoderV1::PacketSequenceNumber;
 
-        ServerMessagesContainer( PacketCoderV1::HandshakeId _handshakeId ) : m_handshakeId(_handshakeId){}
-        ~ServerMessagesContainer() = default;
+        //! Handler of responses for asynchronous request
+        /*!
+         *  Handler is called under lock of container, so it must not call the container
+         * @param _message response, nullptr when request is cancelled or its deadline expired
+         * @return true when request is completed and handler is not needed anymore
+         */
+        using ResponseHandler = std::function<bool( const ServerMessageView* _message )>;
+
+        ServerMessagesContainer( PacketCoderV1::HandshakeId _handshakeId );
+        //! Cancels all pending asynchronous requests
+        ~ServerMessagesContainer();
+
+        ServerMessagesContainer( const ServerMessagesContainer& ) = delete;
+        ServerMessagesContainer& operator=( const ServerMessagesContainer& ) = delete;
 
         //! register for server response for given client message id
         void expectResponseForClientMessage( ClientRequestMessageId _clientMessageId );
 
+        //! register handler of server responses for given client message id, responses are not collected
+        /*!
+         * @param _timeout time in which the next response has to arrive, otherwise request is cancelled
+         */
+        void expectResponseForClientMessage( ClientRequestMessageId _clientMessageId, ResponseHandler _handler, std::chrono::milliseconds _timeout );
+
         //! unregister for server response for given client message id
         void stopExpectingResponseForClientMessage( ClientRequestMessageId _clientMessageId );
 
+        //! removes handler for given client message id and calls it with nullptr
+        void cancelResponse( ClientRequestMessageId _clientMessageId );
+
+        //! removes all handlers and calls them with nullptr
+        void cancelAllResponses();
+
         //! return and remove all received messages for given client id
         std::optional< ServerMessages > moveReceivedMessages( ClientRequestMessageId _clientMessageId );
 
         //! save server response
         /*!
-         *
+         *  Message is copied only when it is expected, so unexpected messages are never allocated
          * @param _message message to save
          * @return true when message was saved, othrwise false
          */
-        bool saveMessage( const PacketCoderV1::DecodedPacket& _message );
+        bool saveMessage( const PacketCoderV1::DecodedPacketView& _message );
+        bool saveMessage( const PacketCoderV2::DecodedPacketView& _message );
 
     private:
-        bool saveMessage( ClientRequestMessageId _clientMessageId, const PacketCoderV1::DecodedPacket& _message );
+        //! Handler of asynchronous request waiting for response
+        struct PendingResponse {
+            ResponseHandler handler;
+            std::chrono::milliseconds timeout;
+            //! Deadline is moved by every response which does not complete request
+            std::chrono::steady_clock::time_point deadline;
+        };
+
+        template<typename _DecodedPacketView>
+        bool saveMessage( ClientRequestMessageId _clientMessageId, const _DecodedPacketView& _message );
+        //! Body of thread which cancels requests with expired deadline
+        void watchDeadlines();
 
     private:
         const PacketCoderV1::HandshakeId m_handshakeId;
         std::mutex m_messagesMutex;
         std::unordered_map< ClientRequestMessageId, ServerMessages > m_serverMessages;
+        std::unordered_map< ClientRequestMessageId, PendingResponse > m_responseHandlers;
+
+        bool m_isStopped = false;
+        //! Watcher of deadlines waits for the earliest deadline or for new handler
+        std::condition_variable m_deadlinesCondition;
+        std::thread m_deadlinesWatcher;
     };
 
 } // namespace Challenge::Communication::Client
@@ -0,0 +1,56 @@
+#include "LocalConnection.h"
+
+#include "Lib/Log/Logger.h"
+
+namespace Challenge::Communication::Client {
+
+template<>
+std::shared_ptr<ITransportConnection> ITransportConnection::create<QLocalSocket*>(QLocalSocket* _socket) try {
+    return std::make_shared<LocalConnection>( _socket );
+} catch ( std::runtime_error& _exception ) {
+    LOG_ERROR(_exception.what());
+    return nullptr;
+}
+
+template std::shared_ptr<ITransportConnection> ITransportConnection::create<QLocalSocket*>(QLocalSocket*);
+
+LocalConnection::LocalConnection(QLocalSocket* _socket) :
+    m_qtConnectionHelper( _socket ) {
+}
+
+bool
+LocalConnection::isValid() const {
+    return m_qtConnectionHelper.isValid();
+}
+
+bool
+LocalConnection::registerConnectionExpiredCallback(ConnectionExpiredCallback _callback) {
+    return m_qtConnectionHelper.registerConnectionExpiredCallback(_callback);
+}
+
+bool
+LocalConnection::registerNewDataReadyToReadCallback(NewDataReadyToReadCallback _callback) {
+    return m_qtConnectionHelper.registerNewDataReadyToReadCallback(_callback);
+}
+
+std::optional<ITransportConnection::Payload>
+LocalConnection::receive() {
+    return m_qtConnectionHelper.receive();
+}
+
+std::optional<std::size_t>
+LocalConnection::receiveInto( ITransportConnection::Payload& _buffer ) {
+    return m_qtConnectionHelper.receiveInto( _buffer );
+}
+
+std::optional<uint32_t>
+LocalConnection::send( const ITransportConnection::Payload& _payload ) {
+    return m_qtConnectionHelper.send(_payload);
+}
+
+bool
+LocalConnection::flush() {
+    return m_qtConnectionHelper.flush();
+}
+
+} // namespace Challenge::Communication::Client
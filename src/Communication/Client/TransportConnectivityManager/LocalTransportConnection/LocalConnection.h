@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Communication/Client/TransportConnectivityManager/ITransportConnection.h"
+#include "Lib/QtTcpConnectionHelper/QtTcpConnectionHelper.h"
+
+#include <QLocalSocket>
+#include <QPointer>
+
+#include <memory>
+
+namespace Challenge {
+namespace Communication {
+namespace Client {
+
+            //! Connection on local ( Unix domain ) socket
+            class LocalConnection : public ITransportConnection {
+            public:
+                LocalConnection(QLocalSocket* _socket);
+                ~LocalConnection() override = default;
+
+                bool isValid() const override;
+                bool registerConnectionExpiredCallback(ConnectionExpiredCallback _callback) override;
+                bool registerNewDataReadyToReadCallback(NewDataReadyToReadCallback _callback) override;
+                std::optional<Payload> receive() override;
+                std::optional<std::size_t> receiveInto( Payload& _buffer ) override;
+                std::optional<uint32_t> send( const Payload& _payload ) override;
+                bool flush() override;
+
+            private:
+                QtTcpConnectionHelper m_qtConnectionHelper;
+            };
+
+} // namespace Client
+} // namespace Communication
+} // namespace Challenge
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "LocalConnectivityManager.h"
+
+#include "Communication/Client/TransportConnectivityManager/ITransportConnection.h"
+
+#include "Lib/Log/Logger.h"
+
+#include <QCoreApplication>
+#include <QLocalSocket>
+
+namespace Challenge::Communication::Client {
+
+template<>
+std::shared_ptr<ITransportConnectivityManager>
+ITransportConnectivityManager::create<LocalSocketEngine>( LocalSocketEngine _engine ) {
+    return std::unique_ptr<ITransportConnectivityManager>(new LocalConnectivityManager( std::move( _engine.path ) ));
+}
+
+template std::shared_ptr<ITransportConnectivityManager> ITransportConnectivityManager::create( LocalSocketEngine );
+
+LocalConnectivityManager::LocalConnectivityManager( std::string _path ) : m_path( std::move( _path ) ) {
+}
+
+std::shared_ptr<ITransportConnection>
+LocalConnectivityManager::connectToServer() const {
+
+    auto localSocket = new QLocalSocket(QCoreApplication::instance());
+    localSocket->connectToServer( QString::fromStdString( m_path ) );
+    bool isConnected = localSocket->waitForConnected( 3000 );
+
+    if ( !isConnected ) {
+        localSocket->deleteLater();
+        return nullptr;
+    }
+
+    return ITransportConnection::create(localSocket);
+}
+
+}// Challenge::Communication::Client
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Communication/Client/TransportConnectivityManager/ITransportConnectivityManager.h"
+
+#include <string>
+
+namespace Challenge {
+namespace Communication {
+namespace Client {
+
+    //! Connects to server running on the same host over local ( Unix domain ) socket
+    class LocalConnectivityManager : public ITransportConnectivityManager {
+        public:
+            explicit LocalConnectivityManager( std::string _path );
+            ~LocalConnectivityManager() override = default;
+
+            virtual std::shared_ptr<ITransportConnection> connectToServer() const override;
+
+        private:
+            const std::string m_path;
+    };
+
+} // Client
+} // Communication
+} // Challenge
@@ -0,0 +1,43 @@
+#include "SharedMemoryConnection.h"
+
+namespace Challenge::Communication::Client {
+
+SharedMemoryConnection::SharedMemoryConnection( int _socket ) : m_channel( _socket, SharedMemoryChannel::Side::Client ) {
+}
+
+bool
+SharedMemoryConnection::isValid() const {
+    return m_channel.isValid();
+}
+
+bool
+SharedMemoryConnection::registerConnectionExpiredCallback(ConnectionExpiredCallback _callback) {
+    return m_channel.registerConnectionExpiredCallback(_callback);
+}
+
+bool
+SharedMemoryConnection::registerNewDataReadyToReadCallback(NewDataReadyToReadCallback _callback) {
+    return m_channel.registerNewDataReadyToReadCallback(_callback);
+}
+
+std::optional<ITransportConnection::Payload>
+SharedMemoryConnection::receive() {
+    return m_channel.receive();
+}
+
+std::optional<std::size_t>
+SharedMemoryConnection::receiveInto( ITransportConnection::Payload& _buffer ) {
+    return m_channel.receiveInto( _buffer );
+}
+
+std::optional<uint32_t>
+SharedMemoryConnection::send( const ITransportConnection::Payload& _payload ) {
+    return m_channel.send(_payload);
+}
+
+bool
+SharedMemoryConnection::flush() {
+    return m_channel.flush();
+}
+
+} // namespace Challenge::Communication::Client
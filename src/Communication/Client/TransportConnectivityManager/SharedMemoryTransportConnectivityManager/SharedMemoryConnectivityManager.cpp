@@ -0,0 +1,55 @@
+#include "SharedMemoryConnectivityManager.h"
+#include "SharedMemoryConnection.h"
+
+#include "Lib/Log/Logger.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace Challenge::Communication::Client {
+
+template<>
+std::shared_ptr<ITransportConnectivityManager>
+ITransportConnectivityManager::create<SharedMemoryEngine>( SharedMemoryEngine _engine ) {
+    return std::unique_ptr<ITransportConnectivityManager>(new SharedMemoryConnectivityManager( std::move( _engine.path ) ));
+}
+
+template std::shared_ptr<ITransportConnectivityManager> ITransportConnectivityManager::create( SharedMemoryEngine );
+
+SharedMemoryConnectivityManager::SharedMemoryConnectivityManager( std::string _path ) : m_path( std::move( _path ) ) {
+}
+
+std::shared_ptr<ITransportConnection>
+SharedMemoryConnectivityManager::connectToServer() const try {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if ( m_path.empty() || m_path.size() >= sizeof( address.sun_path ) ) {
+        throw std::runtime_error( "Invalid path of local socket" );
+    }
+    std::strncpy( address.sun_path, m_path.c_str(), sizeof( address.sun_path ) - 1 );
+
+    auto socket = ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    if ( socket == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    if ( ::connect( socket, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) == -1 ) {
+        auto error = errno;
+        ::close( socket );
+        throw std::runtime_error( std::strerror( error ) );
+    }
+
+    // connection owns the socket, it is closed also when shared memory is not received
+    return std::make_shared<SharedMemoryConnection>( socket );
+
+} catch ( std::runtime_error& _exception ) {
+    LOG_ERROR( _exception.what() );
+    return nullptr;
+}
+
+}// Challenge::Communication::Client
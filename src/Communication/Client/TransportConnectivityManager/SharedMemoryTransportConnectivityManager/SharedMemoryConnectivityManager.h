@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Communication/Client/TransportConnectivityManager/ITransportConnectivityManager.h"
+
+#include <string>
+
+namespace Challenge {
+namespace Communication {
+namespace Client {
+
+    //! Connects to server running on the same host, data are exchanged over rings in shared memory
+    class SharedMemoryConnectivityManager : public ITransportConnectivityManager {
+        public:
+            //! Constructor
+            /*!
+             *
+             * @param _path path of local socket on which server passes shared memory
+             */
+            explicit SharedMemoryConnectivityManager( std::string _path );
+            ~SharedMemoryConnectivityManager() override = default;
+
+            virtual std::shared_ptr<ITransportConnection> connectToServer() const override;
+
+        private:
+            const std::string m_path;
+    };
+
+} // Client
+} // Communication
+} // Challenge
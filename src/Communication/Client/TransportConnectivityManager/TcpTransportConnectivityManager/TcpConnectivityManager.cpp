@@ -13,11 +13,14 @@
 
 namespace Challenge::Communication::Client {
 
+template<>
 std::shared_ptr<ITransportConnectivityManager>
-ITransportConnectivityManager::create() {
+ITransportConnectivityManager::create<>() {
     return std::unique_ptr<ITransportConnectivityManager>(new TcpConnectivityManager());
 }
 
+template std::shared_ptr<ITransportConnectivityManager> ITransportConnectivityManager::create();
+
 
 std::shared_ptr<ITransportConnection>
 TcpConnectivityManager::connectToServer() const {
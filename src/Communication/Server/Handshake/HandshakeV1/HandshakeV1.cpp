@@ -5,8 +5,12 @@
 #include "Lib/PacketCoderV1/PacketDecoder.h"
 #include "Lib/PacketCoderV1/PacketFactory.h"
 #include "Lib/PacketCoderV1/BytesStream.h"
+#include "Lib/PacketCoderV2/Packets.h"
 #include "Lib/Log/Logger.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <stdexcept>
 
 namespace Challenge::Communication::Server {
@@ -22,7 +26,32 @@ std::shared_ptr<IHandshake> IHandshake::start( std::shared_ptr<ITransportConnect
 
 template std::shared_ptr<IHandshake> IHandshake::start( std::shared_ptr<ITransportConnection>);
 
+template<>
+std::shared_ptr<IHandshake> IHandshake::start( std::shared_ptr<ITransportConnection> _connection, PacketCoderV1::BytesStream* _stream ) try {
+    assert( _stream );
+    return std::shared_ptr<IHandshake>(new HandshakeV1(_connection, *_stream) );
+} catch ( HandshakeV1::IncompleteInvite& ) {
+    // next part of invite will be received later
+    return nullptr;
+} catch ( std::runtime_error& _exception ) {
+    LOG_ERROR( _exception.what() );
+    return nullptr;
+}
+
+template std::shared_ptr<IHandshake> IHandshake::start( std::shared_ptr<ITransportConnection>, PacketCoderV1::BytesStream* );
+
 HandshakeV1::HandshakeV1( std::shared_ptr<ITransportConnection> _connection ) : m_identifier( sizeof( HandshakeIdType ) ) {
+    // invite has to be received at once
+    PacketCoderV1::BytesStream stream;
+    execute( std::move( _connection ), stream );
+}
+
+HandshakeV1::HandshakeV1( std::shared_ptr<ITransportConnection> _connection, PacketCoderV1::BytesStream& _stream ) : m_identifier( sizeof( HandshakeIdType ) ) {
+    execute( std::move( _connection ), _stream );
+}
+
+void
+HandshakeV1::execute( std::shared_ptr<ITransportConnection> _connection, PacketCoderV1::BytesStream& _stream ) {
     m_connection = _connection;
 
     if ( !m_connection ) {
@@ -38,15 +67,14 @@ HandshakeV1::HandshakeV1( std::shared_ptr<ITransportConnection> _connection ) :
         throw std::runtime_error("no data to receive");
     }
 
-    Challenge::PacketCoderV1::BytesStream stream;
-    stream.pushBytes( std::move(received).value() );
+    _stream.pushBytes( received.value() );
 
-    auto rawPacket = stream.getPacket();
+    auto rawPacket = _stream.getPacket();
     if ( !rawPacket.has_value() ) {
-        throw std::runtime_error( "Unexpected packet" );
+        throw IncompleteInvite();
     }
 
-    PacketCoderV1::DecodedPacket decodedPacket(rawPacket.value());
+    PacketCoderV1::DecodedPacketView decodedPacket(rawPacket.value());
     auto decodedPacketVariant = decodedPacket.decodedPacket();
 
     if ( !std::holds_alternative<const PacketCoderV1::Client::HandshakeInvite*>(decodedPacketVariant) ) {
@@ -55,13 +83,24 @@ HandshakeV1::HandshakeV1( std::shared_ptr<ITransportConnection> _connection ) :
 
     auto handshakeInvite = std::get<const PacketCoderV1::Client::HandshakeInvite*>(decodedPacketVariant);
 
-    static HandshakeIdType handshakeId = 0;
-    handshakeId++;
+    // handshakes are made concurrently by server workers
+    static std::atomic<HandshakeIdType> lastHandshakeId{ 0 };
+    const HandshakeIdType handshakeId = ++lastHandshakeId;
 
     m_identifier = PacketCoderV1::handshakeIdToByteVector(handshakeId);
 
     PacketCoderV1::PacketFactory packetFactory;
-    auto handshakeResponse = packetFactory.createAck( ntohl(handshakeInvite->packetHeader.nboClientPacketNumber), handshakeId );
+    const auto clientPacketNumber = ntohl(handshakeInvite->packetHeader.nboClientPacketNumber);
+    PacketCoderV1::PacketFactory::PacketBytes handshakeResponse;
+
+    if ( rawPacket->size() >= sizeof(PacketCoderV1::Client::HandshakeInviteWithVersion) ) {
+        // client proposes the highest version known by it, the highest version known by both sides is chosen
+        auto inviteWithVersion = reinterpret_cast<const PacketCoderV1::Client::HandshakeInviteWithVersion*>( rawPacket->data() );
+        m_protocolVersion = std::clamp( ntohs(inviteWithVersion->nboMaxProtocolVersion), uint16_t{1}, PacketCoderV2::VERSION_2 );
+        handshakeResponse = packetFactory.createAck( clientPacketNumber, handshakeId, m_protocolVersion );
+    } else {
+        handshakeResponse = packetFactory.createAck( clientPacketNumber, handshakeId );
+    }
 
     auto result = m_connection->send( handshakeResponse );
 
@@ -73,6 +112,9 @@ HandshakeV1::HandshakeV1( std::shared_ptr<ITransportConnection> _connection ) :
         throw std::runtime_error( "Cannot sent whole handshake response" );
      }
 
+    // client waits for the response, it cannot wait for next iteration of event loop
+    m_connection->flush();
+
     LOG_INFORMATION( "Handshake completed" );
 }
 
@@ -86,6 +128,11 @@ HandshakeV1::connection() const {
     return *m_connection;
 }
 
+uint16_t
+HandshakeV1::protocolVersion() const {
+    return m_protocolVersion;
+}
+
 bool
 HandshakeV1::isValid() const {
     assert(m_connection);
@@ -2,6 +2,9 @@
 
 #include "Communication/Server/IHandshake.h"
 
+#include <stdexcept>
+
+#include "Lib/PacketCoderV1/BytesStream.h"
 #include "Lib/PacketCoderV1/Packets.h"
 
 namespace Challenge::Communication::Server {
@@ -19,14 +22,35 @@ namespace Challenge::Communication::Server {
              */
             HandshakeV1( std::shared_ptr<ITransportConnection> _connection );
 
+            //! Constructor
+            /*!
+             *  Excecutes handshake algorithm, received bytes are appended to stream kept for the connection, so invite
+             *  received in more parts is completed by the next attempt
+             *
+             * @param _connection transport connection
+             * @param _stream bytes of connection received by previous attempts
+             * @throw std::runtime_error in case of handshake fial, IncompleteInvite when invite is not received whole yet
+             */
+            HandshakeV1( std::shared_ptr<ITransportConnection> _connection, PacketCoderV1::BytesStream& _stream );
+
+            //! Thrown when stream does not contain whole invite yet
+            struct IncompleteInvite : std::runtime_error {
+                IncompleteInvite() : std::runtime_error( "Incomplete handshake invite" ) {}
+            };
+
             const Identifier& identifier() const override;
             ITransportConnection& connection() const override;
+            uint16_t protocolVersion() const override;
 
             bool isValid() const override;
 
+        private:
+            void execute( std::shared_ptr<ITransportConnection> _connection, PacketCoderV1::BytesStream& _stream ); // may throw std::runtime_error
+
         private:
             Identifier m_identifier;
             std::shared_ptr<ITransportConnection> m_connection;
+            uint16_t m_protocolVersion = 1;
     };
 } // namespace Challenge::Communication::Server
 
@@ -5,19 +5,30 @@
 
 #include "Event/EventData.h"
 
+#include "Lib/C++Tools/ScopedAction.h"
+#include "Lib/EncodedEventsCache/EncodedEventsCache.h"
 #include "Lib/Log/Logger.h"
 #include "Lib/PacketCoderV1/PacketDecoder.h"
 #include "Lib/PacketCoderV1/PacketFactory.h"
 #include "Lib/PacketCoderV1/BytesStream.h"
+#include "Lib/PacketCoderV2/PacketDecoder.h"
+#include "Lib/PacketCoderV2/PacketFactory.h"
 #include "Lib/Uint64/BytsOrderUint64.h"
 
 #include "EventsStorage/IEventsStorage.h"
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
 namespace Challenge::Communication::Server {
 
+    //! Maximal number of events read from storage at once, when saved events are sent to client
+    constexpr std::size_t SAVED_EVENTS_CHUNK_SIZE = 256;
+
+    //! Maximal length of SavedEventsPackedResponse of version 2, it limits memory used by one response
+    constexpr std::size_t SAVED_EVENTS_PACKED_RESPONSE_V2_MAX_LENGTH = 1024 * 1024;
+
     template<>
     std::shared_ptr<IProtocolExecutor> IProtocolExecutor::create( std::shared_ptr<IHandshake> _handshake, std::shared_ptr<Challenge::EventsStorage::IEventsStorage> _storage) try {
         return std::shared_ptr<IProtocolExecutor>( new ProtocolExecutorV1(_handshake, _storage) );
@@ -28,11 +39,40 @@ namespace Challenge::Communication::Server {
 
     template std::shared_ptr<IProtocolExecutor> IProtocolExecutor::create( std::shared_ptr<IHandshake>, std::shared_ptr<Challenge::EventsStorage::IEventsStorage>);
 
+    template<>
+    std::shared_ptr<IProtocolExecutor> IProtocolExecutor::create( std::shared_ptr<IHandshake> _handshake, std::shared_ptr<Challenge::EventsStorage::IEventsStorage> _storage
+                                                                , ProtocolExecutorV1::CompletionExecutor _completionExecutor ) try {
+        return std::shared_ptr<IProtocolExecutor>( new ProtocolExecutorV1(_handshake, _storage, std::move(_completionExecutor)) );
+    } catch ( std::runtime_error _exception ) {
+        LOG_ERROR( _exception.what() );
+        return nullptr;
+    }
+
+    template std::shared_ptr<IProtocolExecutor> IProtocolExecutor::create( std::shared_ptr<IHandshake>, std::shared_ptr<Challenge::EventsStorage::IEventsStorage>
+                                                                         , ProtocolExecutorV1::CompletionExecutor );
+
+    template<>
+    std::shared_ptr<IProtocolExecutor> IProtocolExecutor::create( std::shared_ptr<IHandshake> _handshake, std::shared_ptr<Challenge::EventsStorage::IEventsStorage> _storage
+                                                                , ProtocolExecutorV1::CompletionExecutor _completionExecutor
+                                                                , std::shared_ptr<EncodedEventsCache> _encodedEventsCache ) try {
+        return std::shared_ptr<IProtocolExecutor>( new ProtocolExecutorV1(_handshake, _storage, std::move(_completionExecutor), std::move(_encodedEventsCache)) );
+    } catch ( std::runtime_error _exception ) {
+        LOG_ERROR( _exception.what() );
+        return nullptr;
+    }
+
+    template std::shared_ptr<IProtocolExecutor> IProtocolExecutor::create( std::shared_ptr<IHandshake>, std::shared_ptr<Challenge::EventsStorage::IEventsStorage>
+                                                                         , ProtocolExecutorV1::CompletionExecutor, std::shared_ptr<EncodedEventsCache> );
+
 ProtocolExecutorV1::ProtocolExecutorV1(
           std::shared_ptr<IHandshake> _handshake
-        , std::shared_ptr<EventsStorage::IEventsStorage> _storage ) {
+        , std::shared_ptr<EventsStorage::IEventsStorage> _storage
+        , CompletionExecutor _completionExecutor
+        , std::shared_ptr<EncodedEventsCache> _encodedEventsCache ) {
     m_handshake = std::move(_handshake);
     m_storage = std::move(_storage);
+    m_completionExecutor = std::move(_completionExecutor);
+    m_encodedEventsCache = std::move(_encodedEventsCache);
 
     if (!m_handshake) {
         throw std::runtime_error("Connection is nullptr");
@@ -49,9 +89,6 @@ ProtocolExecutorV1::ProtocolExecutorV1(
 
     auto newDataCallback = [this]{ onNewDataReceived(); };
     m_handshake->connection().registerNewDataReadyToReadCallback(newDataCallback);
-
-    auto newSavedEventCallback =[this]{onNewEventSaved();};
-    m_storage->registerEventAddedCallback(newSavedEventCallback, this);
 }
 
 ProtocolExecutorV1::~ProtocolExecutorV1() {
@@ -59,7 +96,6 @@ ProtocolExecutorV1::~ProtocolExecutorV1() {
     assert(m_storage);
 
     m_handshake->connection().registerNewDataReadyToReadCallback(nullptr);
-    m_storage->registerEventAddedCallback(nullptr, this);
 }
 
 void
@@ -70,25 +106,36 @@ ProtocolExecutorV1::onNewDataReceived() {
         return;
     }
 
-    while ( auto receivedPayload = m_handshake->connection().receive() ) {
-        if ( receivedPayload.value().size() == 0 ) {
+    // responses to all received packets are coalesced by transport, they are written at once when all are handled
+    ScopedAction flushResponses( [this]{ m_handshake->connection().flush(); } );
+
+    auto& connection = m_handshake->connection();
+    // transport receives bytes straight into the stream, incomplete packet stays there until rest of it is received
+    while ( auto numberOfReceived = m_receivedStream.pushBytesFrom( [&connection]( auto& _buffer ){ return connection.receiveInto( _buffer ); } ) ) {
+        if ( numberOfReceived.value() == 0 ) {
             return;
         }
 
-        PacketCoderV1::BytesStream stream;
-        stream.pushBytes( receivedPayload.value() );
-
-        for ( auto packetFromStream = stream.getPacket(); packetFromStream.has_value(); packetFromStream = stream.getPacket() ) {
+        for ( auto packetFromStream = m_receivedStream.getPacket(); packetFromStream.has_value(); packetFromStream = m_receivedStream.getPacket() ) {
             try {
-                PacketCoderV1::DecodedPacket packet(std::move(packetFromStream).value());
+                if ( PacketCoderV2::isPacketV2( packetFromStream.value() ) ) {
+                    onPacketV2( packetFromStream.value() );
+                    continue;
+                }
+
+                PacketCoderV1::DecodedPacketView packet(packetFromStream.value());
 
                 auto eventTypeDispatcher = [this](auto &&_packetType) {
                     using EventType = std::decay_t<decltype(_packetType)>;
 
                     if constexpr (std::is_same_v<EventType, const PacketCoderV1::Client::SendEvent *>) {
                         onPacket(*_packetType);
+                    } else if constexpr (std::is_same_v<EventType, const PacketCoderV1::Client::SendEvents *>) {
+                        onPacket(*_packetType);
                     } else if constexpr (std::is_same_v<EventType, const PacketCoderV1::Client::SavedEventsRequest *>) {
                         onPacket(*_packetType);
+                    } else if constexpr (std::is_same_v<EventType, const PacketCoderV1::Client::SavedEventsPackedRequest *>) {
+                        onPacket(*_packetType);
                     } else if constexpr (std::is_same_v<EventType, const PacketCoderV1::Client::NumberOfSavedEventsRequest *>) {
                         onPacket(*_packetType);
                     } else {
@@ -103,6 +150,32 @@ ProtocolExecutorV1::onNewDataReceived() {
     }
 }
 
+void
+ProtocolExecutorV1::onPacketV2( BytesView _packet ) {
+    assert( m_handshake );
+
+    if ( m_handshake->protocolVersion() < PacketCoderV2::VERSION_2 ) {
+        // client did not negotiate version 2
+        return;
+    }
+
+    PacketCoderV2::DecodedPacketView packet( _packet );
+
+    auto eventTypeDispatcher = [this](auto &&_packetType) {
+        using EventType = std::decay_t<decltype(_packetType)>;
+
+        if constexpr (std::is_same_v<EventType, const PacketCoderV2::Client::SendEvent *>) {
+            onPacket(*_packetType);
+        } else if constexpr (std::is_same_v<EventType, const PacketCoderV2::Client::SendEvents *>) {
+            onPacket(*_packetType);
+        } else {
+            // ignore rest of packets from client
+        }
+    };
+
+    std::visit(eventTypeDispatcher, packet.decodedPacket());
+}
+
 void
 ProtocolExecutorV1::onPacket(const Challenge::PacketCoderV1::Client::SendEvent& _packet) {
     assert(m_handshake);
@@ -121,19 +194,51 @@ ProtocolExecutorV1::onPacket(const Challenge::PacketCoderV1::Client::SendEvent&
     auto textLength = ntohs( _packet.nboLengthOfText );
     std::string text(reinterpret_cast<const char*>(_packet.text), textLength );
     auto timeStamp = std::chrono::system_clock::now();
-    EventData eventData{timeStamp, text, ntohl(_packet.nboPriority) };
+    EventData eventData{timeStamp, std::move(text), ntohl(_packet.nboPriority) };
+
+    // save is completed when the transaction holding the event is committed, so ACK confirms durable event, event
+    // which was not saved ( e.g. it was rejected by full queue of storage writer ) is answered by NACK
+    const auto clientPacketNumber = ntohl(_packet.clientV1HeaderWithHandshake.clientV1PacketHeader.nboClientPacketNumber);
+    m_storage->saveEventAsync( std::move(eventData), createSaveCompletion( [clientPacketNumber, incomingPacketHandshakeId]( std::size_t _numberOfSavedEvents ){
+        Challenge::PacketCoderV1::PacketFactory packetFactory;
+        return _numberOfSavedEvents == 1 ? packetFactory.createAck( clientPacketNumber, incomingPacketHandshakeId )
+                                         : packetFactory.createNack( clientPacketNumber, incomingPacketHandshakeId );
+    }));
+}
+
+void
+ProtocolExecutorV1::onPacket(const Challenge::PacketCoderV1::Client::SendEvents& _packet) {
+    assert(m_handshake);
+    assert(m_storage);
 
-    if ( !m_storage->saveEvent( eventData ) ) {
+    if ( !m_handshake->isValid() ) {
         return;
     }
 
-    Challenge::PacketCoderV1::PacketFactory packetFactory;
-    auto ackPacket = packetFactory.createAck(
-            ntohl(_packet.clientV1HeaderWithHandshake.clientV1PacketHeader.nboClientPacketNumber)
-            , incomingPacketHandshakeId);
+    const auto incomingPacketHandshakeId = ntohl(_packet.clientV1HeaderWithHandshake.nboHandshakeId);
+
+    if ( PacketCoderV1::byteVectorToHandshakeId( m_handshake->identifier() ).value() != incomingPacketHandshakeId ) {
+        return;
+    }
 
-    // result of send is ignored on purpose
-    m_handshake->connection().send( ackPacket );
+    // all events of packet get the same time stamp, they are received at once
+    const auto timeStamp = std::chrono::system_clock::now();
+    EventsStorage::IEventsStorage::Events events;
+    events.reserve( ntohs(_packet.nboNumberOfEvents) );
+    PacketCoderV1::visitEntries( _packet, [&events, &timeStamp]( const PacketCoderV1::Client::SendEventsEntry& _entry ) {
+        events.push_back( EventData{
+                  timeStamp
+                , std::string( reinterpret_cast<const char*>(_entry.text), ntohs(_entry.nboLengthOfText) )
+                , ntohl(_entry.nboPriority)
+        } );
+    });
+
+    // unlike ACK of single event, response is sent also when not all events were saved
+    const auto clientPacketNumber = ntohl(_packet.clientV1HeaderWithHandshake.clientV1PacketHeader.nboClientPacketNumber);
+    m_storage->saveEventsAsync( std::move(events), createSaveCompletion( [clientPacketNumber, incomingPacketHandshakeId]( std::size_t _numberOfSavedEvents ){
+        Challenge::PacketCoderV1::PacketFactory packetFactory;
+        return packetFactory.createSendEventsAck( clientPacketNumber, incomingPacketHandshakeId, static_cast<uint16_t>( _numberOfSavedEvents ) );
+    }));
 }
 
 void
@@ -141,8 +246,6 @@ ProtocolExecutorV1::onPacket(const Challenge::PacketCoderV1::Client::SavedEvents
     assert(m_handshake);
     assert(m_storage);
 
-    using namespace std::chrono;
-
     if ( !m_handshake->isValid() ) {
         return;
     }
@@ -153,34 +256,117 @@ ProtocolExecutorV1::onPacket(const Challenge::PacketCoderV1::Client::SavedEvents
         return;
     }
 
-    auto savedEvents = m_storage->getSavedEvents( ntohll( _packet.nboFirstEvent ), ntohll( _packet.nboLastEvent ) );
+    const auto clientPacketNumber = ntohl(_packet.clientV1HeaderWithHandshake.clientV1PacketHeader.nboClientPacketNumber);
+
+    Challenge::PacketCoderV2::PacketFactory packetFactory;
+    auto sendEvents = [this, clientPacketNumber, incomingPacketHandshakeId, &packetFactory]( const EncodedEntries& _entries, bool _isLastChunk ) {
+        for ( std::size_t entryIndex = 0; entryIndex < _entries.size(); ++entryIndex ) {
+            // only header of response is created, encoded event is copied
+            auto response = packetFactory.createSavedEventsResponseV1(
+                      clientPacketNumber
+                    , incomingPacketHandshakeId
+                    , _isLastChunk && entryIndex + 1 == _entries.size()
+                    , *_entries[entryIndex]
+                    );
+            if ( !response.has_value() ) {
+                return false;
+            }
+            auto result = m_handshake->connection().send( response.value() );
+
+            if ( !result.has_value() || result.value() != response.value().size() ) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // responses are sent as events are read from storage
+    visitEncodedEvents( ntohll( _packet.nboFirstEvent ), ntohll( _packet.nboLastEvent ), sendEvents );
+}
+
+void
+ProtocolExecutorV1::onPacket(const Challenge::PacketCoderV1::Client::SavedEventsPackedRequest& _packet ) {
+    assert(m_handshake);
+    assert(m_storage);
 
-    if ( !savedEvents.has_value() ) {
+    using PacketCoderV2::PacketFactory;
+
+    if ( !m_handshake->isValid() ) {
         return;
     }
 
-    Challenge::PacketCoderV1::PacketFactory packetFactory;
-    auto eventNumber = 1;
-    for ( auto& event : savedEvents.value() ) {
-        auto response = packetFactory.createSavedEventsResponse(
-                  ntohl(_packet.clientV1HeaderWithHandshake.clientV1PacketHeader.nboClientPacketNumber)
-                , ntohl(_packet.clientV1HeaderWithHandshake.nboHandshakeId)
-                , eventNumber == savedEvents->size()
-                , duration_cast<milliseconds>( event.timeStamp.time_since_epoch() ).count()
-                , event.priority
-                , event.text
-                );
+    const auto incomingPacketHandshakeId = ntohl(_packet.clientV1HeaderWithHandshake.nboHandshakeId);
+
+    if ( PacketCoderV1::byteVectorToHandshakeId( m_handshake->identifier() ).value() != incomingPacketHandshakeId ) {
+        return;
+    }
+
+    const auto clientPacketNumber = ntohl(_packet.clientV1HeaderWithHandshake.clientV1PacketHeader.nboClientPacketNumber);
+    // with version 2 packets are not limited to 65535 bytes, so events are sent in less packets
+    const auto isVersion2 = m_handshake->protocolVersion() >= PacketCoderV2::VERSION_2;
+
+    // texts of version 1 are truncated, so at least one event always fits, event longer than usual packet of version 2
+    // is sent alone in packet up to MAX_PACKET_LENGTH
+    auto countEventsFittingPacket = [isVersion2]( EncodedEntries::const_iterator _firstEntry, EncodedEntries::const_iterator _lastEntry ) {
+        if ( !isVersion2 ) {
+            return PacketFactory::countEntriesFittingSavedEventsPackedResponseV1( _firstEntry, _lastEntry );
+        }
+
+        const auto numberOfEvents = PacketFactory::countEntriesFittingSavedEventsPackedResponse( _firstEntry, _lastEntry, SAVED_EVENTS_PACKED_RESPONSE_V2_MAX_LENGTH );
+        return numberOfEvents > 0
+               ? numberOfEvents
+               : PacketFactory::countEntriesFittingSavedEventsPackedResponse( _firstEntry, _lastEntry, ApplicationProtocol::MAX_PACKET_LENGTH );
+    };
+
+    // encoded events are copied into packet, only headers are created
+    auto sendPacket = [this, isVersion2, clientPacketNumber, incomingPacketHandshakeId]( bool _isLast, EncodedEntries::const_iterator _firstEntry, EncodedEntries::const_iterator _lastEntry ) {
+        auto response = isVersion2
+                ? PacketFactory().createSavedEventsPackedResponse( clientPacketNumber, incomingPacketHandshakeId, _isLast, _firstEntry, _lastEntry )
+                : PacketFactory().createSavedEventsPackedResponseV1( clientPacketNumber, incomingPacketHandshakeId, _isLast, _firstEntry, _lastEntry );
         if ( !response.has_value() ) {
-            return;
+            return false;
         }
-        auto result = m_handshake->connection().send( response.value() );
 
-        if ( !result.has_value() || result.value() != response.value().size() ) {
-            return;
+        auto result = m_handshake->connection().send( response.value() );
+        return result.has_value() && result.value() == response.value().size();
+    };
+
+    // events which do not fill whole packet wait for next chunk, so only the last packet is not full
+    EncodedEntries pendingEvents;
+    auto sendEvents = [&pendingEvents, &countEventsFittingPacket, &sendPacket]( const EncodedEntries& _entries, bool _isLastChunk ) {
+        pendingEvents.insert( pendingEvents.end(), _entries.begin(), _entries.end() );
+
+        auto firstEvent = pendingEvents.cbegin();
+        for (;;) {
+            const auto numberOfEventsInPacket = countEventsFittingPacket( firstEvent, pendingEvents.cend() );
+            const auto isRestOfEvents = numberOfEventsInPacket == static_cast<std::size_t>( std::distance( firstEvent, pendingEvents.cend() ) );
+
+            if ( isRestOfEvents && !_isLastChunk ) {
+                break;
+            }
+
+            if ( numberOfEventsInPacket == 0 && !isRestOfEvents ) {
+                // event is too long to be sent, client still gets the last packet, so it does not wait for the rest
+                sendPacket( true, firstEvent, firstEvent );
+                return false;
+            }
+
+            if ( !sendPacket( isRestOfEvents, firstEvent, firstEvent + numberOfEventsInPacket ) ) {
+                return false;
+            }
+
+            firstEvent += numberOfEventsInPacket;
+            if ( isRestOfEvents ) {
+                break;
+            }
         }
-        ++eventNumber;
-    }
 
+        pendingEvents.erase( pendingEvents.cbegin(), firstEvent );
+        return true;
+    };
+
+    // last packet is sent also when range is empty, so client does not wait for events
+    visitEncodedEvents( ntohll( _packet.nboFirstEvent ), ntohll( _packet.nboLastEvent ), sendEvents );
 }
 
 void
@@ -214,25 +400,151 @@ ProtocolExecutorV1::onPacket(const Challenge::PacketCoderV1::Client::NumberOfSav
 }
 
 void
-ProtocolExecutorV1::onNewEventSaved() {
-    assert( m_storage );
-    assert( m_handshake );
+ProtocolExecutorV1::onPacket(const Challenge::PacketCoderV2::Client::SendEvent& _packet) {
+    assert(m_handshake);
+    assert(m_storage);
 
     if ( !m_handshake->isValid() ) {
         return;
     }
 
-    auto handshakeId = PacketCoderV1::byteVectorToHandshakeId( m_handshake->identifier() ).value();
+    const auto incomingPacketHandshakeId = ntohl(_packet.clientV2HeaderWithHandshake.nboHandshakeId);
 
-    auto numberOfEvents = m_storage->getNumberOfEvents();
-    if (!numberOfEvents.has_value() ) {
+    if ( PacketCoderV1::byteVectorToHandshakeId( m_handshake->identifier() ).value() != incomingPacketHandshakeId ) {
         return;
     }
 
-    Challenge::PacketCoderV1::PacketFactory packetFactory;
-    auto notification = packetFactory.createNewEventsNotification( handshakeId, numberOfEvents.value() );
+    std::string text(reinterpret_cast<const char*>(_packet.text), ntohl( _packet.nboLengthOfText ) );
+    EventData eventData{std::chrono::system_clock::now(), std::move(text), ntohl(_packet.nboPriority) };
+
+    // Ack and Nack have fixed size, so they are sent in version 1
+    const auto clientPacketNumber = ntohl(_packet.clientV2HeaderWithHandshake.clientV2PacketHeader.nboClientPacketNumber);
+    m_storage->saveEventAsync( std::move(eventData), createSaveCompletion( [clientPacketNumber, incomingPacketHandshakeId]( std::size_t _numberOfSavedEvents ){
+        Challenge::PacketCoderV1::PacketFactory packetFactory;
+        return _numberOfSavedEvents == 1 ? packetFactory.createAck( clientPacketNumber, incomingPacketHandshakeId )
+                                         : packetFactory.createNack( clientPacketNumber, incomingPacketHandshakeId );
+    }));
+}
+
+void
+ProtocolExecutorV1::onPacket(const Challenge::PacketCoderV2::Client::SendEvents& _packet) {
+    assert(m_handshake);
+    assert(m_storage);
+
+    if ( !m_handshake->isValid() ) {
+        return;
+    }
+
+    const auto incomingPacketHandshakeId = ntohl(_packet.clientV2HeaderWithHandshake.nboHandshakeId);
+
+    if ( PacketCoderV1::byteVectorToHandshakeId( m_handshake->identifier() ).value() != incomingPacketHandshakeId ) {
+        return;
+    }
+
+    const auto timeStamp = std::chrono::system_clock::now();
+    EventsStorage::IEventsStorage::Events events;
+    events.reserve( ntohl(_packet.nboNumberOfEvents) );
+    PacketCoderV2::visitEntries( _packet, [&events, &timeStamp]( const PacketCoderV2::Client::SendEventsEntry& _entry ) {
+        events.push_back( EventData{
+                  timeStamp
+                , std::string( reinterpret_cast<const char*>(_entry.text), ntohl(_entry.nboLengthOfText) )
+                , ntohl(_entry.nboPriority)
+        } );
+    });
+
+    const auto clientPacketNumber = ntohl(_packet.clientV2HeaderWithHandshake.clientV2PacketHeader.nboClientPacketNumber);
+    m_storage->saveEventsAsync( std::move(events), createSaveCompletion( [clientPacketNumber, incomingPacketHandshakeId]( std::size_t _numberOfSavedEvents ){
+        Challenge::PacketCoderV2::PacketFactory packetFactory;
+        return packetFactory.createSendEventsAck( clientPacketNumber, incomingPacketHandshakeId, static_cast<uint32_t>( _numberOfSavedEvents ) );
+    }));
+}
+
+std::function<void(std::size_t)>
+ProtocolExecutorV1::createSaveCompletion( std::function<Payload(std::size_t)> _createResponse ) const {
+    // executor may be gone when save is completed, handshake keeps the connection
+    auto handleCompletion = [handshake = std::weak_ptr<IHandshake>( m_handshake ), createResponse = std::move(_createResponse)]( std::size_t _numberOfSavedEvents ) {
+        auto handshakeOfExecutor = handshake.lock();
+        if ( !handshakeOfExecutor || !handshakeOfExecutor->isValid() ) {
+            return;
+        }
+
+        auto response = createResponse( _numberOfSavedEvents );
+        if ( !response.empty() ) {
+            // result of send is ignored on purpose, transport flushes response later when it coalesces sent data
+            handshakeOfExecutor->connection().send( response );
+        }
+    };
+
+    if ( !m_completionExecutor ) {
+        return handleCompletion;
+    }
+
+    return [executor = m_completionExecutor, handleCompletion = std::move(handleCompletion)]( std::size_t _numberOfSavedEvents ) {
+        executor( [handleCompletion, _numberOfSavedEvents]{ handleCompletion( _numberOfSavedEvents ); } );
+    };
+}
+
+void
+ProtocolExecutorV1::visitEncodedEvents( uint64_t _firstEvent, uint64_t _lastEvent, EncodedEntriesVisitor _visitor ) const {
+    assert(m_storage);
+    assert(_visitor);
+
+    if ( m_encodedEventsCache && _firstEvent <= _lastEvent ) {
+        // range up to LAST_EVENT_NUMBER is cached, when all saved events of it are cached
+        const auto numberOfEvents = m_storage->getNumberOfEvents();
+        if ( numberOfEvents && _firstEvent < numberOfEvents.value() ) {
+            auto entries = m_encodedEventsCache->get( _firstEvent, std::min( _lastEvent, numberOfEvents.value() - 1 ) );
+            if ( entries ) {
+                _visitor( entries.value(), true );
+                return;
+            }
+        }
+    }
+
+    EncodedEntries entries;
+    auto event = _firstEvent;
+    auto encodeEvents = [this, &entries, &event, &_visitor]( const EventsStorage::IEventsStorage::Events& _events, bool _isLastChunk ) {
+        entries.clear();
+        entries.reserve( _events.size() );
+        if ( m_encodedEventsCache ) {
+            for ( const auto& eventData : _events ) {
+                entries.push_back( std::make_shared<const PacketCoderV2::PacketFactory::PacketBytes>( PacketCoderV2::PacketFactory::createSavedEventsEntry( eventData ) ) );
+                // events are read in order, so number of event follows from the first one
+                m_encodedEventsCache->put( event, entries.back() );
+                ++event;
+            }
+        } else {
+            // entries are not kept beyond response, so all of them share the owner of chunk instead of allocating own one
+            auto chunk = std::make_shared<std::vector<PacketCoderV2::PacketFactory::PacketBytes>>();
+            chunk->reserve( _events.size() );
+            for ( const auto& eventData : _events ) {
+                chunk->push_back( PacketCoderV2::PacketFactory::createSavedEventsEntry( eventData ) );
+            }
+            for ( const auto& entry : *chunk ) {
+                entries.emplace_back( chunk, &entry );
+            }
+        }
+        return _visitor( entries, _isLastChunk );
+    };
+
+    m_storage->visitSavedEvents( _firstEvent, _lastEvent, SAVED_EVENTS_CHUNK_SIZE, encodeEvents );
+}
+
+void
+ProtocolExecutorV1::notifyNewEvents( const Payload& _notification ) {
+    assert( m_handshake );
+
+    if ( !m_handshake->isValid() ) {
+        return;
+    }
+
+    auto handshakeId = PacketCoderV1::byteVectorToHandshakeId( m_handshake->identifier() ).value();
+
+    // capacity of buffer is kept, so notification is copied without allocation
+    m_notification.assign( _notification.begin(), _notification.end() );
+    PacketCoderV1::PacketFactory::setServerPacketHandshakeId( m_notification, handshakeId );
 
-    m_handshake->connection().send(notification);
+    m_handshake->connection().send(m_notification);
 }
 
 bool
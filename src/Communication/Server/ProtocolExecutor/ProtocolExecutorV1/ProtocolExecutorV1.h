@@ -2,41 +2,101 @@
 
 #include "Communication/Server/IProtocolExecutor.h"
 
+#include "Lib/C++Tools/BytesView.h"
+#include "Lib/PacketCoderV1/BytesStream.h"
+#include "Lib/PacketCoderV2/PacketFactory.h"
+
+#include <functional>
 #include <memory>
 
 namespace Challenge::PacketCoderV1::Client {
     struct SendEvent;
+    struct SendEvents;
     struct SavedEventsRequest;
+    struct SavedEventsPackedRequest;
     struct NumberOfSavedEventsRequest;
 } // namespace Challenge::PacketCoderV1::Client
 
+namespace Challenge::PacketCoderV2::Client {
+    struct SendEvent;
+    struct SendEvents;
+} // namespace Challenge::PacketCoderV2::Client
+
 namespace Challenge::EventsStorage {
     class IEventsStorage;
 } // namespace Challenge::EventsStorage
 
+namespace Challenge {
+    class EncodedEventsCache;
+} // namespace Challenge
+
 namespace Challenge::Communication::Server {
 
     class IHandshake;
 
     class ProtocolExecutorV1 : public IProtocolExecutor  {
     public:
+        //! Runs task in thread of the executor, e.g. posts it to event loop
+        using CompletionExecutor = std::function<void(std::function<void()> _task)>;
+
         //! Constructor, may throw std::runtime_error
-        ProtocolExecutorV1(std::shared_ptr<IHandshake> _handshake, std::shared_ptr<EventsStorage::IEventsStorage> _storage);
+        /*!
+         *  Events are saved asynchronously and acknowledged when storage completes the save
+         * @param _completionExecutor passes completions of saves to thread of the executor, nullptr means that they
+         *  are handled on thread which fires them, it is enough only for storage which saves events synchronously
+         * @param _encodedEventsCache cache of encoded saved events shared by executors of server, nullptr means that
+         *  every read event is encoded for its response
+         */
+        ProtocolExecutorV1(std::shared_ptr<IHandshake> _handshake, std::shared_ptr<EventsStorage::IEventsStorage> _storage
+                          , CompletionExecutor _completionExecutor = nullptr
+                          , std::shared_ptr<EncodedEventsCache> _encodedEventsCache = nullptr);
         ~ProtocolExecutorV1();
 
         bool isValid() const override;
+        void notifyNewEvents( const Payload& _notification ) override;
 
     private:
         void onNewDataReceived();
-        void onNewEventSaved();
 
         void onPacket( const Challenge::PacketCoderV1::Client::SendEvent& _packet);
+        void onPacket( const Challenge::PacketCoderV1::Client::SendEvents& _packet);
         void onPacket( const Challenge::PacketCoderV1::Client::SavedEventsRequest& _packet );
+        void onPacket( const Challenge::PacketCoderV1::Client::SavedEventsPackedRequest& _packet );
         void onPacket( const Challenge::PacketCoderV1::Client::NumberOfSavedEventsRequest& _packet );
+        void onPacket( const Challenge::PacketCoderV2::Client::SendEvent& _packet);
+        void onPacket( const Challenge::PacketCoderV2::Client::SendEvents& _packet);
+
+        //! Dispatches packet of version 2, packets are ignored when version 2 was not negotiated
+        void onPacketV2( BytesView _packet );
+
+        //! Sends response when storage completes the save, response is not sent when connection is already gone
+        /*!
+         * @param _createResponse creates response from number of saved events, it returns empty payload when nothing
+         *  has to be sent
+         */
+        std::function<void(std::size_t)> createSaveCompletion( std::function<Payload(std::size_t)> _createResponse ) const;
+
+        using EncodedEntries = PacketCoderV2::PacketFactory::EncodedEntries;
+        using EncodedEntriesVisitor = std::function<bool(const EncodedEntries& _entries, bool _isLastChunk)>;
+
+        //! Visits saved events [_firstEvent, _lastEvent] encoded as PacketCoderV2::Server::SavedEventsEntry
+        /*!
+         *  Range which is whole in cache is visited at once without storage, otherwise events are read from storage,
+         *  encoded and put into cache. Visitor returns false when visit has to be stopped.
+         */
+        void visitEncodedEvents( uint64_t _firstEvent, uint64_t _lastEvent, EncodedEntriesVisitor _visitor ) const;
 
     private:
         std::shared_ptr<IHandshake> m_handshake;
         std::shared_ptr<Challenge::EventsStorage::IEventsStorage> m_storage;
+        CompletionExecutor m_completionExecutor;
+        std::shared_ptr<EncodedEventsCache> m_encodedEventsCache;
+
+        //! Received bytes of connection, it keeps incomplete packet between receives
+        PacketCoderV1::BytesStream m_receivedStream;
+
+        //! Buffer of last notification, it is reused for next notifications
+        Payload m_notification;
     };
 } // namespace Challenge::Communication::Server
 
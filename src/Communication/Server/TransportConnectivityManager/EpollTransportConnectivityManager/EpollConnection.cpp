@@ -0,0 +1,231 @@
+#include "EpollConnection.h"
+
+#include "Lib/Log/Logger.h"
+
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <stdexcept>
+
+namespace Challenge::Communication::Server {
+
+EpollConnection::EpollConnection( int _socket ) : m_socket( _socket ) {
+    if ( m_socket < 0 ) {
+        throw std::runtime_error( "Socket is not connected" );
+    }
+
+    LOG_INFORMATION( "New connection established" );
+}
+
+EpollConnection::~EpollConnection() {
+    // closing of the socket removes it from epoll as well
+    ::close( m_socket );
+}
+
+bool
+EpollConnection::isValid() const {
+    return m_isValid;
+}
+
+bool
+EpollConnection::registerConnectionExpiredCallback(ConnectionExpiredCallback _callback) {
+    std::lock_guard lock(m_callbacksMutex);
+
+    bool result = m_connectionExpiredCallback != nullptr;
+    m_connectionExpiredCallback = _callback;
+    return result;
+}
+
+bool
+EpollConnection::registerNewDataReadyToReadCallback(NewDataReadyToReadCallback _callback) {
+    std::lock_guard lock(m_callbacksMutex);
+
+    bool result = m_newDataReadyToReadCallback != nullptr;
+    m_newDataReadyToReadCallback = _callback;
+    return result;
+}
+
+std::optional<ITransportConnection::Payload>
+EpollConnection::receive() {
+    Payload payload;
+    if ( !receiveInto( payload ).has_value() ) {
+        return std::nullopt;
+    }
+
+    return payload;
+}
+
+std::optional<std::size_t>
+EpollConnection::receiveInto( Payload& _buffer ) {
+    std::lock_guard guard( m_receiveMutex );
+
+    const auto initialSize = _buffer.size();
+    m_isReceivePending = false;
+    while ( true ) {
+        // buffer grows only by bytes which are waiting in the socket, so it is not filled and shrunk back by chunks
+        int numberOfAvailable = 0;
+        if ( ::ioctl( m_socket, FIONREAD, &numberOfAvailable ) == -1 ) {
+            numberOfAvailable = 0;
+        }
+
+        const auto numberOfRead = _buffer.size() - initialSize;
+        if ( numberOfRead == MAX_RECEIVE_SIZE ) {
+            m_isReceivePending = numberOfAvailable > 0;
+            break;
+        }
+
+        // socket is drained, end of stream is reported by epoll as well
+        if ( numberOfAvailable == 0 && numberOfRead > 0 ) {
+            break;
+        }
+
+        // without waiting bytes recv reports only end of stream or error
+        const auto chunkSize = std::min<std::size_t>( std::max( numberOfAvailable, 1 ), MAX_RECEIVE_SIZE - numberOfRead );
+        const auto size = _buffer.size();
+        _buffer.resize( size + chunkSize );
+
+        auto result = ::recv( m_socket, _buffer.data() + size, chunkSize, 0 );
+        _buffer.resize( size + std::max<ssize_t>( result, 0 ) );
+
+        if ( result > 0 ) {
+            continue;
+        }
+
+        if ( result == -1 && errno == EINTR ) {
+            continue;
+        }
+
+        if ( result == 0 || ( errno != EAGAIN && errno != EWOULDBLOCK ) ) {
+            m_isValid = false;
+        }
+        break;
+    }
+
+    const auto numberOfReceived = _buffer.size() - initialSize;
+    if ( numberOfReceived == 0 && !isValid() ) {
+        return std::nullopt;
+    }
+
+    return numberOfReceived;
+}
+
+std::optional<uint32_t>
+EpollConnection::send( const Payload& _payload ) {
+    if ( _payload.size() > std::numeric_limits<uint32_t>::max() ) {
+        return std::nullopt;
+    }
+
+    if ( !isValid() ) {
+        return std::nullopt;
+    }
+
+    std::lock_guard guard( m_writeBufferMutex );
+
+    const auto pendingBytes = m_writeBuffer.size() - m_writeBufferOffset;
+    if ( pendingBytes + _payload.size() > MAX_WRITE_BUFFER_SIZE ) {
+        return std::nullopt;
+    }
+
+    std::size_t numberOfSent = 0;
+    // bytes can be written directly only when nothing waits in the buffer, otherwise order would be broken
+    while ( pendingBytes == 0 && numberOfSent < _payload.size() ) {
+        auto result = ::send( m_socket, _payload.data() + numberOfSent, _payload.size() - numberOfSent, MSG_NOSIGNAL );
+        if ( result >= 0 ) {
+            numberOfSent += result;
+        } else if ( errno == EINTR ) {
+            continue;
+        } else if ( errno == EAGAIN || errno == EWOULDBLOCK ) {
+            break;
+        } else {
+            // expiration is notified when epoll reports error of the socket
+            m_isValid = false;
+            return std::nullopt;
+        }
+    }
+
+    m_writeBuffer.insert( m_writeBuffer.end(), _payload.begin() + numberOfSent, _payload.end() );
+    return static_cast<uint32_t>( _payload.size() );
+}
+
+void
+EpollConnection::onEvents( uint32_t _events ) {
+    if ( _events & EPOLLOUT ) {
+        writeSocket();
+    }
+
+    std::lock_guard lock(m_callbacksMutex);
+    if ( _events & EPOLLIN ) {
+        // only receive made by the callback may leave bytes for the next dispatch
+        m_isReceivePending = false;
+
+        // callback may replace itself, so its copy is invoked
+        auto callback = m_newDataReadyToReadCallback;
+        if ( callback != nullptr ) {
+            callback();
+        }
+    }
+
+    // bytes received before peer closed connection can still be read
+    if ( _events & ( EPOLLRDHUP | EPOLLHUP | EPOLLERR ) ) {
+        m_isValid = false;
+    }
+
+    if ( !m_isValid && !m_isExpirationNotified ) {
+        LOG_INFORMATION( "Connection lost" );
+        m_isExpirationNotified = true;
+
+        auto callback = m_connectionExpiredCallback;
+        if ( callback != nullptr ) {
+            callback();
+        }
+    }
+}
+
+bool
+EpollConnection::isReceivePending() const {
+    return m_isReceivePending && m_isValid;
+}
+
+int
+EpollConnection::socket() const {
+    return m_socket;
+}
+
+void
+EpollConnection::writeSocket() {
+    std::lock_guard guard( m_writeBufferMutex );
+
+    while ( m_writeBufferOffset < m_writeBuffer.size() ) {
+        auto result = ::send( m_socket
+                , m_writeBuffer.data() + m_writeBufferOffset
+                , m_writeBuffer.size() - m_writeBufferOffset
+                , MSG_NOSIGNAL );
+
+        if ( result >= 0 ) {
+            m_writeBufferOffset += result;
+        } else if ( errno == EINTR ) {
+            continue;
+        } else {
+            if ( errno != EAGAIN && errno != EWOULDBLOCK ) {
+                m_isValid = false;
+            }
+            break;
+        }
+    }
+
+    if ( m_writeBufferOffset == m_writeBuffer.size() ) {
+        m_writeBuffer.clear();
+        m_writeBufferOffset = 0;
+    } else if ( m_writeBufferOffset >= WRITE_BUFFER_COMPACTION_SIZE ) {
+        // slow reader would otherwise keep all bytes sent to it since the buffer was drained last time
+        m_writeBuffer.erase( m_writeBuffer.begin(), m_writeBuffer.begin() + m_writeBufferOffset );
+        m_writeBufferOffset = 0;
+    }
+}
+
+} // namespace Challenge::Communication::Server
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Communication/Server/TransportConnectivityManager/ITransportConnection.h"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+namespace Challenge {
+namespace Communication {
+namespace Server {
+
+            //! Connection on non-blocking socket, events of the socket are delivered by EpollTransportConnectivityManager
+            /*!
+             *  Socket is registered in edge-triggered mode. Received bytes stay in the socket until they are read directly
+             *  into buffer of the receiver, the receiver reads the socket in callback of new data. One read takes at most
+             *  MAX_RECEIVE_SIZE bytes, so one fast client does not starve the others, the rest is read when manager
+             *  dispatches the connection again. Sent data which the socket cannot take at once are kept in the write
+             *  buffer and flushed when socket is writable again.
+             */
+            class EpollConnection : public ITransportConnection {
+            public:
+                //! Maximal number of bytes read from the socket by one receive
+                static constexpr std::size_t MAX_RECEIVE_SIZE = 1024 * 1024;
+                //! Sent bytes are dropped from the front of the write buffer when they exceed this size
+                static constexpr std::size_t WRITE_BUFFER_COMPACTION_SIZE = 1024 * 1024;
+                //! Maximal number of bytes waiting in the write buffer, send fails when it would be exceeded
+                static constexpr std::size_t MAX_WRITE_BUFFER_SIZE = 64 * 1024 * 1024;
+
+                //! Constructor
+                /*!
+                 *
+                 * @param _socket connected non-blocking socket, the connection takes ownership of it
+                 * @throw std::runtime_error if socket is invalid
+                 */
+                explicit EpollConnection( int _socket );
+                ~EpollConnection() override;
+
+                EpollConnection(const EpollConnection &) = delete;
+                EpollConnection(EpollConnection &&) = delete;
+                EpollConnection &operator=(EpollConnection &) = delete;
+                EpollConnection &operator=(EpollConnection &&) = delete;
+
+                bool isValid() const override;
+                bool registerConnectionExpiredCallback(ConnectionExpiredCallback _callback) override;
+                bool registerNewDataReadyToReadCallback(NewDataReadyToReadCallback _callback) override;
+                //! Returns received data, data received before peer closed connection are returned as well
+                std::optional<Payload> receive() override;
+                //! Reads socket directly into given buffer until it is drained or MAX_RECEIVE_SIZE bytes are read
+                std::optional<std::size_t> receiveInto( Payload& _buffer ) override;
+                //! Sends data or queues it in the write buffer, returns number of bytes accepted
+                std::optional<uint32_t> send( const Payload& _payload ) override;
+
+                //! Handles events reported by epoll for the socket
+                void onEvents( uint32_t _events );
+
+                //! Returns true when the last receive left bytes in the socket, epoll does not report them again
+                bool isReceivePending() const;
+
+                int socket() const;
+
+            private:
+                //! Writes pending bytes of the write buffer until the socket would block
+                void writeSocket();
+
+            private:
+                const int m_socket;
+                std::atomic<bool> m_isValid{ true };
+                bool m_isExpirationNotified = false;
+
+                std::mutex m_receiveMutex;
+                std::atomic<bool> m_isReceivePending{ false };
+
+                Payload m_writeBuffer;
+                //! Number of bytes at the beginning of the write buffer which are already sent
+                std::size_t m_writeBufferOffset = 0;
+                std::mutex m_writeBufferMutex;
+
+                ConnectionExpiredCallback m_connectionExpiredCallback;
+                NewDataReadyToReadCallback m_newDataReadyToReadCallback;
+                std::recursive_mutex m_callbacksMutex;
+            };
+
+} // namespace Server
+} // namespace Communication
+} // namespace Challenge
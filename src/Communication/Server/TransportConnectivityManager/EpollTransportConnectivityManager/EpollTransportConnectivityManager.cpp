@@ -0,0 +1,252 @@
+#include "EpollTransportConnectivityManager.h"
+#include "EpollConnection.h"
+
+#include "Configuration/Defines.h"
+#include "Lib/C++Tools/ScopedAction.h"
+#include "Lib/Log/Logger.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace Challenge::Communication::Server {
+
+template<>
+std::unique_ptr<ITransportConnectivityManager>
+ITransportConnectivityManager::create<EpollEngine>( EpollEngine _engine ) try {
+    return std::unique_ptr<ITransportConnectivityManager>(
+            new EpollTransportConnectivityManager( SERVER_IP, SERVER_PORT, _engine.isPortShared ) );
+} catch ( std::runtime_error& _exception ) {
+    LOG_ERROR( _exception.what() );
+    return nullptr;
+}
+
+template std::unique_ptr<ITransportConnectivityManager> ITransportConnectivityManager::create<EpollEngine>( EpollEngine );
+
+namespace {
+    constexpr uint64_t LISTENING_SOCKET_ID = 0;
+    //! Number of connection entries which are kept before entries of destroyed connections are dropped
+    constexpr std::size_t MIN_CONNECTIONS_TO_DROP_DESTROYED = 64;
+} // namespace
+
+EpollTransportConnectivityManager::EpollTransportConnectivityManager( const std::string& _ipAddress, uint16_t _port, bool _isPortShared ) {
+    // destructor is not called for not constructed object
+    bool isConstructed = false;
+    ScopedAction closeOnFailure( [this, &isConstructed]{ if ( !isConstructed ) { closeDescriptors(); } } );
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons( _port );
+    if ( inet_pton( AF_INET, _ipAddress.c_str(), &address.sin_addr ) != 1 ) {
+        throw std::runtime_error( "Invalid address to listen on" );
+    }
+
+    m_listeningSocket = ::socket( AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+    if ( m_listeningSocket == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    int enable = 1;
+    if ( setsockopt( m_listeningSocket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof( enable ) ) == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    if ( _isPortShared && setsockopt( m_listeningSocket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof( enable ) ) == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    if ( bind( m_listeningSocket, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    if ( listen( m_listeningSocket, SOMAXCONN ) == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    m_epoll = epoll_create1( EPOLL_CLOEXEC );
+    if ( m_epoll == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    epoll_event listeningEvent{};
+    listeningEvent.events = EPOLLIN | EPOLLET;
+    listeningEvent.data.u64 = LISTENING_SOCKET_ID;
+    if ( epoll_ctl( m_epoll, EPOLL_CTL_ADD, m_listeningSocket, &listeningEvent ) == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    // epoll descriptor is readable when any of registered sockets has events
+    m_epollNotifier = std::make_unique<QSocketNotifier>( m_epoll, QSocketNotifier::Read );
+    QObject::connect( m_epollNotifier.get(), &QSocketNotifier::activated, [this]{ processEvents(); } );
+
+    isConstructed = true;
+    LOG_INFORMATION( "Start listening to connections" );
+}
+
+EpollTransportConnectivityManager::~EpollTransportConnectivityManager() {
+    closeDescriptors();
+}
+
+bool
+EpollTransportConnectivityManager::registerNewConnectionCallback( NewConnectionCallback _callback ) {
+    bool result = m_connectionCallback != nullptr;
+    m_connectionCallback = _callback;
+    return result;
+}
+
+uint16_t
+EpollTransportConnectivityManager::port() const {
+    sockaddr_in address{};
+    socklen_t addressLength = sizeof( address );
+    if ( getsockname( m_listeningSocket, reinterpret_cast<sockaddr*>( &address ), &addressLength ) == -1 ) {
+        return 0;
+    }
+
+    return ntohs( address.sin_port );
+}
+
+void
+EpollTransportConnectivityManager::processEvents() {
+    std::array<epoll_event, MAX_EVENTS_PER_WAIT> events;
+
+    int numberOfEvents = 0;
+    do {
+        numberOfEvents = epoll_wait( m_epoll, events.data(), events.size(), 0 );
+
+        for ( auto eventIndex = 0; eventIndex < numberOfEvents; ++eventIndex ) {
+            const auto& event = events[ eventIndex ];
+
+            if ( event.data.u64 == LISTENING_SOCKET_ID ) {
+                acceptConnections();
+                continue;
+            }
+
+            auto connectionIt = m_connections.find( event.data.u64 );
+            if ( connectionIt == m_connections.end() ) {
+                continue;
+            }
+
+            // connection is kept alive during dispatching, even if callback releases it
+            auto connection = connectionIt->second.lock();
+            if ( !connection ) {
+                m_connections.erase( connectionIt );
+                continue;
+            }
+
+            connection->onEvents( event.events );
+            if ( connection->isReceivePending() ) {
+                m_pendingReceives.push_back( connectionIt->first );
+            }
+        }
+    } while ( numberOfEvents == MAX_EVENTS_PER_WAIT );
+
+    // rest of received bytes is read in next iteration of event loop, after other sources of events
+    if ( !m_pendingReceives.empty() && !m_isPendingReceivesScheduled ) {
+        m_isPendingReceivesScheduled = true;
+        QMetaObject::invokeMethod( m_epollNotifier.get(), [this]{ processPendingReceives(); }, Qt::QueuedConnection );
+    }
+}
+
+void
+EpollTransportConnectivityManager::processPendingReceives() {
+    m_isPendingReceivesScheduled = false;
+
+    auto pendingReceives = std::move( m_pendingReceives );
+    m_pendingReceives.clear();
+    for ( auto connectionId : pendingReceives ) {
+        auto connectionIt = m_connections.find( connectionId );
+        if ( connectionIt == m_connections.end() ) {
+            continue;
+        }
+
+        auto connection = connectionIt->second.lock();
+        if ( !connection ) {
+            continue;
+        }
+
+        connection->onEvents( EPOLLIN );
+        if ( connection->isReceivePending() ) {
+            m_pendingReceives.push_back( connectionId );
+        }
+    }
+
+    if ( !m_pendingReceives.empty() ) {
+        m_isPendingReceivesScheduled = true;
+        QMetaObject::invokeMethod( m_epollNotifier.get(), [this]{ processPendingReceives(); }, Qt::QueuedConnection );
+    }
+}
+
+void
+EpollTransportConnectivityManager::dropDestroyedConnections() {
+    if ( m_connections.size() < m_connectionsToDropDestroyed ) {
+        return;
+    }
+
+    for ( auto connectionIt = m_connections.begin(); connectionIt != m_connections.end(); ) {
+        connectionIt = connectionIt->second.expired() ? m_connections.erase( connectionIt ) : std::next( connectionIt );
+    }
+    m_connectionsToDropDestroyed = std::max( MIN_CONNECTIONS_TO_DROP_DESTROYED, 2 * m_connections.size() );
+}
+
+void
+EpollTransportConnectivityManager::closeDescriptors() {
+    m_epollNotifier.reset();
+
+    if ( m_epoll != -1 ) {
+        ::close( m_epoll );
+    }
+
+    if ( m_listeningSocket != -1 ) {
+        ::close( m_listeningSocket );
+    }
+}
+
+void
+EpollTransportConnectivityManager::acceptConnections() {
+    // in edge-triggered mode all pending connections have to be accepted at once
+    while ( true ) {
+        auto socket = accept4( m_listeningSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC );
+        if ( socket == -1 ) {
+            if ( errno == EINTR || errno == ECONNABORTED ) {
+                continue;
+            }
+
+            if ( errno != EAGAIN && errno != EWOULDBLOCK ) {
+                LOG_ERROR( std::strerror( errno ) );
+            }
+            return;
+        }
+
+        int enable = 1;
+        setsockopt( socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof( enable ) );
+
+        auto connection = std::make_shared<EpollConnection>( socket );
+
+        const auto connectionId = m_nextConnectionId++;
+        epoll_event connectionEvent{};
+        connectionEvent.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        connectionEvent.data.u64 = connectionId;
+        if ( epoll_ctl( m_epoll, EPOLL_CTL_ADD, socket, &connectionEvent ) == -1 ) {
+            LOG_ERROR( "Cannot start TCP connection" );
+            continue;
+        }
+
+        dropDestroyedConnections();
+        m_connections.emplace( connectionId, connection );
+
+        if ( m_connectionCallback != nullptr ) {
+            m_connectionCallback( std::move( connection ) );
+        }
+    }
+}
+
+} // namespace Challenge::Communication::Server
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Communication/Server/TransportConnectivityManager/ITransportConnectivityManager.h"
+
+#include <QSocketNotifier>
+
+#include <cinttypes>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Challenge {
+namespace Communication {
+namespace Server {
+
+    class EpollConnection;
+
+    //! Accepts connections and dispatches events of their sockets with epoll, without QTcpServer and QTcpSocket
+    /*!
+     *  Epoll descriptor is watched by QSocketNotifier, so events of all sockets are handled in Qt event loop by
+     *  one notification, regardless of number of connections.
+     */
+    class EpollTransportConnectivityManager : public ITransportConnectivityManager {
+        public:
+            //! Maximal number of events taken by one epoll_wait
+            static constexpr int MAX_EVENTS_PER_WAIT = 256;
+
+            //! Constructor
+            /*!
+             *
+             * @param _ipAddress IPv4 address to listen on
+             * @param _port tcp port, with 0 any free port is chosen
+             * @param _isPortShared port is opened with SO_REUSEPORT, so other managers can listen on it as well
+             * @throw std::runtime_error if cannot start to listen on given address and port
+             */
+            EpollTransportConnectivityManager( const std::string& _ipAddress, uint16_t _port, bool _isPortShared = false );
+            ~EpollTransportConnectivityManager() override;
+
+            EpollTransportConnectivityManager(const EpollTransportConnectivityManager &) = delete;
+            EpollTransportConnectivityManager(EpollTransportConnectivityManager &&) = delete;
+            EpollTransportConnectivityManager &operator=(EpollTransportConnectivityManager &) = delete;
+            EpollTransportConnectivityManager &operator=(EpollTransportConnectivityManager &&) = delete;
+
+            bool registerNewConnectionCallback( NewConnectionCallback _callback ) override;
+
+            //! Returns port on which connections are accepted
+            uint16_t port() const;
+
+            //! Dispatches all events ready on sockets without blocking, it is fired by Qt event loop
+            void processEvents();
+
+        private:
+            void acceptConnections();
+            void closeDescriptors();
+            //! Dispatches connections which left received bytes in socket, epoll does not report them again
+            void processPendingReceives();
+            //! Drops entries of destroyed connections, cost is amortized over accepted connections
+            void dropDestroyedConnections();
+
+        private:
+            int m_listeningSocket = -1;
+            int m_epoll = -1;
+            std::unique_ptr<QSocketNotifier> m_epollNotifier;
+
+            NewConnectionCallback m_connectionCallback;
+            //! Connections are identified by sequence number in data of epoll event, descriptor of destroyed connection
+            //! may be reused by connection accepted while older events of it are still dispatched
+            using ConnectionId = uint64_t;
+            //! Connections are owned by users, entries of destroyed ones are dropped from time to time
+            std::unordered_map<ConnectionId, std::weak_ptr<EpollConnection>> m_connections;
+            //! Id 0 is used by listening socket
+            ConnectionId m_nextConnectionId = 1;
+            std::size_t m_connectionsToDropDestroyed = 0;
+
+            std::vector<ConnectionId> m_pendingReceives;
+            bool m_isPendingReceivesScheduled = false;
+    };
+
+} // Communication
+} // Server
+} // Challenge
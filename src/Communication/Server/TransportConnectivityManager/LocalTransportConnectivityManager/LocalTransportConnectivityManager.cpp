@@ -0,0 +1,66 @@
+#include "LocalTransportConnectivityManager.h"
+
+#include "Communication/Server/TransportConnectivityManager/ITransportConnectivityManager.h"
+#include "Communication/Server/TransportConnectivityManager/ITransportConnection.h"
+
+#include "Lib/Log/Logger.h"
+
+#include <QLocalSocket>
+
+#include <stdexcept>
+
+namespace Challenge::Communication::Server {
+
+template<>
+std::unique_ptr<ITransportConnectivityManager>
+ITransportConnectivityManager::create<LocalSocketEngine>(LocalSocketEngine _engine) try {
+    return std::unique_ptr<ITransportConnectivityManager>(new LocalTransportConnectivityManager(_engine.path));
+
+} catch (std::runtime_error &_exception) {
+    LOG_ERROR(_exception.what());
+    return nullptr;
+}
+
+template std::unique_ptr<ITransportConnectivityManager> ITransportConnectivityManager::create(LocalSocketEngine);
+
+LocalTransportConnectivityManager::LocalTransportConnectivityManager(const std::string& _path) {
+    auto connectionResult = connect(&m_server, &QLocalServer::newConnection, this, &LocalTransportConnectivityManager::onNewConnection);
+    if (!connectionResult) {
+        throw std::runtime_error("Cannot connect signal with slot");
+    }
+
+    // socket file is not removed when previous server crashed
+    const auto path = QString::fromStdString( _path );
+    QLocalServer::removeServer( path );
+
+    if (!m_server.listen( path )) {
+        throw std::runtime_error(m_server.errorString().toStdString());
+    }
+
+    LOG_INFORMATION( "Start listening to local connections" );
+}
+
+void
+LocalTransportConnectivityManager::onNewConnection() {
+    while (auto connection = m_server.nextPendingConnection()) {
+       auto newTransportConnection = ITransportConnection::create( connection );
+       if ( !newTransportConnection ) {
+           LOG_ERROR( "Cannot start local connection" );
+           connection->disconnectFromServer();
+           continue;
+       }
+
+       if ( m_connectionCallback != nullptr ) {
+           m_connectionCallback(std::move(newTransportConnection));
+       }
+    }
+}
+
+bool
+LocalTransportConnectivityManager::registerNewConnectionCallback(NewConnectionCallback _callback) {
+    bool result = m_connectionCallback != nullptr;
+    m_connectionCallback = _callback;
+    return result;
+}
+
+}// Challenge::Communication::Server
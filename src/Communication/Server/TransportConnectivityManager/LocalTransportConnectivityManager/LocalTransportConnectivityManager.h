@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Communication/Server/TransportConnectivityManager/ITransportConnectivityManager.h"
+
+#include <QObject>
+#include <QLocalServer>
+
+#include <string>
+
+namespace Challenge {
+namespace Communication {
+namespace Server {
+
+    //! Accepts connections of clients running on the same host, their data do not pass through TCP stack
+    class LocalTransportConnectivityManager : public QObject, public ITransportConnectivityManager {
+        Q_OBJECT
+        public:
+            //! Constructor
+            /*!
+             *
+             * @param _path path of the socket, stale socket file with the same path is removed
+             * @throw std::runtime_error is cannot start to listen on given path
+             */
+            explicit LocalTransportConnectivityManager(const std::string& _path);
+            ~LocalTransportConnectivityManager() override = default;
+
+            bool registerNewConnectionCallback( NewConnectionCallback _callback) override;
+
+        private slots:
+            void onNewConnection();
+
+        private:
+            NewConnectionCallback m_connectionCallback;
+            QLocalServer m_server;
+    };
+
+} // Communication
+} // Server
+} // Challenge
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Communication/Server/TransportConnectivityManager/ITransportConnection.h"
+#include "Lib/SharedMemoryChannel/SharedMemoryChannel.h"
+
+namespace Challenge {
+namespace Communication {
+namespace Server {
+
+            //! Connection with client on the same host over rings in shared memory
+            class SharedMemoryConnection : public ITransportConnection {
+            public:
+                //! Constructor
+                /*!
+                 *
+                 * @param _socket accepted Unix domain socket, shared memory is passed to client over it
+                 * @throw std::runtime_error if shared memory cannot be created
+                 */
+                explicit SharedMemoryConnection( int _socket );
+                ~SharedMemoryConnection() override = default;
+
+                bool isValid() const override;
+                bool registerConnectionExpiredCallback(ConnectionExpiredCallback _callback) override;
+                bool registerNewDataReadyToReadCallback(NewDataReadyToReadCallback _callback) override;
+                std::optional<Payload> receive() override;
+                std::optional<std::size_t> receiveInto( Payload& _buffer ) override;
+                std::optional<uint32_t> send( const Payload& _payload ) override;
+                bool flush() override;
+
+            private:
+                SharedMemoryChannel m_channel;
+            };
+
+} // namespace Server
+} // namespace Communication
+} // namespace Challenge
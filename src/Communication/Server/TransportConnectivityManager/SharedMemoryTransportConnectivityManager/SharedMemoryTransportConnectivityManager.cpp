@@ -0,0 +1,115 @@
+#include "SharedMemoryTransportConnectivityManager.h"
+#include "SharedMemoryConnection.h"
+
+#include "Lib/C++Tools/ScopedAction.h"
+#include "Lib/Log/Logger.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace Challenge::Communication::Server {
+
+template<>
+std::unique_ptr<ITransportConnectivityManager>
+ITransportConnectivityManager::create<SharedMemoryEngine>( SharedMemoryEngine _engine ) try {
+    return std::unique_ptr<ITransportConnectivityManager>( new SharedMemoryTransportConnectivityManager( _engine.path ) );
+} catch ( std::runtime_error& _exception ) {
+    LOG_ERROR( _exception.what() );
+    return nullptr;
+}
+
+template std::unique_ptr<ITransportConnectivityManager> ITransportConnectivityManager::create<SharedMemoryEngine>( SharedMemoryEngine );
+
+SharedMemoryTransportConnectivityManager::SharedMemoryTransportConnectivityManager( const std::string& _path )
+    : m_path( _path ) {
+    // destructor is not called for not constructed object
+    bool isConstructed = false;
+    ScopedAction closeOnFailure( [this, &isConstructed]{ if ( !isConstructed ) { closeDescriptors(); } } );
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if ( m_path.empty() || m_path.size() >= sizeof( address.sun_path ) ) {
+        throw std::runtime_error( "Invalid path of local socket" );
+    }
+    std::strncpy( address.sun_path, m_path.c_str(), sizeof( address.sun_path ) - 1 );
+
+    m_listeningSocket = ::socket( AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+    if ( m_listeningSocket == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    // socket file is not removed when previous server crashed
+    ::unlink( m_path.c_str() );
+
+    if ( bind( m_listeningSocket, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    if ( listen( m_listeningSocket, SOMAXCONN ) == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    m_listeningNotifier = std::make_unique<QSocketNotifier>( m_listeningSocket, QSocketNotifier::Read );
+    QObject::connect( m_listeningNotifier.get(), &QSocketNotifier::activated, [this]{ acceptConnections(); } );
+
+    isConstructed = true;
+    LOG_INFORMATION( "Start listening to shared memory connections" );
+}
+
+SharedMemoryTransportConnectivityManager::~SharedMemoryTransportConnectivityManager() {
+    closeDescriptors();
+    ::unlink( m_path.c_str() );
+}
+
+bool
+SharedMemoryTransportConnectivityManager::registerNewConnectionCallback( NewConnectionCallback _callback ) {
+    bool result = m_connectionCallback != nullptr;
+    m_connectionCallback = _callback;
+    return result;
+}
+
+void
+SharedMemoryTransportConnectivityManager::closeDescriptors() {
+    m_listeningNotifier.reset();
+
+    if ( m_listeningSocket != -1 ) {
+        ::close( m_listeningSocket );
+    }
+}
+
+void
+SharedMemoryTransportConnectivityManager::acceptConnections() {
+    while ( true ) {
+        auto socket = accept4( m_listeningSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC );
+        if ( socket == -1 ) {
+            if ( errno == EINTR || errno == ECONNABORTED ) {
+                continue;
+            }
+
+            if ( errno != EAGAIN && errno != EWOULDBLOCK ) {
+                LOG_ERROR( std::strerror( errno ) );
+            }
+            return;
+        }
+
+        std::shared_ptr<ITransportConnection> connection;
+        try {
+            // connection owns the socket, it is closed also when connection cannot be created
+            connection = std::make_shared<SharedMemoryConnection>( socket );
+        } catch ( std::runtime_error& _exception ) {
+            LOG_ERROR( _exception.what() );
+            continue;
+        }
+
+        if ( m_connectionCallback != nullptr ) {
+            m_connectionCallback( std::move( connection ) );
+        }
+    }
+}
+
+} // namespace Challenge::Communication::Server
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Communication/Server/TransportConnectivityManager/ITransportConnectivityManager.h"
+
+#include <QSocketNotifier>
+
+#include <memory>
+#include <string>
+
+namespace Challenge {
+namespace Communication {
+namespace Server {
+
+    //! Accepts clients on the same host and serves them over rings in shared memory
+    /*!
+     *  Client connects to local socket, server passes it shared memory of the connection and the socket is then
+     *  used only to detect that client is gone.
+     */
+    class SharedMemoryTransportConnectivityManager : public ITransportConnectivityManager {
+        public:
+            //! Constructor
+            /*!
+             *
+             * @param _path path of local socket, stale socket file with the same path is removed
+             * @throw std::runtime_error if cannot start to listen on given path
+             */
+            explicit SharedMemoryTransportConnectivityManager( const std::string& _path );
+            ~SharedMemoryTransportConnectivityManager() override;
+
+            SharedMemoryTransportConnectivityManager(const SharedMemoryTransportConnectivityManager &) = delete;
+            SharedMemoryTransportConnectivityManager(SharedMemoryTransportConnectivityManager &&) = delete;
+            SharedMemoryTransportConnectivityManager &operator=(SharedMemoryTransportConnectivityManager &) = delete;
+            SharedMemoryTransportConnectivityManager &operator=(SharedMemoryTransportConnectivityManager &&) = delete;
+
+            bool registerNewConnectionCallback( NewConnectionCallback _callback ) override;
+
+            //! Accepts all pending clients without blocking, it is fired by Qt event loop
+            void acceptConnections();
+
+        private:
+            void closeDescriptors();
+
+        private:
+            const std::string m_path;
+            int m_listeningSocket = -1;
+            std::unique_ptr<QSocketNotifier> m_listeningNotifier;
+
+            NewConnectionCallback m_connectionCallback;
+    };
+
+} // Communication
+} // Server
+} // Challenge
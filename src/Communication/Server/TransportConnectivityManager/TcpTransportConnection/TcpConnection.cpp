@@ -37,9 +37,19 @@ TcpConnection::receive() {
     return m_qtConnectionHelper.receive();
 }
 
+std::optional<std::size_t>
+TcpConnection::receiveInto( ITransportConnection::Payload& _buffer ) {
+    return m_qtConnectionHelper.receiveInto( _buffer );
+}
+
 std::optional<uint32_t>
 TcpConnection::send( const ITransportConnection::Payload& _payload ) {
     return m_qtConnectionHelper.send(_payload);
 }
 
+bool
+TcpConnection::flush() {
+    return m_qtConnectionHelper.flush();
+}
+
 } // namespace Challenge::Communication::Server
@@ -21,7 +21,9 @@ namespace Server {
                 bool registerConnectionExpiredCallback(ConnectionExpiredCallback _callback) override;
                 bool registerNewDataReadyToReadCallback(NewDataReadyToReadCallback _callback) override;
                 std::optional<Payload> receive() override;
+                std::optional<std::size_t> receiveInto( Payload& _buffer ) override;
                 std::optional<uint32_t> send( const Payload& _payload ) override;
+                bool flush() override;
 
             private:
                 QtTcpConnectionHelper m_qtConnectionHelper;
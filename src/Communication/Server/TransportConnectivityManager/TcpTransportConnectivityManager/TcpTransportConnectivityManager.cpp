@@ -13,8 +13,9 @@
 
 namespace Challenge::Communication::Server {
 
+template<>
 std::unique_ptr<ITransportConnectivityManager>
-ITransportConnectivityManager::create() try {
+ITransportConnectivityManager::create<>() try {
     QHostAddress address(SERVER_IP);
     return std::unique_ptr<ITransportConnectivityManager>(new TcpTransportConnectivityManager(address, SERVER_PORT));
 
@@ -23,6 +24,8 @@ ITransportConnectivityManager::create() try {
     return nullptr;
 }
 
+template std::unique_ptr<ITransportConnectivityManager> ITransportConnectivityManager::create();
+
 TcpTransportConnectivityManager::TcpTransportConnectivityManager(const QHostAddress &_hostAddress, uint16_t _port) {
     auto connectionResult = connect(&m_server, &QTcpServer::newConnection, this, &TcpTransportConnectivityManager::onNewConnection);
     if (!connectionResult) {
@@ -0,0 +1,182 @@
+#include "AsyncStorage.h"
+
+#include "Lib/Log/Logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+
+namespace Challenge::EventsStorage {
+
+    template<>
+    std::shared_ptr<IEventsStorage> IEventsStorage::create<AsyncWriterEngine>( AsyncWriterEngine _engine ) try {
+        return std::shared_ptr<IEventsStorage>( new AsyncStorage( std::move( _engine.storage ), _engine.maxQueueSize, _engine.policy ) );
+    } catch ( std::exception& _exception ) {
+        LOG_ERROR( _exception.what() );
+        return nullptr;
+    }
+
+AsyncStorage::AsyncStorage( std::shared_ptr<IEventsStorage> _storage, std::size_t _maxQueueSize, FullQueuePolicy _policy )
+    : m_storage( std::move( _storage ) )
+    , m_queue( _maxQueueSize, _policy ) {
+    if ( !m_storage ) {
+        throw std::runtime_error( "Storage is nullptr" );
+    }
+
+    m_writer = std::thread( [this]{ runWriter(); } );
+}
+
+AsyncStorage::~AsyncStorage() {
+    {
+        std::lock_guard lock( m_queueMutex );
+        m_isStopped = true;
+    }
+    m_queueNotEmptyCondition.notify_one();
+    m_writer.join();
+}
+
+bool
+AsyncStorage::saveEvent( const EventData& _event ) {
+    return saveAndWait( Events{ _event } ) == 1;
+}
+
+std::size_t
+AsyncStorage::saveEvents( const Events& _events ) {
+    if ( _events.empty() ) {
+        return 0;
+    }
+    return saveAndWait( _events );
+}
+
+void
+AsyncStorage::saveEventAsync( EventData _event, SaveCompletion _completion ) {
+    assert( _completion );
+
+    Events events;
+    events.push_back( std::move( _event ) );
+    enqueue( std::move( events ), std::move( _completion ) );
+}
+
+void
+AsyncStorage::saveEventsAsync( Events _events, SaveCompletion _completion ) {
+    assert( _completion );
+
+    if ( _events.empty() ) {
+        _completion( 0 );
+        return;
+    }
+    enqueue( std::move( _events ), std::move( _completion ) );
+}
+
+std::size_t
+AsyncStorage::saveAndWait( Events _events ) {
+    std::promise<std::size_t> numberOfSavedEvents;
+    auto result = numberOfSavedEvents.get_future();
+
+    // events saved before are queued before these ones, so synchronous save keeps order of saves
+    enqueue( std::move( _events ), [&numberOfSavedEvents]( std::size_t _numberOfSavedEvents ){
+        numberOfSavedEvents.set_value( _numberOfSavedEvents );
+    });
+
+    return result.get();
+}
+
+void
+AsyncStorage::enqueue( Events _events, SaveCompletion _completion ) {
+    PendingWrite write;
+    write.events = std::move( _events );
+    write.completion = std::move( _completion );
+
+    // completions of rejected or shed writes are fired after queue is unlocked
+    std::vector<PendingWrite> notQueuedWrites;
+    {
+        std::unique_lock lock( m_queueMutex );
+        notQueuedWrites = m_queue.push( std::move( write ), lock, m_queueNotFullCondition );
+    }
+    m_queueNotEmptyCondition.notify_one();
+
+    for ( auto& notQueuedWrite : notQueuedWrites ) {
+        notQueuedWrite.completion( 0 );
+    }
+}
+
+void
+AsyncStorage::runWriter() {
+    std::vector<PendingWrite> writes;
+
+    for (;;) {
+        {
+            std::unique_lock lock( m_queueMutex );
+            m_queueNotEmptyCondition.wait( lock, [this]{ return !m_queue.isEmpty() || m_isStopped; } );
+
+            // queued events are written also when storage is being destroyed
+            if ( m_queue.isEmpty() ) {
+                return;
+            }
+
+            m_queue.takeBatch( MAX_WRITE_BATCH_SIZE, writes );
+        }
+        m_queueNotFullCondition.notify_all();
+
+        write( writes );
+        writes.clear();
+    }
+}
+
+void
+AsyncStorage::write( std::vector<PendingWrite>& _writes ) {
+    assert( !_writes.empty() );
+
+    if ( _writes.size() == 1 ) {
+        _writes.front().completion( m_storage->saveEvents( _writes.front().events ) );
+        return;
+    }
+
+    Events events;
+    for ( auto& write : _writes ) {
+        std::move( write.events.begin(), write.events.end(), std::back_inserter( events ) );
+    }
+
+    // saved events are always the first events of batch, so they belong to the first writes
+    auto numberOfSavedEvents = m_storage->saveEvents( events );
+    for ( auto& write : _writes ) {
+        const auto numberOfSavedEventsOfWrite = std::min( numberOfSavedEvents, write.events.size() );
+        numberOfSavedEvents -= numberOfSavedEventsOfWrite;
+        write.completion( numberOfSavedEventsOfWrite );
+    }
+}
+
+std::optional<IEventsStorage::Events>
+AsyncStorage::getSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent ) const {
+    return m_storage->getSavedEvents( _firstEvent, _lastEvent );
+}
+
+bool
+AsyncStorage::visitSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent, std::size_t _chunkSize, EventsChunkVisitor _visitor ) const {
+    return m_storage->visitSavedEvents( _firstEvent, _lastEvent, _chunkSize, std::move( _visitor ) );
+}
+
+std::optional<uint64_t>
+AsyncStorage::getNumberOfEvents() const {
+    return m_storage->getNumberOfEvents();
+}
+
+bool
+AsyncStorage::registerEventAddedCallback( EventSavedCallback _callback, void* _key ) {
+    return m_storage->registerEventAddedCallback( std::move( _callback ), _key );
+}
+
+void
+AsyncStorage::setCallbackExecutor( CallbackExecutor _executor ) {
+    m_storage->setCallbackExecutor( std::move( _executor ) );
+}
+
+std::size_t
+AsyncStorage::getQueueDepth() const {
+    std::lock_guard lock( m_queueMutex );
+    return m_queue.getNumberOfEvents();
+}
+
+} // namespace Challenge::EventsStorage
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "EventsStorage/IEventsStorage.h"
+#include "Lib/WritesQueue/WritesQueue.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Challenge::EventsStorage {
+
+    //! Decorator of storage, which writes events on own thread
+    /*!
+     *  Saved events wait in bounded queue, so network thread does not wait for disk. Writer takes all waiting events
+     *  at once and saves them by one saveEvents of decorated storage, so they share one transaction. Reads and
+     *  callbacks of new events are passed to decorated storage, reads see only events which are already written.
+     *  It is meant for storage which saves synchronously, sqlite storage has own bounded queue of its writer thread.
+     */
+    class AsyncStorage : public IEventsStorage {
+        public:
+            //! Maximal number of events saved by writer at once
+            static constexpr std::size_t MAX_WRITE_BATCH_SIZE = 256;
+
+            //! Constructor
+            /*!
+             *
+             * @param _storage storage which saves events
+             * @param _maxQueueSize maximal number of events waiting for writer, batch bigger than queue is accepted
+             *  only by empty queue
+             * @param _policy what happens with saved events, when queue is full
+             * @throw std::runtime_error if storage is nullptr or size of queue is 0
+             */
+            AsyncStorage( std::shared_ptr<IEventsStorage> _storage, std::size_t _maxQueueSize, FullQueuePolicy _policy );
+            //! Writes all queued events before return
+            ~AsyncStorage() override;
+
+            AsyncStorage(const AsyncStorage &) = delete;
+            AsyncStorage(AsyncStorage &&) = delete;
+            AsyncStorage &operator=(AsyncStorage &) = delete;
+            AsyncStorage &operator=(AsyncStorage &&) = delete;
+
+            //! Saves event through queue, returns when event is written
+            bool saveEvent( const EventData& _event ) override;
+            //! Saves events through queue, returns when events are written
+            std::size_t saveEvents( const Events& _events ) override;
+            void saveEventAsync( EventData _event, SaveCompletion _completion ) override;
+            void saveEventsAsync( Events _events, SaveCompletion _completion ) override;
+            std::optional<Events> getSavedEvents(uint64_t _firstEvent, uint64_t _lastEvent) const override;
+            bool visitSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent, std::size_t _chunkSize, EventsChunkVisitor _visitor ) const override;
+            std::optional<uint64_t> getNumberOfEvents() const override;
+            bool registerEventAddedCallback( EventSavedCallback _callback, void* _key ) override;
+            void setCallbackExecutor( CallbackExecutor _executor ) override;
+
+            //! Returns number of events waiting for writer
+            std::size_t getQueueDepth() const;
+
+        private:
+            using PendingWrite = WritesQueue::PendingWrite;
+
+            //! Queues events or applies full queue policy, completion is fired on calling thread if events are rejected
+            void enqueue( Events _events, SaveCompletion _completion );
+            //! Saves events synchronously through queue
+            std::size_t saveAndWait( Events _events );
+            void runWriter();
+            //! Saves events of all writes by decorated storage at once, then fires completions
+            void write( std::vector<PendingWrite>& _writes );
+
+        private:
+            const std::shared_ptr<IEventsStorage> m_storage;
+
+            WritesQueue m_queue;
+            bool m_isStopped = false;
+            mutable std::mutex m_queueMutex;
+            //! Writer waits for queued events
+            std::condition_variable m_queueNotEmptyCondition;
+            //! Blocked savers wait for space in queue
+            std::condition_variable m_queueNotFullCondition;
+
+            std::thread m_writer;
+    };
+
+} // namespace Challenge::EventsStorage
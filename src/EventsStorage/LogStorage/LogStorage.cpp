@@ -0,0 +1,326 @@
+#include "LogStorage.h"
+
+#include "Lib/Log/Logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace Challenge::EventsStorage {
+
+    namespace {
+        constexpr auto INDEX_FILE_NAME = "events.idx";
+        constexpr uint64_t INDEX_MAGIC = 0x3130584449545645; // "EVTIDX01"
+        constexpr std::size_t INITIAL_INDEX_CAPACITY = 4096;
+        constexpr std::size_t RECORD_ALIGNMENT = 8;
+
+        struct IndexHeader {
+            uint64_t magic;
+            //! Events which are completely written, it is updated as the last step of save
+            uint64_t numberOfEvents;
+        };
+
+        struct IndexEntry {
+            uint32_t segment;
+            uint32_t offset;
+        };
+
+        struct RecordHeader {
+            uint64_t millisecondsFromEpoch;
+            uint32_t priority;
+            uint32_t lengthOfText;
+        };
+
+        std::string segmentFileName( uint32_t _segment ) {
+            return "segment-" + std::to_string( _segment ) + ".log";
+        }
+
+        std::size_t alignRecordOffset( std::size_t _offset ) {
+            return ( _offset + RECORD_ALIGNMENT - 1 ) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+        }
+
+        IndexHeader* indexHeader( const MappedFile& _index ) {
+            return reinterpret_cast<IndexHeader*>( _index.data() );
+        }
+
+        IndexEntry* indexEntry( const MappedFile& _index, uint64_t _eventNumber ) {
+            return reinterpret_cast<IndexEntry*>( _index.data() + sizeof(IndexHeader) ) + _eventNumber;
+        }
+
+        std::size_t indexCapacity( const MappedFile& _index ) {
+            return ( _index.size() - sizeof(IndexHeader) ) / sizeof(IndexEntry);
+        }
+    } // namespace
+
+    template<>
+    std::shared_ptr<IEventsStorage> IEventsStorage::create<AppendLogEngine>( AppendLogEngine _engine ) try {
+        return std::shared_ptr<IEventsStorage>( new LogStorage( _engine.absPathToDirectory ) );
+    } catch ( std::exception& _exception ) {
+        LOG_ERROR( _exception.what() );
+        return nullptr;
+    }
+
+LogStorage::LogStorage( std::experimental::filesystem::path _absPathToDirectory )
+    : LogStorage( std::move(_absPathToDirectory), Settings{} ) {
+}
+
+LogStorage::LogStorage( std::experimental::filesystem::path _absPathToDirectory, Settings _settings )
+    : m_directory( std::move(_absPathToDirectory) )
+    , m_settings( _settings ) {
+    if ( !m_directory.is_absolute() ) {
+        throw std::runtime_error( "Path to directory is not absolute" );
+    }
+
+    if ( m_settings.segmentSize <= sizeof(RecordHeader) || m_settings.segmentSize > std::numeric_limits<uint32_t>::max() ) {
+        throw std::runtime_error( "Invalid size of segment" );
+    }
+
+    std::error_code error;
+    std::experimental::filesystem::create_directory( m_directory, error );
+    if ( error ) {
+        throw std::runtime_error( "Cannot create directory " + m_directory.string() );
+    }
+
+    openIndex();
+}
+
+void
+LogStorage::openIndex() {
+    const auto indexPath = ( m_directory / INDEX_FILE_NAME ).string();
+    m_index = std::make_unique<MappedFile>( indexPath, sizeof(IndexHeader) + INITIAL_INDEX_CAPACITY * sizeof(IndexEntry) );
+
+    auto header = indexHeader( *m_index );
+    if ( header->magic == 0 && header->numberOfEvents == 0 ) {
+        header->magic = INDEX_MAGIC;
+        m_index->sync( 0, sizeof(IndexHeader) );
+    }
+
+    if ( header->magic != INDEX_MAGIC ) {
+        throw std::runtime_error( indexPath + " is not an index of events" );
+    }
+
+    const auto numberOfEvents = header->numberOfEvents;
+    if ( numberOfEvents > indexCapacity( *m_index ) ) {
+        throw std::runtime_error( indexPath + " is truncated" );
+    }
+
+    const auto lastSegment = numberOfEvents > 0 ? indexEntry( *m_index, numberOfEvents - 1 )->segment : 0;
+    for ( uint32_t segment = 0; segment <= lastSegment; ++segment ) {
+        openSegment( segment );
+    }
+
+    if ( numberOfEvents > 0 ) {
+        const auto& lastEntry = *indexEntry( *m_index, numberOfEvents - 1 );
+        RecordHeader record;
+        std::memcpy( &record, m_segments.back()->data() + lastEntry.offset, sizeof(record) );
+        m_writeOffset = alignRecordOffset( lastEntry.offset + sizeof(RecordHeader) + record.lengthOfText );
+    }
+
+    m_numberOfEvents = numberOfEvents;
+}
+
+void
+LogStorage::openSegment( uint32_t _segment ) {
+    assert( _segment == m_segments.size() );
+
+    const auto segmentPath = ( m_directory / segmentFileName( _segment ) ).string();
+    m_segments.push_back( std::make_unique<MappedFile>( segmentPath, m_settings.segmentSize ) );
+    m_writeOffset = 0;
+}
+
+bool
+LogStorage::saveEvent( const EventData& _event ) {
+    return appendEvents( &_event, 1 ) == 1;
+}
+
+std::size_t
+LogStorage::saveEvents( const Events& _events ) {
+    return appendEvents( _events.data(), _events.size() );
+}
+
+std::size_t
+LogStorage::appendEvents( const EventData* _events, std::size_t _numberOfEvents ) {
+    if ( _numberOfEvents == 0 ) {
+        return 0;
+    }
+
+    std::unique_lock lock(m_storageMutex);
+    assert( !m_segments.empty() );
+
+    const auto firstEventNumber = m_numberOfEvents.load();
+    const auto firstSegment = m_segments.size() - 1;
+    const auto firstWriteOffset = m_writeOffset;
+    auto writeOffset = m_writeOffset;
+    std::size_t numberOfWrittenEvents = 0;
+
+    try {
+        for ( ; numberOfWrittenEvents < _numberOfEvents; ++numberOfWrittenEvents ) {
+            const auto& event = _events[numberOfWrittenEvents];
+            const auto recordSize = sizeof(RecordHeader) + event.text.size();
+            if ( recordSize > m_settings.segmentSize ) {
+                LOG_ERROR( "Event is too big for segment" );
+                break;
+            }
+
+            if ( writeOffset + recordSize > m_segments.back()->size() ) {
+                openSegment( m_segments.size() );
+                writeOffset = 0;
+            }
+
+            const auto eventNumber = firstEventNumber + numberOfWrittenEvents;
+            if ( eventNumber >= indexCapacity( *m_index ) ) {
+                m_index->resize( m_index->size() * 2 );
+            }
+
+            auto& segment = *m_segments.back();
+            RecordHeader record{
+                  static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::milliseconds>( event.timeStamp.time_since_epoch() ).count() )
+                , event.priority
+                , static_cast<uint32_t>( event.text.size() )
+            };
+            std::memcpy( segment.data() + writeOffset, &record, sizeof(record) );
+            std::memcpy( segment.data() + writeOffset + sizeof(record), event.text.data(), event.text.size() );
+
+            auto entry = indexEntry( *m_index, eventNumber );
+            entry->segment = static_cast<uint32_t>( m_segments.size() - 1 );
+            entry->offset = static_cast<uint32_t>( writeOffset );
+
+            writeOffset = alignRecordOffset( writeOffset + recordSize );
+        }
+    } catch ( std::runtime_error& _exception ) {
+        LOG_ERROR( _exception.what() );
+    }
+
+    // next write starts after already written records, even when they are not counted
+    m_writeOffset = writeOffset;
+
+    if ( numberOfWrittenEvents == 0 ) {
+        return 0;
+    }
+
+    // records and their index entries of whole batch have to be on disk before events are counted
+    if ( m_settings.isSyncOnWrite ) {
+        const auto lastSegment = m_segments.size() - 1;
+        for ( auto segment = firstSegment; segment <= lastSegment; ++segment ) {
+            const auto syncBegin = segment == firstSegment ? firstWriteOffset : 0;
+            const auto syncEnd = segment == lastSegment ? std::min( writeOffset, m_segments[segment]->size() ) : m_segments[segment]->size();
+            if ( syncEnd > syncBegin && !m_segments[segment]->sync( syncBegin, syncEnd - syncBegin ) ) {
+                LOG_ERROR( "Cannot write events to disk" );
+                return 0;
+            }
+        }
+
+        const auto entriesOffset = reinterpret_cast<std::byte*>( indexEntry( *m_index, firstEventNumber ) ) - m_index->data();
+        if ( !m_index->sync( entriesOffset, numberOfWrittenEvents * sizeof(IndexEntry) ) ) {
+            LOG_ERROR( "Cannot write events to disk" );
+            return 0;
+        }
+    }
+
+    const auto numberOfEvents = firstEventNumber + numberOfWrittenEvents;
+    indexHeader( *m_index )->numberOfEvents = numberOfEvents;
+    if ( m_settings.isSyncOnWrite && !m_index->sync( 0, sizeof(IndexHeader) ) ) {
+        indexHeader( *m_index )->numberOfEvents = firstEventNumber;
+        LOG_ERROR( "Cannot write number of events to disk" );
+        return 0;
+    }
+
+    m_numberOfEvents = numberOfEvents;
+    m_publisher.publish( numberOfEvents );
+
+    return numberOfWrittenEvents;
+}
+
+EventData
+LogStorage::readEvent( uint64_t _eventNumber ) const {
+    assert( _eventNumber < m_numberOfEvents );
+
+    const auto& entry = *indexEntry( *m_index, _eventNumber );
+    assert( entry.segment < m_segments.size() );
+    const auto recordData = m_segments[entry.segment]->data() + entry.offset;
+
+    RecordHeader record;
+    std::memcpy( &record, recordData, sizeof(record) );
+
+    std::chrono::time_point<std::chrono::system_clock> time( std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(record.millisecondsFromEpoch) ) );
+    return EventData{ time, std::string( reinterpret_cast<const char*>( recordData + sizeof(record) ), record.lengthOfText ), record.priority };
+}
+
+std::optional<IEventsStorage::Events>
+LogStorage::getSavedEvents(uint64_t _firstEvent, uint64_t _lastEvent) const {
+    if ( _firstEvent > _lastEvent ) {
+        return std::nullopt;
+    }
+
+    std::shared_lock lock(m_storageMutex);
+
+    const auto numberOfEvents = m_numberOfEvents.load();
+    IEventsStorage::Events events;
+    if ( _firstEvent >= numberOfEvents ) {
+        return std::move(events);
+    }
+
+    const auto lastEvent = std::min( _lastEvent, numberOfEvents - 1 );
+    events.reserve( lastEvent - _firstEvent + 1 );
+    for ( auto eventNumber = _firstEvent; eventNumber <= lastEvent; ++eventNumber ) {
+        events.push_back( readEvent( eventNumber ) );
+    }
+
+    return std::move(events);
+}
+
+bool
+LogStorage::visitSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent, std::size_t _chunkSize, EventsChunkVisitor _visitor ) const {
+    assert( _chunkSize > 0 );
+    assert( _visitor );
+
+    if ( _firstEvent > _lastEvent ) {
+        return false;
+    }
+
+    IEventsStorage::Events chunk;
+    chunk.reserve( _chunkSize );
+    auto eventNumber = _firstEvent;
+
+    for (;;) {
+        bool isLastChunk = false;
+        {
+            // range is limited by number of events from the time reading of range started
+            std::shared_lock lock(m_storageMutex);
+            const auto numberOfEvents = m_numberOfEvents.load();
+            const auto lastEvent = numberOfEvents > 0 ? std::min( _lastEvent, numberOfEvents - 1 ) : 0;
+            _lastEvent = lastEvent;
+
+            while ( eventNumber <= lastEvent && eventNumber < numberOfEvents && chunk.size() < _chunkSize ) {
+                chunk.push_back( readEvent( eventNumber ) );
+                ++eventNumber;
+            }
+            isLastChunk = eventNumber > lastEvent || eventNumber >= numberOfEvents;
+        }
+
+        if ( !_visitor( chunk, isLastChunk ) || isLastChunk ) {
+            return true;
+        }
+        chunk.clear();
+    }
+}
+
+std::optional<uint64_t>
+LogStorage::getNumberOfEvents() const {
+    return m_numberOfEvents.load();
+}
+
+bool
+LogStorage::registerEventAddedCallback( EventSavedCallback _callback, void* _key ) {
+    return m_publisher.subscribe( _callback, _key );
+}
+
+void
+LogStorage::setCallbackExecutor( CallbackExecutor _executor ) {
+    m_publisher.setExecutor( _executor );
+}
+
+} // namespace Challenge::EventsStorage
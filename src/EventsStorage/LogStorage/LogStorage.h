@@ -0,0 +1,75 @@
+#pragma once
+
+#include "EventsStorage/IEventsStorage.h"
+#include "Lib/EventsPublisher/EventsPublisher.h"
+
+#include "MappedFile.h"
+
+#include <atomic>
+#include <experimental/filesystem>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace Challenge::EventsStorage {
+
+    //! Append only storage of events, it keeps events in memory mapped files
+    /*!
+     *  Directory of storage contains:
+     *  - events.idx - dense index, entry n contains position of event n
+     *  - segment-N.log - segments of fixed size with records (record header + text of event)
+     *
+     *  Event is found by index in constant time, events of range are read sequentially from segments.
+     */
+    class LogStorage : public IEventsStorage {
+        public:
+            struct Settings {
+                //! Size of one segment file, record of event must fit into it
+                std::size_t segmentSize = 64 * 1024 * 1024;
+
+                //! When true saveEvent returns after record and index are written to disk
+                bool isSyncOnWrite = true;
+            };
+
+            //! Opens storage in directory, directory is created when it does not exist
+            LogStorage( std::experimental::filesystem::path _absPathToDirectory ); // may throw std::runtime_error
+            LogStorage( std::experimental::filesystem::path _absPathToDirectory, Settings _settings ); // may throw std::runtime_error
+            ~LogStorage() override = default;
+
+            bool saveEvent( const EventData& _event ) override;
+            //! Writes records of all events and syncs them once, events which do not fit into segment are not saved
+            std::size_t saveEvents( const Events& _events ) override;
+            std::optional<Events> getSavedEvents(uint64_t _firstEvent, uint64_t _lastEvent) const override;
+            bool visitSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent, std::size_t _chunkSize, EventsChunkVisitor _visitor ) const override;
+            std::optional<uint64_t> getNumberOfEvents() const override;
+            bool registerEventAddedCallback( EventSavedCallback _callback, void* _key ) override;
+            void setCallbackExecutor( CallbackExecutor _executor ) override;
+
+        private:
+            void openIndex(); // may throw std::runtime_error
+            void openSegment( uint32_t _segment ); // may throw std::runtime_error
+
+            //! Appends events, events are counted after all written records are on disk
+            std::size_t appendEvents( const EventData* _events, std::size_t _numberOfEvents );
+
+            //! Reads event, storage has to be locked
+            EventData readEvent( uint64_t _eventNumber ) const;
+
+
+        private:
+            const std::experimental::filesystem::path m_directory;
+            const Settings m_settings;
+
+            std::unique_ptr<MappedFile> m_index;
+            std::vector<std::unique_ptr<MappedFile>> m_segments;
+            //! Position of next record in last segment
+            std::size_t m_writeOffset = 0;
+
+            std::atomic<uint64_t> m_numberOfEvents{ 0 };
+            mutable std::shared_mutex m_storageMutex;
+
+            EventsPublisher m_publisher;
+    };
+
+} // namespace Challenge::EventsStorage
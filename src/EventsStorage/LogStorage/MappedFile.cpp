@@ -0,0 +1,77 @@
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Challenge::EventsStorage {
+
+MappedFile::MappedFile( const std::string& _absPath, std::size_t _minimalSize ) {
+    assert( _minimalSize > 0 );
+
+    m_fileDescriptor = ::open( _absPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644 );
+    if ( m_fileDescriptor == -1 ) {
+        throw std::runtime_error( "Cannot open file " + _absPath );
+    }
+
+    struct stat fileStatus{};
+    if ( ::fstat( m_fileDescriptor, &fileStatus ) == -1 ) {
+        ::close( m_fileDescriptor );
+        throw std::runtime_error( "Cannot get size of file " + _absPath );
+    }
+
+    m_size = std::max( static_cast<std::size_t>( fileStatus.st_size ), _minimalSize );
+    if ( static_cast<std::size_t>( fileStatus.st_size ) < m_size && ::ftruncate( m_fileDescriptor, m_size ) == -1 ) {
+        ::close( m_fileDescriptor );
+        throw std::runtime_error( "Cannot extend file " + _absPath );
+    }
+
+    auto mapping = ::mmap( nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fileDescriptor, 0 );
+    if ( mapping == MAP_FAILED ) {
+        ::close( m_fileDescriptor );
+        throw std::runtime_error( "Cannot map file " + _absPath );
+    }
+    m_data = static_cast<std::byte*>( mapping );
+}
+
+MappedFile::~MappedFile() {
+    ::munmap( m_data, m_size );
+    ::close( m_fileDescriptor );
+}
+
+void
+MappedFile::resize( std::size_t _newSize ) {
+    if ( _newSize <= m_size ) {
+        return;
+    }
+
+    if ( ::ftruncate( m_fileDescriptor, _newSize ) == -1 ) {
+        throw std::runtime_error( "Cannot extend mapped file" );
+    }
+
+    auto mapping = ::mremap( m_data, m_size, _newSize, MREMAP_MAYMOVE );
+    if ( mapping == MAP_FAILED ) {
+        throw std::runtime_error( "Cannot extend file mapping" );
+    }
+
+    m_data = static_cast<std::byte*>( mapping );
+    m_size = _newSize;
+}
+
+bool
+MappedFile::sync( std::size_t _offset, std::size_t _length ) const {
+    assert( _offset + _length <= m_size );
+
+    // msync requires address aligned to page
+    static const std::size_t pageSize = ::sysconf( _SC_PAGESIZE );
+    const auto alignedOffset = _offset - _offset % pageSize;
+
+    return ::msync( m_data + alignedOffset, _length + ( _offset - alignedOffset ), MS_SYNC ) == 0;
+}
+
+} // namespace Challenge::EventsStorage
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Challenge::EventsStorage {
+
+    //! Read-write shared memory mapping of whole file
+    class MappedFile {
+    public:
+        //! Constructor
+        /*!
+         *  Opens or creates file, file smaller than _minimalSize is extended
+         * @param _absPath path to file
+         * @param _minimalSize minimal size of mapping
+         * @throw std::runtime_error when file cannot be opened or mapped
+         */
+        MappedFile( const std::string& _absPath, std::size_t _minimalSize );
+        ~MappedFile();
+
+        MappedFile( const MappedFile& ) = delete;
+        MappedFile& operator=( const MappedFile& ) = delete;
+
+        std::byte* data() const { return m_data; }
+        std::size_t size() const { return m_size; }
+
+        //! Extends file and its mapping, mapping may be moved so pointers to old data are invalidated
+        /*!
+         * @throw std::runtime_error in case of error
+         */
+        void resize( std::size_t _newSize );
+
+        //! Writes range of mapping to disk, returns when data are on disk
+        bool sync( std::size_t _offset, std::size_t _length ) const;
+
+    private:
+        int m_fileDescriptor = -1;
+        std::byte* m_data = nullptr;
+        std::size_t m_size = 0;
+    };
+
+} // namespace Challenge::EventsStorage
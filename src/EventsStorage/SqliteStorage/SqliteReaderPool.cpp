@@ -0,0 +1,142 @@
+#include "SqliteReaderPool.h"
+
+#include "Lib/Log/Logger.h"
+
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+
+#include <atomic>
+#include <cassert>
+#include <stdexcept>
+
+namespace Challenge::EventsStorage {
+
+    namespace {
+        //! Connections of all pools are registered in one Qt registry, so their names have to be unique
+        std::atomic<uint64_t> nextReaderId{ 0 };
+    } // namespace
+
+SqliteReaderPool::SqliteReaderPool( const std::string& _absPathToDbFile, std::size_t _numberOfReaders
+                                  , const QString& _readStatement, const std::vector<QString>& _setupStatements )
+    : m_absPathToDbFile( QString::fromStdString( _absPathToDbFile ) )
+    , m_readStatement( _readStatement )
+    , m_setupStatements( _setupStatements ) {
+
+    if ( _numberOfReaders == 0 ) {
+        throw std::runtime_error("At least one reader is required");
+    }
+
+    std::vector<std::promise<bool>> isOpened( _numberOfReaders );
+    for ( auto& isReaderOpened : isOpened ) {
+        const auto connectionName = QString( "challenge.reader.%1" ).arg( static_cast<qlonglong>( nextReaderId++ ) );
+        m_readers.emplace_back( [this, connectionName, &isReaderOpened]{ runReader( connectionName, isReaderOpened ); } );
+    }
+
+    bool areAllOpened = true;
+    for ( auto& isReaderOpened : isOpened ) {
+        areAllOpened = isReaderOpened.get_future().get() && areAllOpened;
+    }
+
+    if ( !areAllOpened ) {
+        stopReaders();
+        throw std::runtime_error("Cannot open readers of database");
+    }
+}
+
+SqliteReaderPool::~SqliteReaderPool() {
+    stopReaders();
+}
+
+void
+SqliteReaderPool::read( ReadTask _task ) {
+    assert( _task );
+
+    std::packaged_task<void(QSqlQuery&)> task( std::move( _task ) );
+    auto isDone = task.get_future();
+    {
+        std::lock_guard lock(m_tasksMutex);
+        m_tasks.push_back( std::move( task ) );
+    }
+    m_tasksCondition.notify_one();
+
+    isDone.get();
+}
+
+void
+SqliteReaderPool::runReader( const QString& _connectionName, std::promise<bool>& _isOpened ) {
+    {
+        auto database = QSqlDatabase::addDatabase( "QSQLITE", _connectionName );
+        database.setDatabaseName( m_absPathToDbFile );
+        database.setConnectOptions( "QSQLITE_OPEN_READONLY" );
+
+        if ( !database.open() ) {
+            LOG_ERROR( database.lastError().text().toStdString().c_str() );
+            _isOpened.set_value( false );
+        } else {
+            QSqlQuery readStatement( database );
+            const bool isReady = setupReader( readStatement );
+            _isOpened.set_value( isReady );
+
+            if ( isReady ) {
+                serveReads( readStatement );
+            }
+        }
+    }
+
+    // connection can be removed only when no object uses it
+    QSqlDatabase::removeDatabase( _connectionName );
+}
+
+bool
+SqliteReaderPool::setupReader( QSqlQuery& _readStatement ) {
+    for ( const auto& setupStatement : m_setupStatements ) {
+        if ( !_readStatement.exec( setupStatement ) ) {
+            LOG_ERROR( _readStatement.lastError().text().toStdString().c_str() );
+            return false;
+        }
+    }
+
+    _readStatement.setForwardOnly(true);
+    if ( !_readStatement.prepare( m_readStatement ) ) {
+        LOG_ERROR( _readStatement.lastError().text().toStdString().c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+void
+SqliteReaderPool::serveReads( QSqlQuery& _readStatement ) {
+    for (;;) {
+        std::unique_lock lock(m_tasksMutex);
+        m_tasksCondition.wait( lock, [this]{ return m_isStopped || !m_tasks.empty(); } );
+
+        if ( m_tasks.empty() ) {
+            return;
+        }
+
+        auto task = std::move( m_tasks.front() );
+        m_tasks.pop_front();
+        lock.unlock();
+
+        task( _readStatement );
+        // reset statement does not hold read transaction, so checkpoint of write ahead log is not blocked
+        _readStatement.finish();
+    }
+}
+
+void
+SqliteReaderPool::stopReaders() {
+    {
+        std::lock_guard lock(m_tasksMutex);
+        m_isStopped = true;
+    }
+    m_tasksCondition.notify_all();
+
+    for ( auto& reader : m_readers ) {
+        reader.join();
+    }
+    m_readers.clear();
+}
+
+} // namespace Challenge::EventsStorage
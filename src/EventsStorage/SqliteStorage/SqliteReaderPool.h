@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QString>
+#include <QtSql/QSqlQuery>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Challenge::EventsStorage {
+
+    //! Read-only connections to sqlite database file, each of them owned by own thread
+    /*!
+     *  Qt allows to use connection only in thread which created it, so every reader opens, uses and closes its
+     *  connection in its own thread. Read is passed to the first free reader and caller waits for it. In write ahead
+     *  log mode readers do not block the writer nor each other, so range reads of many clients run in parallel.
+     */
+    class SqliteReaderPool {
+    public:
+        //! Task reading database by prepared statement of reader, statement is finished after the task
+        using ReadTask = std::function<void(QSqlQuery& _readStatement)>;
+
+        //! Constructor
+        /*!
+         *
+         * @param _absPathToDbFile database file, it has to exist
+         * @param _numberOfReaders number of connections and their threads
+         * @param _readStatement statement prepared once by every reader
+         * @param _setupStatements statements executed by every reader after its connection is opened, e.g. pragmas
+         * @throw std::runtime_error if any reader cannot open database
+         */
+        SqliteReaderPool( const std::string& _absPathToDbFile, std::size_t _numberOfReaders
+                        , const QString& _readStatement, const std::vector<QString>& _setupStatements );
+        ~SqliteReaderPool();
+
+        SqliteReaderPool(const SqliteReaderPool &) = delete;
+        SqliteReaderPool(SqliteReaderPool &&) = delete;
+        SqliteReaderPool &operator=(SqliteReaderPool &) = delete;
+        SqliteReaderPool &operator=(SqliteReaderPool &&) = delete;
+
+        //! Runs task in thread of free reader, returns when the task is done
+        void read( ReadTask _task );
+
+    private:
+        //! Body of reader thread, connection lives only in this thread
+        void runReader( const QString& _connectionName, std::promise<bool>& _isOpened );
+        //! Executes setup statements and prepares read statement on opened connection
+        bool setupReader( QSqlQuery& _readStatement );
+        //! Runs tasks until pool is stopped
+        void serveReads( QSqlQuery& _readStatement );
+        void stopReaders();
+
+    private:
+        const QString m_absPathToDbFile;
+        const QString m_readStatement;
+        const std::vector<QString> m_setupStatements;
+
+        std::deque<std::packaged_task<void(QSqlQuery&)>> m_tasks;
+        bool m_isStopped = false;
+        std::mutex m_tasksMutex;
+        std::condition_variable m_tasksCondition;
+
+        std::vector<std::thread> m_readers;
+    };
+
+} // namespace Challenge::EventsStorage
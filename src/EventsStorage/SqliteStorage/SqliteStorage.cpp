@@ -1,5 +1,6 @@
 #include "SqliteStorage.h"
 
+#include "Configuration/Defines.h"
 #include "Lib/Log/Logger.h"
 
 #include <QtSql/QSqlQuery>
@@ -7,161 +8,644 @@
 #include <QString>
 #include <QVariant>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <iterator>
+#include <limits>
 #include <stdexcept>
 
 namespace Challenge::EventsStorage {
 
-    //table events(id,text,timestamp(time from epoch),priority)
+    //table events(id,text,timestamp(time from epoch),priority,seq)
+    // seq is number of event, storage assigns it densely from 0, so range of events is read exactly by unique index
     constexpr auto SQL_CREATE_EVENTS_TABLE =
             "CREATE TABLE IF NOT EXISTS events (id INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE NOT NULL, text TEXT NOT NULL, timestamp INTEGER NOT NULL, priority INTEGER NOT NULL)";
 
-    constexpr auto SQL_INSERT_EVENT = "INSERT INTO events(text,timestamp,priority) "
-                                      "VALUES(?,?,?)";
+    constexpr auto SQL_ADD_SEQ_COLUMN = "ALTER TABLE events ADD COLUMN seq INTEGER";
 
-    constexpr auto SQL_GET_NUMBER_OF_EVENTS = "SELECT COUNT(id) FROM events";
+    constexpr auto SQL_CREATE_SEQ_INDEX = "CREATE UNIQUE INDEX IF NOT EXISTS events_seq ON events(seq)";
 
-    constexpr auto SQL_GET_EVENTS = "SELECT text,timestamp,priority FROM events WHERE id >= ? AND id <= ?";
+    constexpr auto SQL_GET_SCHEMA_VERSION = "PRAGMA user_version";
 
+    constexpr auto SQL_SET_SCHEMA_VERSION = "PRAGMA user_version = 1";
+
+    //! Version 0 is table without seq column, created by previous versions of storage
+    constexpr auto SCHEMA_VERSION_WITH_SEQ = 1;
+
+    //! Order of ids is order of saving, numbering is computed once for whole table and looked up by id
+    constexpr auto SQL_NUMBER_EVENTS =
+            "WITH numbering AS (SELECT id, ROW_NUMBER() OVER (ORDER BY id) - 1 AS seq FROM events) "
+            "UPDATE events SET seq = (SELECT numbering.seq FROM numbering WHERE numbering.id = events.id)";
+
+    constexpr auto SQL_INSERT_EVENT = "INSERT INTO events(seq,text,timestamp,priority) "
+                                      "VALUES(?,?,?,?)";
+
+    //! Events removed outside of storage leave gaps, so number of events is the next seq, not count of rows
+    constexpr auto SQL_GET_NUMBER_OF_EVENTS = "SELECT COALESCE(MAX(seq) + 1, 0) FROM events";
+
+    // index on seq is not covering, rows are clustered by id which grows with seq, so rows of range are read from
+    // neighbouring pages and text is not stored twice
+    constexpr auto SQL_GET_EVENTS = "SELECT text,timestamp,priority FROM events WHERE seq >= ? AND seq <= ? ORDER BY seq";
+
+    constexpr auto SQL_SET_JOURNAL_MODE = "PRAGMA journal_mode = %1";
+
+    constexpr auto SQL_SET_SYNCHRONOUS = "PRAGMA synchronous = %1";
+
+    //! Negative cache size is in KiB, positive one is in pages
+    constexpr auto SQL_SET_CACHE_SIZE = "PRAGMA cache_size = -%1";
+
+    constexpr auto SQL_SET_MMAP_SIZE = "PRAGMA mmap_size = %1";
+
+    //! Size of page cache of durable and fast profiles
+    constexpr uint32_t TUNED_CACHE_SIZE_KIB = 16 * 1024;
+
+    //! Events are read by range scan, so the whole database file of usual size is mapped
+    constexpr uint64_t TUNED_MMAP_SIZE = 256 * 1024 * 1024;
+
+    //! Number of clients which read history of events at the same time without waiting for each other
+    constexpr std::size_t TUNED_NUMBER_OF_READERS = 4;
+
+
+    namespace {
+        //! Connections of all storages are registered in one Qt registry, so their names have to be unique
+        std::atomic<uint64_t> nextWriterId{ 0 };
+
+        //! Reads event from current row of query created with SQL_GET_EVENTS
+        EventData readEvent( const QSqlQuery& _query ) {
+            QString text = _query.value(0).toString();
+            uint64_t  timestamp = _query.value(1).toULongLong();
+            uint32_t priority = _query.value(2).toUInt();
+
+            std::chrono::time_point<std::chrono::system_clock> time( std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(timestamp) ) );
+            return EventData{time, text.toStdString(), priority};
+        }
+
+        //! Reads range of events by query prepared with SQL_GET_EVENTS, the query is finished
+        std::optional<IEventsStorage::Events> readRange( QSqlQuery& _query, qlonglong _firstEvent, qlonglong _lastEvent ) {
+            _query.bindValue( 0, QVariant::fromValue( _firstEvent ));
+            _query.bindValue( 1, QVariant::fromValue( _lastEvent ));
+
+            if ( !_query.exec() ) {
+                LOG_ERROR( _query.lastError().text().toStdString().c_str() );
+                _query.finish();
+                return std::nullopt;
+            }
+
+            IEventsStorage::Events events;
+            while ( _query.next() ) {
+                events.push_back( readEvent( _query ) );
+            }
+            // reset statement does not hold read transaction until next call
+            _query.finish();
+
+            return std::move(events);
+        }
+    } // namespace
 
     template<>
-    std::shared_ptr<IEventsStorage> IEventsStorage::create<>() try {
+    std::shared_ptr<IEventsStorage> IEventsStorage::create<SqliteEngine>( SqliteEngine _engine ) try {
         constexpr auto DB_FILE_ABS_PATH = "/tmp/challenge.db";
-        return std::unique_ptr<IEventsStorage>( new SqliteStorage(DB_FILE_ABS_PATH) );
+        SqliteStorage::GroupCommitSettings groupCommit{ STORAGE_GROUP_COMMIT_MAX_BATCH_SIZE, STORAGE_GROUP_COMMIT_MAX_DELAY
+                                                      , _engine.maxQueueSize, _engine.policy };
+        // event is acknowledged to client after commit, so commit has to survive power loss
+        return std::unique_ptr<IEventsStorage>( new SqliteStorage(DB_FILE_ABS_PATH, groupCommit, SqliteStorage::TuningSettings::durable()) );
 
     } catch ( std::exception& _exception ) {
         LOG_ERROR( _exception.what() );
         return nullptr;
     }
 
+    template<>
+    std::shared_ptr<IEventsStorage> IEventsStorage::create<>() {
+        return create( SqliteEngine{} );
+    }
+
     template std::shared_ptr<Challenge::EventsStorage::IEventsStorage> Challenge::EventsStorage::IEventsStorage::create();
 
-SqliteStorage::SqliteStorage( std::experimental::filesystem::path _absPathToDbFile ) {
+SqliteStorage::TuningSettings
+SqliteStorage::TuningSettings::compatible() {
+    return TuningSettings{};
+}
+
+SqliteStorage::TuningSettings
+SqliteStorage::TuningSettings::durable() {
+    return TuningSettings{ JournalMode::Wal, Synchronous::Full, TUNED_CACHE_SIZE_KIB, TUNED_MMAP_SIZE, TUNED_NUMBER_OF_READERS };
+}
+
+SqliteStorage::TuningSettings
+SqliteStorage::TuningSettings::fast() {
+    return TuningSettings{ JournalMode::Wal, Synchronous::Normal, TUNED_CACHE_SIZE_KIB, TUNED_MMAP_SIZE, TUNED_NUMBER_OF_READERS };
+}
+
+SqliteStorage::SqliteStorage( std::experimental::filesystem::path _absPathToDbFile )
+    : SqliteStorage( std::move(_absPathToDbFile), GroupCommitSettings{} ) {
+}
+
+SqliteStorage::SqliteStorage( std::experimental::filesystem::path _absPathToDbFile, GroupCommitSettings _groupCommit )
+    : SqliteStorage( std::move(_absPathToDbFile), _groupCommit, TuningSettings{} ) {
+}
+
+SqliteStorage::SqliteStorage( std::experimental::filesystem::path _absPathToDbFile, GroupCommitSettings _groupCommit, TuningSettings _tuning )
+    : m_groupCommitSettings( _groupCommit )
+    , m_writes( _groupCommit.maxQueueSize, _groupCommit.fullQueuePolicy ) {
     if ( !_absPathToDbFile.is_absolute() ) {
         throw std::runtime_error( "Path to file is not absolute" );
     }
-    initializeDatabase(_absPathToDbFile.c_str());
+    openDatabase(_absPathToDbFile.c_str(), _tuning);
+}
 
-    assert( m_database.isValid() );
-    assert( m_database.isOpen() );
+SqliteStorage::SqliteStorage() : SqliteStorage( GroupCommitSettings{} ) {
 }
 
-SqliteStorage::SqliteStorage() {
-    initializeDatabase(":memory:");
-    assert( m_database.isValid() );
-    assert(m_database.isOpen());
+SqliteStorage::SqliteStorage( GroupCommitSettings _groupCommit ) : SqliteStorage( _groupCommit, TuningSettings{} ) {
+}
+
+SqliteStorage::SqliteStorage( GroupCommitSettings _groupCommit, TuningSettings _tuning )
+    : m_groupCommitSettings( _groupCommit )
+    , m_writes( _groupCommit.maxQueueSize, _groupCommit.fullQueuePolicy ) {
+    openDatabase(":memory:", _tuning);
+}
+
+SqliteStorage::~SqliteStorage() {
+    m_readerPool.reset();
+    stopWriter();
 }
 
 void
-SqliteStorage::initializeDatabase( const std::string& _sqliteName ) {
+SqliteStorage::openDatabase( const std::string& _sqliteName, const TuningSettings& _tuning ) {
     assert( !_sqliteName.empty() );
 
-    const QString driver("QSQLITE");
-
-    if ( !QSqlDatabase::isDriverAvailable( driver ) ) {
+    if ( !QSqlDatabase::isDriverAvailable( "QSQLITE" ) ) {
         throw std::runtime_error("Sqlite driver is not available");
     }
 
-    m_database  = QSqlDatabase::addDatabase(driver);
+    m_connectionName = QString( "challenge.writer.%1" ).arg( static_cast<qlonglong>( nextWriterId++ ) );
+
+    std::promise<void> isOpened;
+    auto isWriterOpened = isOpened.get_future();
+    m_writer = std::thread( [this, _sqliteName, _tuning, &isOpened]{ runWriter( _sqliteName, _tuning, isOpened ); } );
+
+    try {
+        // exception of database initialization is passed from writer thread
+        isWriterOpened.get();
+    } catch ( ... ) {
+        m_writer.join();
+        throw;
+    }
+
+    if ( _sqliteName != ":memory:" && _tuning.numberOfReaders > 0 ) {
+        try {
+            openReaders( _sqliteName, _tuning );
+        } catch ( ... ) {
+            stopWriter();
+            throw;
+        }
+    }
+}
+
+void
+SqliteStorage::runWriter( const std::string& _sqliteName, const TuningSettings& _tuning, std::promise<void>& _isOpened ) {
+    {
+        m_database = QSqlDatabase::addDatabase( "QSQLITE", m_connectionName );
+
+        bool isInitialized = false;
+        try {
+            initializeDatabase( _sqliteName, _tuning );
+            isInitialized = true;
+        } catch ( ... ) {
+            _isOpened.set_exception( std::current_exception() );
+        }
+
+        if ( isInitialized ) {
+            _isOpened.set_value();
+            serveWrites();
+        }
+
+        m_insertEventQuery.reset();
+        m_getEventsQuery.reset();
+        m_database.close();
+        m_database = QSqlDatabase();
+    }
+
+    // connection can be removed only when no object uses it
+    QSqlDatabase::removeDatabase( m_connectionName );
+}
+
+void
+SqliteStorage::serveWrites() {
+    std::vector<PendingWrite> writes;
+
+    for (;;) {
+        std::unique_lock lock( m_writerMutex );
+        m_writerCondition.wait( lock, [this]{ return m_isWriterStopped || !m_tasks.empty() || !m_writes.isEmpty(); } );
+
+        // reads do not wait for batch which still collects events
+        if ( !m_tasks.empty() ) {
+            auto task = std::move( m_tasks.front() );
+            m_tasks.pop_front();
+            lock.unlock();
+
+            task();
+            continue;
+        }
+
+        // queued events are written also when storage is being destroyed
+        if ( m_writes.isEmpty() ) {
+            return;
+        }
+
+        // the first queued write waits for next ones until batch is full or its deadline expires
+        const auto isBatchFull = [this]{ return m_writes.getNumberOfEvents() >= m_groupCommitSettings.maxBatchSize; };
+        if ( !isBatchFull() && !m_isWriterStopped && std::chrono::steady_clock::now() < m_writes.front().deadline ) {
+            m_writerCondition.wait_until( lock, m_writes.front().deadline, [this, &isBatchFull]{
+                return m_isWriterStopped || !m_tasks.empty() || isBatchFull();
+            });
+            continue;
+        }
+
+        m_writes.takeBatch( m_groupCommitSettings.maxBatchSize, writes );
+        lock.unlock();
+        m_writesNotFullCondition.notify_all();
+
+        writeBatch( writes );
+        writes.clear();
+    }
+}
+
+void
+SqliteStorage::stopWriter() {
+    if ( !m_writer.joinable() ) {
+        return;
+    }
+
+    {
+        std::lock_guard lock( m_writerMutex );
+        m_isWriterStopped = true;
+    }
+    m_writerCondition.notify_all();
+    m_writer.join();
+}
+
+void
+SqliteStorage::enqueueWrite( Events _events, SaveCompletion _completion ) {
+    assert( !_events.empty() );
+    assert( _completion );
+
+    PendingWrite write;
+    write.events = std::move( _events );
+    write.completion = std::move( _completion );
+    write.deadline = std::chrono::steady_clock::now() + m_groupCommitSettings.maxDelay;
+
+    // completions of rejected or shed writes are fired after queue is unlocked
+    std::vector<PendingWrite> notQueuedWrites;
+    {
+        std::unique_lock lock( m_writerMutex );
+        notQueuedWrites = m_writes.push( std::move( write ), lock, m_writesNotFullCondition );
+    }
+    m_writerCondition.notify_one();
+
+    for ( auto& notQueuedWrite : notQueuedWrites ) {
+        notQueuedWrite.completion( 0 );
+    }
+}
+
+std::size_t
+SqliteStorage::saveAndWait( Events _events ) {
+    std::promise<std::size_t> numberOfSavedEvents;
+    auto result = numberOfSavedEvents.get_future();
+
+    enqueueWrite( std::move( _events ), [&numberOfSavedEvents]( std::size_t _numberOfSavedEvents ){
+        numberOfSavedEvents.set_value( _numberOfSavedEvents );
+    });
+
+    return result.get();
+}
+
+void
+SqliteStorage::runInWriter( std::function<void()> _task ) const {
+    assert( _task );
+
+    std::packaged_task<void()> task( std::move( _task ) );
+    auto isDone = task.get_future();
+    {
+        std::lock_guard lock( m_writerMutex );
+        m_tasks.push_back( std::move( task ) );
+    }
+    m_writerCondition.notify_one();
+
+    isDone.get();
+}
+
+void
+SqliteStorage::writeBatch( std::vector<PendingWrite>& _writes ) {
+    assert( !_writes.empty() );
+
+    std::vector<const EventData*> events;
+    for ( const auto& write : _writes ) {
+        std::transform( write.events.begin(), write.events.end(), std::back_inserter( events ), []( const auto& _event ){ return &_event; } );
+    }
+
+    // all writes share one transaction, so either all or none of them are saved
+    const bool result = commitBatch( events );
+    if ( result ) {
+        ++m_transactions;
+        m_savedEvents += events.size();
+        m_publisher.publish( m_numberOfEvents );
+    }
+
+    for ( auto& write : _writes ) {
+        write.completion( result ? write.events.size() : 0 );
+    }
+}
+
+void
+SqliteStorage::initializeDatabase( const std::string& _sqliteName, const TuningSettings& _tuning ) {
     m_database.setDatabaseName(_sqliteName.c_str());
 
     if ( !m_database.open() ) {
         throw std::runtime_error("Cannot open sqlite db database");
     }
 
-    QSqlQuery queryCreateEventsTable(m_database);
-    queryCreateEventsTable.prepare(SQL_CREATE_EVENTS_TABLE);
-    if ( !queryCreateEventsTable.exec() ) {
-        throw std::runtime_error( queryCreateEventsTable.lastError().text().toStdString() + " Cannot create events table");
+    tuneDatabase( _sqliteName == ":memory:", _tuning );
+
+    QSqlQuery querySchemaVersion( SQL_GET_SCHEMA_VERSION, m_database );
+    if ( !querySchemaVersion.isActive() || !querySchemaVersion.next() ) {
+        throw std::runtime_error( querySchemaVersion.lastError().text().toStdString() + " Cannot read schema version");
+    }
+
+    if ( querySchemaVersion.value(0).toInt() < SCHEMA_VERSION_WITH_SEQ ) {
+        querySchemaVersion.finish();
+        migrateDatabase();
+    }
+
+    // number of events is counted once, later it is maintained by write path
+    QSqlQuery queryNumberOfEvents( SQL_GET_NUMBER_OF_EVENTS, m_database );
+    if ( !queryNumberOfEvents.isActive() || !queryNumberOfEvents.next() ) {
+        throw std::runtime_error( queryNumberOfEvents.lastError().text().toStdString() + " Cannot count events");
+    }
+    m_numberOfEvents = queryNumberOfEvents.value(0).toULongLong();
+    queryNumberOfEvents.finish();
+
+    prepareStatements();
+}
+
+void
+SqliteStorage::tuneDatabase( bool _isInMemory, const TuningSettings& _tuning ) {
+    QSqlQuery query(m_database);
+
+    if ( !_isInMemory ) {
+        const auto journalMode = _tuning.journalMode == TuningSettings::JournalMode::Wal ? "wal" : "delete";
+        // sqlite answers with journal mode which is really used, e.g. file system may not support wal
+        if ( !query.exec( QString( SQL_SET_JOURNAL_MODE ).arg( QString( journalMode ) ) ) || !query.next()
+             || query.value(0).toString() != QString( journalMode ) ) {
+            throw std::runtime_error( query.lastError().text().toStdString() + " Cannot set journal mode");
+        }
+        query.finish();
+    }
+
+    const auto synchronous = _tuning.synchronous == TuningSettings::Synchronous::Off ? "OFF"
+                           : _tuning.synchronous == TuningSettings::Synchronous::Normal ? "NORMAL"
+                           : "FULL";
+    if ( !query.exec( QString( SQL_SET_SYNCHRONOUS ).arg( QString( synchronous ) ) ) ) {
+        throw std::runtime_error( query.lastError().text().toStdString() + " Cannot set synchronous level");
+    }
+
+    if ( _tuning.cacheSizeKiB > 0 && !query.exec( QString( SQL_SET_CACHE_SIZE ).arg( _tuning.cacheSizeKiB ) ) ) {
+        throw std::runtime_error( query.lastError().text().toStdString() + " Cannot set cache size");
+    }
+
+    // sqlite may limit size of memory map by its compile time maximum, so the answer is not checked
+    if ( !query.exec( QString( SQL_SET_MMAP_SIZE ).arg( static_cast<qlonglong>( _tuning.mmapSize ) ) ) ) {
+        throw std::runtime_error( query.lastError().text().toStdString() + " Cannot set memory map size");
+    }
+    query.finish();
+}
+
+void
+SqliteStorage::prepareStatements() {
+    m_insertEventQuery = std::make_unique<QSqlQuery>( m_database );
+    if ( !m_insertEventQuery->prepare( SQL_INSERT_EVENT ) ) {
+        throw std::runtime_error( m_insertEventQuery->lastError().text().toStdString() + " Cannot prepare insert of event");
+    }
+
+    m_getEventsQuery = std::make_unique<QSqlQuery>( m_database );
+    m_getEventsQuery->setForwardOnly(true);
+    if ( !m_getEventsQuery->prepare( SQL_GET_EVENTS ) ) {
+        throw std::runtime_error( m_getEventsQuery->lastError().text().toStdString() + " Cannot prepare reading of events");
+    }
+}
+
+void
+SqliteStorage::openReaders( const std::string& _sqliteName, const TuningSettings& _tuning ) {
+    // with rollback journal readers would block commits of the writer
+    if ( _tuning.journalMode != TuningSettings::JournalMode::Wal ) {
+        throw std::runtime_error( "Readers require write ahead log" );
+    }
+
+    // page cache and memory map are settings of connection, not of database file
+    std::vector<QString> readerSetup{ QString( SQL_SET_MMAP_SIZE ).arg( static_cast<qlonglong>( _tuning.mmapSize ) ) };
+    if ( _tuning.cacheSizeKiB > 0 ) {
+        readerSetup.push_back( QString( SQL_SET_CACHE_SIZE ).arg( _tuning.cacheSizeKiB ) );
+    }
+
+    m_readerPool = std::make_unique<SqliteReaderPool>( _sqliteName, _tuning.numberOfReaders, SQL_GET_EVENTS, readerSetup );
+}
+
+void
+SqliteStorage::migrateDatabase() {
+    if ( !m_database.transaction() ) {
+        throw std::runtime_error( m_database.lastError().text().toStdString() + " Cannot start transaction");
     }
 
+    QSqlQuery query(m_database);
+    const bool isMigrated = query.exec( SQL_CREATE_EVENTS_TABLE )
+                            && query.exec( SQL_ADD_SEQ_COLUMN )
+                            && query.exec( SQL_NUMBER_EVENTS )
+                            && query.exec( SQL_CREATE_SEQ_INDEX )
+                            && query.exec( SQL_SET_SCHEMA_VERSION );
+
+    if ( !isMigrated || !m_database.commit() ) {
+        const auto error = query.lastError().text().toStdString();
+        m_database.rollback();
+        throw std::runtime_error( error + " Cannot migrate events table");
+    }
 }
 
 bool
 SqliteStorage::saveEvent( const EventData& _event ) {
-    assert( m_database.open() );
+    return saveAndWait( Events{ _event } ) == 1;
+}
 
-    QSqlQuery query(m_database);
-    query.prepare( SQL_INSERT_EVENT );
+std::size_t
+SqliteStorage::saveEvents( const Events& _events ) {
+    if ( _events.empty() ) {
+        return 0;
+    }
+    return saveAndWait( _events );
+}
 
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(_event.timeStamp.time_since_epoch() ).count();
+void
+SqliteStorage::saveEventAsync( EventData _event, SaveCompletion _completion ) {
+    Events events;
+    events.push_back( std::move( _event ) );
+    enqueueWrite( std::move( events ), std::move( _completion ) );
+}
 
-    query.addBindValue( QString::fromStdString( _event.text ) );
-    query.addBindValue( QVariant::fromValue(timestamp) );
-    query.addBindValue( QVariant::fromValue(_event.priority) );
+void
+SqliteStorage::saveEventsAsync( Events _events, SaveCompletion _completion ) {
+    if ( _events.empty() ) {
+        _completion( 0 );
+        return;
+    }
+    enqueueWrite( std::move( _events ), std::move( _completion ) );
+}
 
-    if(!query.exec()) {
-        LOG_ERROR( query.lastError().text().toStdString().c_str() );
+bool
+SqliteStorage::commitBatch( const std::vector<const EventData*>& _events ) {
+    assert( !_events.empty() );
+
+    // events are numbered only when they are committed, failed write does not leave a gap
+    if ( _events.size() == 1 ) {
+        if ( !insertEvent( *_events.front(), m_numberOfEvents ) ) {
+            return false;
+        }
+        ++m_numberOfEvents;
+        return true;
+    }
+
+    if ( !m_database.transaction() ) {
+        LOG_ERROR( m_database.lastError().text().toStdString().c_str() );
         return false;
     }
 
-    std::lock_guard lock(m_callbackMutex);
-    for ( auto& callback : m_callbacks ) {
-        assert(callback.second);
-        callback.second();
+    auto seq = m_numberOfEvents.load();
+    for ( auto event : _events ) {
+        assert( event );
+        if ( !insertEvent( *event, seq++ ) ) {
+            m_database.rollback();
+            return false;
+        }
+    }
+
+    if ( !m_database.commit() ) {
+        LOG_ERROR( m_database.lastError().text().toStdString().c_str() );
+        m_database.rollback();
+        return false;
     }
+
+    m_numberOfEvents += _events.size();
     return true;
 }
 
+bool
+SqliteStorage::insertEvent( const EventData& _event, uint64_t _seq ) {
+    assert( m_database.isOpen() );
+    assert( m_insertEventQuery );
+
+    auto& query = *m_insertEventQuery;
+
+    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(_event.timeStamp.time_since_epoch() ).count();
+
+    // statement is reused, so values are bound by position instead of appended
+    query.bindValue( 0, QVariant::fromValue( static_cast<qlonglong>( _seq ) ) );
+    query.bindValue( 1, QString::fromStdString( _event.text ) );
+    query.bindValue( 2, QVariant::fromValue(timestamp) );
+    query.bindValue( 3, QVariant::fromValue(_event.priority) );
+
+    const bool result = query.exec();
+    if ( !result ) {
+        LOG_ERROR( query.lastError().text().toStdString().c_str() );
+    }
+    query.finish();
+
+    return result;
+}
+
 std::optional<IEventsStorage::Events>
 SqliteStorage::getSavedEvents(uint64_t _firstEvent, uint64_t _lastEvent) const {
     if ( _firstEvent > _lastEvent ) {
         return std::nullopt;
     }
 
-    // SQL count from 1, we count events from 0
-    auto firstEvent = _firstEvent + 1;
-    auto lastEvent = _lastEvent == LAST_EVENT_NUMBER ? LAST_EVENT_NUMBER : _lastEvent + 1;
+    // sqlite integers are signed
+    auto firstEvent = static_cast<qlonglong>( std::min<uint64_t>( _firstEvent, std::numeric_limits<qlonglong>::max() ) );
+    auto lastEvent = static_cast<qlonglong>( std::min<uint64_t>( _lastEvent, std::numeric_limits<qlonglong>::max() ) );
 
-    QSqlQuery query(m_database);
-    query.prepare(SQL_GET_EVENTS);
-    query.addBindValue( QVariant::fromValue( firstEvent ));
-    query.addBindValue( QVariant::fromValue( lastEvent ));
+    return readEvents( firstEvent, lastEvent );
+}
 
-    if ( !query.exec() ) {
-        LOG_ERROR( query.lastError().text().toStdString().c_str() );
-        return std::nullopt;
+std::optional<IEventsStorage::Events>
+SqliteStorage::readEvents( qlonglong _firstEvent, qlonglong _lastEvent ) const {
+    std::optional<IEventsStorage::Events> events;
+    auto readTask = [&events, _firstEvent, _lastEvent]( QSqlQuery& _query ) {
+        events = readRange( _query, _firstEvent, _lastEvent );
+    };
+
+    if ( m_readerPool ) {
+        m_readerPool->read( readTask );
+    } else {
+        runInWriter( [this, &readTask]{ readTask( *m_getEventsQuery ); } );
     }
+    return events;
+}
 
-    IEventsStorage::Events events;
-    while ( query.next() ) {
-        QString text = query.value(0).toString();
-        uint64_t  timestamp = query.value(1).toULongLong();
-        uint32_t priority = query.value(2).toUInt();
+bool
+SqliteStorage::visitSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent, std::size_t _chunkSize, EventsChunkVisitor _visitor ) const {
+    assert( _chunkSize > 0 );
+    assert( _visitor );
 
-        std::chrono::time_point<std::chrono::system_clock> time( std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(timestamp) ) );
-        // I have no time to fight now with emplace_back and chrono, at now it is passed by copy
-        EventData data{time, text.toStdString(), priority};
-        events.push_back( std::move(data) );
+    if ( _firstEvent > _lastEvent ) {
+        return false;
     }
 
-    return std::move(events);
-}
+    // sqlite integers are signed
+    const auto firstEvent = static_cast<qlonglong>( std::min<uint64_t>( _firstEvent, std::numeric_limits<qlonglong>::max() ) );
+    const auto numberOfEvents = static_cast<qlonglong>( std::min<uint64_t>( m_numberOfEvents, std::numeric_limits<qlonglong>::max() ) );
+    const auto lastEvent = std::min( static_cast<qlonglong>( std::min<uint64_t>( _lastEvent, std::numeric_limits<qlonglong>::max() ) ), numberOfEvents - 1 );
+    const auto chunkSize = static_cast<qlonglong>( std::min<std::size_t>( _chunkSize, std::numeric_limits<qlonglong>::max() ) );
 
-std::optional<uint64_t>
-SqliteStorage::getNumberOfEvents() const {
-    QSqlQuery query( SQL_GET_NUMBER_OF_EVENTS, m_database);
-
-    if ( !query.isActive() ) {
-        LOG_ERROR( query.lastError().text().toStdString().c_str() );
-        return std::nullopt;
+    if ( firstEvent > lastEvent ) {
+        _visitor( IEventsStorage::Events(), true );
+        return true;
     }
 
-    if ( !query.next() ) {
-        return std::nullopt;
+    // events are numbered densely, so every chunk is read by own range query and neither reader nor writer waits for
+    // the visitor, events committed during the visit are not visited
+    for ( auto firstEventOfChunk = firstEvent;; ) {
+        const auto lastEventOfChunk = lastEvent - firstEventOfChunk < chunkSize ? lastEvent : firstEventOfChunk + chunkSize - 1;
+
+        auto chunk = readEvents( firstEventOfChunk, lastEventOfChunk );
+        if ( !chunk ) {
+            return false;
+        }
+
+        const bool isLastChunk = lastEventOfChunk == lastEvent;
+        if ( !_visitor( chunk.value(), isLastChunk ) || isLastChunk ) {
+            return true;
+        }
+        firstEventOfChunk = lastEventOfChunk + 1;
     }
+}
+
+SqliteStorage::Statistics
+SqliteStorage::getStatistics() const {
+    return Statistics{ m_transactions, m_savedEvents };
+}
 
-    return query.value(0).toULongLong();
+std::optional<uint64_t>
+SqliteStorage::getNumberOfEvents() const {
+    return m_numberOfEvents.load();
 }
 
 bool
 SqliteStorage::registerEventAddedCallback( EventSavedCallback _callback, void* _key ) {
-    std::lock_guard lock(m_callbackMutex);
-    if ( _callback == nullptr ) {
-        m_callbacks.erase(_key);
-        return true;
-    }
-    return m_callbacks.insert_or_assign( _key, _callback ).second;
+    return m_publisher.subscribe( _callback, _key );
+}
+
+void
+SqliteStorage::setCallbackExecutor( CallbackExecutor _executor ) {
+    m_publisher.setExecutor( _executor );
 }
 
 } // namespace Challenge::EventsStorage
@@ -1,40 +1,199 @@
 #pragma once
 
 #include "EventsStorage/IEventsStorage.h"
+#include "Lib/EventsPublisher/EventsPublisher.h"
+#include "Lib/WritesQueue/WritesQueue.h"
+
+#include "SqliteReaderPool.h"
 
 #include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <experimental/filesystem>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace Challenge::EventsStorage {
 
+    //! Storage of events in sqlite database
+    /*!
+     *  Qt allows to use connection only in thread which created it, so connection of writer is opened, used and
+     *  closed by own writer thread of storage. Saves of any thread are queued to the writer, reads are served by
+     *  reader pool, or by the writer when there are no readers.
+     */
     class SqliteStorage : public IEventsStorage {
         public:
+             //! Group commit configuration
+             /*!
+              *  Events saved concurrently (or within maxDelay) are collected into one batch and written in a single
+              *  transaction, so the cost of journal sync is shared by all events of the batch. Saves wait for writer
+              *  in one queue, its size limits memory of events which are not written yet.
+              */
+             struct GroupCommitSettings {
+                 //! Maximal number of events written in one transaction, 1 disables group commit
+                 std::size_t maxBatchSize = 1;
+
+                 //! Maximal time the first event of a batch waits for more events, before the batch is written
+                 std::chrono::microseconds maxDelay{ 0 };
+
+                 //! Maximal number of events waiting for writer, by default queue is not limited
+                 std::size_t maxQueueSize = std::numeric_limits<std::size_t>::max();
+                 //! What happens with saved events, when queue of writer is full
+                 FullQueuePolicy fullQueuePolicy = FullQueuePolicy::Block;
+             };
+
+             //! Counters of writes since storage was opened, events of one transaction share sync of journal
+             struct Statistics {
+                 uint64_t transactions = 0;
+                 uint64_t savedEvents = 0;
+             };
+
+             //! Tuning of sqlite connections, default values keep defaults of sqlite
+             struct TuningSettings {
+                 enum class JournalMode {
+                     Delete,
+                     Wal
+                 };
+
+                 enum class Synchronous {
+                     Off,
+                     Normal,
+                     Full
+                 };
+
+                 //! Journal of database file, database in memory keeps its own journal
+                 JournalMode journalMode = JournalMode::Delete;
+                 Synchronous synchronous = Synchronous::Full;
+                 //! Size of page cache in KiB, 0 keeps default size of sqlite
+                 uint32_t cacheSizeKiB = 0;
+                 //! Maximal number of bytes of database file read through memory map, 0 disables memory mapped reads
+                 uint64_t mmapSize = 0;
+                 //! Number of read-only connections serving range reads in parallel, they require write ahead log
+                 /*!
+                  *  With 0 ( and for database in memory, which is private to its connection ) events are read by
+                  *  connection of writer
+                  */
+                 std::size_t numberOfReaders = 0;
+
+                 //! Defaults of sqlite, rollback journal is synced on each commit
+                 static TuningSettings compatible();
+                 //! Write ahead log synced on each commit, committed events survive power loss
+                 static TuningSettings durable();
+                 //! Write ahead log synced only by checkpoint, power loss ( not crash of server ) may lose last commits
+                 static TuningSettings fast();
+             };
+
              //! constructs database working on file
              SqliteStorage( std::experimental::filesystem::path _absPathToDbFile ); // may throw std::runtime_error
+             SqliteStorage( std::experimental::filesystem::path _absPathToDbFile, GroupCommitSettings _groupCommit ); // may throw std::runtime_error
+             SqliteStorage( std::experimental::filesystem::path _absPathToDbFile, GroupCommitSettings _groupCommit, TuningSettings _tuning ); // may throw std::runtime_error
 
              //! constructs database on memory
              SqliteStorage(); // may throw std::runtime_error
-             ~SqliteStorage() override = default;
+             explicit SqliteStorage( GroupCommitSettings _groupCommit ); // may throw std::runtime_error
+             SqliteStorage( GroupCommitSettings _groupCommit, TuningSettings _tuning ); // may throw std::runtime_error
+             //! Writes all queued events before return
+             ~SqliteStorage() override;
+
+             SqliteStorage(const SqliteStorage &) = delete;
+             SqliteStorage(SqliteStorage &&) = delete;
+             SqliteStorage &operator=(SqliteStorage &) = delete;
+             SqliteStorage &operator=(SqliteStorage &&) = delete;
 
+            //! Saves event, returns when the transaction which contains the event is committed
             bool saveEvent( const EventData& _event ) override;
+            //! Saves all events in one transaction, so either all or none of them are saved
+            std::size_t saveEvents( const Events& _events ) override;
+            //! Queues event to writer and returns, completion is fired by writer thread after commit
+            /*!
+             *  When queue of writer is full, full queue policy is applied, rejected or shed event is completed with 0
+             *  before return
+             */
+            void saveEventAsync( EventData _event, SaveCompletion _completion ) override;
+            //! Queues events to writer and returns, they are written in one transaction
+            void saveEventsAsync( Events _events, SaveCompletion _completion ) override;
             std::optional<Events> getSavedEvents(uint64_t _firstEvent, uint64_t _lastEvent) const override;
+            bool visitSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent, std::size_t _chunkSize, EventsChunkVisitor _visitor ) const override;
+            //! Returns number of events counted when database was opened and updated by every committed write
             std::optional<uint64_t> getNumberOfEvents() const override;
             bool registerEventAddedCallback( EventSavedCallback _callback, void* _key ) override;
+            void setCallbackExecutor( CallbackExecutor _executor ) override;
+
+            Statistics getStatistics() const;
 
         private:
-            void initializeDatabase( const std::string& _sqliteName ); // may throw std::runtime_error
+            using PendingWrite = WritesQueue::PendingWrite;
+
+            //! Starts writer thread and waits until it opens database, opens readers
+            void openDatabase( const std::string& _sqliteName, const TuningSettings& _tuning ); // may throw std::runtime_error
+            //! Body of writer thread, connection of writer lives only in this thread
+            void runWriter( const std::string& _sqliteName, const TuningSettings& _tuning, std::promise<void>& _isOpened );
+            //! Runs reads and writes until writer is stopped and no write is queued
+            void serveWrites();
+            void stopWriter();
+            //! Queues events for writer, completion is fired by writer thread or by calling thread if events are not queued
+            void enqueueWrite( Events _events, SaveCompletion _completion );
+            //! Saves events synchronously through queue of writer
+            std::size_t saveAndWait( Events _events );
+            //! Runs task in writer thread, returns when the task is done
+            void runInWriter( std::function<void()> _task ) const;
+            //! Writes events of all writes in one transaction, then fires completions
+            void writeBatch( std::vector<PendingWrite>& _writes );
 
+            void initializeDatabase( const std::string& _sqliteName, const TuningSettings& _tuning ); // may throw std::runtime_error
+            //! Sets pragmas of connection, they have to be set before first access to database
+            void tuneDatabase( bool _isInMemory, const TuningSettings& _tuning ); // may throw std::runtime_error
+            //! Prepares statements of write and read path, which are kept for whole life of storage
+            void prepareStatements(); // may throw std::runtime_error
+            //! Opens read-only connections of database file, their pragmas are taken from tuning
+            void openReaders( const std::string& _sqliteName, const TuningSettings& _tuning ); // may throw std::runtime_error
+            //! Adds seq column to events table, existing events are numbered in order of saving
+            void migrateDatabase(); // may throw std::runtime_error
+
+            //! Inserts event with given number, number has to be the next one after committed events
+            bool insertEvent( const EventData& _event, uint64_t _seq );
+            bool commitBatch( const std::vector<const EventData*>& _events );
+            //! Reads range of events by reader pool, or by writer when there are no readers
+            std::optional<Events> readEvents( qlonglong _firstEvent, qlonglong _lastEvent ) const;
 
         private:
+            //! Connection and statements are used only by writer thread
             QSqlDatabase m_database;
-            using CallbackRegister = std::unordered_map<void*, EventSavedCallback >;
-            CallbackRegister m_callbacks;
+            QString m_connectionName;
+            //! Statements are parsed once
+            std::unique_ptr<QSqlQuery> m_insertEventQuery;
+            std::unique_ptr<QSqlQuery> m_getEventsQuery;
+            //! Range reads go to readers when they exist, connection of writer is then used only for writes
+            std::unique_ptr<SqliteReaderPool> m_readerPool;
+            std::atomic<uint64_t> m_numberOfEvents{ 0 };
+            std::atomic<uint64_t> m_transactions{ 0 };
+            std::atomic<uint64_t> m_savedEvents{ 0 };
+
+            EventsPublisher m_publisher;
+
+            const GroupCommitSettings m_groupCommitSettings;
 
-            std::mutex m_callbackMutex;
+            WritesQueue m_writes;
+            //! Other work of writer connection, e.g. reads when there are no readers
+            mutable std::deque<std::packaged_task<void()>> m_tasks;
+            bool m_isWriterStopped = false;
+            mutable std::mutex m_writerMutex;
+            mutable std::condition_variable m_writerCondition;
+            //! Savers blocked by full queue wait for writer
+            std::condition_variable m_writesNotFullCondition;
+            std::thread m_writer;
     };
 
 } // namespace Challenge::EventsStorage
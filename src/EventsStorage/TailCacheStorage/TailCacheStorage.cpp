@@ -0,0 +1,183 @@
+#include "TailCacheStorage.h"
+
+#include "Lib/Log/Logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <future>
+#include <stdexcept>
+
+namespace Challenge::EventsStorage {
+
+    template<>
+    std::shared_ptr<IEventsStorage> IEventsStorage::create<TailCacheEngine>( TailCacheEngine _engine ) try {
+        return std::shared_ptr<IEventsStorage>( new TailCacheStorage( std::move( _engine.storage ), _engine.maxEvents, _engine.maxBytes ) );
+    } catch ( std::exception& _exception ) {
+        LOG_ERROR( _exception.what() );
+        return nullptr;
+    }
+
+TailCacheStorage::TailCacheStorage( std::shared_ptr<IEventsStorage> _storage, std::size_t _maxEvents, std::size_t _maxBytes )
+    : m_storage( std::move( _storage ) )
+    , m_maxBytes( _maxBytes ) {
+    if ( !m_storage ) {
+        throw std::runtime_error( "Storage is nullptr" );
+    }
+
+    if ( _maxEvents == 0 || _maxBytes == 0 ) {
+        throw std::runtime_error( "Cache cannot be empty" );
+    }
+
+    m_ring.resize( _maxEvents );
+    // events saved before are read from decorated storage
+    m_firstCachedEvent = m_storage->getNumberOfEvents().value_or( 0 );
+}
+
+bool
+TailCacheStorage::saveEvent( const EventData& _event ) {
+    return saveEvents( Events{ _event } ) == 1;
+}
+
+std::size_t
+TailCacheStorage::saveEvents( const Events& _events ) {
+    std::promise<std::size_t> numberOfSavedEvents;
+    auto savedFuture = numberOfSavedEvents.get_future();
+    saveEventsAsync( _events, [&numberOfSavedEvents]( std::size_t _numberOfSavedEvents ){
+        numberOfSavedEvents.set_value( _numberOfSavedEvents );
+    });
+    return savedFuture.get();
+}
+
+void
+TailCacheStorage::saveEventAsync( EventData _event, SaveCompletion _completion ) {
+    Events events;
+    events.push_back( std::move( _event ) );
+    saveEventsAsync( std::move( events ), std::move( _completion ) );
+}
+
+void
+TailCacheStorage::saveEventsAsync( Events _events, SaveCompletion _completion ) {
+    assert( _completion );
+
+    // decorated storage gets copy, events of completion are moved to cache
+    auto events = _events;
+    std::lock_guard lock( m_writeMutex );
+    m_storage->saveEventsAsync( std::move( events ), [this, events = std::move( _events ), completion = std::move( _completion )]
+                                                     ( std::size_t _numberOfSavedEvents ) mutable {
+        append( events, _numberOfSavedEvents );
+        completion( _numberOfSavedEvents );
+    });
+}
+
+void
+TailCacheStorage::append( Events& _events, std::size_t _numberOfSavedEvents ) {
+    std::lock_guard lock( m_cacheMutex );
+
+    // saved events are always the first events of batch
+    for ( std::size_t event = 0; event < _numberOfSavedEvents; ++event ) {
+        if ( m_numberOfCachedEvents == m_ring.size() ) {
+            evictOldest();
+        }
+
+        auto& slot = m_ring[ ( m_firstCachedEvent + m_numberOfCachedEvents ) % m_ring.size() ];
+        slot = std::move( _events[event] );
+        ++m_numberOfCachedEvents;
+        m_cachedBytes += sizeOf( slot );
+
+        while ( m_cachedBytes > m_maxBytes ) {
+            evictOldest();
+        }
+    }
+}
+
+void
+TailCacheStorage::evictOldest() {
+    assert( m_numberOfCachedEvents > 0 );
+
+    auto& slot = m_ring[ m_firstCachedEvent % m_ring.size() ];
+    m_cachedBytes -= sizeOf( slot );
+    // text of evicted event is released, so bytes limit bounds memory of cache
+    slot = EventData();
+
+    ++m_firstCachedEvent;
+    --m_numberOfCachedEvents;
+}
+
+std::size_t
+TailCacheStorage::sizeOf( const EventData& _event ) {
+    return sizeof( EventData ) + _event.text.size();
+}
+
+std::optional<IEventsStorage::Events>
+TailCacheStorage::readCached( uint64_t _firstEvent, uint64_t _lastEvent ) const {
+    assert( _firstEvent <= _lastEvent );
+
+    // event saved by decorated storage is appended to cache just after the save, until then range is not cached
+    const auto numberOfEvents = m_storage->getNumberOfEvents();
+
+    std::lock_guard lock( m_cacheMutex );
+    const auto endOfCache = m_firstCachedEvent + m_numberOfCachedEvents;
+    if ( !numberOfEvents || numberOfEvents.value() > endOfCache || _firstEvent < m_firstCachedEvent ) {
+        ++m_misses;
+        return std::nullopt;
+    }
+
+    Events events;
+    if ( _firstEvent < endOfCache ) {
+        const auto lastEvent = std::min( _lastEvent, endOfCache - 1 );
+        events.reserve( lastEvent - _firstEvent + 1 );
+        for ( auto event = _firstEvent; event <= lastEvent; ++event ) {
+            events.push_back( m_ring[ event % m_ring.size() ] );
+        }
+    }
+
+    ++m_hits;
+    return std::move( events );
+}
+
+std::optional<IEventsStorage::Events>
+TailCacheStorage::getSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent ) const {
+    if ( _firstEvent <= _lastEvent ) {
+        auto events = readCached( _firstEvent, _lastEvent );
+        if ( events ) {
+            return events;
+        }
+    }
+    return m_storage->getSavedEvents( _firstEvent, _lastEvent );
+}
+
+bool
+TailCacheStorage::visitSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent, std::size_t _chunkSize, EventsChunkVisitor _visitor ) const {
+    assert( _chunkSize > 0 );
+    assert( _visitor );
+
+    auto events = _firstEvent <= _lastEvent ? readCached( _firstEvent, _lastEvent ) : std::nullopt;
+    if ( !events ) {
+        return m_storage->visitSavedEvents( _firstEvent, _lastEvent, _chunkSize, std::move( _visitor ) );
+    }
+
+    // cached range is copied, so visitor does not block saves
+    return visitInChunks( std::move( events.value() ), _chunkSize, _visitor );
+}
+
+std::optional<uint64_t>
+TailCacheStorage::getNumberOfEvents() const {
+    return m_storage->getNumberOfEvents();
+}
+
+bool
+TailCacheStorage::registerEventAddedCallback( EventSavedCallback _callback, void* _key ) {
+    return m_storage->registerEventAddedCallback( std::move( _callback ), _key );
+}
+
+void
+TailCacheStorage::setCallbackExecutor( CallbackExecutor _executor ) {
+    m_storage->setCallbackExecutor( std::move( _executor ) );
+}
+
+TailCacheStorage::Statistics
+TailCacheStorage::getStatistics() const {
+    return Statistics{ m_hits, m_misses };
+}
+
+} // namespace Challenge::EventsStorage
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "EventsStorage/IEventsStorage.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Challenge::EventsStorage {
+
+    //! Decorator of storage, which keeps the newest saved events in memory
+    /*!
+     *  Clients read mostly events announced by the last NEW_EVENTS_NOTIFICATION, so reads of range which is cached
+     *  are answered without decorated storage. Cached events are kept in ring of preallocated slots, event with
+     *  number n is in slot n % maxEvents. Saved events are appended to cache, the oldest ones are evicted when limit
+     *  of count or of bytes is exceeded.
+     *
+     *  All saves go to asynchronous path of decorated storage, saved events are appended to cache by its completions.
+     *  Completions are fired in order of saves, so number of saved event follows from the end of cache. Storage with
+     *  own writer thread keeps batching of writes, decorator only serializes handing of saves over to it.
+     */
+    class TailCacheStorage : public IEventsStorage {
+        public:
+            //! Counters of reads, read of range is hit when the whole range is answered by cache
+            struct Statistics {
+                uint64_t hits = 0;
+                uint64_t misses = 0;
+            };
+
+            //! Constructor
+            /*!
+             *
+             * @param _storage storage which saves events, all events have to be saved through the decorator
+             * @param _maxEvents maximal number of cached events
+             * @param _maxBytes maximal size of cached events, size of event is size of EventData and of its text
+             * @throw std::runtime_error if storage is nullptr or any limit is 0
+             */
+            TailCacheStorage( std::shared_ptr<IEventsStorage> _storage, std::size_t _maxEvents, std::size_t _maxBytes );
+            ~TailCacheStorage() override = default;
+
+            TailCacheStorage(const TailCacheStorage &) = delete;
+            TailCacheStorage(TailCacheStorage &&) = delete;
+            TailCacheStorage &operator=(TailCacheStorage &) = delete;
+            TailCacheStorage &operator=(TailCacheStorage &&) = delete;
+
+            //! Saves event by decorated storage and appends it to cache
+            bool saveEvent( const EventData& _event ) override;
+            //! Saves events by decorated storage and appends saved ones to cache
+            std::size_t saveEvents( const Events& _events ) override;
+            //! Hands event over to decorated storage, it is appended to cache before completion is fired
+            void saveEventAsync( EventData _event, SaveCompletion _completion ) override;
+            //! Hands events over to decorated storage, saved ones are appended to cache before completion is fired
+            void saveEventsAsync( Events _events, SaveCompletion _completion ) override;
+            std::optional<Events> getSavedEvents(uint64_t _firstEvent, uint64_t _lastEvent) const override;
+            bool visitSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent, std::size_t _chunkSize, EventsChunkVisitor _visitor ) const override;
+            std::optional<uint64_t> getNumberOfEvents() const override;
+            bool registerEventAddedCallback( EventSavedCallback _callback, void* _key ) override;
+            void setCallbackExecutor( CallbackExecutor _executor ) override;
+
+            Statistics getStatistics() const;
+
+        private:
+            //! Returns events of range when cache contains all of them, counts hit or miss
+            std::optional<Events> readCached( uint64_t _firstEvent, uint64_t _lastEvent ) const;
+            //! Appends saved events to the end of cache
+            void append( Events& _events, std::size_t _numberOfSavedEvents );
+            void evictOldest();
+            static std::size_t sizeOf( const EventData& _event );
+
+        private:
+            const std::shared_ptr<IEventsStorage> m_storage;
+            const std::size_t m_maxBytes;
+
+            //! Saves are handed over in order, so their completions are fired in the same order
+            std::mutex m_writeMutex;
+
+            std::vector<EventData> m_ring;
+            //! Number of the oldest cached event
+            uint64_t m_firstCachedEvent = 0;
+            std::size_t m_numberOfCachedEvents = 0;
+            std::size_t m_cachedBytes = 0;
+            mutable std::mutex m_cacheMutex;
+
+            mutable std::atomic<uint64_t> m_hits{ 0 };
+            mutable std::atomic<uint64_t> m_misses{ 0 };
+    };
+
+} // namespace Challenge::EventsStorage
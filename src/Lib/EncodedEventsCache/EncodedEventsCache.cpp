@@ -0,0 +1,80 @@
+#include "Lib/EncodedEventsCache/EncodedEventsCache.h"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace Challenge {
+
+EncodedEventsCache::EncodedEventsCache( std::size_t _maxEvents, std::size_t _maxBytes )
+    : m_maxEvents( _maxEvents )
+    , m_maxBytes( _maxBytes ) {
+    if ( _maxEvents == 0 || _maxBytes == 0 ) {
+        throw std::runtime_error( "Cache cannot be empty" );
+    }
+}
+
+std::optional<EncodedEventsCache::Entries>
+EncodedEventsCache::get( uint64_t _firstEvent, uint64_t _lastEvent ) const {
+    assert( _firstEvent <= _lastEvent );
+
+    std::lock_guard lock( m_mutex );
+
+    const auto endOfCache = m_firstEvent + m_entries.size();
+    if ( _firstEvent < m_firstEvent || _lastEvent >= endOfCache ) {
+        ++m_statistics.misses;
+        return std::nullopt;
+    }
+
+    const auto first = m_entries.begin() + ( _firstEvent - m_firstEvent );
+    Entries entries( first, first + ( _lastEvent - _firstEvent + 1 ) );
+
+    ++m_statistics.hits;
+    return std::move( entries );
+}
+
+void
+EncodedEventsCache::put( uint64_t _event, Entry _entry ) {
+    assert( _entry );
+
+    std::lock_guard lock( m_mutex );
+
+    const auto endOfCache = m_firstEvent + m_entries.size();
+    if ( _event < endOfCache && !m_entries.empty() ) {
+        return;
+    }
+
+    // cache keeps only continuous range of events
+    if ( _event != endOfCache ) {
+        m_entries.clear();
+        m_cachedBytes = 0;
+        m_firstEvent = _event;
+    }
+
+    if ( m_entries.size() == m_maxEvents ) {
+        evictOldest();
+    }
+
+    m_cachedBytes += _entry->size();
+    m_entries.push_back( std::move( _entry ) );
+
+    while ( m_cachedBytes > m_maxBytes ) {
+        evictOldest();
+    }
+}
+
+void
+EncodedEventsCache::evictOldest() {
+    assert( !m_entries.empty() );
+
+    m_cachedBytes -= m_entries.front()->size();
+    m_entries.pop_front();
+    ++m_firstEvent;
+}
+
+EncodedEventsCache::Statistics
+EncodedEventsCache::getStatistics() const {
+    std::lock_guard lock( m_mutex );
+    return m_statistics;
+}
+
+} // namespace Challenge
@@ -0,0 +1,195 @@
+#include "Lib/EventsPublisher/EventsPublisher.h"
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Challenge {
+
+    //! Shared with scheduled tasks, so task which runs after publisher was destroyed does nothing
+    class EventsPublisher::State {
+    public:
+        void publish( uint64_t _numberOfEvents );
+        void dispatch();
+        bool subscribe( Subscriber _subscriber, void* _key );
+        void setExecutor( Executor _executor );
+        void stopThread();
+
+    private:
+        void schedule();
+        void runThread();
+
+    private:
+        std::weak_ptr<State> m_self;
+        friend class EventsPublisher;
+
+        std::atomic<uint64_t> m_publishedNumberOfEvents{ 0 };
+        std::atomic<bool> m_isDispatchScheduled{ false };
+
+        std::mutex m_subscribersMutex;
+        std::unordered_map<void*, Subscriber> m_subscribers;
+        uint64_t m_dispatchedNumberOfEvents = 0;
+        bool m_isDispatching = false;
+        //! Subscribers called by running dispatch, member keeps its capacity between dispatches
+        std::vector<Subscriber> m_dispatchedSubscribers;
+        std::condition_variable m_dispatchFinishedCondition;
+
+        std::mutex m_executorMutex;
+        Executor m_executor;
+        std::condition_variable m_threadCondition;
+        std::thread m_thread;
+        bool m_isThreadNotified = false;
+        bool m_isThreadStopped = false;
+    };
+
+void
+EventsPublisher::State::publish( uint64_t _numberOfEvents ) {
+    // number of events only grows, but concurrent writers may publish in any order
+    auto publishedNumberOfEvents = m_publishedNumberOfEvents.load();
+    while ( publishedNumberOfEvents < _numberOfEvents
+            && !m_publishedNumberOfEvents.compare_exchange_weak( publishedNumberOfEvents, _numberOfEvents ) ) {
+    }
+
+    // scheduled dispatch has not started yet, it will read the new number
+    if ( m_isDispatchScheduled.exchange( true ) ) {
+        return;
+    }
+    schedule();
+}
+
+void
+EventsPublisher::State::schedule() {
+    std::unique_lock lock(m_executorMutex);
+    if ( !m_executor ) {
+        if ( !m_thread.joinable() ) {
+            m_thread = std::thread( [this]{ runThread(); } );
+        }
+        m_isThreadNotified = true;
+        m_threadCondition.notify_one();
+        return;
+    }
+
+    // executor may run task immediately, and subscriber may publish again
+    auto executor = m_executor;
+    lock.unlock();
+
+    executor( [state = m_self]{
+        if ( auto lockedState = state.lock() ) {
+            lockedState->dispatch();
+        }
+    });
+}
+
+void
+EventsPublisher::State::runThread() {
+    std::unique_lock lock(m_executorMutex);
+    for (;;) {
+        m_threadCondition.wait( lock, [this]{ return m_isThreadNotified || m_isThreadStopped; } );
+        if ( m_isThreadStopped ) {
+            return;
+        }
+        m_isThreadNotified = false;
+
+        lock.unlock();
+        dispatch();
+        lock.lock();
+    }
+}
+
+void
+EventsPublisher::State::dispatch() {
+    // numbers published from now on need next dispatch
+    m_isDispatchScheduled = false;
+
+    std::unique_lock lock(m_subscribersMutex);
+    // running dispatch reads the number again after calling subscribers, so it delivers also the newer number, e.g.
+    // when subscriber publishes and executor runs dispatch immediately
+    if ( m_isDispatching ) {
+        return;
+    }
+    m_isDispatching = true;
+
+    // number is read under lock, so concurrent dispatches never notify older number after newer one
+    for ( auto numberOfEvents = m_publishedNumberOfEvents.load();
+          numberOfEvents != m_dispatchedNumberOfEvents;
+          numberOfEvents = m_publishedNumberOfEvents.load() ) {
+        m_dispatchedNumberOfEvents = numberOfEvents;
+
+        // subscribers are called without lock, so they may publish
+        m_dispatchedSubscribers.clear();
+        for ( auto& subscriber : m_subscribers ) {
+            assert( subscriber.second );
+            m_dispatchedSubscribers.push_back( subscriber.second );
+        }
+
+        lock.unlock();
+        for ( auto& subscriber : m_dispatchedSubscribers ) {
+            subscriber( numberOfEvents );
+        }
+        lock.lock();
+    }
+
+    m_isDispatching = false;
+    m_dispatchFinishedCondition.notify_all();
+}
+
+bool
+EventsPublisher::State::subscribe( Subscriber _subscriber, void* _key ) {
+    std::unique_lock lock(m_subscribersMutex);
+    if ( _subscriber == nullptr ) {
+        m_subscribers.erase(_key);
+        // running dispatch may still call removed subscriber
+        m_dispatchFinishedCondition.wait( lock, [this]{ return !m_isDispatching; } );
+        return true;
+    }
+    return m_subscribers.insert_or_assign( _key, _subscriber ).second;
+}
+
+void
+EventsPublisher::State::setExecutor( Executor _executor ) {
+    std::lock_guard lock(m_executorMutex);
+    m_executor = _executor;
+}
+
+void
+EventsPublisher::State::stopThread() {
+    {
+        std::lock_guard lock(m_executorMutex);
+        m_isThreadStopped = true;
+        m_threadCondition.notify_one();
+    }
+
+    if ( m_thread.joinable() ) {
+        m_thread.join();
+    }
+}
+
+EventsPublisher::EventsPublisher( Executor _executor ) : m_state( std::make_shared<State>() ) {
+    m_state->m_self = m_state;
+    m_state->setExecutor( _executor );
+}
+
+EventsPublisher::~EventsPublisher() {
+    m_state->stopThread();
+}
+
+void
+EventsPublisher::setExecutor( Executor _executor ) {
+    m_state->setExecutor( _executor );
+}
+
+void
+EventsPublisher::publish( uint64_t _numberOfEvents ) {
+    m_state->publish( _numberOfEvents );
+}
+
+bool
+EventsPublisher::subscribe( Subscriber _subscriber, void* _key ) {
+    return m_state->subscribe( _subscriber, _key );
+}
+
+} // namespace Challenge
@@ -3,34 +3,84 @@
 
 #include <arpa/inet.h>
 
+#include <cassert>
+#include <cstring>
+
 namespace Challenge::PacketCoderV1 {
 
-void BytesStream::pushBytes( const BytesStream::Bytes& _bytes ) {
+void BytesStream::pushBytes( BytesView _bytes ) {
+    dropReturnedPackets();
     m_stream.insert( m_stream.end(), _bytes.begin(), _bytes.end() );
+}
+
+void
+BytesStream::dropReturnedPackets() {
+    assert( m_readOffset <= m_stream.size() );
 
+    // returned packets are dropped when they take at least half of buffer, so each byte is moved at most once
+    // in average and buffer does not grow with number of received packets
+    if ( m_readOffset == m_stream.size() ) {
+        m_stream.clear();
+        m_readOffset = 0;
+    } else if ( m_readOffset >= m_stream.size() / 2 ) {
+        m_stream.erase( m_stream.begin(), m_stream.begin() + m_readOffset );
+        m_readOffset = 0;
+    }
 }
 
-std::optional< BytesStream::Bytes >
+std::optional< BytesView >
 BytesStream::getPacket() {
-    if ( m_stream.size() < sizeof(Communication::ApplicationProtocol::PacketHeader) ) {
-        // malformed packet
-        m_stream.clear();
+    using namespace Communication::ApplicationProtocol;
+
+    const auto availableBytes = m_stream.size() - m_readOffset;
+    if ( availableBytes < sizeof(PacketHeader) ) {
+        // header is not complete yet
         return std::nullopt;
     }
 
-    auto frameHeader = reinterpret_cast< Communication::ApplicationProtocol::PacketHeader* >(m_stream.data());
-    auto firstPacketSize = ntohs(frameHeader->nboPacketLength);
+    PacketHeader frameHeader;
+    std::memcpy( &frameHeader, m_stream.data() + m_readOffset, sizeof(frameHeader) );
+    std::size_t firstPacketSize = ntohs(frameHeader.nboPacketLength);
+    std::size_t headerSize = sizeof(PacketHeader);
 
-    if ( m_stream.size() < firstPacketSize ) {
-        // malformed packet
-        m_stream.clear();
+    if ( firstPacketSize == EXTENDED_PACKET_LENGTH ) {
+        if ( availableBytes < sizeof(ExtendedPacketHeader) ) {
+            // extended header is not complete yet
+            return std::nullopt;
+        }
+
+        ExtendedPacketHeader extendedFrameHeader;
+        std::memcpy( &extendedFrameHeader, m_stream.data() + m_readOffset, sizeof(extendedFrameHeader) );
+        firstPacketSize = ntohl(extendedFrameHeader.nboPacketLength);
+        headerSize = sizeof(ExtendedPacketHeader);
+    }
+
+    if ( firstPacketSize < headerSize || firstPacketSize > MAX_PACKET_LENGTH ) {
+        // malformed packet, boundaries of next packets are unknown
+        clear();
+        return std::nullopt;
+    }
+
+    if ( availableBytes < firstPacketSize ) {
+        // packet is not complete yet
         return std::nullopt;
     }
 
-    Bytes result( m_stream.begin(), m_stream.begin() + firstPacketSize );
-    m_stream.erase( m_stream.begin(), m_stream.begin() + firstPacketSize );
+    BytesView packet( m_stream.data() + m_readOffset, firstPacketSize );
+    m_readOffset += firstPacketSize;
+
+    return packet;
+}
+
+std::size_t
+BytesStream::size() const {
+    return m_stream.size() - m_readOffset;
+}
 
-    return std::move( result );
+void
+BytesStream::clear() {
+    m_stream.clear();
+    m_readOffset = 0;
 }
 
-} // namespace Challenge::PacketCoderV1
\ No newline at end of file
+} // namespace Challenge::PacketCoderV1
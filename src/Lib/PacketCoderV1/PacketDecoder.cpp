@@ -1,10 +1,11 @@
 #include "Lib/PacketCoderV1/PacketDecoder.h"
 
-#include <exception>
+#include <cassert>
+#include <stdexcept>
 
 namespace Challenge::PacketCoderV1 {
 
-DecodedPacket::DecodedPacket( PacketBytes _bytes ) : m_bytes( std::move( _bytes ) ) {
+DecodedPacketView::DecodedPacketView( BytesView _bytes ) : m_bytes( _bytes ) {
     if ( m_bytes.size() < sizeof( PacketHeader<EventsTypes::NUMBER_OF_SAVED_EVENTS_REQUEST> ) ) {
         throw std::runtime_error( "Invalid packet format" );
     }
@@ -16,7 +17,7 @@ DecodedPacket::DecodedPacket( PacketBytes _bytes ) : m_bytes( std::move( _bytes
 }
 
 bool
-DecodedPacket::setup()  {
+DecodedPacketView::setup()  {
     const auto packetHeader  = reinterpret_cast< const PacketHeader<EventsTypes::NUMBER_OF_SAVED_EVENTS_REQUEST>* >( m_bytes.data() );
     if ( ntohs(packetHeader->appPacketHeader.nboPacketLength) != m_bytes.size() ) {
         return false;
@@ -45,13 +46,24 @@ DecodedPacket::setup()  {
             return setupVariant<Server::SavedEventsResponse>();
         case EventsTypes::NEW_EVENTS_NOTIFICATION:
             return setupVariant<Server::NewEventsNotification>();
+        case EventsTypes::SEND_EVENTS:
+            return setupVariant<Client::SendEvents>();
+        case EventsTypes::SEND_EVENTS_ACK:
+            return setupVariant<Server::SendEventsAck>();
+        case EventsTypes::SAVED_EVENTS_PACKED_REQUEST:
+            return setupVariant<Client::SavedEventsPackedRequest>();
+        case EventsTypes::SAVED_EVENTS_PACKED_RESPONSE:
+            return setupVariant<Server::SavedEventsPackedResponse>();
+        case EventsTypes::NACK:
+            return setupVariant<Server::Nack>();
         default:
-                assert( "Unknown type" );
+            assert( !"Unknown type" );
+            return false;
         }
 }
 
 std::optional<EventsTypes>
-DecodedPacket::getEventType() const {
+DecodedPacketView::getEventType() const {
     const auto packetHeader  = reinterpret_cast< const PacketHeader<EventsTypes::SEND_EVENT>* >( m_bytes.data() );
 
     assert( ntohs(packetHeader->appPacketHeader.nboPacketLength) == m_bytes.size() );
@@ -65,16 +77,42 @@ DecodedPacket::getEventType() const {
         case static_cast<uint8_t>(EventsTypes::SAVED_EVENTS_REQUEST):
         case static_cast<uint8_t>(EventsTypes::SAVED_EVENTS_RESPONSE):
         case static_cast<uint8_t>(EventsTypes::NEW_EVENTS_NOTIFICATION):
+        case static_cast<uint8_t>(EventsTypes::SEND_EVENTS):
+        case static_cast<uint8_t>(EventsTypes::SEND_EVENTS_ACK):
+        case static_cast<uint8_t>(EventsTypes::SAVED_EVENTS_PACKED_REQUEST):
+        case static_cast<uint8_t>(EventsTypes::SAVED_EVENTS_PACKED_RESPONSE):
+        case static_cast<uint8_t>(EventsTypes::NACK):
             return static_cast< EventsTypes >( packetHeader->type );
         default:
             return std::nullopt;
     }
 }
 
-const DecodedPacket::PacketVariant& DecodedPacket::decodedPacket() const {
-    assert(m_decodedPacketVariant);
+DecodedPacket::DecodedPacket( PacketBytes _bytes ) : m_bytes( std::move( _bytes ) ), m_view( m_bytes ) {
+}
+
+DecodedPacket::DecodedPacket( const DecodedPacketView& _packet ) : DecodedPacket( _packet.bytes().toBytes() ) {
+}
+
+DecodedPacket::DecodedPacket( const DecodedPacket& _packet ) : DecodedPacket( _packet.m_bytes ) {
+}
+
+DecodedPacket::DecodedPacket( DecodedPacket&& _packet ) : DecodedPacket( std::move( _packet.m_bytes ) ) {
+}
+
+DecodedPacket&
+DecodedPacket::operator=( const DecodedPacket& _packet ) {
+    if ( this != &_packet ) {
+        *this = DecodedPacket( _packet );
+    }
+    return *this;
+}
 
-    return *m_decodedPacketVariant;
+DecodedPacket&
+DecodedPacket::operator=( DecodedPacket&& _packet ) {
+    m_bytes = std::move( _packet.m_bytes );
+    m_view = DecodedPacketView( m_bytes );
+    return *this;
 }
 
-} // namespace Challenge::PacketCoderV1
\ No newline at end of file
+} // namespace Challenge::PacketCoderV1
@@ -2,8 +2,30 @@
 
 #include "Lib/Uint64/BytsOrderUint64.h"
 
+#include <cassert>
+#include <iterator>
+
 namespace Challenge::PacketCoderV1 {
 
+namespace {
+    //! Counts events which fit into packet with events of _EntryType following _PacketType
+    template<typename _PacketType, typename _EntryType>
+    std::size_t countEventsFittingPacket( PacketFactory::Events::const_iterator _firstEvent, PacketFactory::Events::const_iterator _lastEvent ) {
+        std::size_t packetLength = sizeof(_PacketType);
+        std::size_t numberOfEvents = 0;
+
+        for ( auto event = _firstEvent; event != _lastEvent && numberOfEvents < std::numeric_limits<uint16_t>::max(); ++event ) {
+            packetLength += sizeof(_EntryType) + event->text.length();
+            if ( packetLength > std::numeric_limits<uint16_t>::max() ) {
+                break;
+            }
+            ++numberOfEvents;
+        }
+
+        return numberOfEvents;
+    }
+} // namespace
+
 PacketFactory::PacketBytes
 PacketFactory::createHandshakeInvite(uint32_t _packetNumber){
     PacketBytes packetBytes( sizeof(Client::HandshakeInvite) );
@@ -17,6 +39,20 @@ PacketFactory::createHandshakeInvite(uint32_t _packetNumber){
     return packetBytes;
 }
 
+PacketFactory::PacketBytes
+PacketFactory::createHandshakeInvite(uint32_t _packetNumber, uint16_t _maxProtocolVersion){
+    PacketBytes packetBytes( sizeof(Client::HandshakeInviteWithVersion) );
+    auto packet = reinterpret_cast< Client::HandshakeInviteWithVersion* >(packetBytes.data());
+
+    const_cast<uint8_t&>( packet->packetHeader.v1PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::HANDSHAKE_INVITE);
+    packet->packetHeader.v1PacketHeader.appPacketHeader.nboProtocolVersion = htons(1);
+    packet->packetHeader.v1PacketHeader.appPacketHeader.nboPacketLength = htons(sizeof(Client::HandshakeInviteWithVersion));
+    packet->packetHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->nboMaxProtocolVersion = htons(_maxProtocolVersion);
+
+    return packetBytes;
+}
+
 std::optional<PacketFactory::PacketBytes>
 PacketFactory::createSendEvent( uint32_t _packetNumber, HandshakeId _handshakeId,  const std::string& _eventText, uint32_t _priority){
     if ( _eventText.length() > std::numeric_limits<uint16_t>::max() ) {
@@ -48,6 +84,48 @@ PacketFactory::createSendEvent( uint32_t _packetNumber, HandshakeId _handshakeId
     return std::move(packetBytes);
 }
 
+std::optional<PacketFactory::PacketBytes>
+PacketFactory::createSendEvents( uint32_t _packetNumber, HandshakeId _handshakeId, Events::const_iterator _firstEvent, Events::const_iterator _lastEvent ) {
+    const auto numberOfEvents = static_cast<std::size_t>( std::distance( _firstEvent, _lastEvent ) );
+    if ( countEventsFittingSendEvents( _firstEvent, _lastEvent ) != numberOfEvents ) {
+        return std::nullopt;
+    }
+
+    std::size_t wholePacketLength = sizeof(Client::SendEvents);
+    for ( auto event = _firstEvent; event != _lastEvent; ++event ) {
+        wholePacketLength += sizeof(Client::SendEventsEntry) + event->text.length();
+    }
+
+    PacketBytes packetBytes( wholePacketLength );
+
+    auto packet = reinterpret_cast< Client::SendEvents* >( packetBytes.data() );
+    const_cast<uint8_t&>( packet->clientV1HeaderWithHandshake.clientV1PacketHeader.v1PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::SEND_EVENTS);
+
+    packet->clientV1HeaderWithHandshake.clientV1PacketHeader.v1PacketHeader.appPacketHeader.nboPacketLength = htons(wholePacketLength);
+    packet->clientV1HeaderWithHandshake.clientV1PacketHeader.v1PacketHeader.appPacketHeader.nboProtocolVersion = htons(1);
+
+    packet->clientV1HeaderWithHandshake.clientV1PacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->clientV1HeaderWithHandshake.nboHandshakeId = htonl(_handshakeId);
+    packet->nboNumberOfEvents = htons(numberOfEvents);
+
+    auto entryBytes = packet->events;
+    for ( auto event = _firstEvent; event != _lastEvent; ++event ) {
+        auto entry = reinterpret_cast< Client::SendEventsEntry* >( entryBytes );
+        entry->nboPriority = htonl(event->priority);
+        entry->nboLengthOfText = htons(event->text.length());
+        memcpy( entry->text, event->text.data(), event->text.length() );
+
+        entryBytes += sizeof(Client::SendEventsEntry) + event->text.length();
+    }
+
+    return std::move(packetBytes);
+}
+
+std::size_t
+PacketFactory::countEventsFittingSendEvents( Events::const_iterator _firstEvent, Events::const_iterator _lastEvent ) {
+    return countEventsFittingPacket<Client::SendEvents, Client::SendEventsEntry>( _firstEvent, _lastEvent );
+}
+
 PacketFactory::PacketBytes
 PacketFactory::createAck( uint32_t _packetNumber, HandshakeId _handshakeId ) {
     PacketBytes packetBytes( sizeof(Server::Ack) );
@@ -61,6 +139,50 @@ PacketFactory::createAck( uint32_t _packetNumber, HandshakeId _handshakeId ) {
 
     return packetBytes;
 }
+
+PacketFactory::PacketBytes
+PacketFactory::createAck( uint32_t _packetNumber, HandshakeId _handshakeId, uint16_t _protocolVersion ) {
+    PacketBytes packetBytes( sizeof(Server::AckWithVersion) );
+    auto packet = reinterpret_cast< Server::AckWithVersion* >(packetBytes.data());
+
+    const_cast<uint8_t&>( packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::ACK);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboProtocolVersion = htons(1);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboPacketLength = htons(sizeof(Server::AckWithVersion));
+    packet->serverResponsePacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId = htonl(_handshakeId);
+    packet->nboProtocolVersion = htons(_protocolVersion);
+
+    return packetBytes;
+}
+
+PacketFactory::PacketBytes
+PacketFactory::createNack( uint32_t _packetNumber, HandshakeId _handshakeId ) {
+    PacketBytes packetBytes( sizeof(Server::Nack) );
+    auto packet = reinterpret_cast< Server::Nack* >(packetBytes.data());
+
+    const_cast<uint8_t&>( packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::NACK);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboProtocolVersion = htons(1);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboPacketLength = htons(sizeof(Server::Nack));
+    packet->serverResponsePacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId = htonl(_handshakeId);
+
+    return packetBytes;
+}
+
+PacketFactory::PacketBytes
+PacketFactory::createSendEventsAck( uint32_t _packetNumber, HandshakeId _handshakeId, uint16_t _numberOfSavedEvents ) {
+    PacketBytes packetBytes( sizeof(Server::SendEventsAck) );
+    auto packet = reinterpret_cast< Server::SendEventsAck* >(packetBytes.data());
+
+    const_cast<uint8_t&>( packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::SEND_EVENTS_ACK);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboProtocolVersion = htons(1);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboPacketLength = htons(sizeof(Server::SendEventsAck));
+    packet->serverResponsePacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId = htonl(_handshakeId);
+    packet->nboNumberOfSavedEvents = htons(_numberOfSavedEvents);
+
+    return packetBytes;
+}
     
 PacketFactory::PacketBytes
 PacketFactory::createNumberOfEventsRequest( uint32_t _packetNumber, HandshakeId _handshakeId){
@@ -138,6 +260,69 @@ PacketFactory::createSavedEventsResponse( uint32_t _packetNumber, HandshakeId _h
     return std::move(packetBytes);
 }
 
+PacketFactory::PacketBytes
+PacketFactory::createSavedEventsPackedRequest( uint32_t _packetNumber, HandshakeId _handshakeId, uint64_t _firstEvent, uint64_t _lastEvent ){
+    PacketBytes packetBytes( sizeof(Client::SavedEventsPackedRequest) );
+    auto packet = reinterpret_cast< Client::SavedEventsPackedRequest* >(packetBytes.data());
+
+    const_cast<uint8_t&>( packet->clientV1HeaderWithHandshake.clientV1PacketHeader.v1PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::SAVED_EVENTS_PACKED_REQUEST);
+    packet->clientV1HeaderWithHandshake.clientV1PacketHeader.v1PacketHeader.appPacketHeader.nboProtocolVersion = htons(1);
+    packet->clientV1HeaderWithHandshake.clientV1PacketHeader.v1PacketHeader.appPacketHeader.nboPacketLength = htons(sizeof(Client::SavedEventsPackedRequest));
+    packet->clientV1HeaderWithHandshake.clientV1PacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->clientV1HeaderWithHandshake.nboHandshakeId = htonl(_handshakeId);
+
+    packet->nboFirstEvent = htonll(_firstEvent);
+    packet->nboLastEvent = htonll(_lastEvent);
+
+    return packetBytes;
+}
+
+std::optional<PacketFactory::PacketBytes>
+PacketFactory::createSavedEventsPackedResponse( uint32_t _packetNumber, HandshakeId _handshakeId, bool _isLast, Events::const_iterator _firstEvent, Events::const_iterator _lastEvent ) {
+    using namespace std::chrono;
+
+    const auto numberOfEvents = static_cast<std::size_t>( std::distance( _firstEvent, _lastEvent ) );
+    if ( countEventsFittingSavedEventsPackedResponse( _firstEvent, _lastEvent ) != numberOfEvents ) {
+        return std::nullopt;
+    }
+
+    std::size_t wholePacketLength = sizeof(Server::SavedEventsPackedResponse);
+    for ( auto event = _firstEvent; event != _lastEvent; ++event ) {
+        wholePacketLength += sizeof(Server::SavedEventsEntry) + event->text.length();
+    }
+
+    PacketBytes packetBytes( wholePacketLength );
+
+    auto packet = reinterpret_cast< Server::SavedEventsPackedResponse* >( packetBytes.data() );
+    const_cast<uint8_t&>( packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::SAVED_EVENTS_PACKED_RESPONSE);
+
+    packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboPacketLength = htons(wholePacketLength);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboProtocolVersion = htons(1);
+
+    packet->serverResponsePacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId = htonl(_handshakeId);
+    packet->isLastPacket = _isLast;
+    packet->nboNumberOfEvents = htons(numberOfEvents);
+
+    auto entryBytes = packet->events;
+    for ( auto event = _firstEvent; event != _lastEvent; ++event ) {
+        auto entry = reinterpret_cast< Server::SavedEventsEntry* >( entryBytes );
+        entry->nboMillisecondsFromEpoch = htonll( duration_cast<milliseconds>( event->timeStamp.time_since_epoch() ).count() );
+        entry->nboPriority = htonl(event->priority);
+        entry->nboLengthOfText = htons(event->text.length());
+        memcpy( entry->text, event->text.data(), event->text.length() );
+
+        entryBytes += sizeof(Server::SavedEventsEntry) + event->text.length();
+    }
+
+    return std::move(packetBytes);
+}
+
+std::size_t
+PacketFactory::countEventsFittingSavedEventsPackedResponse( Events::const_iterator _firstEvent, Events::const_iterator _lastEvent ) {
+    return countEventsFittingPacket<Server::SavedEventsPackedResponse, Server::SavedEventsEntry>( _firstEvent, _lastEvent );
+}
+
 PacketFactory::PacketBytes
 PacketFactory::createNewEventsNotification( HandshakeId _handshakeId,  uint64_t _numberOfEvents ) {
     PacketBytes packetBytes( sizeof(Server::NewEventsNotification) );
@@ -152,5 +337,15 @@ PacketFactory::createNewEventsNotification( HandshakeId _handshakeId,  uint64_t
 
     return packetBytes;
 }
+
+void
+PacketFactory::setServerPacketHandshakeId( PacketBytes& _serverPacket, HandshakeId _handshakeId ) {
+    // all packets of server start with the same header, type of packet does not change its layout
+    using ServerPacketHeader = Server::PacketHeader<EventsTypes::NEW_EVENTS_NOTIFICATION>;
+    assert( _serverPacket.size() >= sizeof(ServerPacketHeader) );
+
+    auto header = reinterpret_cast< ServerPacketHeader* >(_serverPacket.data());
+    header->nboHandshakeId = htonl(_handshakeId);
+}
     
 } // namespace Challenge::PacketCoderV1
@@ -0,0 +1,81 @@
+#include "Lib/PacketCoderV2/PacketDecoder.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace Challenge::PacketCoderV2 {
+
+bool
+isPacketV2( BytesView _bytes ) {
+    using Challenge::Communication::ApplicationProtocol::ExtendedPacketHeader;
+    using Challenge::Communication::ApplicationProtocol::EXTENDED_PACKET_LENGTH;
+
+    if ( _bytes.size() < sizeof(ExtendedPacketHeader) ) {
+        return false;
+    }
+
+    Challenge::Communication::ApplicationProtocol::PacketHeader header;
+    std::memcpy( &header, _bytes.data(), sizeof(header) );
+    return ntohs(header.nboPacketLength) == EXTENDED_PACKET_LENGTH && ntohs(header.nboProtocolVersion) == VERSION_2;
+}
+
+DecodedPacketView::DecodedPacketView( BytesView _bytes ) : m_bytes( _bytes ) {
+    if ( m_bytes.size() < sizeof( PacketHeader<EventsTypes::SEND_EVENT> ) || !isPacketV2( m_bytes ) ) {
+        throw std::runtime_error( "Invalid packet format" );
+    }
+
+    if (!setup()) {
+        throw std::runtime_error( "Invalid packet format" );
+    }
+}
+
+bool
+DecodedPacketView::setup()  {
+    const auto packetHeader  = reinterpret_cast< const PacketHeader<EventsTypes::SEND_EVENT>* >( m_bytes.data() );
+    if ( ntohl(packetHeader->appPacketHeader.nboPacketLength) != m_bytes.size() ) {
+        return false;
+    }
+
+    switch ( packetHeader->type ) {
+        case static_cast<uint8_t>(EventsTypes::SEND_EVENT):
+            return setupVariant<Client::SendEvent>();
+        case static_cast<uint8_t>(EventsTypes::SEND_EVENTS):
+            return setupVariant<Client::SendEvents>();
+        case static_cast<uint8_t>(EventsTypes::SEND_EVENTS_ACK):
+            return setupVariant<Server::SendEventsAck>();
+        case static_cast<uint8_t>(EventsTypes::SAVED_EVENTS_PACKED_RESPONSE):
+            return setupVariant<Server::SavedEventsPackedResponse>();
+        default:
+            // remaining messages are exchanged only in version 1
+            return false;
+    }
+}
+
+DecodedPacket::DecodedPacket( PacketBytes _bytes ) : m_bytes( std::move( _bytes ) ), m_view( m_bytes ) {
+}
+
+DecodedPacket::DecodedPacket( const DecodedPacketView& _packet ) : DecodedPacket( _packet.bytes().toBytes() ) {
+}
+
+DecodedPacket::DecodedPacket( const DecodedPacket& _packet ) : DecodedPacket( _packet.m_bytes ) {
+}
+
+DecodedPacket::DecodedPacket( DecodedPacket&& _packet ) : DecodedPacket( std::move( _packet.m_bytes ) ) {
+}
+
+DecodedPacket&
+DecodedPacket::operator=( const DecodedPacket& _packet ) {
+    if ( this != &_packet ) {
+        *this = DecodedPacket( _packet );
+    }
+    return *this;
+}
+
+DecodedPacket&
+DecodedPacket::operator=( DecodedPacket&& _packet ) {
+    m_bytes = std::move( _packet.m_bytes );
+    m_view = DecodedPacketView( m_bytes );
+    return *this;
+}
+
+} // namespace Challenge::PacketCoderV2
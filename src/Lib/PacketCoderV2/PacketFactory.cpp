@@ -0,0 +1,353 @@
+#include "Lib/PacketCoderV2/PacketFactory.h"
+
+#include "Lib/Uint64/BytsOrderUint64.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+namespace Challenge::PacketCoderV2 {
+
+namespace {
+    using Challenge::Communication::ApplicationProtocol::EXTENDED_PACKET_LENGTH;
+    using Challenge::Communication::ApplicationProtocol::MAX_PACKET_LENGTH;
+
+    //! Fills header which is common for all packets of version 2
+    template< EventsTypes _EventType >
+    void setupHeader( PacketHeader<_EventType>& _header, std::size_t _packetLength ) {
+        _header.appPacketHeader.packetHeader.nboPacketLength = htons(EXTENDED_PACKET_LENGTH);
+        _header.appPacketHeader.packetHeader.nboProtocolVersion = htons(VERSION_2);
+        _header.appPacketHeader.nboPacketLength = htonl(_packetLength);
+    }
+
+    //! Counts events which fit into packet with events of _EntryType following _PacketType
+    template<typename _PacketType, typename _EntryType>
+    std::size_t countEventsFittingPacket( PacketFactory::Events::const_iterator _firstEvent, PacketFactory::Events::const_iterator _lastEvent, std::size_t _maxPacketLength ) {
+        const auto maxPacketLength = std::min( _maxPacketLength, MAX_PACKET_LENGTH );
+        std::size_t packetLength = sizeof(_PacketType);
+        std::size_t numberOfEvents = 0;
+
+        for ( auto event = _firstEvent; event != _lastEvent; ++event ) {
+            packetLength += sizeof(_EntryType) + event->text.length();
+            if ( packetLength > maxPacketLength ) {
+                break;
+            }
+            ++numberOfEvents;
+        }
+
+        return numberOfEvents;
+    }
+
+    // SavedEventsResponse of version 1 ends with fields of its SavedEventsEntry
+    static_assert( sizeof(PacketCoderV1::Server::SavedEventsResponse)
+                   == offsetof(PacketCoderV1::Server::SavedEventsResponse, nboMillisecondsFromEpoch) + sizeof(PacketCoderV1::Server::SavedEventsEntry) );
+
+    //! Returns length of text of encoded Server::SavedEventsEntry
+    std::size_t getTextLengthOfEntry( BytesView _entry ) {
+        assert( _entry.size() >= sizeof(Server::SavedEventsEntry) );
+        return _entry.size() - sizeof(Server::SavedEventsEntry);
+    }
+
+    //! Longest text of entry which fits into any response of version 1 together with its headers
+    constexpr std::size_t MAX_TEXT_LENGTH_V1 = std::numeric_limits<uint16_t>::max()
+                                               - sizeof(PacketCoderV1::Server::SavedEventsPackedResponse)
+                                               - sizeof(PacketCoderV1::Server::SavedEventsEntry);
+
+    //! Returns length of text of encoded entry sent by version 1
+    /*!
+     *  Length of packet of version 1 is 16 bits, so longer text is truncated, at start of UTF-8 sequence
+     */
+    std::size_t getTextLengthOfEntryV1( BytesView _entry ) {
+        const auto textLength = getTextLengthOfEntry( _entry );
+        if ( textLength <= MAX_TEXT_LENGTH_V1 ) {
+            return textLength;
+        }
+
+        auto text = reinterpret_cast< const Server::SavedEventsEntry* >( _entry.data() )->text;
+        auto truncatedLength = MAX_TEXT_LENGTH_V1;
+        while ( truncatedLength > 0 && ( std::to_integer<uint8_t>( text[truncatedLength] ) & 0xC0 ) == 0x80 ) {
+            --truncatedLength;
+        }
+        return truncatedLength;
+    }
+
+    //! Copies encoded entry as PacketCoderV1::Server::SavedEventsEntry, only length of text is encoded again
+    void copyEntryV1( BytesView _entry, std::byte* _destination ) {
+        const auto textLength = getTextLengthOfEntryV1( _entry );
+        auto entry = reinterpret_cast< const Server::SavedEventsEntry* >( _entry.data() );
+        auto entryV1 = reinterpret_cast< PacketCoderV1::Server::SavedEventsEntry* >( _destination );
+
+        entryV1->nboMillisecondsFromEpoch = entry->nboMillisecondsFromEpoch;
+        entryV1->nboPriority = entry->nboPriority;
+        entryV1->nboLengthOfText = htons(textLength);
+        memcpy( entryV1->text, entry->text, textLength );
+    }
+} // namespace
+
+std::optional<PacketFactory::PacketBytes>
+PacketFactory::createSendEvent( uint32_t _packetNumber, HandshakeId _handshakeId, const std::string& _eventText, uint32_t _priority ) {
+    const std::size_t wholePacketLength = sizeof(Client::SendEvent) + _eventText.length() * sizeof(std::byte);
+
+    if ( wholePacketLength > MAX_PACKET_LENGTH ) {
+        return std::nullopt;
+    }
+
+    PacketBytes packetBytes( wholePacketLength );
+
+    auto packet = reinterpret_cast< Client::SendEvent* >( packetBytes.data() );
+    const_cast<uint8_t&>( packet->clientV2HeaderWithHandshake.clientV2PacketHeader.v2PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::SEND_EVENT);
+    setupHeader( packet->clientV2HeaderWithHandshake.clientV2PacketHeader.v2PacketHeader, wholePacketLength );
+
+    packet->clientV2HeaderWithHandshake.clientV2PacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->clientV2HeaderWithHandshake.nboHandshakeId = htonl(_handshakeId);
+
+    packet->nboPriority = htonl(_priority);
+    packet->nboLengthOfText = htonl(_eventText.length());
+    memcpy( packet->text, _eventText.data(), _eventText.length() );
+
+    return std::move(packetBytes);
+}
+
+std::optional<PacketFactory::PacketBytes>
+PacketFactory::createSendEvents( uint32_t _packetNumber, HandshakeId _handshakeId, Events::const_iterator _firstEvent, Events::const_iterator _lastEvent ) {
+    const auto numberOfEvents = static_cast<std::size_t>( std::distance( _firstEvent, _lastEvent ) );
+    if ( countEventsFittingSendEvents( _firstEvent, _lastEvent, MAX_PACKET_LENGTH ) != numberOfEvents ) {
+        return std::nullopt;
+    }
+
+    std::size_t wholePacketLength = sizeof(Client::SendEvents);
+    for ( auto event = _firstEvent; event != _lastEvent; ++event ) {
+        wholePacketLength += sizeof(Client::SendEventsEntry) + event->text.length();
+    }
+
+    PacketBytes packetBytes( wholePacketLength );
+
+    auto packet = reinterpret_cast< Client::SendEvents* >( packetBytes.data() );
+    const_cast<uint8_t&>( packet->clientV2HeaderWithHandshake.clientV2PacketHeader.v2PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::SEND_EVENTS);
+    setupHeader( packet->clientV2HeaderWithHandshake.clientV2PacketHeader.v2PacketHeader, wholePacketLength );
+
+    packet->clientV2HeaderWithHandshake.clientV2PacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->clientV2HeaderWithHandshake.nboHandshakeId = htonl(_handshakeId);
+    packet->nboNumberOfEvents = htonl(numberOfEvents);
+
+    auto entryBytes = packet->events;
+    for ( auto event = _firstEvent; event != _lastEvent; ++event ) {
+        auto entry = reinterpret_cast< Client::SendEventsEntry* >( entryBytes );
+        entry->nboPriority = htonl(event->priority);
+        entry->nboLengthOfText = htonl(event->text.length());
+        memcpy( entry->text, event->text.data(), event->text.length() );
+
+        entryBytes += sizeof(Client::SendEventsEntry) + event->text.length();
+    }
+
+    return std::move(packetBytes);
+}
+
+std::size_t
+PacketFactory::countEventsFittingSendEvents( Events::const_iterator _firstEvent, Events::const_iterator _lastEvent, std::size_t _maxPacketLength ) {
+    return countEventsFittingPacket<Client::SendEvents, Client::SendEventsEntry>( _firstEvent, _lastEvent, _maxPacketLength );
+}
+
+PacketFactory::PacketBytes
+PacketFactory::createSendEventsAck( uint32_t _packetNumber, HandshakeId _handshakeId, uint32_t _numberOfSavedEvents ) {
+    PacketBytes packetBytes( sizeof(Server::SendEventsAck) );
+    auto packet = reinterpret_cast< Server::SendEventsAck* >(packetBytes.data());
+
+    const_cast<uint8_t&>( packet->serverResponsePacketHeader.serverV2PacketHeader.v2PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::SEND_EVENTS_ACK);
+    setupHeader( packet->serverResponsePacketHeader.serverV2PacketHeader.v2PacketHeader, sizeof(Server::SendEventsAck) );
+    packet->serverResponsePacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->serverResponsePacketHeader.serverV2PacketHeader.nboHandshakeId = htonl(_handshakeId);
+    packet->nboNumberOfSavedEvents = htonl(_numberOfSavedEvents);
+
+    return packetBytes;
+}
+
+std::optional<PacketFactory::PacketBytes>
+PacketFactory::createSavedEventsPackedResponse( uint32_t _packetNumber, HandshakeId _handshakeId, bool _isLast, Events::const_iterator _firstEvent, Events::const_iterator _lastEvent ) {
+    using namespace std::chrono;
+
+    const auto numberOfEvents = static_cast<std::size_t>( std::distance( _firstEvent, _lastEvent ) );
+    if ( countEventsFittingSavedEventsPackedResponse( _firstEvent, _lastEvent, MAX_PACKET_LENGTH ) != numberOfEvents ) {
+        return std::nullopt;
+    }
+
+    std::size_t wholePacketLength = sizeof(Server::SavedEventsPackedResponse);
+    for ( auto event = _firstEvent; event != _lastEvent; ++event ) {
+        wholePacketLength += sizeof(Server::SavedEventsEntry) + event->text.length();
+    }
+
+    PacketBytes packetBytes( wholePacketLength );
+
+    auto packet = reinterpret_cast< Server::SavedEventsPackedResponse* >( packetBytes.data() );
+    const_cast<uint8_t&>( packet->serverResponsePacketHeader.serverV2PacketHeader.v2PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::SAVED_EVENTS_PACKED_RESPONSE);
+    setupHeader( packet->serverResponsePacketHeader.serverV2PacketHeader.v2PacketHeader, wholePacketLength );
+
+    packet->serverResponsePacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->serverResponsePacketHeader.serverV2PacketHeader.nboHandshakeId = htonl(_handshakeId);
+    packet->isLastPacket = _isLast;
+    packet->nboNumberOfEvents = htonl(numberOfEvents);
+
+    auto entryBytes = packet->events;
+    for ( auto event = _firstEvent; event != _lastEvent; ++event ) {
+        auto entry = reinterpret_cast< Server::SavedEventsEntry* >( entryBytes );
+        entry->nboMillisecondsFromEpoch = htonll( duration_cast<milliseconds>( event->timeStamp.time_since_epoch() ).count() );
+        entry->nboPriority = htonl(event->priority);
+        entry->nboLengthOfText = htonl(event->text.length());
+        memcpy( entry->text, event->text.data(), event->text.length() );
+
+        entryBytes += sizeof(Server::SavedEventsEntry) + event->text.length();
+    }
+
+    return std::move(packetBytes);
+}
+
+std::size_t
+PacketFactory::countEventsFittingSavedEventsPackedResponse( Events::const_iterator _firstEvent, Events::const_iterator _lastEvent, std::size_t _maxPacketLength ) {
+    return countEventsFittingPacket<Server::SavedEventsPackedResponse, Server::SavedEventsEntry>( _firstEvent, _lastEvent, _maxPacketLength );
+}
+
+PacketFactory::PacketBytes
+PacketFactory::createSavedEventsEntry( const EventData& _event ) {
+    using namespace std::chrono;
+
+    PacketBytes entryBytes( sizeof(Server::SavedEventsEntry) + _event.text.length() );
+
+    auto entry = reinterpret_cast< Server::SavedEventsEntry* >( entryBytes.data() );
+    entry->nboMillisecondsFromEpoch = htonll( duration_cast<milliseconds>( _event.timeStamp.time_since_epoch() ).count() );
+    entry->nboPriority = htonl(_event.priority);
+    entry->nboLengthOfText = htonl(_event.text.length());
+    memcpy( entry->text, _event.text.data(), _event.text.length() );
+
+    return entryBytes;
+}
+
+std::optional<PacketFactory::PacketBytes>
+PacketFactory::createSavedEventsPackedResponse( uint32_t _packetNumber, HandshakeId _handshakeId, bool _isLast, EncodedEntries::const_iterator _firstEntry, EncodedEntries::const_iterator _lastEntry ) {
+    const auto numberOfEntries = static_cast<std::size_t>( std::distance( _firstEntry, _lastEntry ) );
+    if ( countEntriesFittingSavedEventsPackedResponse( _firstEntry, _lastEntry, MAX_PACKET_LENGTH ) != numberOfEntries ) {
+        return std::nullopt;
+    }
+
+    std::size_t wholePacketLength = sizeof(Server::SavedEventsPackedResponse);
+    for ( auto entry = _firstEntry; entry != _lastEntry; ++entry ) {
+        wholePacketLength += (*entry)->size();
+    }
+
+    PacketBytes packetBytes( wholePacketLength );
+
+    auto packet = reinterpret_cast< Server::SavedEventsPackedResponse* >( packetBytes.data() );
+    const_cast<uint8_t&>( packet->serverResponsePacketHeader.serverV2PacketHeader.v2PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::SAVED_EVENTS_PACKED_RESPONSE);
+    setupHeader( packet->serverResponsePacketHeader.serverV2PacketHeader.v2PacketHeader, wholePacketLength );
+
+    packet->serverResponsePacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->serverResponsePacketHeader.serverV2PacketHeader.nboHandshakeId = htonl(_handshakeId);
+    packet->isLastPacket = _isLast;
+    packet->nboNumberOfEvents = htonl(numberOfEntries);
+
+    // entries are already in format of the packet
+    auto entryBytes = packet->events;
+    for ( auto entry = _firstEntry; entry != _lastEntry; ++entry ) {
+        memcpy( entryBytes, (*entry)->data(), (*entry)->size() );
+        entryBytes += (*entry)->size();
+    }
+
+    return std::move(packetBytes);
+}
+
+std::size_t
+PacketFactory::countEntriesFittingSavedEventsPackedResponse( EncodedEntries::const_iterator _firstEntry, EncodedEntries::const_iterator _lastEntry, std::size_t _maxPacketLength ) {
+    const auto maxPacketLength = std::min( _maxPacketLength, MAX_PACKET_LENGTH );
+    std::size_t packetLength = sizeof(Server::SavedEventsPackedResponse);
+    std::size_t numberOfEntries = 0;
+
+    for ( auto entry = _firstEntry; entry != _lastEntry; ++entry ) {
+        packetLength += (*entry)->size();
+        if ( packetLength > maxPacketLength ) {
+            break;
+        }
+        ++numberOfEntries;
+    }
+
+    return numberOfEntries;
+}
+
+std::optional<PacketFactory::PacketBytes>
+PacketFactory::createSavedEventsResponseV1( uint32_t _packetNumber, HandshakeId _handshakeId, bool _isLast, BytesView _entry ) {
+    using PacketCoderV1::Server::SavedEventsResponse;
+
+    const std::size_t wholePacketLength = sizeof(SavedEventsResponse) + getTextLengthOfEntryV1( _entry );
+
+    PacketBytes packetBytes( wholePacketLength );
+
+    auto packet = reinterpret_cast< SavedEventsResponse* >( packetBytes.data() );
+    const_cast<uint8_t&>( packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::SAVED_EVENTS_RESPONSE);
+
+    packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboPacketLength = htons(wholePacketLength);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboProtocolVersion = htons(PacketCoderV1::VERSION_1);
+
+    packet->serverResponsePacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId = htonl(_handshakeId);
+    packet->isLastEvent = _isLast;
+
+    copyEntryV1( _entry, packetBytes.data() + offsetof(SavedEventsResponse, nboMillisecondsFromEpoch) );
+
+    return std::move(packetBytes);
+}
+
+std::optional<PacketFactory::PacketBytes>
+PacketFactory::createSavedEventsPackedResponseV1( uint32_t _packetNumber, HandshakeId _handshakeId, bool _isLast, EncodedEntries::const_iterator _firstEntry, EncodedEntries::const_iterator _lastEntry ) {
+    using PacketCoderV1::Server::SavedEventsPackedResponse;
+    using EntryV1 = PacketCoderV1::Server::SavedEventsEntry;
+
+    const auto numberOfEntries = static_cast<std::size_t>( std::distance( _firstEntry, _lastEntry ) );
+    if ( countEntriesFittingSavedEventsPackedResponseV1( _firstEntry, _lastEntry ) != numberOfEntries ) {
+        return std::nullopt;
+    }
+
+    std::size_t wholePacketLength = sizeof(SavedEventsPackedResponse);
+    for ( auto entry = _firstEntry; entry != _lastEntry; ++entry ) {
+        wholePacketLength += sizeof(EntryV1) + getTextLengthOfEntryV1( **entry );
+    }
+
+    PacketBytes packetBytes( wholePacketLength );
+
+    auto packet = reinterpret_cast< SavedEventsPackedResponse* >( packetBytes.data() );
+    const_cast<uint8_t&>( packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.type ) = static_cast<uint8_t >(EventsTypes::SAVED_EVENTS_PACKED_RESPONSE);
+
+    packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboPacketLength = htons(wholePacketLength);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboProtocolVersion = htons(PacketCoderV1::VERSION_1);
+
+    packet->serverResponsePacketHeader.nboClientPacketNumber = htonl(_packetNumber);
+    packet->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId = htonl(_handshakeId);
+    packet->isLastPacket = _isLast;
+    packet->nboNumberOfEvents = htons(numberOfEntries);
+
+    auto entryBytes = packet->events;
+    for ( auto entry = _firstEntry; entry != _lastEntry; ++entry ) {
+        copyEntryV1( **entry, entryBytes );
+        entryBytes += sizeof(EntryV1) + getTextLengthOfEntryV1( **entry );
+    }
+
+    return std::move(packetBytes);
+}
+
+std::size_t
+PacketFactory::countEntriesFittingSavedEventsPackedResponseV1( EncodedEntries::const_iterator _firstEntry, EncodedEntries::const_iterator _lastEntry ) {
+    std::size_t packetLength = sizeof(PacketCoderV1::Server::SavedEventsPackedResponse);
+    std::size_t numberOfEntries = 0;
+
+    for ( auto entry = _firstEntry; entry != _lastEntry && numberOfEntries < std::numeric_limits<uint16_t>::max(); ++entry ) {
+        packetLength += sizeof(PacketCoderV1::Server::SavedEventsEntry) + getTextLengthOfEntryV1( **entry );
+        if ( packetLength > std::numeric_limits<uint16_t>::max() ) {
+            break;
+        }
+        ++numberOfEntries;
+    }
+
+    return numberOfEntries;
+}
+
+} // namespace Challenge::PacketCoderV2
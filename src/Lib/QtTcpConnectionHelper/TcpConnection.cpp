@@ -1,36 +1,62 @@
 #include "Lib/QtTcpConnectionHelper/QtTcpConnectionHelper.h"
 
+#include "Lib/C++Tools/ScopedAction.h"
 #include "Lib/Log/Logger.h"
 
+#include <QTimer>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
 #include <cassert>
+#include <climits>
+#include <limits>
 
 namespace Challenge {
 
-QtTcpConnectionHelper::QtTcpConnectionHelper(QPointer<QTcpSocket> _socket) : m_connectedSocket( std::move(_socket) ) {
-    assert( m_connectedSocket );
+template< typename _Socket >
+void
+QtTcpConnectionHelper::initialize( QPointer<_Socket> _socket ) {
+    assert( _socket );
 
-    if ( !m_connectedSocket->isValid() ) {
+    if ( !_socket->isValid() ) {
         throw std::runtime_error( "Socket is not connected" );
     }
 
+    m_connectedSocket = _socket;
+    m_isSocketConnected = [_socket]{ return _socket->isValid() && _socket->state() == _Socket::ConnectedState; };
+    m_flushSocket = [_socket]{ _socket->flush(); };
+    m_socketDescriptor = [_socket]{ return static_cast<qintptr>( _socket->socketDescriptor() ); };
 
     m_dataStream.setDevice( m_connectedSocket );
     m_dataStream.setVersion( QDataStream::Qt_4_0 );
 
-    if ( !connect( m_connectedSocket, &QIODevice::readyRead, this, &QtTcpConnectionHelper::onDataArrived ) ) {
+    if ( !connect( _socket, &QIODevice::readyRead, this, &QtTcpConnectionHelper::onDataArrived ) ) {
         throw std::runtime_error( "Cannot connect signals with slot" );
     }
 
-    if ( !connect( m_connectedSocket, &QAbstractSocket::disconnected, this, &QtTcpConnectionHelper::onDisconnected ) ) {
+    if ( !connect( _socket, &_Socket::disconnected, this, &QtTcpConnectionHelper::onDisconnected ) ) {
         throw std::runtime_error( "Cannot connect signals with slot" );
     }
 
     LOG_INFORMATION( "New connection established");
 }
 
+QtTcpConnectionHelper::QtTcpConnectionHelper(QPointer<QTcpSocket> _socket) {
+    initialize( std::move(_socket) );
+}
+
+QtTcpConnectionHelper::QtTcpConnectionHelper(QPointer<QLocalSocket> _socket) {
+    initialize( std::move(_socket) );
+}
+
 QtTcpConnectionHelper::~QtTcpConnectionHelper() {
     assert(m_connectedSocket);
 
+    // queued data are written before socket is closed
+    flush();
+
     m_connectedSocket->deleteLater();
 }
 
@@ -38,7 +64,7 @@ bool
 QtTcpConnectionHelper::isValid() const {
     assert( m_connectedSocket );
 
-    return m_connectedSocket->isValid() && m_connectedSocket->state() == QAbstractSocket::ConnectedState;
+    return m_isSocketConnected();
 }
 
 bool
@@ -65,31 +91,47 @@ QtTcpConnectionHelper::registerNewDataReadyToReadCallback(NewDataReadyToReadCall
 
 std::optional<QtTcpConnectionHelper::Payload>
 QtTcpConnectionHelper::receive() {
+    Payload payload;
+    if ( !receiveInto( payload ).has_value() ) {
+        return std::nullopt;
+    }
+
+    return payload;
+}
+
+std::optional<std::size_t>
+QtTcpConnectionHelper::receiveInto( Payload& _buffer ) {
     static_assert( sizeof(std::byte) == sizeof(char), "Char must be converted to std::byte"  );
     assert( m_connectedSocket );
     m_connectedSocket->waitForReadyRead(0);
 
-    std::lock_guard guard( m_rawDataMutex );
+    std::lock_guard guard( m_receiveMutex );
 
     if (!isValid()) {
         return std::nullopt;
     }
 
-    /* I know here copy is made, but now is important time of implementation, if system will start to work
-     * then we can optimize this
-     */
-    // TODO: remove copy QByteArray to std::string
-    auto beginIt = reinterpret_cast<const std::byte*>( (const char*)(m_rawDataFromSocket) );
-    auto endIt = beginIt + m_rawDataFromSocket.size();
-    Payload payload(beginIt, endIt);
-    m_rawDataFromSocket.clear();
-    return std::move( payload );
+    // received bytes wait in buffer of Qt socket, they are copied only from there to buffer of caller
+    const auto numberOfAvailable = m_connectedSocket->bytesAvailable();
+    if ( numberOfAvailable <= 0 ) {
+        return 0;
+    }
+
+    const auto size = _buffer.size();
+    _buffer.resize( size + numberOfAvailable );
+    auto numberOfRead = m_connectedSocket->read( reinterpret_cast<char*>( _buffer.data() + size ), numberOfAvailable );
+    _buffer.resize( size + std::max<qint64>( numberOfRead, 0 ) );
+
+    if ( numberOfRead == -1 ) {
+        return std::nullopt;
+    }
+
+    return static_cast<std::size_t>( numberOfRead );
 }
 
 std::optional<uint32_t>
 QtTcpConnectionHelper::send( const QtTcpConnectionHelper::Payload& _payload ) {
     assert( m_connectedSocket );
-    static_assert( sizeof(std::byte) == sizeof(char), "Char must be converted to std::byte" );
 
     if ( _payload.size() > std::numeric_limits<uint32_t>::max() ) {
         return std::nullopt;
@@ -99,29 +141,105 @@ QtTcpConnectionHelper::send( const QtTcpConnectionHelper::Payload& _payload ) {
         return std::nullopt;
     }
 
-    auto numberOfSent = m_connectedSocket->write(reinterpret_cast<const char*>(_payload.data()), _payload.size() );
-    m_connectedSocket->flush();
-    if ( numberOfSent == -1 ) {
-        return std::nullopt;
+    std::lock_guard guard( m_outboundQueueMutex );
+
+    m_outboundQueue.push_back( _payload );
+    m_outboundQueueSize += _payload.size();
+
+    if ( m_outboundQueueSize >= FLUSH_THRESHOLD ) {
+        if ( !flushOutboundQueue() ) {
+            return std::nullopt;
+        }
+    } else if ( !m_isFlushScheduled ) {
+        // packets sent during this iteration of event loop are written together
+        m_isFlushScheduled = true;
+        QTimer::singleShot( 0, this, [this]{ flush(); } );
     }
 
-    return static_cast<uint32_t>(numberOfSent);
+    return static_cast<uint32_t>( _payload.size() );
 }
 
-void
-QtTcpConnectionHelper::onDataArrived() {
-    assert(m_connectedSocket);
+bool
+QtTcpConnectionHelper::flush() {
+    assert( m_connectedSocket );
+
+    std::lock_guard guard( m_outboundQueueMutex );
+    return flushOutboundQueue();
+}
+
+bool
+QtTcpConnectionHelper::flushOutboundQueue() {
+    static_assert( sizeof(std::byte) == sizeof(char), "Char must be converted to std::byte" );
 
-    {
-        std::lock_guard lock(m_rawDataMutex);
-        m_rawDataFromSocket.append(m_connectedSocket->readAll());
+    m_isFlushScheduled = false;
+
+    if ( m_outboundQueue.empty() ) {
+        return true;
     }
 
-    {
-        std::lock_guard lock(m_callbacksMutex);
-        if (m_newDataReadyToReadCallback != nullptr) {
-            m_newDataReadyToReadCallback();
+    ScopedAction clearQueue( [this]{ m_outboundQueue.clear(); m_outboundQueueSize = 0; } );
+
+    if ( !isValid() ) {
+        return false;
+    }
+
+    std::size_t numberOfWritten = 0;
+
+    // socket can be written directly only if Qt socket does not buffer anything, otherwise order would be broken
+    if ( m_connectedSocket->bytesToWrite() == 0 ) {
+        std::vector<iovec> buffers;
+        buffers.reserve( std::min<std::size_t>( m_outboundQueue.size(), IOV_MAX ) );
+        for ( auto& payload : m_outboundQueue ) {
+            if ( buffers.size() == IOV_MAX ) {
+                break;
+            }
+            buffers.push_back( iovec{ payload.data(), payload.size() } );
         }
+
+        msghdr message{};
+        message.msg_iov = buffers.data();
+        message.msg_iovlen = buffers.size();
+
+        // sendmsg is writev, which does not raise SIGPIPE when peer is gone
+        auto result = ::sendmsg( m_socketDescriptor(), &message, MSG_NOSIGNAL );
+        // in case of error rest of data are passed to Qt socket, which reports the error
+        numberOfWritten = result > 0 ? static_cast<std::size_t>( result ) : 0;
+    }
+
+    if ( numberOfWritten == m_outboundQueueSize ) {
+        return true;
+    }
+
+    // part which kernel did not take is buffered by the Qt socket
+    for ( auto& payload : m_outboundQueue ) {
+        if ( numberOfWritten >= payload.size() ) {
+            numberOfWritten -= payload.size();
+            continue;
+        }
+
+        auto result = m_connectedSocket->write( reinterpret_cast<const char*>( payload.data() ) + numberOfWritten
+                                              , payload.size() - numberOfWritten );
+        numberOfWritten = 0;
+        if ( result == -1 ) {
+            return false;
+        }
+    }
+
+    m_flushSocket();
+    return true;
+}
+
+void
+QtTcpConnectionHelper::onDataArrived() {
+    assert(m_connectedSocket);
+
+    // data are left in Qt socket, receiver reads them straight to its own buffer
+    std::lock_guard lock(m_callbacksMutex);
+    // callback may register another one (e.g. server hands connection over to protocol executor),
+    // so the invoked callback cannot be the instance which is overwritten
+    auto callback = m_newDataReadyToReadCallback;
+    if (callback != nullptr) {
+        callback();
     }
 }
 
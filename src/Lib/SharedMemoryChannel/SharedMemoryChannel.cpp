@@ -0,0 +1,416 @@
+#include "Lib/SharedMemoryChannel/SharedMemoryChannel.h"
+
+#include "Lib/C++Tools/ScopedAction.h"
+#include "Lib/Log/Logger.h"
+
+#include <QTimer>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+namespace Challenge {
+
+namespace {
+
+    //! Layout of shared memory, ring of each direction has own control and buffer
+    struct Segment {
+        SharedMemoryRing::Control toServer;
+        SharedMemoryRing::Control toClient;
+        std::byte toServerData[ SharedMemoryChannel::RING_CAPACITY ];
+        std::byte toClientData[ SharedMemoryChannel::RING_CAPACITY ];
+    };
+
+    //! Descriptors passed from server to client: segment, wake up of client, wake up of server
+    constexpr std::size_t NUMBER_OF_PASSED_DESCRIPTORS = 3;
+
+} // namespace
+
+SharedMemoryChannel::SharedMemoryChannel( int _socket, Side _side ) : m_socket( _socket ) {
+    if ( m_socket < 0 ) {
+        throw std::runtime_error( "Invalid socket" );
+    }
+
+    // destructor is not called for not constructed object
+    bool isConstructed = false;
+    ScopedAction closeOnFailure( [this, &isConstructed]{ if ( !isConstructed ) { closeDescriptors(); } } );
+
+    if ( _side == Side::Server ) {
+        createSharedMemory();
+    } else {
+        receiveSharedMemory();
+    }
+
+    auto segment = static_cast<Segment*>( m_segment );
+    const bool isServer = _side == Side::Server;
+    m_inbound = std::make_unique<SharedMemoryRing>( isServer ? segment->toServer : segment->toClient
+                                                  , isServer ? segment->toServerData : segment->toClientData
+                                                  , RING_CAPACITY );
+    m_outbound = std::make_unique<SharedMemoryRing>( isServer ? segment->toClient : segment->toServer
+                                                   , isServer ? segment->toClientData : segment->toServerData
+                                                   , RING_CAPACITY );
+
+    m_wakeUpNotifier = std::make_unique<QSocketNotifier>( m_wakeUpEvent, QSocketNotifier::Read );
+    QObject::connect( m_wakeUpNotifier.get(), &QSocketNotifier::activated, [this]{ onWakeUp(); } );
+
+    m_socketNotifier = std::make_unique<QSocketNotifier>( m_socket, QSocketNotifier::Read );
+    QObject::connect( m_socketNotifier.get(), &QSocketNotifier::activated, [this]{ onSocketEvent(); } );
+
+    isConstructed = true;
+    LOG_INFORMATION( "New shared memory connection established" );
+}
+
+SharedMemoryChannel::~SharedMemoryChannel() {
+    // bytes written to ring are delivered, even if peer was not woken yet
+    flush();
+
+    closeDescriptors();
+}
+
+void
+SharedMemoryChannel::createSharedMemory() {
+    auto memory = ::memfd_create( "challenge.channel", MFD_CLOEXEC );
+    if ( memory == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    // mapping keeps memory alive, descriptor is needed only until it is passed to client
+    ScopedAction closeMemory( [memory]{ ::close( memory ); } );
+
+    if ( ::ftruncate( memory, sizeof( Segment ) ) == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    mapSharedMemory( memory );
+    new ( m_segment ) Segment;
+
+    m_wakeUpEvent = ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    m_peerWakeUpEvent = ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    if ( m_wakeUpEvent == -1 || m_peerWakeUpEvent == -1 ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    const std::array<int, NUMBER_OF_PASSED_DESCRIPTORS> descriptors = { memory, m_peerWakeUpEvent, m_wakeUpEvent };
+
+    // one byte of data is required to pass descriptors
+    char data = 0;
+    iovec buffer{ &data, sizeof( data ) };
+    alignas( cmsghdr ) char control[ CMSG_SPACE( sizeof( descriptors ) ) ]{};
+
+    msghdr message{};
+    message.msg_iov = &buffer;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof( control );
+
+    auto controlMessage = CMSG_FIRSTHDR( &message );
+    controlMessage->cmsg_level = SOL_SOCKET;
+    controlMessage->cmsg_type = SCM_RIGHTS;
+    controlMessage->cmsg_len = CMSG_LEN( sizeof( descriptors ) );
+    std::memcpy( CMSG_DATA( controlMessage ), descriptors.data(), sizeof( descriptors ) );
+
+    if ( ::sendmsg( m_socket, &message, MSG_NOSIGNAL ) != sizeof( data ) ) {
+        throw std::runtime_error( "Cannot pass shared memory to client" );
+    }
+}
+
+void
+SharedMemoryChannel::receiveSharedMemory() {
+    pollfd socketEvents{ m_socket, POLLIN, 0 };
+    if ( ::poll( &socketEvents, 1, SETUP_TIMEOUT_MS ) != 1 ) {
+        throw std::runtime_error( "Shared memory was not received from server" );
+    }
+
+    std::array<int, NUMBER_OF_PASSED_DESCRIPTORS> descriptors;
+
+    char data = 0;
+    iovec buffer{ &data, sizeof( data ) };
+    alignas( cmsghdr ) char control[ CMSG_SPACE( sizeof( descriptors ) ) ]{};
+
+    msghdr message{};
+    message.msg_iov = &buffer;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof( control );
+
+    if ( ::recvmsg( m_socket, &message, MSG_CMSG_CLOEXEC ) != sizeof( data ) ) {
+        throw std::runtime_error( "Shared memory was not received from server" );
+    }
+
+    auto controlMessage = CMSG_FIRSTHDR( &message );
+    if ( controlMessage == nullptr
+         || controlMessage->cmsg_level != SOL_SOCKET
+         || controlMessage->cmsg_type != SCM_RIGHTS
+         || controlMessage->cmsg_len != CMSG_LEN( sizeof( descriptors ) ) ) {
+        throw std::runtime_error( "Shared memory was not received from server" );
+    }
+
+    std::memcpy( descriptors.data(), CMSG_DATA( controlMessage ), sizeof( descriptors ) );
+
+    const auto memory = descriptors[0];
+    ScopedAction closeMemory( [memory]{ ::close( memory ); } );
+    m_wakeUpEvent = descriptors[1];
+    m_peerWakeUpEvent = descriptors[2];
+
+    struct stat memoryStatus{};
+    if ( ::fstat( memory, &memoryStatus ) == -1 || memoryStatus.st_size != sizeof( Segment ) ) {
+        throw std::runtime_error( "Unexpected size of shared memory" );
+    }
+
+    mapSharedMemory( memory );
+}
+
+void
+SharedMemoryChannel::mapSharedMemory( int _memoryDescriptor ) {
+    auto segment = ::mmap( nullptr, sizeof( Segment ), PROT_READ | PROT_WRITE, MAP_SHARED, _memoryDescriptor, 0 );
+    if ( segment == MAP_FAILED ) {
+        throw std::runtime_error( std::strerror( errno ) );
+    }
+
+    m_segment = segment;
+}
+
+void
+SharedMemoryChannel::closeDescriptors() {
+    m_wakeUpNotifier.reset();
+    m_socketNotifier.reset();
+
+    if ( m_segment != nullptr ) {
+        ::munmap( m_segment, sizeof( Segment ) );
+    }
+
+    for ( auto descriptor : { m_wakeUpEvent, m_peerWakeUpEvent, m_socket } ) {
+        if ( descriptor != -1 ) {
+            ::close( descriptor );
+        }
+    }
+}
+
+bool
+SharedMemoryChannel::isValid() const {
+    return m_isValid;
+}
+
+bool
+SharedMemoryChannel::registerConnectionExpiredCallback( ConnectionExpiredCallback _callback ) {
+    std::lock_guard lock( m_callbacksMutex );
+
+    bool result = m_connectionExpiredCallback != nullptr;
+    m_connectionExpiredCallback = _callback;
+    return result;
+}
+
+bool
+SharedMemoryChannel::registerNewDataReadyToReadCallback( NewDataReadyToReadCallback _callback ) {
+    std::lock_guard lock( m_callbacksMutex );
+
+    bool result = m_newDataReadyToReadCallback != nullptr;
+    m_newDataReadyToReadCallback = _callback;
+    return result;
+}
+
+std::optional<SharedMemoryChannel::Payload>
+SharedMemoryChannel::receive() {
+    Payload payload;
+    if ( !receiveInto( payload ).has_value() ) {
+        return std::nullopt;
+    }
+
+    return payload;
+}
+
+std::optional<std::size_t>
+SharedMemoryChannel::receiveInto( Payload& _buffer ) {
+    std::lock_guard guard( m_inboundMutex );
+
+    auto readRing = [this, &_buffer] {
+        auto numberOfRead = m_inbound->readInto( _buffer );
+        if ( numberOfRead > 0 && m_inbound->takeWaitingProducer() ) {
+            ::eventfd_write( m_peerWakeUpEvent, 1 );
+        }
+        return numberOfRead;
+    };
+
+    auto numberOfReceived = readRing();
+
+    if ( m_inbound->isCorrupted() ) {
+        markRingCorrupted();
+        return std::nullopt;
+    }
+
+    // client may poll without event loop, so closed peer is detected here as well
+    if ( numberOfReceived == 0 && isValid() && !isPeerConnected() ) {
+        m_isValid = false;
+        // peer could write its last bytes after the ring was read
+        numberOfReceived = readRing();
+    }
+
+    if ( numberOfReceived == 0 && !isValid() ) {
+        return std::nullopt;
+    }
+
+    return numberOfReceived;
+}
+
+std::optional<uint32_t>
+SharedMemoryChannel::send( const Payload& _payload ) {
+    if ( _payload.size() > std::numeric_limits<uint32_t>::max() ) {
+        return std::nullopt;
+    }
+
+    if ( !isValid() ) {
+        return std::nullopt;
+    }
+
+    std::lock_guard guard( m_outboundMutex );
+
+    auto numberOfWritten = std::size_t{ 0 };
+    if ( m_pendingOffset == m_pending.size() ) {
+        numberOfWritten = m_outbound->write( _payload );
+        m_isPeerWakeUpPending = m_isPeerWakeUpPending || numberOfWritten > 0;
+    }
+
+    if ( m_outbound->isCorrupted() ) {
+        markRingCorrupted();
+        return std::nullopt;
+    }
+
+    if ( numberOfWritten < _payload.size() ) {
+        // already written part of pending buffer is dropped, so buffer does not grow while peer reads slowly
+        m_pending.erase( m_pending.begin(), m_pending.begin() + m_pendingOffset );
+        m_pendingOffset = 0;
+
+        if ( m_pending.size() + _payload.size() - numberOfWritten > MAX_PENDING_SIZE ) {
+            // part of payload may be already in ring, so stream of peer cannot continue
+            LOG_ERROR( "Pending buffer of shared memory connection is full" );
+            m_isValid = false;
+            return std::nullopt;
+        }
+
+        m_pending.insert( m_pending.end(), _payload.begin() + numberOfWritten, _payload.end() );
+        writePending();
+
+        if ( !isValid() ) {
+            return std::nullopt;
+        }
+    }
+
+    if ( m_isPeerWakeUpPending && !m_isFlushScheduled ) {
+        // packets sent during this iteration of event loop wake up peer once
+        m_isFlushScheduled = true;
+        QTimer::singleShot( 0, this, [this]{ flush(); } );
+    }
+
+    return static_cast<uint32_t>( _payload.size() );
+}
+
+bool
+SharedMemoryChannel::flush() {
+    std::lock_guard guard( m_outboundMutex );
+
+    m_isFlushScheduled = false;
+    writePending();
+
+    if ( m_isPeerWakeUpPending ) {
+        wakeUpPeer();
+    }
+
+    return isValid();
+}
+
+void
+SharedMemoryChannel::writePending() {
+    while ( m_pendingOffset < m_pending.size() ) {
+        auto numberOfWritten = m_outbound->write( BytesView( m_pending.data() + m_pendingOffset, m_pending.size() - m_pendingOffset ) );
+        m_pendingOffset += numberOfWritten;
+        m_isPeerWakeUpPending = m_isPeerWakeUpPending || numberOfWritten > 0;
+
+        if ( m_outbound->isCorrupted() ) {
+            markRingCorrupted();
+            return;
+        }
+
+        if ( m_pendingOffset < m_pending.size() && !m_outbound->waitForSpace() ) {
+            // peer has to read the full ring, it wakes this side when space is freed
+            wakeUpPeer();
+            return;
+        }
+    }
+
+    m_pending.clear();
+    m_pendingOffset = 0;
+}
+
+void
+SharedMemoryChannel::markRingCorrupted() {
+    if ( m_isValid.exchange( false ) ) {
+        LOG_ERROR( "Peer corrupted ring of shared memory connection" );
+    }
+}
+
+void
+SharedMemoryChannel::wakeUpPeer() {
+    m_isPeerWakeUpPending = false;
+    ::eventfd_write( m_peerWakeUpEvent, 1 );
+}
+
+bool
+SharedMemoryChannel::isPeerConnected() {
+    std::array<char, 16> data;
+    auto result = ::recv( m_socket, data.data(), data.size(), MSG_DONTWAIT );
+    return result > 0 || ( result == -1 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ) );
+}
+
+void
+SharedMemoryChannel::onWakeUp() {
+    // counter of wake ups is reset, data and free space are checked in rings
+    eventfd_t numberOfWakeUps = 0;
+    ::eventfd_read( m_wakeUpEvent, &numberOfWakeUps );
+
+    flush();
+
+    if ( m_inbound->isEmpty() ) {
+        return;
+    }
+
+    std::lock_guard lock( m_callbacksMutex );
+    // callback may replace itself, so its copy is invoked
+    auto callback = m_newDataReadyToReadCallback;
+    if ( callback != nullptr ) {
+        callback();
+    }
+}
+
+void
+SharedMemoryChannel::onSocketEvent() {
+    if ( isPeerConnected() ) {
+        return;
+    }
+
+    m_isValid = false;
+    // closed socket stays readable
+    m_socketNotifier->setEnabled( false );
+
+    std::lock_guard lock( m_callbacksMutex );
+    if ( m_isExpirationNotified ) {
+        return;
+    }
+
+    m_isExpirationNotified = true;
+    LOG_INFORMATION( "Connection lost" );
+    if ( m_connectionExpiredCallback != nullptr ) {
+        m_connectionExpiredCallback();
+    }
+}
+
+} // namespace Challenge
@@ -0,0 +1,108 @@
+#include "Lib/SharedMemoryChannel/SharedMemoryRing.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Challenge {
+
+SharedMemoryRing::SharedMemoryRing( Control& _control, std::byte* _data, std::size_t _capacity )
+    : m_control( _control )
+    , m_data( _data )
+    , m_capacity( _capacity )
+    , m_head( _control.head.load( std::memory_order_relaxed ) )
+    , m_tail( _control.tail.load( std::memory_order_relaxed ) ) {
+
+    if ( m_capacity == 0 || ( m_capacity & ( m_capacity - 1 ) ) != 0 ) {
+        throw std::runtime_error( "Capacity of ring must be power of two" );
+    }
+}
+
+std::size_t
+SharedMemoryRing::write( BytesView _bytes ) {
+    if ( m_isCorrupted ) {
+        return 0;
+    }
+
+    const auto tail = m_control.tail.load( std::memory_order_acquire );
+    // consumer cannot read bytes which were not written yet, tail before head - capacity is wrapped as well
+    if ( m_head - tail > m_capacity ) {
+        m_isCorrupted = true;
+        return 0;
+    }
+
+    const auto numberOfWritten = std::min<std::size_t>( _bytes.size(), m_capacity - ( m_head - tail ) );
+    if ( numberOfWritten == 0 ) {
+        return 0;
+    }
+
+    // bytes wrapped at the end of buffer are copied in two parts
+    const auto offset = m_head & ( m_capacity - 1 );
+    const auto firstPart = std::min( numberOfWritten, m_capacity - offset );
+    std::memcpy( m_data + offset, _bytes.data(), firstPart );
+    std::memcpy( m_data, _bytes.data() + firstPart, numberOfWritten - firstPart );
+
+    m_head += numberOfWritten;
+    m_control.head.store( m_head, std::memory_order_release );
+    return numberOfWritten;
+}
+
+std::size_t
+SharedMemoryRing::readInto( std::vector<std::byte>& _buffer ) {
+    if ( m_isCorrupted ) {
+        return 0;
+    }
+
+    const auto head = m_control.head.load( std::memory_order_acquire );
+    // producer cannot write more than capacity, head before tail is wrapped as well
+    if ( head - m_tail > m_capacity ) {
+        m_isCorrupted = true;
+        return 0;
+    }
+
+    const auto numberOfRead = static_cast<std::size_t>( head - m_tail );
+    if ( numberOfRead == 0 ) {
+        return 0;
+    }
+
+    const auto offset = m_tail & ( m_capacity - 1 );
+    const auto firstPart = std::min( numberOfRead, m_capacity - offset );
+    _buffer.insert( _buffer.end(), m_data + offset, m_data + offset + firstPart );
+    _buffer.insert( _buffer.end(), m_data, m_data + ( numberOfRead - firstPart ) );
+
+    // sequentially consistent store pairs with announcement of waiting producer, so its wake up is not lost
+    m_tail = head;
+    m_control.tail.store( m_tail, std::memory_order_seq_cst );
+    return numberOfRead;
+}
+
+bool
+SharedMemoryRing::isEmpty() const {
+    return m_control.head.load( std::memory_order_acquire ) == m_tail;
+}
+
+bool
+SharedMemoryRing::waitForSpace() {
+    m_control.isProducerWaiting.store( true, std::memory_order_seq_cst );
+
+    const auto tail = m_control.tail.load( std::memory_order_seq_cst );
+    // corrupted tail is found by next write
+    return m_head - tail != m_capacity;
+}
+
+bool
+SharedMemoryRing::takeWaitingProducer() {
+    return m_control.isProducerWaiting.exchange( false, std::memory_order_seq_cst );
+}
+
+bool
+SharedMemoryRing::isCorrupted() const {
+    return m_isCorrupted;
+}
+
+std::size_t
+SharedMemoryRing::capacity() const {
+    return m_capacity;
+}
+
+} // namespace Challenge
@@ -0,0 +1,107 @@
+#include "Lib/WritesQueue/WritesQueue.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace Challenge {
+
+WritesQueue::WritesQueue( std::size_t _maxNumberOfEvents, EventsStorage::FullQueuePolicy _policy )
+    : m_maxNumberOfEvents( _maxNumberOfEvents )
+    , m_policy( _policy ) {
+    if ( m_maxNumberOfEvents == 0 ) {
+        throw std::runtime_error( "Queue of writer cannot be empty" );
+    }
+}
+
+std::vector<WritesQueue::PendingWrite>
+WritesQueue::push( PendingWrite _write, std::unique_lock<std::mutex>& _lock, std::condition_variable& _notFullCondition ) {
+    assert( !_write.events.empty() );
+    assert( _write.completion );
+    assert( _lock.owns_lock() );
+
+    _write.priority = std::max_element( _write.events.begin(), _write.events.end(), []( const auto& _first, const auto& _second ){
+        return _first.priority < _second.priority;
+    })->priority;
+
+    const auto size = _write.events.size();
+    std::vector<PendingWrite> notQueuedWrites;
+
+    if ( !isSpaceFor( size ) ) {
+        using EventsStorage::FullQueuePolicy;
+        if ( m_policy == FullQueuePolicy::Block ) {
+            _notFullCondition.wait( _lock, [this, size]{ return isSpaceFor( size ); } );
+        } else if ( m_policy == FullQueuePolicy::ShedLowPriority ) {
+            notQueuedWrites = shedLowerPriority( _write.priority, size );
+        }
+    }
+
+    if ( !isSpaceFor( size ) ) {
+        // write was rejected
+        notQueuedWrites.push_back( std::move( _write ) );
+        return notQueuedWrites;
+    }
+
+    m_numberOfEvents += size;
+    m_writes.push_back( std::move( _write ) );
+    return notQueuedWrites;
+}
+
+void
+WritesQueue::takeBatch( std::size_t _maxNumberOfEvents, std::vector<PendingWrite>& _writes ) {
+    assert( !m_writes.empty() );
+
+    std::size_t numberOfEvents = 0;
+    const auto firstWrite = _writes.size();
+    while ( !m_writes.empty() && ( _writes.size() == firstWrite || numberOfEvents + m_writes.front().events.size() <= _maxNumberOfEvents ) ) {
+        numberOfEvents += m_writes.front().events.size();
+        _writes.push_back( std::move( m_writes.front() ) );
+        m_writes.pop_front();
+    }
+    m_numberOfEvents -= numberOfEvents;
+}
+
+bool
+WritesQueue::isSpaceFor( std::size_t _numberOfEvents ) const {
+    return m_numberOfEvents == 0 || m_numberOfEvents + _numberOfEvents <= m_maxNumberOfEvents;
+}
+
+std::vector<WritesQueue::PendingWrite>
+WritesQueue::shedLowerPriority( uint32_t _priority, std::size_t _numberOfEvents ) {
+    // writes with the lowest priority are shed first, older before newer
+    std::vector<std::size_t> candidates;
+    for ( std::size_t position = 0; position < m_writes.size(); ++position ) {
+        if ( m_writes[position].priority < _priority ) {
+            candidates.push_back( position );
+        }
+    }
+    std::stable_sort( candidates.begin(), candidates.end(), [this]( auto _first, auto _second ){
+        return m_writes[_first].priority < m_writes[_second].priority;
+    });
+
+    std::size_t numberOfEvents = m_numberOfEvents;
+    auto shedCandidates = candidates.begin();
+    while ( shedCandidates != candidates.end() && numberOfEvents > 0 && numberOfEvents + _numberOfEvents > m_maxNumberOfEvents ) {
+        numberOfEvents -= m_writes[*shedCandidates].events.size();
+        ++shedCandidates;
+    }
+
+    // nothing is shed, when space cannot be made
+    if ( numberOfEvents > 0 && numberOfEvents + _numberOfEvents > m_maxNumberOfEvents ) {
+        return {};
+    }
+
+    candidates.erase( shedCandidates, candidates.end() );
+    std::sort( candidates.begin(), candidates.end() );
+
+    std::vector<PendingWrite> shedWrites;
+    for ( auto position = candidates.rbegin(); position != candidates.rend(); ++position ) {
+        shedWrites.push_back( std::move( m_writes[*position] ) );
+        m_writes.erase( m_writes.begin() + *position );
+    }
+    m_numberOfEvents = numberOfEvents;
+
+    return shedWrites;
+}
+
+} // namespace Challenge
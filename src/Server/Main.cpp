@@ -1,7 +1,9 @@
 #include <QCoreApplication>
+#include <QCommandLineParser>
 
 #include "Server.h"
 
+#include "Configuration/Defines.h"
 #include "Lib/Log/Logger.h"
 #include "Lib/C++Tools/ScopedAction.h"
 
@@ -13,7 +15,84 @@ int32_t  main( int32_t _argc, char** _argv) try {
 
     QCoreApplication application(_argc, _argv);
 
-    Challenge::Communication::Server::Server server;
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption storageOption( "storage", "Storage of events: sqlite (default) or log", "engine", "sqlite" );
+    parser.addOption( storageOption );
+    QCommandLineOption transportOption( "transport", "Transport of connections: qt (default) or epoll", "engine", "qt" );
+    parser.addOption( transportOption );
+    QCommandLineOption workersOption( "workers", "Number of threads serving connections, more than 1 requires epoll transport", "number", "1" );
+    parser.addOption( workersOption );
+    QCommandLineOption localSocketOption( "local-socket", "Path of local socket for clients on the same host, server listens also on it", "path" );
+    parser.addOption( localSocketOption );
+    QCommandLineOption sharedMemoryOption( "shared-memory", "Path of local socket on which clients on the same host get shared memory for data", "path" );
+    parser.addOption( sharedMemoryOption );
+    QCommandLineOption writerQueueOption( "writer-queue", "Number of events waiting for writer thread of storage (default 4096), log storage with 0 saves events in threads of workers", "size", QString::number( STORAGE_WRITER_QUEUE_SIZE ) );
+    parser.addOption( writerQueueOption );
+    QCommandLineOption writerQueuePolicyOption( "writer-queue-policy", "Handling of events when queue of writer is full: reject (default), shed or block", "policy", "reject" );
+    parser.addOption( writerQueuePolicyOption );
+    QCommandLineOption tailCacheOption( "tail-cache", "Number of the newest events kept in memory for reads of clients, 0 (default) reads all events from storage", "size", "0" );
+    parser.addOption( tailCacheOption );
+    QCommandLineOption encodedEventsCacheOption( "encoded-events-cache", "Number of events kept encoded for responses to clients, 0 (default) encodes events for every response", "size", "0" );
+    parser.addOption( encodedEventsCacheOption );
+    parser.process( application );
+
+    using Challenge::Communication::Server::Server;
+    const auto storage = parser.value( storageOption );
+    if ( storage != "sqlite" && storage != "log" ) {
+        LOG_ERROR( "Unknown storage engine" );
+        return -1;
+    }
+
+    const auto transport = parser.value( transportOption );
+    if ( transport != "qt" && transport != "epoll" ) {
+        LOG_ERROR( "Unknown transport engine" );
+        return -1;
+    }
+
+    bool isNumber = false;
+    const auto workers = parser.value( workersOption ).toUInt( &isNumber );
+    if ( !isNumber || workers == 0 ) {
+        LOG_ERROR( "Invalid number of workers" );
+        return -1;
+    }
+
+    const auto writerQueueSize = parser.value( writerQueueOption ).toUInt( &isNumber );
+    if ( !isNumber || ( writerQueueSize == 0 && storage != "log" ) ) {
+        LOG_ERROR( "Invalid size of writer queue" );
+        return -1;
+    }
+
+    const auto tailCacheSize = parser.value( tailCacheOption ).toUInt( &isNumber );
+    if ( !isNumber ) {
+        LOG_ERROR( "Invalid size of tail cache" );
+        return -1;
+    }
+
+    const auto encodedEventsCacheSize = parser.value( encodedEventsCacheOption ).toUInt( &isNumber );
+    if ( !isNumber ) {
+        LOG_ERROR( "Invalid size of encoded events cache" );
+        return -1;
+    }
+
+    using Challenge::EventsStorage::FullQueuePolicy;
+    const auto writerQueuePolicy = parser.value( writerQueuePolicyOption );
+    if ( writerQueuePolicy != "block" && writerQueuePolicy != "reject" && writerQueuePolicy != "shed" ) {
+        LOG_ERROR( "Unknown policy of writer queue" );
+        return -1;
+    }
+
+    Server server( storage == "log" ? Server::StorageEngine::AppendLog : Server::StorageEngine::Sqlite
+                 , transport == "epoll" ? Server::TransportEngine::Epoll : Server::TransportEngine::QtTcp
+                 , workers
+                 , parser.value( localSocketOption ).toStdString()
+                 , parser.value( sharedMemoryOption ).toStdString()
+                 , writerQueueSize
+                 , writerQueuePolicy == "block" ? FullQueuePolicy::Block
+                   : writerQueuePolicy == "shed" ? FullQueuePolicy::ShedLowPriority
+                   : FullQueuePolicy::Reject
+                 , tailCacheSize
+                 , encodedEventsCacheSize );
 
     return QCoreApplication::exec();
 } catch ( std::exception& _exception ) {
@@ -22,4 +101,4 @@ int32_t  main( int32_t _argc, char** _argv) try {
 } catch (...) {
     LOG_ERROR( "Unhandled unknown exception" );
     return -1;
-}
\ No newline at end of file
+}
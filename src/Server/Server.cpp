@@ -1,113 +1,162 @@
 #include "Server.h"
+#include "ServerWorker.h"
 
 #include "Communication/Server/TransportConnectivityManager/ITransportConnectivityManager.h"
-#include "Communication/Server/TransportConnectivityManager/ITransportConnection.h"
-#include "Communication/Server/IHandshake.h"
-#include "Communication/Server/IProtocolExecutor.h"
 
 #include "EventsStorage/IEventsStorage.h"
 
+#include "Lib/EncodedEventsCache/EncodedEventsCache.h"
+#include "Lib/PacketCoderV1/PacketFactory.h"
+
+#include "Configuration/Defines.h"
+
+#include <QTimer>
+
 #include <stdexcept>
 
 namespace Challenge::Communication::Server {
 
-Server::Server() {
-    m_connectivityManager = ITransportConnectivityManager::create();
+Server::Server( StorageEngine _storageEngine, TransportEngine _transportEngine, uint32_t _numberOfWorkers
+              , const std::string& _localSocketPath, const std::string& _sharedMemorySocketPath
+              , std::size_t _writerQueueSize, Challenge::EventsStorage::FullQueuePolicy _writerQueuePolicy
+              , std::size_t _tailCacheSize, std::size_t _encodedEventsCacheSize ) {
+    if ( _numberOfWorkers == 0 ) {
+        throw std::runtime_error("At least one worker is required");
+    }
 
-    if ( !m_connectivityManager ) {
-        throw std::runtime_error("Cannot create connectivity manager");
+    const bool isMultiReactor = _numberOfWorkers > 1;
+    if ( isMultiReactor && _transportEngine != TransportEngine::Epoll ) {
+        throw std::runtime_error("More workers require epoll transport");
     }
 
-    m_storage = Challenge::EventsStorage::IEventsStorage::create();
+    using Challenge::EventsStorage::IEventsStorage;
+    // sqlite storage applies policy of full queue by its own writer thread, so events are not handed over twice
+    m_storage = _storageEngine == StorageEngine::AppendLog
+            ? IEventsStorage::create( Challenge::EventsStorage::AppendLogEngine{ LOG_STORAGE_DIRECTORY } )
+            : IEventsStorage::create( Challenge::EventsStorage::SqliteEngine{ _writerQueueSize, _writerQueuePolicy } );
 
     if ( !m_storage ) {
         throw std::runtime_error("Cannot create storage");
     }
 
-    m_connectivityManager->registerNewConnectionCallback([this](auto _connection){onNewConnection(_connection);});
+    if ( _tailCacheSize > 0 ) {
+        // cache hands saves over to asynchronous path of storage, so they are still written in batches
+        m_storage = IEventsStorage::create( Challenge::EventsStorage::TailCacheEngine{ m_storage, _tailCacheSize, STORAGE_TAIL_CACHE_MAX_BYTES } );
 
-    auto connectionResult = connect( &m_timer, &QTimer::timeout, this, &Server::onServicesCheck );
-    if (!connectionResult ) {
-        throw std::runtime_error( "Cannot connect slot with QTimer signal" );
+        if ( !m_storage ) {
+            throw std::runtime_error("Cannot create cache of storage");
+        }
     }
 
-    m_timer.setInterval( 200 );
-    m_timer.start();
-}
+    if ( _storageEngine == StorageEngine::AppendLog && _writerQueueSize > 0 ) {
+        // log storage saves in calling thread, so it gets own writer thread and workers do not wait for disk
+        m_storage = IEventsStorage::create( Challenge::EventsStorage::AsyncWriterEngine{ m_storage, _writerQueueSize, _writerQueuePolicy } );
 
-void
-Server::onNewConnection( std::shared_ptr<ITransportConnection> _newConnection ) {
-    auto time = std::chrono::steady_clock::now();
-    m_connectionWaitingForHandshake.push_back( std::make_pair(_newConnection, time) );
-}
+        if ( !m_storage ) {
+            throw std::runtime_error("Cannot create writer of storage");
+        }
+    }
 
-void
-Server::agingConnections() {
-    auto time = std::chrono::steady_clock::now();
-
-    m_connectionWaitingForHandshake.erase(
-            std::remove_if(
-                    m_connectionWaitingForHandshake.begin()
-                    , m_connectionWaitingForHandshake.end()
-                    , [time](const auto& _connectionAndTime ) {
-                        return (time - _connectionAndTime.second ) >= std::chrono::seconds(1);
-                    }
-            )
-            , m_connectionWaitingForHandshake.end()
-    );
-}
+    if ( _encodedEventsCacheSize > 0 ) {
+        m_encodedEventsCache = std::make_shared<Challenge::EncodedEventsCache>( _encodedEventsCacheSize, ENCODED_EVENTS_CACHE_MAX_BYTES );
+    }
 
-void
-Server::handshakeOnConnections() {
-    auto createHandshake = [this]( ConnectionAndTime& _connectionAndTime ) {
-        auto handshake = IHandshake::start( _connectionAndTime.first );
+    // callbacks of storage are fired later in event loop, so saving of event does not wait for notifications,
+    // queued invocation is safe also when storage saves events in another thread
+    m_storage->setCallbackExecutor( [this]( std::function<void()> _task ) {
+        QMetaObject::invokeMethod( this, std::move( _task ), Qt::QueuedConnection );
+    });
+
+    m_storage->registerEventAddedCallback( [this]( uint64_t _numberOfEvents ){ onNewEventsSaved( _numberOfEvents ); }, this );
+
+    auto connectivityManagerFactory = [_transportEngine, isMultiReactor] {
+        return _transportEngine == TransportEngine::Epoll
+               ? ITransportConnectivityManager::create( EpollEngine{ isMultiReactor } )
+               : ITransportConnectivityManager::create();
+    };
+
+    for ( uint32_t worker = 0; worker < _numberOfWorkers; ++worker ) {
+        ServerWorker::ConnectivityManagerFactories factories{ connectivityManagerFactory };
 
-        if ( !handshake ) {
-            return false;
+        // only one listener can own the path, local clients skip TCP stack, so one worker serves them
+        if ( worker == 0 && !_localSocketPath.empty() ) {
+            factories.push_back( [_localSocketPath]{ return ITransportConnectivityManager::create( LocalSocketEngine{ _localSocketPath } ); } );
         }
 
-        auto protocolExecutor = IProtocolExecutor::create( handshake, m_storage );
-        if (!protocolExecutor) {
-            return false;
+        if ( worker == 0 && !_sharedMemorySocketPath.empty() ) {
+            factories.push_back( [_sharedMemorySocketPath]{ return ITransportConnectivityManager::create( SharedMemoryEngine{ _sharedMemorySocketPath } ); } );
         }
 
-        m_protocolsExecutors.push_back( protocolExecutor );
-        return true;
-    };
+        m_workers.push_back( std::make_unique<ServerWorker>( std::move( factories ), m_storage, m_encodedEventsCache ) );
+    }
 
-    m_connectionWaitingForHandshake.erase(
-            std::remove_if(
-                    m_connectionWaitingForHandshake.begin()
-                    , m_connectionWaitingForHandshake.end()
-                    , createHandshake
-            )
-            , m_connectionWaitingForHandshake.end()
-    );
-}
+    if ( !isMultiReactor ) {
+        if ( !m_workers.front()->start() ) {
+            m_storage->registerEventAddedCallback( nullptr, this );
+            throw std::runtime_error("Cannot create connectivity manager");
+        }
+        return;
+    }
 
+    for ( auto& worker : m_workers ) {
+        m_workersThreads.push_back( std::make_unique<QThread>() );
+        worker->moveToThread( m_workersThreads.back().get() );
+        m_workersThreads.back()->start();
+
+        bool isStarted = false;
+        QMetaObject::invokeMethod( worker.get(), "start", Qt::BlockingQueuedConnection, Q_RETURN_ARG( bool, isStarted ) );
+        if ( !isStarted ) {
+            stopWorkers();
+            m_storage->registerEventAddedCallback( nullptr, this );
+            throw std::runtime_error("Cannot create connectivity manager");
+        }
+    }
+}
 
-void
-Server::checkPendingConnections() {
-   agingConnections();
-   handshakeOnConnections();
+Server::~Server() {
+    m_storage->registerEventAddedCallback( nullptr, this );
+    stopWorkers();
+    // workers and their executors are gone, so storage is destroyed here while server still receives its callbacks,
+    // writer thread finishes queued saves and their completions are dropped by guard of workers
+    m_storage.reset();
 }
 
 void
-Server::checkProtocolsExecutors() {
-    m_protocolsExecutors.erase(
-            std::remove_if(
-                    m_protocolsExecutors.begin()
-                    , m_protocolsExecutors.end()
-                    , [](auto _protocolExecutor ) {return !_protocolExecutor->isValid();}
-            )
-            , m_protocolsExecutors.end()
-    );
+Server::stopWorkers() {
+    if ( m_workersThreads.empty() ) {
+        m_workers.clear();
+        return;
+    }
+
+    for ( std::size_t worker = 0; worker < m_workersThreads.size(); ++worker ) {
+        // connections and executors are released in the thread which serves them
+        QMetaObject::invokeMethod( m_workers[worker].get(), "stop", Qt::BlockingQueuedConnection );
+        m_workersThreads[worker]->quit();
+        m_workersThreads[worker]->wait();
+    }
+
+    m_workers.clear();
+    m_workersThreads.clear();
 }
 
 void
-Server::onServicesCheck() {
-    checkPendingConnections();
-    checkProtocolsExecutors();
+Server::onNewEventsSaved( uint64_t _numberOfEvents ) {
+    // handshake id is patched by each executor
+    constexpr PacketCoderV1::HandshakeId ANY_HANDSHAKE_ID = 0;
+
+    PacketCoderV1::PacketFactory packetFactory;
+    const auto notification = packetFactory.createNewEventsNotification( ANY_HANDSHAKE_ID, _numberOfEvents );
+
+    if ( m_workersThreads.empty() ) {
+        m_workers.front()->notifyNewEvents( notification );
+        return;
+    }
+
+    // each worker passes notification to its executors in own thread
+    for ( auto& worker : m_workers ) {
+        auto workerPointer = worker.get();
+        QTimer::singleShot( 0, workerPointer, [workerPointer, notification]{ workerPointer->notifyNewEvents( notification ); } );
+    }
 }
 
 } // namespace Challenge::Communication::Server
@@ -1,65 +1,92 @@
 #pragma once
 
-#include <QTimer>
+#include "EventsStorage/IEventsStorage.h"
+#include "Configuration/Defines.h"
 
-#include <chrono>
+#include <QObject>
+#include <QThread>
+
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace Challenge {
-namespace EventsStorage {
-        class IEventsStorage;
-} // namespace Storage
+    class EncodedEventsCache;
 } // namespace Challenge
 
 namespace Challenge {
 namespace Communication {
 namespace Server {
 
-            class ITransportConnectivityManager;
-
-            class ITransportConnection;
-
-            class IProtocolExecutor;
+            class ServerWorker;
 
             class Server : public QObject {
             Q_OBJECT
             public:
+                //! Engine used to save events
+                enum class StorageEngine {
+                    Sqlite,
+                    AppendLog
+                };
+
+                //! Transport used to accept and serve connections
+                enum class TransportEngine {
+                    QtTcp,
+                    Epoll
+                };
+
                 //! Constructor
                 /*!
-                *
+                *  With one worker connections are served by thread of the server. With more workers each worker runs own
+                *  event loop in own thread and listens on the port shared with SO_REUSEPORT, so only epoll transport
+                *  can be used
+                * @param _localSocketPath when not empty, server listens also on local socket with this path, for clients
+                *  on the same host. Local connections are served by the first worker
+                * @param _sharedMemorySocketPath when not empty, server accepts clients on the same host also on local socket
+                *  with this path and exchanges data with them over shared memory. They are served by the first worker
+                * @param _writerQueueSize maximal number of events waiting for writer thread of storage. Sqlite storage
+                *  always saves events by own writer thread, so the size must not be 0. Log storage gets own writer
+                *  thread when the size is not 0, otherwise events are saved in thread of worker
+                * @param _writerQueuePolicy what happens with event when queue of writer is full, blocking policy blocks
+                *  also thread of worker
+                * @param _tailCacheSize when not 0, this number of the newest events is kept in memory and reads of them
+                *  do not go to storage
+                * @param _encodedEventsCacheSize when not 0, this number of events read by clients is kept encoded for
+                *  responses, so next responses with them are only copied
                 * @throw may throw std::runtime_error
                 */
-                Server();
+                explicit Server( StorageEngine _storageEngine = StorageEngine::Sqlite
+                               , TransportEngine _transportEngine = TransportEngine::QtTcp
+                               , uint32_t _numberOfWorkers = 1
+                               , const std::string& _localSocketPath = {}
+                               , const std::string& _sharedMemorySocketPath = {}
+                               , std::size_t _writerQueueSize = STORAGE_WRITER_QUEUE_SIZE
+                               , Challenge::EventsStorage::FullQueuePolicy _writerQueuePolicy = Challenge::EventsStorage::FullQueuePolicy::Reject
+                               , std::size_t _tailCacheSize = 0
+                               , std::size_t _encodedEventsCacheSize = 0 );
+                ~Server() override;
 
                 Server(const Server &) = delete;
                 Server(Server &&) = delete;
                 Server &operator=(Server &) = delete;
                 Server &operator=(Server &&) = delete;
 
-            private slots:
-                void onServicesCheck();
-
             private:
-                void onNewConnection(std::shared_ptr<ITransportConnection> _newConnection);
-                void checkPendingConnections();
-                void agingConnections();
-                void handshakeOnConnections();
-                void checkProtocolsExecutors();
+                //! Encodes notification once and passes it to all workers
+                void onNewEventsSaved( uint64_t _numberOfEvents );
+                //! Stops workers and their threads
+                void stopWorkers();
 
             private:
-                using ConnectionStartTimePoint = std::chrono::time_point<std::chrono::steady_clock>;
-                using ConnectionAndTime = std::pair<std::shared_ptr<ITransportConnection>, ConnectionStartTimePoint>;
-                using ConnectionsWaitingForHandshake = std::vector<ConnectionAndTime>;
-                using ProtocolsExecutors = std::vector<std::shared_ptr<IProtocolExecutor> >;
-
-                std::shared_ptr<ITransportConnectivityManager> m_connectivityManager;
                 std::shared_ptr<Challenge::EventsStorage::IEventsStorage> m_storage;
+                //! Shared by all workers, nullptr when events are encoded for every response
+                std::shared_ptr<Challenge::EncodedEventsCache> m_encodedEventsCache;
 
-                ConnectionsWaitingForHandshake m_connectionWaitingForHandshake;
-                ProtocolsExecutors m_protocolsExecutors;
-
-                QTimer m_timer;
+                std::vector<std::unique_ptr<ServerWorker>> m_workers;
+                //! Threads of workers, empty when the only worker runs in thread of the server
+                std::vector<std::unique_ptr<QThread>> m_workersThreads;
             };
 } //namespace Server
 } // namespace Communication
@@ -0,0 +1,165 @@
+#include "ServerWorker.h"
+
+#include "Communication/Server/TransportConnectivityManager/ITransportConnectivityManager.h"
+#include "Communication/Server/TransportConnectivityManager/ITransportConnection.h"
+#include "Communication/Server/IHandshake.h"
+#include "Communication/Server/IProtocolExecutor.h"
+
+#include "EventsStorage/IEventsStorage.h"
+
+#include "Lib/Log/Logger.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Challenge::Communication::Server {
+
+ServerWorker::ServerWorker( ConnectivityManagerFactories _connectivityManagerFactories
+                          , std::shared_ptr<Challenge::EventsStorage::IEventsStorage> _storage
+                          , std::shared_ptr<Challenge::EncodedEventsCache> _encodedEventsCache )
+    : m_connectivityManagerFactories( std::move( _connectivityManagerFactories ) )
+    , m_storage( std::move( _storage ) )
+    , m_encodedEventsCache( std::move( _encodedEventsCache ) )
+    , m_completionTarget( std::make_shared<CompletionTarget>() ) {
+
+    if ( m_connectivityManagerFactories.empty() ) {
+        throw std::runtime_error("No connectivity manager factory");
+    }
+
+    for ( auto& factory : m_connectivityManagerFactories ) {
+        if ( !factory ) {
+            throw std::runtime_error("Connectivity manager factory is nullptr");
+        }
+    }
+
+    if ( !m_storage ) {
+        throw std::runtime_error("Storage is nullptr");
+    }
+
+    auto connectionResult = connect( &m_timer, &QTimer::timeout, this, &ServerWorker::onServicesCheck );
+    if (!connectionResult ) {
+        throw std::runtime_error( "Cannot connect slot with QTimer signal" );
+    }
+
+    m_timer.setInterval( 200 );
+    m_completionTarget->worker = this;
+}
+
+ServerWorker::~ServerWorker() {
+    // completion fired later by storage does not post to destroyed worker
+    std::lock_guard lock( m_completionTarget->mutex );
+    m_completionTarget->worker = nullptr;
+}
+
+bool
+ServerWorker::start() {
+    // transport has to be created in thread of the worker, its sockets are watched by event loop of this thread
+    for ( auto& factory : m_connectivityManagerFactories ) {
+        auto connectivityManager = factory();
+
+        if ( !connectivityManager ) {
+            LOG_ERROR( "Cannot create connectivity manager" );
+            m_connectivityManagers.clear();
+            return false;
+        }
+
+        // connections of all transports go through the same handshake and protocol executors
+        connectivityManager->registerNewConnectionCallback([this](auto _connection){onNewConnection(_connection);});
+        m_connectivityManagers.push_back( std::move( connectivityManager ) );
+    }
+
+    m_timer.start();
+    return true;
+}
+
+void
+ServerWorker::stop() {
+    m_timer.stop();
+
+    m_protocolsExecutors.clear();
+    m_connectionWaitingForHandshake.clear();
+    m_handshakeDeadlines = HandshakeDeadlines();
+    m_connectivityManagers.clear();
+}
+
+void
+ServerWorker::notifyNewEvents( const std::vector<std::byte>& _notification ) {
+    for ( auto& protocolExecutor : m_protocolsExecutors ) {
+        protocolExecutor->notifyNewEvents( _notification );
+    }
+}
+
+void
+ServerWorker::onNewConnection( std::shared_ptr<ITransportConnection> _newConnection ) {
+    const auto connectionId = m_nextConnectionId++;
+
+    m_handshakeDeadlines.emplace( std::chrono::steady_clock::now() + HANDSHAKE_TIMEOUT, connectionId );
+    m_connectionWaitingForHandshake.emplace( connectionId, ConnectionWaitingForHandshake{ _newConnection, {} } );
+
+    // protocol executor registers own callback on the connection after successful handshake
+    _newConnection->registerNewDataReadyToReadCallback( [this, connectionId]{ handshakeOnConnection( connectionId ); } );
+}
+
+void
+ServerWorker::agingConnections() {
+    auto time = std::chrono::steady_clock::now();
+
+    while ( !m_handshakeDeadlines.empty() && m_handshakeDeadlines.top().first <= time ) {
+        // connection is already gone from waiting connections, if handshake was completed
+        m_connectionWaitingForHandshake.erase( m_handshakeDeadlines.top().second );
+        m_handshakeDeadlines.pop();
+    }
+}
+
+void
+ServerWorker::handshakeOnConnection( uint64_t _connectionId ) {
+    auto connectionIt = m_connectionWaitingForHandshake.find( _connectionId );
+    if ( connectionIt == m_connectionWaitingForHandshake.end() ) {
+        return;
+    }
+
+    // invite may arrive in more parts, received ones wait in stream of connection
+    auto handshake = IHandshake::start( connectionIt->second.connection, &connectionIt->second.stream );
+
+    if ( !handshake ) {
+        // connection is kept until its deadline, so it is never destroyed from its own callback
+        return;
+    }
+
+    // storage may complete saves in its own thread, responses are sent from thread of this worker
+    // worker is guarded, because storage may fire completions when it is being destroyed after the worker
+    std::function<void(std::function<void()>)> completionExecutor = [target = m_completionTarget]( std::function<void()> _task ) {
+        std::lock_guard lock( target->mutex );
+        if ( target->worker ) {
+            QMetaObject::invokeMethod( target->worker, std::move( _task ), Qt::QueuedConnection );
+        }
+    };
+
+    auto protocolExecutor = IProtocolExecutor::create( handshake, m_storage, completionExecutor, m_encodedEventsCache );
+    if (!protocolExecutor) {
+        return;
+    }
+
+    m_protocolsExecutors.push_back( protocolExecutor );
+    m_connectionWaitingForHandshake.erase( connectionIt );
+}
+
+void
+ServerWorker::checkProtocolsExecutors() {
+    m_protocolsExecutors.erase(
+            std::remove_if(
+                    m_protocolsExecutors.begin()
+                    , m_protocolsExecutors.end()
+                    , [](auto _protocolExecutor ) {return !_protocolExecutor->isValid();}
+            )
+            , m_protocolsExecutors.end()
+    );
+}
+
+void
+ServerWorker::onServicesCheck() {
+    agingConnections();
+    checkProtocolsExecutors();
+}
+
+} // namespace Challenge::Communication::Server
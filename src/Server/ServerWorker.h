@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Lib/PacketCoderV1/BytesStream.h"
+
+#include <QObject>
+#include <QTimer>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace Challenge {
+namespace EventsStorage {
+        class IEventsStorage;
+} // namespace Storage
+
+        class EncodedEventsCache;
+} // namespace Challenge
+
+namespace Challenge {
+namespace Communication {
+namespace Server {
+
+            class ITransportConnectivityManager;
+
+            class ITransportConnection;
+
+            class IProtocolExecutor;
+
+            //! I/O loop of server, it accepts connections, makes handshakes and owns protocol executors of its connections
+            /*!
+             *  Worker lives in one thread, all its connections and executors are served only by event loop of this thread.
+             *  Workers share only the storage and cache of encoded events. Events are handed over to writer thread of the
+             *  storage, which alone uses its connection to database, cache is guarded by own mutex.
+             */
+            class ServerWorker : public QObject {
+            Q_OBJECT
+            public:
+                using ConnectivityManagerFactory = std::function<std::unique_ptr<ITransportConnectivityManager>()>;
+                using ConnectivityManagerFactories = std::vector<ConnectivityManagerFactory>;
+
+                //! Constructor
+                /*!
+                 *  Nothing is started until start() is called from the thread of the worker
+                 * @param _connectivityManagerFactories create transports used by this worker, e.g. TCP and local socket
+                 * @param _storage storage shared by all workers
+                 * @param _encodedEventsCache cache shared by all workers, it may be nullptr
+                 * @throw std::runtime_error if there is no factory
+                 */
+                ServerWorker( ConnectivityManagerFactories _connectivityManagerFactories
+                            , std::shared_ptr<Challenge::EventsStorage::IEventsStorage> _storage
+                            , std::shared_ptr<Challenge::EncodedEventsCache> _encodedEventsCache = nullptr );
+                ~ServerWorker() override;
+
+                ServerWorker(const ServerWorker &) = delete;
+                ServerWorker(ServerWorker &&) = delete;
+                ServerWorker &operator=(ServerWorker &) = delete;
+                ServerWorker &operator=(ServerWorker &&) = delete;
+
+                //! Passes notification encoded once by server to all protocol executors of the worker
+                void notifyNewEvents( const std::vector<std::byte>& _notification );
+
+            public slots:
+                //! Creates transports and starts to accept connections, it has to be called in thread of the worker
+                /*!
+                 * @return false when any transport cannot be created
+                 */
+                bool start();
+
+                //! Releases all connections and executors, it has to be called in thread of the worker
+                void stop();
+
+            private slots:
+                void onServicesCheck();
+
+            private:
+                void onNewConnection(std::shared_ptr<ITransportConnection> _newConnection);
+                //! Drops connections without handshake, cost depends only on number of expired connections
+                void agingConnections();
+                //! Fired when pending connection received data, handshake is attempted again until invite is received whole
+                void handshakeOnConnection( uint64_t _connectionId );
+                void checkProtocolsExecutors();
+
+            private:
+                //! Time for client to send handshake invite after connection is established
+                static constexpr std::chrono::seconds HANDSHAKE_TIMEOUT{ 1 };
+
+                using HandshakeDeadlineTimePoint = std::chrono::time_point<std::chrono::steady_clock>;
+                using HandshakeDeadline = std::pair<HandshakeDeadlineTimePoint, uint64_t>;
+                //! Min-heap of deadlines, entries of connections which completed handshake are dropped when they expire
+                using HandshakeDeadlines = std::priority_queue<HandshakeDeadline, std::vector<HandshakeDeadline>, std::greater<>>;
+                //! Connection waiting for handshake together with received part of invite
+                struct ConnectionWaitingForHandshake {
+                    std::shared_ptr<ITransportConnection> connection;
+                    Challenge::PacketCoderV1::BytesStream stream;
+                };
+                //! Connections are identified by sequence number, so deadline never refers to reused address of connection
+                using ConnectionsWaitingForHandshake = std::unordered_map<uint64_t, ConnectionWaitingForHandshake>;
+                using ProtocolsExecutors = std::vector<std::shared_ptr<IProtocolExecutor> >;
+
+                //! Receiver of completions of storage, storage may fire them from its thread after worker is destroyed
+                struct CompletionTarget {
+                    std::mutex mutex;
+                    ServerWorker* worker = nullptr;
+                };
+
+                ConnectivityManagerFactories m_connectivityManagerFactories;
+                std::vector<std::unique_ptr<ITransportConnectivityManager>> m_connectivityManagers;
+                std::shared_ptr<Challenge::EventsStorage::IEventsStorage> m_storage;
+                std::shared_ptr<Challenge::EncodedEventsCache> m_encodedEventsCache;
+
+                ConnectionsWaitingForHandshake m_connectionWaitingForHandshake;
+                HandshakeDeadlines m_handshakeDeadlines;
+                uint64_t m_nextConnectionId = 0;
+                ProtocolsExecutors m_protocolsExecutors;
+                //! Shared with completion executors of all connections, it is cleared by destructor
+                std::shared_ptr<CompletionTarget> m_completionTarget;
+
+                //! Timer is child of worker, so it is moved to thread of worker together with it
+                QTimer m_timer{ this };
+            };
+} //namespace Server
+} // namespace Communication
+} // namespace Challenge
@@ -47,7 +47,7 @@ TEST( ClientHandshakeV1, cannotReceiveAck ) {
     auto connectionMock = std::make_shared< NiceMock<Challenge::Communication::Client::Mock::ITransportConnection> >();
 
     EXPECT_CALL( *connectionMock, isValid ).WillRepeatedly(Return(true));
-    EXPECT_CALL( *connectionMock, send(_) ).WillRepeatedly(Return(sizeof(Challenge::PacketCoderV1::Client::HandshakeInvite)));
+    EXPECT_CALL( *connectionMock, send(_) ).WillRepeatedly(Return(sizeof(Challenge::PacketCoderV1::Client::HandshakeInviteWithVersion)));
     EXPECT_CALL( *connectionMock, receive ).WillRepeatedly(Return(std::nullopt));
 
     ASSERT_THROW( HandshakeV1 unitUnderTest(connectionMock), std::runtime_error);
@@ -57,7 +57,7 @@ TEST( ClientHandshakeV1, handshakeAccepted ) {
     auto connectionMock = std::make_shared< NiceMock<Challenge::Communication::Client::Mock::ITransportConnection> >();
 
     EXPECT_CALL( *connectionMock, isValid ).WillRepeatedly(Return(true));
-    EXPECT_CALL( *connectionMock, send(_) ).Times(1).WillRepeatedly(Return(sizeof(Challenge::PacketCoderV1::Client::HandshakeInvite)));
+    EXPECT_CALL( *connectionMock, send(_) ).Times(1).WillRepeatedly(Return(sizeof(Challenge::PacketCoderV1::Client::HandshakeInviteWithVersion)));
 
     Challenge::PacketCoderV1::PacketFactory packetFactory;
     auto ack = packetFactory.createAck( 0, 7 );
@@ -69,13 +69,35 @@ TEST( ClientHandshakeV1, handshakeAccepted ) {
 
     ASSERT_EQ( identifier, 7 );
     ASSERT_EQ( connectionMock.get(), &unitUnderTest.connection() );
+    ASSERT_EQ( unitUnderTest.protocolVersion(), 1 );
+}
+
+TEST( ClientHandshakeV1, protocolVersionNegotiated ) {
+    auto connectionMock = std::make_shared< NiceMock<Challenge::Communication::Client::Mock::ITransportConnection> >();
+
+    EXPECT_CALL( *connectionMock, isValid ).WillRepeatedly(Return(true));
+    EXPECT_CALL( *connectionMock, send(_) ).Times(1).WillRepeatedly(Invoke([]( const auto& _invite ) {
+        auto invite = reinterpret_cast<const Challenge::PacketCoderV1::Client::HandshakeInviteWithVersion*>( _invite.data() );
+        EXPECT_EQ( _invite.size(), sizeof(Challenge::PacketCoderV1::Client::HandshakeInviteWithVersion) );
+        EXPECT_EQ( ntohs(invite->nboMaxProtocolVersion), 2 );
+        return _invite.size();
+    }));
+
+    Challenge::PacketCoderV1::PacketFactory packetFactory;
+    auto ack = packetFactory.createAck( 0, 7, 2 );
+    EXPECT_CALL( *connectionMock, receive ).WillRepeatedly(Return(ack));
+
+    HandshakeV1 unitUnderTest(connectionMock);
+
+    ASSERT_EQ( Challenge::PacketCoderV1::byteVectorToHandshakeId( unitUnderTest.identifier() ).value(), 7 );
+    ASSERT_EQ( unitUnderTest.protocolVersion(), 2 );
 }
 
 
 TEST( ClientHandshakeV1, isValidMethod ) {
     auto connectionMock = std::make_shared< NiceMock<Challenge::Communication::Client::Mock::ITransportConnection> >();
 
-    EXPECT_CALL( *connectionMock, send(_) ).Times(1).WillRepeatedly(Return(sizeof(Challenge::PacketCoderV1::Client::HandshakeInvite)));
+    EXPECT_CALL( *connectionMock, send(_) ).Times(1).WillRepeatedly(Return(sizeof(Challenge::PacketCoderV1::Client::HandshakeInviteWithVersion)));
 
     Challenge::PacketCoderV1::PacketFactory packetFactory;
     auto ack = packetFactory.createAck( 0, 7 );
@@ -97,7 +119,7 @@ TEST( ClientHandshakeV1, unexpectedPacketRecieived ) {
     auto connectionMock = std::make_shared< NiceMock<Challenge::Communication::Client::Mock::ITransportConnection> >();
 
     EXPECT_CALL( *connectionMock, isValid ).WillRepeatedly(Return(true));
-    EXPECT_CALL( *connectionMock, send(_) ).WillRepeatedly(Return(sizeof(Challenge::PacketCoderV1::Client::HandshakeInvite)));
+    EXPECT_CALL( *connectionMock, send(_) ).WillRepeatedly(Return(sizeof(Challenge::PacketCoderV1::Client::HandshakeInviteWithVersion)));
 
     Challenge::PacketCoderV1::PacketFactory packetFactory;
     auto unexpectedPacket = packetFactory.createNewEventsNotification( 7, 15 );
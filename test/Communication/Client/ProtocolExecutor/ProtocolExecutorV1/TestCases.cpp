@@ -6,8 +6,11 @@
 
 #include "Lib/PacketCoderV1/PacketDecoder.h"
 #include "Lib/PacketCoderV1/PacketFactory.h"
+#include "Lib/PacketCoderV2/PacketDecoder.h"
+#include "Lib/PacketCoderV2/PacketFactory.h"
 #include "Lib/Uint64/BytsOrderUint64.h"
 
+#include <deque>
 #include <stdexcept>
 
 #include <gtest/gtest.h>
@@ -81,6 +84,43 @@ TEST( ClientAppProtocolV1, sendEvent ) {
     ASSERT_FALSE( result );
 }
 
+TEST( ClientAppProtocolV1, sendEvents ) {
+    auto handshakeMock = std::make_shared<Challenge::Communication::Client::Mock::IHandshake>();
+    auto connectionMock = std::make_shared<NiceMock<Challenge::Communication::Client::Mock::ITransportConnection>>();
+
+    IHandshake::Identifier idenifire = Challenge::PacketCoderV1::handshakeIdToByteVector( 7 );
+    EXPECT_CALL( *handshakeMock, connection).WillRepeatedly(ReturnRef(*connectionMock));
+    EXPECT_CALL( *handshakeMock, isValid ).WillRepeatedly(Return(true));
+    EXPECT_CALL( *handshakeMock, identifier ).WillRepeatedly(ReturnRef(idenifire));
+
+    PayloadCatcher payloadCather;
+
+    // all events fit into one packet
+    EXPECT_CALL( *connectionMock, send(_)).Times(1)
+        .WillOnce( Invoke(&payloadCather, &PayloadCatcher::setPayload) );
+    EXPECT_CALL( *connectionMock, registerNewDataReadyToReadCallback(_)).WillRepeatedly(Return(false));
+
+    Challenge::PacketCoderV1::PacketFactory packetFactory;
+    EXPECT_CALL( *connectionMock, receive())
+        .WillRepeatedly(Return(packetFactory.createSendEventsAck( 1, 7, 3 )));
+
+    ApplicationProtocolV1 unitUnderTest( handshakeMock );
+
+    ASSERT_EQ( unitUnderTest.sendEvents( {} ), 0 );
+
+    const auto timeStamp = std::chrono::system_clock::now();
+    auto result = unitUnderTest.sendEvents( { { timeStamp, "TEXT1", 1 }, { timeStamp, "TEXT2", 2 }, { timeStamp, "TEXT3", 3 } } );
+    ASSERT_TRUE( result.has_value() );
+    ASSERT_EQ( result.value(), 3 );
+
+    Challenge::PacketCoderV1::DecodedPacket decodedPacket( payloadCather.m_catchedPayload );
+
+    ASSERT_TRUE( std::holds_alternative<const Challenge::PacketCoderV1::Client::SendEvents*>(decodedPacket.decodedPacket()));
+    auto sentPacket = std::get<const Challenge::PacketCoderV1::Client::SendEvents*>(decodedPacket.decodedPacket());
+    ASSERT_EQ( ntohs(sentPacket->nboNumberOfEvents), 3 );
+    ASSERT_EQ( ntohl(sentPacket->clientV1HeaderWithHandshake.nboHandshakeId), 7 );
+}
+
 TEST( ClientAppProtocolV1, askForEventsNumber ) {
     auto handshakeMock = std::make_shared<Challenge::Communication::Client::Mock::IHandshake>();
     auto connectionMock = std::make_shared<NiceMock<Challenge::Communication::Client::Mock::ITransportConnection>>();
@@ -132,8 +172,8 @@ TEST( ClientAppProtocolV1, askForEvents ) {
 
     Challenge::PacketCoderV1::DecodedPacket decodedPacket( payloadCather.m_catchedPayload );
 
-    ASSERT_TRUE( std::holds_alternative<const Challenge::PacketCoderV1::Client::SavedEventsRequest*>(decodedPacket.decodedPacket()));
-    auto sentPacket = std::get<const Challenge::PacketCoderV1::Client::SavedEventsRequest*>(decodedPacket.decodedPacket());
+    ASSERT_TRUE( std::holds_alternative<const Challenge::PacketCoderV1::Client::SavedEventsPackedRequest*>(decodedPacket.decodedPacket()));
+    auto sentPacket = std::get<const Challenge::PacketCoderV1::Client::SavedEventsPackedRequest*>(decodedPacket.decodedPacket());
     ASSERT_EQ( ntohl(sentPacket->clientV1HeaderWithHandshake.nboHandshakeId), 7 );
     ASSERT_EQ( ntohll(sentPacket->nboFirstEvent), 3 );
     ASSERT_EQ( ntohll(sentPacket->nboLastEvent), 8 );
@@ -141,6 +181,245 @@ TEST( ClientAppProtocolV1, askForEvents ) {
 }
 
 
+TEST( ClientAppProtocolV1, receiveEventsInPackedResponses ) {
+    auto handshakeMock = std::make_shared<Challenge::Communication::Client::Mock::IHandshake>();
+    auto connectionMock = std::make_shared<NiceMock<Challenge::Communication::Client::Mock::ITransportConnection>>();
+
+    IHandshake::Identifier idenifire = Challenge::PacketCoderV1::handshakeIdToByteVector( 7 );
+    EXPECT_CALL( *handshakeMock, connection).WillRepeatedly(ReturnRef(*connectionMock));
+    EXPECT_CALL( *handshakeMock, isValid ).WillRepeatedly(Return(true));
+    EXPECT_CALL( *handshakeMock, identifier ).WillRepeatedly(ReturnRef(idenifire));
+
+    using namespace std::chrono;
+    const time_point<system_clock> timeStamp( duration_cast<system_clock::duration>( milliseconds( 1'500'000'000'123 ) ) );
+    const IProtocolExecutor::Events events{ { timeStamp, "A", 1 }, { timeStamp, "B", 2 }, { timeStamp, "C", 3 } };
+
+    Challenge::PacketCoderV1::PacketFactory packetFactory;
+    auto firstPacket = packetFactory.createSavedEventsPackedResponse( 1, 7, false, events.begin(), events.begin() + 2 ).value();
+    auto lastPacket = packetFactory.createSavedEventsPackedResponse( 1, 7, true, events.begin() + 2, events.end() ).value();
+    // response for empty range
+    auto emptyPacket = packetFactory.createSavedEventsPackedResponse( 2, 7, true, events.end(), events.end() ).value();
+
+    // server responds when request is sent
+    std::deque<ITransportConnection::Payload> serverResponses;
+    EXPECT_CALL( *connectionMock, send(_)).Times(2)
+            .WillOnce( Invoke( [&]( const ITransportConnection::Payload& _payload ) -> std::optional<uint32_t> {
+                serverResponses.push_back( firstPacket );
+                serverResponses.push_back( lastPacket );
+                return _payload.size();
+            } ) )
+            .WillOnce( Invoke( [&]( const ITransportConnection::Payload& _payload ) -> std::optional<uint32_t> {
+                serverResponses.push_back( emptyPacket );
+                return _payload.size();
+            } ) );
+    EXPECT_CALL( *connectionMock, receive())
+            .WillRepeatedly( Invoke( [&serverResponses]() -> std::optional<ITransportConnection::Payload> {
+                if ( serverResponses.empty() ) {
+                    return std::nullopt;
+                }
+                auto response = serverResponses.front();
+                serverResponses.pop_front();
+                return response;
+            } ) );
+
+    ApplicationProtocolV1 unitUnderTest( handshakeMock );
+
+    auto result = unitUnderTest.getSavedEvents(0, 2);
+    ASSERT_TRUE( result.has_value() );
+    ASSERT_EQ( result.value().size(), 3 );
+    for ( std::size_t event = 0; event < events.size(); ++event ) {
+        ASSERT_EQ( result.value()[event].text, events[event].text );
+        ASSERT_EQ( result.value()[event].priority, events[event].priority );
+        ASSERT_EQ( result.value()[event].timeStamp, events[event].timeStamp );
+    }
+
+    auto emptyResult = unitUnderTest.getSavedEvents(5, 8);
+    ASSERT_TRUE( emptyResult.has_value() );
+    ASSERT_TRUE( emptyResult.value().empty() );
+}
+
+TEST( ClientAppProtocolV1, eventsExchangedInProtocolV2 ) {
+    auto handshakeMock = std::make_shared<Challenge::Communication::Client::Mock::IHandshake>();
+    auto connectionMock = std::make_shared<NiceMock<Challenge::Communication::Client::Mock::ITransportConnection>>();
+
+    IHandshake::Identifier idenifire = Challenge::PacketCoderV1::handshakeIdToByteVector( 7 );
+    EXPECT_CALL( *handshakeMock, connection).WillRepeatedly(ReturnRef(*connectionMock));
+    EXPECT_CALL( *handshakeMock, isValid ).WillRepeatedly(Return(true));
+    EXPECT_CALL( *handshakeMock, identifier ).WillRepeatedly(ReturnRef(idenifire));
+    EXPECT_CALL( *handshakeMock, protocolVersion ).WillRepeatedly(Return(2));
+
+    using namespace std::chrono;
+    const time_point<system_clock> timeStamp( duration_cast<system_clock::duration>( milliseconds( 1'500'000'000'123 ) ) );
+    // events do not fit into packets of version 1
+    const IProtocolExecutor::Events events{ { timeStamp, std::string( 70'000, 'A' ), 1 }, { timeStamp, "B", 2 } };
+    const std::string longText( 100'000, 'C' );
+
+    Challenge::PacketCoderV2::PacketFactory packetFactory;
+    auto sendEventsAck = packetFactory.createSendEventsAck( 1, 7, 2 );
+    auto ack = Challenge::PacketCoderV1::PacketFactory().createAck( 2, 7 );
+    auto savedEventsResponse = packetFactory.createSavedEventsPackedResponse( 3, 7, true, events.begin(), events.end() ).value();
+
+    // server responds when request is sent
+    std::vector<ITransportConnection::Payload> sentPayloads;
+    std::deque<ITransportConnection::Payload> serverResponses;
+    EXPECT_CALL( *connectionMock, send(_)).Times(3)
+            .WillRepeatedly( Invoke( [&]( const ITransportConnection::Payload& _payload ) -> std::optional<uint32_t> {
+                sentPayloads.push_back( _payload );
+                serverResponses.push_back( sentPayloads.size() == 1 ? sendEventsAck : sentPayloads.size() == 2 ? ack : savedEventsResponse );
+                return _payload.size();
+            } ) );
+    EXPECT_CALL( *connectionMock, receive())
+            .WillRepeatedly( Invoke( [&serverResponses]() -> std::optional<ITransportConnection::Payload> {
+                if ( serverResponses.empty() ) {
+                    return std::nullopt;
+                }
+                auto response = serverResponses.front();
+                serverResponses.pop_front();
+                return response;
+            } ) );
+
+    ApplicationProtocolV1 unitUnderTest( handshakeMock );
+
+    ASSERT_EQ( unitUnderTest.sendEvents( events ), 2 );
+    ASSERT_TRUE( unitUnderTest.sendEvent( longText, 3 ) );
+
+    auto savedEvents = unitUnderTest.getSavedEvents( 0, 1 );
+    ASSERT_TRUE( savedEvents.has_value() );
+    ASSERT_EQ( savedEvents.value().size(), 2 );
+    ASSERT_EQ( savedEvents.value()[0].text, events[0].text );
+    ASSERT_EQ( savedEvents.value()[1].timeStamp, events[1].timeStamp );
+
+    ASSERT_EQ( sentPayloads.size(), 3 );
+    Challenge::PacketCoderV2::DecodedPacket sentEvents( sentPayloads[0] );
+    ASSERT_EQ( ntohl(std::get<const Challenge::PacketCoderV2::Client::SendEvents*>(sentEvents.decodedPacket())->nboNumberOfEvents), 2 );
+    Challenge::PacketCoderV2::DecodedPacket sentEvent( sentPayloads[1] );
+    ASSERT_EQ( ntohl(std::get<const Challenge::PacketCoderV2::Client::SendEvent*>(sentEvent.decodedPacket())->nboLengthOfText), longText.size() );
+}
+
+TEST( ClientAppProtocolV1, pipelinedAsyncRequests ) {
+    auto handshakeMock = std::make_shared<Challenge::Communication::Client::Mock::IHandshake>();
+    auto connectionMock = std::make_shared<NiceMock<Challenge::Communication::Client::Mock::ITransportConnection>>();
+
+    IHandshake::Identifier idenifire = Challenge::PacketCoderV1::handshakeIdToByteVector( 7 );
+    EXPECT_CALL( *handshakeMock, connection).WillRepeatedly(ReturnRef(*connectionMock));
+    EXPECT_CALL( *handshakeMock, isValid ).WillRepeatedly(Return(true));
+    EXPECT_CALL( *handshakeMock, identifier ).WillRepeatedly(ReturnRef(idenifire));
+
+    Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback> connectionNewDataCallback;
+    EXPECT_CALL( *connectionMock, registerNewDataReadyToReadCallback(_))
+        .WillRepeatedly( Invoke( &connectionNewDataCallback, &Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback>::registerCallback ) );
+
+    // all requests are sent before any response is received
+    std::vector<ITransportConnection::Payload> sentPayloads;
+    EXPECT_CALL( *connectionMock, send(_)).Times(4)
+            .WillRepeatedly( Invoke( [&sentPayloads]( const ITransportConnection::Payload& _payload ) -> std::optional<uint32_t> {
+                sentPayloads.push_back( _payload );
+                return _payload.size();
+            } ) );
+
+    std::deque<ITransportConnection::Payload> serverResponses;
+    EXPECT_CALL( *connectionMock, receive())
+            .WillRepeatedly( Invoke( [&serverResponses]() -> std::optional<ITransportConnection::Payload> {
+                if ( serverResponses.empty() ) {
+                    return std::nullopt;
+                }
+                auto response = serverResponses.front();
+                serverResponses.pop_front();
+                return response;
+            } ) );
+
+    using namespace std::chrono;
+    const time_point<system_clock> timeStamp( duration_cast<system_clock::duration>( milliseconds( 1'500'000'000'123 ) ) );
+    const IProtocolExecutor::Events events{ { timeStamp, "A", 1 }, { timeStamp, "B", 2 } };
+
+    std::future<bool> lostEvent;
+    {
+        ApplicationProtocolV1 unitUnderTest( handshakeMock );
+
+        auto sentEvent = unitUnderTest.sendEventAsync( "TEXT", 5 );
+        auto savedEvents = unitUnderTest.getSavedEventsAsync( 0, 1 );
+        auto numberOfEvents = unitUnderTest.getNumberOfSavedEventsAsync();
+        lostEvent = unitUnderTest.sendEventAsync( "LOST", 1 );
+        ASSERT_EQ( sentPayloads.size(), 4 );
+
+        // responses are matched by client message id, so their order does not matter
+        Challenge::PacketCoderV1::PacketFactory packetFactory;
+        serverResponses.push_back( packetFactory.createNumberOfEventsResponse( 3, 7, 42 ) );
+        serverResponses.push_back( packetFactory.createSavedEventsPackedResponse( 2, 7, false, events.begin(), events.begin() + 1 ).value() );
+        serverResponses.push_back( packetFactory.createAck( 1, 7 ) );
+        serverResponses.push_back( packetFactory.createSavedEventsPackedResponse( 2, 7, true, events.begin() + 1, events.end() ).value() );
+
+        while ( !serverResponses.empty() ) {
+            connectionNewDataCallback.fireCallback();
+        }
+
+        ASSERT_EQ( numberOfEvents.wait_for( 0s ), std::future_status::ready );
+        ASSERT_EQ( numberOfEvents.get(), 42 );
+        ASSERT_EQ( sentEvent.wait_for( 0s ), std::future_status::ready );
+        ASSERT_TRUE( sentEvent.get() );
+        ASSERT_EQ( savedEvents.wait_for( 0s ), std::future_status::ready );
+        auto receivedEvents = savedEvents.get();
+        ASSERT_TRUE( receivedEvents.has_value() );
+        ASSERT_EQ( receivedEvents.value().size(), 2 );
+        ASSERT_EQ( receivedEvents.value()[1].text, "B" );
+
+        ASSERT_EQ( lostEvent.wait_for( 0s ), std::future_status::timeout );
+    }
+
+    // request without response is resolved when executor is destroyed
+    ASSERT_EQ( lostEvent.wait_for( 0s ), std::future_status::ready );
+    ASSERT_FALSE( lostEvent.get() );
+}
+
+TEST( ClientAppProtocolV1, asyncRequestsEndedWithoutResponse ) {
+    auto handshakeMock = std::make_shared<Challenge::Communication::Client::Mock::IHandshake>();
+    auto connectionMock = std::make_shared<NiceMock<Challenge::Communication::Client::Mock::ITransportConnection>>();
+
+    bool isHandshakeValid = true;
+    IHandshake::Identifier idenifire = Challenge::PacketCoderV1::handshakeIdToByteVector( 7 );
+    EXPECT_CALL( *handshakeMock, connection).WillRepeatedly(ReturnRef(*connectionMock));
+    EXPECT_CALL( *handshakeMock, isValid ).WillRepeatedly( Invoke( [&isHandshakeValid]{ return isHandshakeValid; } ) );
+    EXPECT_CALL( *handshakeMock, identifier ).WillRepeatedly(ReturnRef(idenifire));
+
+    Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback> connectionNewDataCallback;
+    EXPECT_CALL( *connectionMock, registerNewDataReadyToReadCallback(_))
+        .WillRepeatedly( Invoke( &connectionNewDataCallback, &Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback>::registerCallback ) );
+    EXPECT_CALL( *connectionMock, send(_)).Times(2)
+            .WillRepeatedly( Invoke( []( const ITransportConnection::Payload& _payload ) -> std::optional<uint32_t> {
+                return _payload.size();
+            } ) );
+
+    std::deque<ITransportConnection::Payload> serverResponses;
+    EXPECT_CALL( *connectionMock, receive())
+            .WillRepeatedly( Invoke( [&serverResponses]() -> std::optional<ITransportConnection::Payload> {
+                if ( serverResponses.empty() ) {
+                    return std::nullopt;
+                }
+                auto response = serverResponses.front();
+                serverResponses.pop_front();
+                return response;
+            } ) );
+
+    using namespace std::chrono;
+    ApplicationProtocolV1 unitUnderTest( handshakeMock );
+
+    // server which did not save event answers by NACK
+    auto rejectedEvent = unitUnderTest.sendEventAsync( "REJECTED", 5 );
+    serverResponses.push_back( Challenge::PacketCoderV1::PacketFactory().createNack( 1, 7 ) );
+    connectionNewDataCallback.fireCallback();
+
+    ASSERT_EQ( rejectedEvent.wait_for( 0s ), std::future_status::ready );
+    ASSERT_FALSE( rejectedEvent.get() );
+
+    // response never arrives on invalid connection
+    auto lostEvent = unitUnderTest.sendEventAsync( "LOST", 5 );
+    isHandshakeValid = false;
+    connectionNewDataCallback.fireCallback();
+
+    ASSERT_EQ( lostEvent.wait_for( 0s ), std::future_status::ready );
+    ASSERT_FALSE( lostEvent.get() );
+}
+
 TEST( ClientAppProtocolV1, newEventCallback ) {
     auto handshakeMock = std::make_shared<Challenge::Communication::Client::Mock::IHandshake>();
     auto connectionMock = std::make_shared<Challenge::Communication::Client::Mock::ITransportConnection>();
@@ -157,7 +436,9 @@ TEST( ClientAppProtocolV1, newEventCallback ) {
                           &connectionNewDataCallback
                         , &Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback>::registerCallback
                         )
-        );
+        )
+        // callback is unregistered by destructor
+        .WillOnce(Return(true));
 
     Challenge::PacketCoderV1::PacketFactory packetFactory;
     auto payload = packetFactory.createNewEventsNotification(7, 17);
@@ -189,9 +470,9 @@ TEST( ClientAppProtocolV1, serverMessagesContainerExpectMessage ) {
     auto ackForPacket2 = packetFactory.createAck(2, 0);
     auto ackForPacket2WrongHandshake = packetFactory.createAck(2, 1);
 
-    Challenge::PacketCoderV1::DecodedPacket ackDecoded1( ackForPacket1 );
-    Challenge::PacketCoderV1::DecodedPacket ackDecoded2( ackForPacket2 );
-    Challenge::PacketCoderV1::DecodedPacket ackDecoded2WrongHandshake( ackForPacket2WrongHandshake );
+    Challenge::PacketCoderV1::DecodedPacketView ackDecoded1( ackForPacket1 );
+    Challenge::PacketCoderV1::DecodedPacketView ackDecoded2( ackForPacket2 );
+    Challenge::PacketCoderV1::DecodedPacketView ackDecoded2WrongHandshake( ackForPacket2WrongHandshake );
 
     ServerMessagesContainer unitUnderTest(0);
 
@@ -215,9 +496,9 @@ TEST( ClientAppProtocolV1, serverMessagesContainerGetMessages ) {
     auto ackForPacket2 = packetFactory.createAck(2, 0);
     auto ackForPacket3 = packetFactory.createAck(3, 0);
 
-    Challenge::PacketCoderV1::DecodedPacket ackDecoded1( ackForPacket1 );
-    Challenge::PacketCoderV1::DecodedPacket ackDecoded2( ackForPacket2 );
-    Challenge::PacketCoderV1::DecodedPacket ackDecoded3( ackForPacket3 );
+    Challenge::PacketCoderV1::DecodedPacketView ackDecoded1( ackForPacket1 );
+    Challenge::PacketCoderV1::DecodedPacketView ackDecoded2( ackForPacket2 );
+    Challenge::PacketCoderV1::DecodedPacketView ackDecoded3( ackForPacket3 );
 
     ServerMessagesContainer unitUnderTest(0);
 
@@ -247,4 +528,23 @@ TEST( ClientAppProtocolV1, serverMessagesContainerGetMessages ) {
     ASSERT_EQ(unitUnderTest.moveReceivedMessages(3).value().size(), 0);
 }
 
+TEST( ClientAppProtocolV1, serverMessagesContainerCancelsExpiredHandler ) {
+    using namespace std::chrono;
+    Challenge::PacketCoderV1::PacketFactory packetFactory;
+    auto ackForPacket1 = packetFactory.createAck(1, 0);
+    Challenge::PacketCoderV1::DecodedPacketView ackDecoded1( ackForPacket1 );
 
+    ServerMessagesContainer unitUnderTest(0);
+
+    std::promise<bool> isCancelled;
+    auto cancelled = isCancelled.get_future();
+    unitUnderTest.expectResponseForClientMessage( 1, [&isCancelled]( const ServerMessageView* _message ) {
+        isCancelled.set_value( _message == nullptr );
+        return true;
+    }, 10ms );
+
+    // nothing is received, handler is cancelled by deadline
+    ASSERT_EQ( cancelled.wait_for( 5s ), std::future_status::ready );
+    ASSERT_TRUE( cancelled.get() );
+    ASSERT_FALSE( unitUnderTest.saveMessage( ackDecoded1 ) );
+}
@@ -0,0 +1,47 @@
+#include "LocalConnectivityManager.h"
+
+#include "Communication/Client/TransportConnectivityManager/ITransportConnection.h"
+
+#include <QCoreApplication>
+#include <QLocalServer>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace Challenge::Communication::Client;
+
+constexpr auto SOCKET_PATH = "/tmp/challenge.test.socket";
+
+TEST( ClientLocalTranportConnectivityManager, CreateAbstraction ) {
+    auto manager = ITransportConnectivityManager::create( LocalSocketEngine{ SOCKET_PATH } );
+    ASSERT_NE( manager, nullptr );
+}
+
+TEST( ClientLocalTranportConnectivityManager, CannotConnectToServer ) {
+    char const* parameters[] = { "app" };
+    auto parametersNumber = 1;
+    QCoreApplication app(parametersNumber, const_cast<char**>(parameters));
+
+    LocalConnectivityManager unitUnderTest( "/not/existing/directory/socket" );
+
+    ASSERT_EQ( unitUnderTest.connectToServer(), nullptr );
+}
+
+TEST( ClientLocalTranportConnectivityManager, StartNewConnectionPositive ) {
+    char const* parameters[] = { "app" };
+    auto parametersNumber = 1;
+    QCoreApplication app(parametersNumber, const_cast<char**>(parameters));
+
+    QLocalServer::removeServer( SOCKET_PATH );
+    QLocalServer server;
+    ASSERT_TRUE( server.listen( SOCKET_PATH ) );
+
+    LocalConnectivityManager connectivityManager( SOCKET_PATH );
+
+    app.processEvents();
+
+    auto newConnection = connectivityManager.connectToServer();
+
+    ASSERT_NE( newConnection, nullptr );
+    ASSERT_TRUE( newConnection->isValid() );
+}
\ No newline at end of file
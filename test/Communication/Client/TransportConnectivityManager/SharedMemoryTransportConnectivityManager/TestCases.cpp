@@ -0,0 +1,74 @@
+#include "SharedMemoryConnectivityManager.h"
+
+#include "Communication/Client/TransportConnectivityManager/ITransportConnection.h"
+
+#include "Lib/SharedMemoryChannel/SharedMemoryChannel.h"
+
+#include <QCoreApplication>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstring>
+#include <future>
+
+using namespace Challenge::Communication::Client;
+using Challenge::SharedMemoryChannel;
+
+constexpr auto SOCKET_PATH = "/tmp/challenge.test.shm.socket";
+
+TEST( ClientSharedMemoryTranportConnectivityManager, CreateAbstraction ) {
+    auto manager = ITransportConnectivityManager::create( SharedMemoryEngine{ SOCKET_PATH } );
+    ASSERT_NE( manager, nullptr );
+}
+
+TEST( ClientSharedMemoryTranportConnectivityManager, CannotConnectToServer ) {
+    char const* parameters[] = { "app" };
+    auto parametersNumber = 1;
+    QCoreApplication app(parametersNumber, const_cast<char**>(parameters));
+
+    SharedMemoryConnectivityManager unitUnderTest( "/not/existing/directory/socket" );
+
+    ASSERT_EQ( unitUnderTest.connectToServer(), nullptr );
+}
+
+TEST( ClientSharedMemoryTranportConnectivityManager, StartNewConnectionPositive ) {
+    char const* parameters[] = { "app" };
+    auto parametersNumber = 1;
+    QCoreApplication app(parametersNumber, const_cast<char**>(parameters));
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy( address.sun_path, SOCKET_PATH, sizeof( address.sun_path ) - 1 );
+
+    auto listeningSocket = ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    ::unlink( SOCKET_PATH );
+    ASSERT_EQ( ::bind( listeningSocket, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ), 0 );
+    ASSERT_EQ( ::listen( listeningSocket, 1 ), 0 );
+
+    // client waits for shared memory, so server side is set up in other thread
+    auto serverChannel = std::async( std::launch::async, [listeningSocket]{
+        return std::make_unique<SharedMemoryChannel>( ::accept( listeningSocket, nullptr, nullptr ), SharedMemoryChannel::Side::Server );
+    });
+
+    SharedMemoryConnectivityManager connectivityManager( SOCKET_PATH );
+    auto newConnection = connectivityManager.connectToServer();
+    auto serverSide = serverChannel.get();
+
+    ASSERT_NE( newConnection, nullptr );
+    ASSERT_TRUE( newConnection->isValid() );
+
+    ASSERT_TRUE( serverSide->send( { std::byte('A') } ).has_value() );
+    ASSERT_TRUE( serverSide->flush() );
+
+    ITransportConnection::Payload buffer;
+    ASSERT_EQ( newConnection->receiveInto( buffer ).value(), 1 );
+    ASSERT_EQ( buffer, ITransportConnection::Payload( { std::byte('A') } ) );
+
+    ::close( listeningSocket );
+    ::unlink( SOCKET_PATH );
+}
@@ -107,6 +107,62 @@ TEST( HandshakeV1, creationHandshakeSuccess ) {
     ASSERT_NO_THROW( HandshakeV1 handshake(connectionMock) );
 }
 
+TEST( HandshakeV1, protocolVersionNegotiated ) {
 
+    auto connectionMock = std::make_shared< Challenge::Communication::Server::Mock::ITransportConnection >();
+
+    Challenge::PacketCoderV1::PacketFactory packetFactory;
+    auto invitePacket = packetFactory.createHandshakeInvite(1, 5);
+    Challenge::PacketCoderV1::PacketFactory::PacketBytes responsePacket;
+
+    EXPECT_CALL( *connectionMock, isValid ).Times(1).WillOnce(Return(true));
+    EXPECT_CALL( *connectionMock, receive ).Times(1).WillOnce(Return(invitePacket));
+    EXPECT_CALL( *connectionMock, send(_) ).Times(1).WillOnce(DoAll(SaveArg<0>(&responsePacket), Return(sizeof(Challenge::PacketCoderV1::Server::AckWithVersion))));
+
+    HandshakeV1 handshake(connectionMock);
+
+    // server chooses the highest version known by both sides
+    ASSERT_EQ( handshake.protocolVersion(), 2 );
+    ASSERT_EQ( responsePacket.size(), sizeof(Challenge::PacketCoderV1::Server::AckWithVersion) );
+    auto ack = reinterpret_cast<const Challenge::PacketCoderV1::Server::AckWithVersion*>( responsePacket.data() );
+    ASSERT_EQ( ntohs(ack->nboProtocolVersion), 2 );
+}
+
+TEST( HandshakeV1, protocolVersion1WhenInviteWithoutVersion ) {
+
+    auto connectionMock = std::make_shared< Challenge::Communication::Server::Mock::ITransportConnection >();
+
+    Challenge::PacketCoderV1::PacketFactory packetFactory;
+    auto invitePacket = packetFactory.createHandshakeInvite(1);
+    auto responsePacket = packetFactory.createAck(1,2);
+
+    EXPECT_CALL( *connectionMock, isValid ).Times(1).WillOnce(Return(true));
+    EXPECT_CALL( *connectionMock, receive ).Times(1).WillOnce(Return(invitePacket));
+    EXPECT_CALL( *connectionMock, send(_) ).Times(1).WillOnce(Return(responsePacket.size()));
+
+    HandshakeV1 handshake(connectionMock);
+
+    ASSERT_EQ( handshake.protocolVersion(), 1 );
+}
 
+TEST( HandshakeV1, fragmentedInviteCompletedByNextAttempt ) {
 
+    auto connectionMock = std::make_shared< Challenge::Communication::Server::Mock::ITransportConnection >();
+
+    Challenge::PacketCoderV1::PacketFactory packetFactory;
+    auto invitePacket = packetFactory.createHandshakeInvite(1, 2);
+    const auto half = invitePacket.size() / 2;
+    Challenge::PacketCoderV1::PacketFactory::PacketBytes firstPart( invitePacket.begin(), invitePacket.begin() + half );
+    Challenge::PacketCoderV1::PacketFactory::PacketBytes secondPart( invitePacket.begin() + half, invitePacket.end() );
+
+    EXPECT_CALL( *connectionMock, isValid ).Times(2).WillRepeatedly(Return(true));
+    EXPECT_CALL( *connectionMock, receive ).Times(2).WillOnce(Return(firstPart)).WillOnce(Return(secondPart));
+    EXPECT_CALL( *connectionMock, send(_) ).Times(1).WillOnce(Return(sizeof(Challenge::PacketCoderV1::Server::AckWithVersion)));
+
+    Challenge::PacketCoderV1::BytesStream stream;
+    ASSERT_EQ( IHandshake::start( connectionMock, &stream ), nullptr );
+
+    auto handshake = IHandshake::start( connectionMock, &stream );
+    ASSERT_NE( handshake, nullptr );
+    ASSERT_EQ( handshake->protocolVersion(), 2 );
+}
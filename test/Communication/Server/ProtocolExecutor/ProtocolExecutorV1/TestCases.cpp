@@ -4,7 +4,9 @@
 #include "Mock/Communication/Server/ITransportConnection.h"
 #include "Mock/Communication/Server/IHandshake.h"
 
+#include "Lib/EncodedEventsCache/EncodedEventsCache.h"
 #include "Lib/PacketCoderV1/PacketFactory.h"
+#include "Lib/PacketCoderV2/PacketFactory.h"
 
 #include "Lib/TestUtils/CallbackCatcher.h"
 
@@ -93,7 +95,8 @@ TEST_F( ProtocolExecutorV1Test, constructionSuccess ) {
             .WillRepeatedly(testing::Return(true));
 
     EXPECT_CALL( *getConnectionMock(), registerNewDataReadyToReadCallback(testing::_) ).Times(2);
-    EXPECT_CALL(*getStorageMock(), registerEventAddedCallback(_, _)).Times(2);
+    // notifications are passed by server
+    EXPECT_CALL(*getStorageMock(), registerEventAddedCallback(_, _)).Times(0);
 
     ASSERT_NO_THROW(ProtocolExecutorV1 appProtocol(getHandshakeMock(), getStorageMock()) );
 }
@@ -153,6 +156,192 @@ TEST_F( ProtocolExecutorV1Test, newEventReceiveAndSaved ) {
     ASSERT_FALSE( newDataCallback.isValid() );
 }
 
+TEST_F( ProtocolExecutorV1Test, newEventAcknowledgedByCompletionExecutor ) {
+    using namespace testing;
+
+    EXPECT_CALL( *getHandshakeMock(), connection )
+            .WillRepeatedly(RETURN_CONNECTION(*getConnectionMock()));
+
+    EXPECT_CALL( *getHandshakeMock(), isValid )
+            .WillRepeatedly(testing::Return(true));
+
+    Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback > newDataCallback;
+    EXPECT_CALL(*getConnectionMock(), registerNewDataReadyToReadCallback(_))
+            .Times(2)
+            .WillRepeatedly(testing::Invoke(&newDataCallback, &Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback>::registerCallback));
+
+    Challenge::PacketCoderV1::PacketFactory packetFactory;
+    auto newEventPayload = packetFactory.createSendEvent( 3,HandshakeId, "new event", 4).value();
+    auto ackPayload = packetFactory.createAck( 3, HandshakeId );
+
+    EXPECT_CALL( *getStorageMock(), saveEvent(_) )
+        .WillOnce(testing::Return(true));
+
+    bool isAckSent = false;
+    EXPECT_CALL(*getConnectionMock(), send(ackPayload))
+        .WillOnce(testing::Invoke([&isAckSent]( const auto& ){ isAckSent = true; return 1; }));
+
+    EXPECT_CALL(*getConnectionMock(), receive())
+            .WillOnce(RETURN_PAYLOAD(newEventPayload))
+            .WillRepeatedly(RETURN_PAYLOAD(std::nullopt));
+
+    // completions are passed to thread of executor, here they wait in the list
+    std::vector<std::function<void()>> postedTasks;
+    auto completionExecutor = [&postedTasks]( std::function<void()> _task ){ postedTasks.push_back( std::move(_task) ); };
+
+    {
+        ProtocolExecutorV1 unitUnderTest(getHandshakeMock(), getStorageMock(), completionExecutor);
+        newDataCallback.fireCallback();
+
+        ASSERT_EQ( postedTasks.size(), 1 );
+        ASSERT_FALSE( isAckSent );
+
+        postedTasks.front()();
+        ASSERT_TRUE( isAckSent );
+    }
+}
+
+TEST_F( ProtocolExecutorV1Test, newEventsReceiveAndPartiallySaved ) {
+    using namespace testing;
+    using Events = Challenge::EventsStorage::IEventsStorage::Events;
+
+    EXPECT_CALL( *getHandshakeMock(), connection )
+            .WillRepeatedly(RETURN_CONNECTION(*getConnectionMock()));
+
+    EXPECT_CALL( *getHandshakeMock(), isValid )
+            .WillRepeatedly(testing::Return(true));
+
+    Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback > newDataCallback;
+    // catch new data callback
+    EXPECT_CALL(*getConnectionMock(), registerNewDataReadyToReadCallback(_))
+            .Times(2)
+            .WillRepeatedly(testing::Invoke(&newDataCallback, &Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback>::registerCallback));
+
+    const auto timeStamp = std::chrono::system_clock::now();
+    const Events eventsToSend{ { timeStamp, "event 1", 1 }, { timeStamp, "", 2 }, { timeStamp, "event 3", 3 } };
+
+    Challenge::PacketCoderV1::PacketFactory packetFactory;
+    auto newEventsPayload = packetFactory.createSendEvents( 3, HandshakeId, eventsToSend.begin(), eventsToSend.end() ).value();
+    auto ackPayload = packetFactory.createSendEventsAck( 3, HandshakeId, 2 );
+
+    Events receivedEvents;
+    EXPECT_CALL( *getStorageMock(), saveEvents(_) )
+        .WillOnce(DoAll(SaveArg<0>(&receivedEvents), Return(2)));
+    EXPECT_CALL( *getStorageMock(), saveEvent(_) ).Times(0);
+
+    // ack reports number of saved events
+    EXPECT_CALL(*getConnectionMock(), send(ackPayload))
+        .WillOnce(testing::Return(true));
+
+    EXPECT_CALL(*getConnectionMock(), receive())
+            .WillOnce(RETURN_PAYLOAD(newEventsPayload))
+            .WillRepeatedly(RETURN_PAYLOAD(std::nullopt));
+
+    {
+            ProtocolExecutorV1 unitUnderTest(getHandshakeMock(), getStorageMock());
+            newDataCallback.fireCallback();
+    }
+
+    ASSERT_EQ( receivedEvents.size(), eventsToSend.size() );
+    for ( std::size_t event = 0; event < eventsToSend.size(); ++event ) {
+        ASSERT_EQ( receivedEvents[event].text, eventsToSend[event].text );
+        ASSERT_EQ( receivedEvents[event].priority, eventsToSend[event].priority );
+    }
+}
+
+TEST_F( ProtocolExecutorV1Test, newEventsReceivedInProtocolV2 ) {
+    using namespace testing;
+    using Events = Challenge::EventsStorage::IEventsStorage::Events;
+
+    EXPECT_CALL( *getHandshakeMock(), connection )
+            .WillRepeatedly(RETURN_CONNECTION(*getConnectionMock()));
+    EXPECT_CALL( *getHandshakeMock(), isValid )
+            .WillRepeatedly(testing::Return(true));
+    EXPECT_CALL( *getHandshakeMock(), protocolVersion )
+            .WillRepeatedly(testing::Return(2));
+
+    Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback > newDataCallback;
+    // catch new data callback
+    EXPECT_CALL(*getConnectionMock(), registerNewDataReadyToReadCallback(_))
+            .Times(2)
+            .WillRepeatedly(testing::Invoke(&newDataCallback, &Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback>::registerCallback));
+
+    // events do not fit into packet of version 1
+    const auto timeStamp = std::chrono::system_clock::now();
+    const Events eventsToSend{ { timeStamp, std::string( 70'000, 'x' ), 1 }, { timeStamp, "event 2", 2 } };
+    const std::string longText( 100'000, 'y' );
+
+    Challenge::PacketCoderV2::PacketFactory packetFactory;
+    auto newEventsPayload = packetFactory.createSendEvents( 3, HandshakeId, eventsToSend.begin(), eventsToSend.end() ).value();
+    auto newEventPayload = packetFactory.createSendEvent( 4, HandshakeId, longText, 7 ).value();
+    auto sendEventsAckPayload = packetFactory.createSendEventsAck( 3, HandshakeId, 2 );
+    auto ackPayload = Challenge::PacketCoderV1::PacketFactory().createAck( 4, HandshakeId );
+
+    Events receivedEvents;
+    EXPECT_CALL( *getStorageMock(), saveEvents(_) )
+        .WillOnce(DoAll(SaveArg<0>(&receivedEvents), Return(2)));
+    EXPECT_CALL( *getStorageMock(), saveEvent(Field(&Challenge::EventData::text, longText)) )
+        .WillOnce(Return(true));
+
+    EXPECT_CALL(*getConnectionMock(), send(sendEventsAckPayload))
+        .WillOnce(testing::Return(sendEventsAckPayload.size()));
+    // ack has fixed size, so it is sent in version 1
+    EXPECT_CALL(*getConnectionMock(), send(ackPayload))
+        .WillOnce(testing::Return(ackPayload.size()));
+
+    // both packets are received at once
+    auto receivedPayload = newEventsPayload;
+    receivedPayload.insert( receivedPayload.end(), newEventPayload.begin(), newEventPayload.end() );
+    EXPECT_CALL(*getConnectionMock(), receive())
+            .WillOnce(RETURN_PAYLOAD(receivedPayload))
+            .WillRepeatedly(RETURN_PAYLOAD(std::nullopt));
+
+    {
+            ProtocolExecutorV1 unitUnderTest(getHandshakeMock(), getStorageMock());
+            newDataCallback.fireCallback();
+    }
+
+    ASSERT_EQ( receivedEvents.size(), eventsToSend.size() );
+    ASSERT_EQ( receivedEvents[0].text, eventsToSend[0].text );
+    ASSERT_EQ( receivedEvents[1].priority, eventsToSend[1].priority );
+}
+
+TEST_F( ProtocolExecutorV1Test, packetsV2IgnoredWhenNotNegotiated ) {
+    using namespace testing;
+    using Events = Challenge::EventsStorage::IEventsStorage::Events;
+
+    EXPECT_CALL( *getHandshakeMock(), connection )
+            .WillRepeatedly(RETURN_CONNECTION(*getConnectionMock()));
+    EXPECT_CALL( *getHandshakeMock(), isValid )
+            .WillRepeatedly(testing::Return(true));
+    EXPECT_CALL( *getHandshakeMock(), protocolVersion )
+            .WillRepeatedly(testing::Return(1));
+
+    Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback > newDataCallback;
+    // catch new data callback
+    EXPECT_CALL(*getConnectionMock(), registerNewDataReadyToReadCallback(_))
+            .Times(2)
+            .WillRepeatedly(testing::Invoke(&newDataCallback, &Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback>::registerCallback));
+
+    const auto timeStamp = std::chrono::system_clock::now();
+    const Events eventsToSend{ { timeStamp, "event 1", 1 } };
+
+    Challenge::PacketCoderV2::PacketFactory packetFactory;
+    auto newEventsPayload = packetFactory.createSendEvents( 3, HandshakeId, eventsToSend.begin(), eventsToSend.end() ).value();
+
+    EXPECT_CALL( *getStorageMock(), saveEvents(_) ).Times(0);
+    EXPECT_CALL(*getConnectionMock(), send(_)).Times(0);
+
+    EXPECT_CALL(*getConnectionMock(), receive())
+            .WillOnce(RETURN_PAYLOAD(newEventsPayload))
+            .WillRepeatedly(RETURN_PAYLOAD(std::nullopt));
+
+    {
+            ProtocolExecutorV1 unitUnderTest(getHandshakeMock(), getStorageMock());
+            newDataCallback.fireCallback();
+    }
+}
+
 TEST_F( ProtocolExecutorV1Test, newEventReceiveAndCannotBeSaved ) {
     using namespace testing;
     const std::string eventText = "new event";
@@ -172,14 +361,16 @@ TEST_F( ProtocolExecutorV1Test, newEventReceiveAndCannotBeSaved ) {
 
     Challenge::PacketCoderV1::PacketFactory packetFactory;
     auto newEventPayload = packetFactory.createSendEvent( 3,HandshakeId, eventText, eventPriority).value();
+    auto nackPayload = packetFactory.createNack( 3, HandshakeId );
 
     EXPECT_CALL( *getStorageMock(), saveEvent(_))
             .WillOnce(testing::Return(false));
 
     EXPECT_CALL(*getStorageMock(), registerEventAddedCallback(_, _)).WillRepeatedly(Return(true));
 
-    EXPECT_CALL(*getConnectionMock(), send(testing::_))
-    .Times(0); // no ACK was sent
+    // client does not wait for ACK of event which was not saved
+    EXPECT_CALL(*getConnectionMock(), send(nackPayload))
+            .WillOnce(Return(nackPayload.size()));
 
     // returns new event
     EXPECT_CALL(*getConnectionMock(), receive())
@@ -472,6 +663,225 @@ TEST_F( ProtocolExecutorV1Test, savedEventsRangeRequestStorageError ) {
     ASSERT_FALSE( newDataCallback.isValid() );
 }
 
+TEST_F( ProtocolExecutorV1Test, savedEventsPackedRequest ) {
+    using namespace testing;
+    using Events = Challenge::EventsStorage::IEventsStorage::Events;
+
+    EXPECT_CALL( *getHandshakeMock(), connection )
+            .WillRepeatedly(RETURN_CONNECTION(*getConnectionMock()));
+    EXPECT_CALL( *getHandshakeMock(), isValid )
+            .WillRepeatedly(testing::Return(true));
+
+    Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback > newDataCallback;
+    // catch new data callback
+    EXPECT_CALL(*getConnectionMock(), registerNewDataReadyToReadCallback(_))
+            .Times(2)
+            .WillRepeatedly(testing::Invoke(&newDataCallback, &Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback>::registerCallback));
+
+    // more events than read from storage at once, but all of them fit into one packet
+    const auto timeStamp = std::chrono::system_clock::now();
+    Events storageEvents;
+    for ( uint32_t event = 0; event < 300; ++event ) {
+        storageEvents.push_back( { timeStamp, "event " + std::to_string( event ), event } );
+    }
+
+    Challenge::PacketCoderV1::PacketFactory packetFactory;
+    auto requestPayload = packetFactory.createSavedEventsPackedRequest(3, HandshakeId, 0, 299);
+    auto emptyRequestPayload = packetFactory.createSavedEventsPackedRequest(4, HandshakeId, 300, 400);
+    auto responsePayload = packetFactory.createSavedEventsPackedResponse( 3, HandshakeId, true, storageEvents.begin(), storageEvents.end() ).value();
+    auto emptyResponsePayload = packetFactory.createSavedEventsPackedResponse( 4, HandshakeId, true, storageEvents.end(), storageEvents.end() ).value();
+
+    EXPECT_CALL( *getStorageMock(), getSavedEvents(0, 299))
+            .WillOnce(Return(storageEvents));
+    EXPECT_CALL( *getStorageMock(), getSavedEvents(300, 400))
+            .WillOnce(Return(Events{}));
+
+    EXPECT_CALL(*getConnectionMock(), send(responsePayload))
+            .WillOnce(testing::Return(responsePayload.size()));
+    // client is informed that there are no events
+    EXPECT_CALL(*getConnectionMock(), send(emptyResponsePayload))
+            .WillOnce(testing::Return(emptyResponsePayload.size()));
+
+    EXPECT_CALL(*getConnectionMock(), receive())
+            .WillOnce(RETURN_PAYLOAD(requestPayload))
+            .WillOnce(RETURN_PAYLOAD(emptyRequestPayload))
+            .WillRepeatedly(RETURN_PAYLOAD(std::nullopt));
+
+    {
+        ProtocolExecutorV1 unitUnderTest(getHandshakeMock(), getStorageMock());
+        newDataCallback.fireCallback();
+    }
+}
+
+TEST_F( ProtocolExecutorV1Test, savedEventsPackedRequestInProtocolV2 ) {
+    using namespace testing;
+    using Events = Challenge::EventsStorage::IEventsStorage::Events;
+
+    EXPECT_CALL( *getHandshakeMock(), connection )
+            .WillRepeatedly(RETURN_CONNECTION(*getConnectionMock()));
+    EXPECT_CALL( *getHandshakeMock(), isValid )
+            .WillRepeatedly(testing::Return(true));
+    EXPECT_CALL( *getHandshakeMock(), protocolVersion )
+            .WillRepeatedly(testing::Return(2));
+
+    Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback > newDataCallback;
+    // catch new data callback
+    EXPECT_CALL(*getConnectionMock(), registerNewDataReadyToReadCallback(_))
+            .Times(2)
+            .WillRepeatedly(testing::Invoke(&newDataCallback, &Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback>::registerCallback));
+
+    // events would need three packets of version 1
+    const auto timeStamp = std::chrono::system_clock::now();
+    const Events storageEvents( 5, { timeStamp, std::string( 30'000, 'x' ), 1 } );
+
+    auto requestPayload = Challenge::PacketCoderV1::PacketFactory().createSavedEventsPackedRequest(3, HandshakeId, 0, 4);
+    auto responsePayload = Challenge::PacketCoderV2::PacketFactory().createSavedEventsPackedResponse( 3, HandshakeId, true, storageEvents.begin(), storageEvents.end() ).value();
+
+    EXPECT_CALL( *getStorageMock(), getSavedEvents(0, 4))
+            .WillOnce(Return(storageEvents));
+
+    EXPECT_CALL(*getConnectionMock(), send(responsePayload))
+            .WillOnce(testing::Return(responsePayload.size()));
+
+    EXPECT_CALL(*getConnectionMock(), receive())
+            .WillOnce(RETURN_PAYLOAD(requestPayload))
+            .WillRepeatedly(RETURN_PAYLOAD(std::nullopt));
+
+    {
+        ProtocolExecutorV1 unitUnderTest(getHandshakeMock(), getStorageMock());
+        newDataCallback.fireCallback();
+    }
+}
+
+TEST_F( ProtocolExecutorV1Test, savedEventsWithTooLongTextInProtocolV1 ) {
+    using namespace testing;
+    using Events = Challenge::EventsStorage::IEventsStorage::Events;
+
+    EXPECT_CALL( *getHandshakeMock(), connection )
+            .WillRepeatedly(RETURN_CONNECTION(*getConnectionMock()));
+    EXPECT_CALL( *getHandshakeMock(), isValid )
+            .WillRepeatedly(testing::Return(true));
+
+    Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback > newDataCallback;
+    // catch new data callback
+    EXPECT_CALL(*getConnectionMock(), registerNewDataReadyToReadCallback(_))
+            .Times(2)
+            .WillRepeatedly(testing::Invoke(&newDataCallback, &Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback>::registerCallback));
+
+    // text does not fit into packet of version 1
+    const auto timeStamp = std::chrono::system_clock::now();
+    const Events storageEvents{ { timeStamp, std::string( 70'000, 'x' ), 1 }, { timeStamp, "B", 2 } };
+
+    Challenge::PacketCoderV1::PacketFactory packetFactory;
+    auto requestPayload = packetFactory.createSavedEventsRequest(3, HandshakeId, 0, 1);
+    auto packedRequestPayload = packetFactory.createSavedEventsPackedRequest(4, HandshakeId, 0, 1);
+
+    EXPECT_CALL( *getStorageMock(), getSavedEvents(0, 1))
+            .Times(2)
+            .WillRepeatedly(Return(storageEvents));
+    EXPECT_CALL(*getStorageMock(), registerEventAddedCallback(_, _)).WillRepeatedly(Return(true));
+
+    std::vector<ITransportConnection::Payload> sentPayloads;
+    EXPECT_CALL(*getConnectionMock(), send(_))
+            .WillRepeatedly(Invoke([&sentPayloads]( const ITransportConnection::Payload& _payload ){
+                sentPayloads.push_back( _payload );
+                return _payload.size();
+            }));
+
+    EXPECT_CALL(*getConnectionMock(), receive())
+            .WillOnce(RETURN_PAYLOAD(requestPayload))
+            .WillOnce(RETURN_PAYLOAD(packedRequestPayload))
+            .WillRepeatedly(RETURN_PAYLOAD(std::nullopt));
+
+    {
+        ProtocolExecutorV1 unitUnderTest(getHandshakeMock(), getStorageMock());
+        newDataCallback.fireCallback();
+    }
+
+    // every event is sent with truncated text, stream of responses is finished by the last one
+    using Challenge::PacketCoderV1::Server::SavedEventsResponse;
+    using Challenge::PacketCoderV1::Server::SavedEventsPackedResponse;
+    ASSERT_EQ( sentPayloads.size(), 4 );
+    for ( const auto& payload : sentPayloads ) {
+        ASSERT_LE( payload.size(), std::numeric_limits<uint16_t>::max() );
+    }
+
+    ASSERT_FALSE( reinterpret_cast<const SavedEventsResponse*>( sentPayloads[0].data() )->isLastEvent );
+    ASSERT_GT( ntohs( reinterpret_cast<const SavedEventsResponse*>( sentPayloads[0].data() )->nboLengthOfText ), 65'000 );
+    ASSERT_TRUE( reinterpret_cast<const SavedEventsResponse*>( sentPayloads[1].data() )->isLastEvent );
+
+    ASSERT_FALSE( reinterpret_cast<const SavedEventsPackedResponse*>( sentPayloads[2].data() )->isLastPacket );
+    ASSERT_EQ( ntohs( reinterpret_cast<const SavedEventsPackedResponse*>( sentPayloads[2].data() )->nboNumberOfEvents ), 1 );
+    ASSERT_TRUE( reinterpret_cast<const SavedEventsPackedResponse*>( sentPayloads[3].data() )->isLastPacket );
+    ASSERT_EQ( ntohs( reinterpret_cast<const SavedEventsPackedResponse*>( sentPayloads[3].data() )->nboNumberOfEvents ), 1 );
+}
+
+TEST_F( ProtocolExecutorV1Test, savedEventsRequestServedFromEncodedEventsCache ) {
+    using namespace testing;
+    using Events = Challenge::EventsStorage::IEventsStorage::Events;
+
+    EXPECT_CALL( *getHandshakeMock(), connection )
+            .WillRepeatedly(RETURN_CONNECTION(*getConnectionMock()));
+    EXPECT_CALL( *getHandshakeMock(), isValid )
+            .WillRepeatedly(testing::Return(true));
+
+    Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback > newDataCallback;
+    // catch new data callback
+    EXPECT_CALL(*getConnectionMock(), registerNewDataReadyToReadCallback(_))
+            .Times(2)
+            .WillRepeatedly(testing::Invoke(&newDataCallback, &Challenge::Tests::CallbackArgument<ITransportConnection::NewDataReadyToReadCallback>::registerCallback));
+
+    const auto timeStamp = std::chrono::system_clock::now();
+    Events storageEvents;
+    for ( uint32_t event = 0; event < 300; ++event ) {
+        storageEvents.push_back( { timeStamp, "event " + std::to_string( event ), event } );
+    }
+
+    Challenge::PacketCoderV1::PacketFactory packetFactory;
+    auto packedRequestPayload = packetFactory.createSavedEventsPackedRequest(3, HandshakeId, 0, Challenge::EventsStorage::IEventsStorage::LAST_EVENT_NUMBER);
+    auto requestPayload = packetFactory.createSavedEventsRequest(4, HandshakeId, 298, 299);
+    auto packedResponsePayload = packetFactory.createSavedEventsPackedResponse( 3, HandshakeId, true, storageEvents.begin(), storageEvents.end() ).value();
+    auto responsePayload1 = packetFactory.createSavedEventsResponse(
+            4, HandshakeId, false
+            , std::chrono::duration_cast<std::chrono::milliseconds>( timeStamp.time_since_epoch()).count()
+            , 298
+            , "event 298" ).value();
+    auto responsePayload2 = packetFactory.createSavedEventsResponse(
+            4, HandshakeId, true
+            , std::chrono::duration_cast<std::chrono::milliseconds>( timeStamp.time_since_epoch()).count()
+            , 299
+            , "event 299" ).value();
+
+    EXPECT_CALL( *getStorageMock(), getNumberOfEvents())
+            .WillRepeatedly(Return(storageEvents.size()));
+    // only the first request reads storage, events encoded for it are cached
+    EXPECT_CALL( *getStorageMock(), getSavedEvents(0, Challenge::EventsStorage::IEventsStorage::LAST_EVENT_NUMBER))
+            .WillOnce(Return(storageEvents));
+    EXPECT_CALL( *getStorageMock(), getSavedEvents(298, 299))
+            .Times(0);
+
+    EXPECT_CALL(*getConnectionMock(), send(packedResponsePayload))
+            .WillOnce(testing::Return(packedResponsePayload.size()));
+    EXPECT_CALL(*getConnectionMock(), send(responsePayload1))
+            .WillOnce(testing::Return(responsePayload1.size()));
+    EXPECT_CALL(*getConnectionMock(), send(responsePayload2))
+            .WillOnce(testing::Return(responsePayload2.size()));
+
+    EXPECT_CALL(*getConnectionMock(), receive())
+            .WillOnce(RETURN_PAYLOAD(packedRequestPayload))
+            .WillOnce(RETURN_PAYLOAD(requestPayload))
+            .WillRepeatedly(RETURN_PAYLOAD(std::nullopt));
+
+    auto encodedEventsCache = std::make_shared<Challenge::EncodedEventsCache>( 1024, 1024 * 1024 );
+    {
+        ProtocolExecutorV1 unitUnderTest(getHandshakeMock(), getStorageMock(), nullptr, encodedEventsCache);
+        newDataCallback.fireCallback();
+    }
+
+    ASSERT_EQ( encodedEventsCache->getStatistics().hits, 1 );
+    ASSERT_EQ( encodedEventsCache->getStatistics().misses, 1 );
+}
+
 TEST_F( ProtocolExecutorV1Test, savedEventsRangeRequestWrongHandshakeId ) {
     using namespace testing;
 
@@ -585,26 +995,28 @@ TEST_F( ProtocolExecutorV1Test, newEventNotification ) {
     EXPECT_CALL( *getHandshakeMock(), isValid )
             .WillRepeatedly(testing::Return(true));
 
-    Challenge::Tests::CallbackArgument<Challenge::EventsStorage::IEventsStorage::EventSavedCallback> newEventCallback;
-    // catch new data callback
-    EXPECT_CALL(*getStorageMock(), registerEventAddedCallback(_, _))
-            .Times(2)
-            .WillRepeatedly(testing::Invoke(&newEventCallback, &Challenge::Tests::CallbackArgument<Challenge::EventsStorage::IEventsStorage::EventSavedCallback>::registerCallback));
-
-    EXPECT_CALL(*getStorageMock(), getNumberOfEvents).Times(1).WillOnce(Return(17));
+    EXPECT_CALL(*getStorageMock(), registerEventAddedCallback(_, _)).Times(0);
+    EXPECT_CALL(*getStorageMock(), getNumberOfEvents).Times(0);
 
     EXPECT_CALL(*getConnectionMock(), registerNewDataReadyToReadCallback(_)).Times(2);
 
     Challenge::PacketCoderV1::PacketFactory packetFactory;
-    auto notificationPayload = packetFactory.createNewEventsNotification(HandshakeId,17);
+    // notification encoded for other connection
+    auto sharedNotification = packetFactory.createNewEventsNotification(HandshakeId + 1, 17);
+    auto notificationPayload = packetFactory.createNewEventsNotification(HandshakeId, 17);
+    auto nextNotificationPayload = packetFactory.createNewEventsNotification(HandshakeId, 18);
 
     EXPECT_CALL( *getConnectionMock(), send(notificationPayload) ).Times(1);
+    EXPECT_CALL( *getConnectionMock(), send(nextNotificationPayload) ).Times(1);
 
     {
             ProtocolExecutorV1 unitUnderTest(getHandshakeMock(), getStorageMock());
-            // new request
-            newEventCallback.fireCallback();
+            unitUnderTest.notifyNewEvents( sharedNotification );
+            unitUnderTest.notifyNewEvents( packetFactory.createNewEventsNotification(HandshakeId + 1, 18) );
     }
+
+    // shared notification is not changed
+    ASSERT_EQ( sharedNotification, packetFactory.createNewEventsNotification(HandshakeId + 1, 17) );
 }
 
 TEST_F( ProtocolExecutorV1Test, isValid ) {
@@ -618,9 +1030,8 @@ TEST_F( ProtocolExecutorV1Test, isValid ) {
             .WillOnce(Return(false))
             .WillRepeatedly(Return(true));
 
-    // catch new data callback
     EXPECT_CALL(*getStorageMock(), registerEventAddedCallback(_, _))
-            .Times(2);
+            .Times(0);
 
     EXPECT_CALL(*getConnectionMock(), registerNewDataReadyToReadCallback(_)).Times(2);
 
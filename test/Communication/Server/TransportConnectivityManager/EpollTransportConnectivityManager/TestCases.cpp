@@ -0,0 +1,241 @@
+#include "EpollTransportConnectivityManager.h"
+#include "EpollConnection.h"
+
+#include <QCoreApplication>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+
+using namespace Challenge::Communication::Server;
+
+class EpollTransportConnectivityManagerTest : public ::testing::Test {
+public:
+    void SetUp() override {
+        char const* params[] = { "app" };
+        auto countParams = 1;
+        m_app.reset( new QCoreApplication( countParams, const_cast<char**>(params) ) );
+
+        m_manager.reset( new EpollTransportConnectivityManager( "127.0.0.1", 0 ) );
+        m_manager->registerNewConnectionCallback( [this]( auto _connection ){ m_connections.push_back( _connection ); } );
+    }
+
+    void TearDown() override {
+        if ( m_clientSocket != -1 ) {
+            ::close( m_clientSocket );
+        }
+
+        m_connections.clear();
+        m_manager.reset();
+        m_app.reset();
+    }
+
+    //! Connects client and returns server side of the connection
+    std::shared_ptr<ITransportConnection> connectClient() {
+        m_clientSocket = ::socket( AF_INET, SOCK_STREAM, 0 );
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons( m_manager->port() );
+        inet_pton( AF_INET, "127.0.0.1", &address.sin_addr );
+
+        if ( ::connect( m_clientSocket, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) == -1 ) {
+            return nullptr;
+        }
+
+        m_manager->processEvents();
+        return m_connections.empty() ? nullptr : m_connections.back();
+    }
+
+    void sendFromClient( const std::string& _text ) {
+        ::send( m_clientSocket, _text.data(), _text.size(), 0 );
+        m_manager->processEvents();
+    }
+
+    int clientSocket() const { return m_clientSocket; }
+    EpollTransportConnectivityManager& manager() { return *m_manager; }
+
+private:
+    std::shared_ptr< QCoreApplication > m_app;
+    std::unique_ptr< EpollTransportConnectivityManager > m_manager;
+    std::vector< std::shared_ptr<ITransportConnection> > m_connections;
+    int m_clientSocket = -1;
+};
+
+TEST( EpollTransportConnectivityManager, CreateAbstraction ) {
+    auto manager = ITransportConnectivityManager::create( EpollEngine{} );
+    ASSERT_NE( manager, nullptr );
+}
+
+TEST( EpollTransportConnectivityManager, Create ) {
+    // wrong address address
+    EXPECT_THROW( EpollTransportConnectivityManager( "1.2.3.4", 1 ), std::runtime_error );
+    EXPECT_THROW( EpollTransportConnectivityManager( "not an address", 0 ), std::runtime_error );
+
+    // shall listen
+    EXPECT_NO_THROW( EpollTransportConnectivityManager( "127.0.0.1", 0 ) );
+}
+
+TEST_F( EpollTransportConnectivityManagerTest, NewConnection ) {
+    auto connection = connectClient();
+
+    ASSERT_NE( connection, nullptr );
+    ASSERT_TRUE( connection->isValid() );
+}
+
+TEST_F( EpollTransportConnectivityManagerTest, ReceivePayload ) {
+    auto connection = connectClient();
+    ASSERT_NE( connection, nullptr );
+
+    auto numberOfCallbacks = 0;
+    ASSERT_FALSE( connection->registerNewDataReadyToReadCallback( [&numberOfCallbacks]{ numberOfCallbacks++; } ) );
+
+    sendFromClient( "ABC" );
+    ASSERT_EQ( numberOfCallbacks, 1 );
+
+    auto received = connection->receive();
+    ASSERT_TRUE( received.has_value() );
+    ASSERT_EQ( received->size(), 3 );
+    ASSERT_EQ( (char)received.value()[0], 'A' );
+    ASSERT_EQ( (char)received.value()[1], 'B' );
+    ASSERT_EQ( (char)received.value()[2], 'C' );
+
+    auto noDataReceived = connection->receive();
+    ASSERT_TRUE( noDataReceived.has_value() );
+    ASSERT_EQ( noDataReceived->size(), 0 );
+}
+
+TEST_F( EpollTransportConnectivityManagerTest, ReceiveIntoBuffer ) {
+    auto connection = connectClient();
+    ASSERT_NE( connection, nullptr );
+
+    // more bytes wait in the socket than one recv of them may return
+    std::string text( 64 * 1024 + 10, 'A' );
+    sendFromClient( text );
+
+    ITransportConnection::Payload buffer = { std::byte('X') };
+    auto numberOfReceived = connection->receiveInto( buffer );
+    ASSERT_TRUE( numberOfReceived.has_value() );
+    ASSERT_EQ( numberOfReceived.value(), text.size() );
+    ASSERT_EQ( buffer.size(), text.size() + 1 );
+    ASSERT_EQ( buffer.front(), std::byte('X') );
+    ASSERT_EQ( buffer.back(), std::byte('A') );
+
+    auto noDataReceived = connection->receiveInto( buffer );
+    ASSERT_TRUE( noDataReceived.has_value() );
+    ASSERT_EQ( noDataReceived.value(), 0 );
+    ASSERT_EQ( buffer.size(), text.size() + 1 );
+}
+
+TEST_F( EpollTransportConnectivityManagerTest, ReceiveIsLimited ) {
+    auto connection = connectClient();
+    ASSERT_NE( connection, nullptr );
+
+    // client blocks until server reads, so it sends from own thread
+    const std::string text( 3 * EpollConnection::MAX_RECEIVE_SIZE, 'A' );
+    std::thread client( [this, &text]{ ::send( clientSocket(), text.data(), text.size(), 0 ); } );
+
+    ITransportConnection::Payload buffer;
+    while ( buffer.size() < text.size() ) {
+        const auto initialSize = buffer.size();
+        auto numberOfReceived = connection->receiveInto( buffer );
+        ASSERT_TRUE( numberOfReceived.has_value() );
+        ASSERT_LE( numberOfReceived.value(), EpollConnection::MAX_RECEIVE_SIZE );
+        ASSERT_EQ( buffer.size(), initialSize + numberOfReceived.value() );
+    }
+    client.join();
+
+    ASSERT_EQ( buffer.size(), text.size() );
+}
+
+TEST_F( EpollTransportConnectivityManagerTest, ConnectionExpired ) {
+    auto connection = connectClient();
+    ASSERT_NE( connection, nullptr );
+
+    bool callbackFired = false;
+    ASSERT_FALSE( connection->registerConnectionExpiredCallback( [&callbackFired]{ callbackFired = true; } ) );
+
+    // data sent before closing are still delivered
+    sendFromClient( "A" );
+    ::shutdown( clientSocket(), SHUT_RDWR );
+    manager().processEvents();
+
+    ASSERT_TRUE( callbackFired );
+    ASSERT_FALSE( connection->isValid() );
+
+    auto received = connection->receive();
+    ASSERT_TRUE( received.has_value() );
+    ASSERT_EQ( received->size(), 1 );
+
+    ASSERT_FALSE( connection->receive().has_value() );
+    ASSERT_FALSE( connection->send( { std::byte('A') } ).has_value() );
+}
+
+TEST_F( EpollTransportConnectivityManagerTest, SendPayload ) {
+    auto connection = connectClient();
+    ASSERT_NE( connection, nullptr );
+
+    ITransportConnection::Payload dataToSend = { std::byte('A'), std::byte('B'), std::byte('C') };
+    auto result = connection->send( dataToSend );
+    ASSERT_TRUE( result.has_value() );
+    ASSERT_EQ( result.value(), dataToSend.size() );
+
+    char receivedData[3] = {};
+    ASSERT_EQ( ::recv( clientSocket(), receivedData, sizeof( receivedData ), MSG_WAITALL ), sizeof( receivedData ) );
+    ASSERT_EQ( receivedData[0], 'A' );
+    ASSERT_EQ( receivedData[1], 'B' );
+    ASSERT_EQ( receivedData[2], 'C' );
+}
+
+TEST_F( EpollTransportConnectivityManagerTest, SendPayloadBiggerThanSocketBuffer ) {
+    auto connection = connectClient();
+    ASSERT_NE( connection, nullptr );
+
+    constexpr std::size_t PAYLOAD_SIZE = 16 * 1024 * 1024;
+    ITransportConnection::Payload dataToSend( PAYLOAD_SIZE );
+    for ( std::size_t index = 0; index < dataToSend.size(); ++index ) {
+        dataToSend[index] = std::byte( index % 251 );
+    }
+
+    auto result = connection->send( dataToSend );
+    ASSERT_TRUE( result.has_value() );
+    ASSERT_EQ( result.value(), dataToSend.size() );
+
+    // rest of payload is waiting in write buffer, it is flushed when client reads
+    std::vector<std::byte> receivedData( PAYLOAD_SIZE );
+    std::size_t numberOfReceived = 0;
+    while ( numberOfReceived < PAYLOAD_SIZE ) {
+        auto received = ::recv( clientSocket(), receivedData.data() + numberOfReceived, PAYLOAD_SIZE - numberOfReceived, 0 );
+        ASSERT_GT( received, 0 );
+        numberOfReceived += received;
+        manager().processEvents();
+    }
+
+    ASSERT_EQ( receivedData, dataToSend );
+}
+
+TEST_F( EpollTransportConnectivityManagerTest, SendFailsWhenWriteBufferIsFull ) {
+    auto connection = connectClient();
+    ASSERT_NE( connection, nullptr );
+
+    ITransportConnection::Payload dataToSend( EpollConnection::MAX_WRITE_BUFFER_SIZE );
+    ASSERT_TRUE( connection->send( dataToSend ).has_value() );
+
+    // client does not read, so buffered data exceed the limit
+    ASSERT_FALSE( connection->send( dataToSend ).has_value() );
+    ASSERT_TRUE( connection->isValid() );
+}
+
+TEST( EpollTransportConnectivityManager, SharedPort ) {
+    EpollTransportConnectivityManager firstManager( "127.0.0.1", 0, true );
+
+    // port can be shared only when all managers agree to share it
+    EXPECT_THROW( EpollTransportConnectivityManager( "127.0.0.1", firstManager.port() ), std::runtime_error );
+    EXPECT_NO_THROW( EpollTransportConnectivityManager( "127.0.0.1", firstManager.port(), true ) );
+}
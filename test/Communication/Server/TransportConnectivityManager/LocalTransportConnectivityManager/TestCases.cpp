@@ -0,0 +1,85 @@
+#include "LocalTransportConnectivityManager.h"
+
+#include "Mock/Communication/Server/ITransportConnection.h"
+
+#include <QCoreApplication>
+#include <QLocalSocket>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace Challenge::Communication::Server;
+
+constexpr auto SOCKET_PATH = "/tmp/challenge.test.socket";
+
+template std::shared_ptr<ITransportConnection> ITransportConnection::create<QLocalSocket*>(QLocalSocket*);
+
+TEST( LocalTranportConnectivityManager, CreateAbstraction ) {
+    auto manager = ITransportConnectivityManager::create( LocalSocketEngine{ SOCKET_PATH } );
+    ASSERT_NE( manager, nullptr );
+}
+
+TEST( LocalTranportConnectivityManager, Create ) {
+    // directory does not exist
+    EXPECT_THROW( LocalTransportConnectivityManager( "/not/existing/directory/socket" ), std::runtime_error );
+
+    // stale socket of previous instance is replaced
+    EXPECT_NO_THROW( LocalTransportConnectivityManager{ SOCKET_PATH } );
+    EXPECT_NO_THROW( LocalTransportConnectivityManager{ SOCKET_PATH } );
+}
+
+TEST( LocalTranportConnectivityManager, StartNewConnectionPositive ) {
+    char const* parameters[] = { "app" };
+    auto parametersNumber = 1;
+    QCoreApplication app(parametersNumber, const_cast<char**>(parameters));
+
+    LocalTransportConnectivityManager connectivityManager( SOCKET_PATH );
+
+    bool callbackFired{ false };
+
+    auto onNewConnectionCallback = [&callbackFired]( std::shared_ptr<ITransportConnection> _newConnection ) {
+        callbackFired = true;
+    };
+
+    connectivityManager.registerNewConnectionCallback( onNewConnectionCallback );
+
+    auto transportConnectionFactoryMock = Mock::ITransportConnection::getFactoryMock();
+    EXPECT_CALL( *transportConnectionFactoryMock, create  )
+    .Times(1)
+    .WillOnce(testing::Return( std::shared_ptr<ITransportConnection>(new Mock::ITransportConnection ) ));
+
+    QLocalSocket localClient;
+    localClient.connectToServer( SOCKET_PATH );
+    ASSERT_TRUE( localClient.waitForConnected( 500 ) );
+    app.processEvents();
+
+    ASSERT_TRUE( callbackFired );
+}
+
+TEST( LocalTranportConnectivityManager, StartNewConnectionFail ) {
+    char const* parameters[] = { "app" };
+    auto parametersNumber = 1;
+    QCoreApplication app(parametersNumber, const_cast<char**>(parameters));
+
+    LocalTransportConnectivityManager connectivityManager( SOCKET_PATH );
+
+    bool callbackFired{ false };
+
+    auto onNewConnectionCallback = [&callbackFired]( std::shared_ptr<ITransportConnection> _newConnection ) {
+        callbackFired = true;
+    };
+
+    connectivityManager.registerNewConnectionCallback( onNewConnectionCallback );
+
+    auto transportConnectionFactoryMock = Mock::ITransportConnection::getFactoryMock();
+    EXPECT_CALL( *transportConnectionFactoryMock, create  )
+            .Times(1)
+            .WillOnce(testing::Return( std::shared_ptr<ITransportConnection>() ));
+
+    QLocalSocket localClient;
+    localClient.connectToServer( SOCKET_PATH );
+    ASSERT_TRUE( localClient.waitForConnected( 500 ) );
+    app.processEvents();
+
+    ASSERT_FALSE( callbackFired );
+}
\ No newline at end of file
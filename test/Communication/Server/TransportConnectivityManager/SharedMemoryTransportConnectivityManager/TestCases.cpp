@@ -0,0 +1,79 @@
+#include "SharedMemoryTransportConnectivityManager.h"
+
+#include "Communication/Server/TransportConnectivityManager/ITransportConnection.h"
+
+#include "Lib/SharedMemoryChannel/SharedMemoryChannel.h"
+
+#include <QCoreApplication>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstring>
+
+using namespace Challenge::Communication::Server;
+using Challenge::SharedMemoryChannel;
+
+constexpr auto SOCKET_PATH = "/tmp/challenge.test.shm.socket";
+
+int connectToServer() {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy( address.sun_path, SOCKET_PATH, sizeof( address.sun_path ) - 1 );
+
+    auto socket = ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    if ( ::connect( socket, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) == -1 ) {
+        ::close( socket );
+        return -1;
+    }
+    return socket;
+}
+
+TEST( SharedMemoryTranportConnectivityManager, CreateAbstraction ) {
+    auto manager = ITransportConnectivityManager::create( SharedMemoryEngine{ SOCKET_PATH } );
+    ASSERT_NE( manager, nullptr );
+
+    ASSERT_EQ( ITransportConnectivityManager::create( SharedMemoryEngine{ "/not/existing/directory/socket" } ), nullptr );
+}
+
+TEST( SharedMemoryTranportConnectivityManager, Create ) {
+    EXPECT_THROW( SharedMemoryTransportConnectivityManager( "/not/existing/directory/socket" ), std::runtime_error );
+    EXPECT_THROW( SharedMemoryTransportConnectivityManager( "" ), std::runtime_error );
+
+    // stale socket of previous instance is replaced
+    EXPECT_NO_THROW( SharedMemoryTransportConnectivityManager{ SOCKET_PATH } );
+    EXPECT_NO_THROW( SharedMemoryTransportConnectivityManager{ SOCKET_PATH } );
+}
+
+TEST( SharedMemoryTranportConnectivityManager, StartNewConnectionPositive ) {
+    char const* parameters[] = { "app" };
+    auto parametersNumber = 1;
+    QCoreApplication app(parametersNumber, const_cast<char**>(parameters));
+
+    SharedMemoryTransportConnectivityManager connectivityManager( SOCKET_PATH );
+
+    std::shared_ptr<ITransportConnection> serverConnection;
+    connectivityManager.registerNewConnectionCallback( [&serverConnection]( std::shared_ptr<ITransportConnection> _newConnection ) {
+        serverConnection = std::move( _newConnection );
+    });
+
+    auto clientSocket = connectToServer();
+    ASSERT_NE( clientSocket, -1 );
+
+    connectivityManager.acceptConnections();
+    ASSERT_NE( serverConnection, nullptr );
+    ASSERT_TRUE( serverConnection->isValid() );
+
+    SharedMemoryChannel clientChannel( clientSocket, SharedMemoryChannel::Side::Client );
+
+    ASSERT_TRUE( clientChannel.send( { std::byte('A'), std::byte('B') } ).has_value() );
+    ASSERT_TRUE( clientChannel.flush() );
+
+    ITransportConnection::Payload buffer;
+    ASSERT_EQ( serverConnection->receiveInto( buffer ).value(), 2 );
+    ASSERT_EQ( buffer, ITransportConnection::Payload( { std::byte('A'), std::byte('B') } ) );
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include "AsyncStorage.h"
+#include "LogStorage.h"
+
+#include "Conformance/StorageConformance.h"
+
+#include <experimental/filesystem>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+using namespace Challenge::EventsStorage;
+
+namespace {
+    constexpr auto TEST_STORAGE_PATH =  "/tmp/energotest.async.log";
+
+    struct AsyncStorageTraits {
+        static std::unique_ptr<IEventsStorage> open() {
+            return std::make_unique<AsyncStorage>( std::make_shared<LogStorage>( TEST_STORAGE_PATH ), 16, FullQueuePolicy::Block );
+        }
+        static void remove() { std::experimental::filesystem::remove_all( TEST_STORAGE_PATH ); }
+    };
+
+    Challenge::EventData createEvent( uint32_t _priority ) {
+        return Challenge::EventData{ std::chrono::system_clock::now(), "event " + std::to_string( _priority ), _priority };
+    }
+
+    //! Storage which holds writer in the first write until it is opened
+    /*!
+     *  Writer cannot be stopped while it is held, so tests use EXPECT, to open storage also after failed check
+     */
+    class GatedStorage : public IEventsStorage {
+    public:
+        bool saveEvent( const Challenge::EventData& _event ) override { return saveEvents( { _event } ) == 1; }
+
+        std::size_t saveEvents( const Events& _events ) override {
+            std::call_once( m_isWriterEntered, [this]{ m_writerEntered.set_value(); } );
+            m_gate.wait();
+
+            std::lock_guard lock( m_writesMutex );
+            m_writes.push_back( _events );
+            return _events.size();
+        }
+
+        std::optional<Events> getSavedEvents( uint64_t, uint64_t ) const override { return Events{}; }
+        std::optional<uint64_t> getNumberOfEvents() const override { return 0; }
+        bool registerEventAddedCallback( EventSavedCallback, void* ) override { return false; }
+        void setCallbackExecutor( CallbackExecutor ) override {}
+
+        void waitForWriter() { m_writerEntered.get_future().wait(); }
+        void open() { m_opening.set_value(); }
+
+        std::vector<Events> writes() const {
+            std::lock_guard lock( m_writesMutex );
+            return m_writes;
+        }
+
+    private:
+        std::once_flag m_isWriterEntered;
+        std::promise<void> m_writerEntered;
+        std::promise<void> m_opening;
+        std::shared_future<void> m_gate{ m_opening.get_future() };
+
+        std::vector<Events> m_writes;
+        mutable std::mutex m_writesMutex;
+    };
+
+    //! Collects number of saved events reported by completions
+    class Completions {
+    public:
+        IEventsStorage::SaveCompletion add() {
+            std::lock_guard lock( m_mutex );
+            m_results.emplace_back();
+            return [this, index = m_results.size() - 1]( std::size_t _numberOfSavedEvents ){
+                std::lock_guard lock( m_mutex );
+                m_results[index] = _numberOfSavedEvents;
+            };
+        }
+
+        std::optional<std::size_t> result( std::size_t _index ) const {
+            std::lock_guard lock( m_mutex );
+            return m_results.at( _index );
+        }
+
+    private:
+        std::vector<std::optional<std::size_t>> m_results;
+        mutable std::mutex m_mutex;
+    };
+} // namespace
+
+INSTANTIATE_TYPED_TEST_CASE_P( Async, StorageConformance, AsyncStorageTraits );
+
+TEST( AsyncStorageCreation, CreateStorage ) {
+    EXPECT_THROW( AsyncStorage( nullptr, 16, FullQueuePolicy::Block ), std::runtime_error );
+    EXPECT_THROW( AsyncStorage( std::make_shared<GatedStorage>(), 0, FullQueuePolicy::Block ), std::runtime_error );
+}
+
+TEST( AsyncStorageQueue, CompletionFiredByWriter ) {
+    auto storage = std::make_shared<GatedStorage>();
+    storage->open();
+    AsyncStorage unitUnderTest( storage, 16, FullQueuePolicy::Block );
+
+    std::promise<std::thread::id> completionThread;
+    unitUnderTest.saveEventAsync( createEvent( 1 ), [&completionThread]( std::size_t _numberOfSavedEvents ){
+        EXPECT_EQ( _numberOfSavedEvents, 1 );
+        completionThread.set_value( std::this_thread::get_id() );
+    });
+
+    ASSERT_NE( completionThread.get_future().get(), std::this_thread::get_id() );
+}
+
+TEST( AsyncStorageQueue, WaitingEventsAreWrittenTogether ) {
+    auto storage = std::make_shared<GatedStorage>();
+    Completions completions;
+    {
+        AsyncStorage unitUnderTest( storage, 16, FullQueuePolicy::Block );
+
+        unitUnderTest.saveEventAsync( createEvent( 1 ), completions.add() );
+        storage->waitForWriter();
+
+        unitUnderTest.saveEventAsync( createEvent( 2 ), completions.add() );
+        unitUnderTest.saveEventsAsync( { createEvent( 3 ), createEvent( 4 ) }, completions.add() );
+        EXPECT_EQ( unitUnderTest.getQueueDepth(), 3 );
+
+        storage->open();
+        // destructor writes all queued events
+    }
+
+    auto writes = storage->writes();
+    ASSERT_EQ( writes.size(), 2 );
+    ASSERT_EQ( writes[0].size(), 1 );
+    ASSERT_EQ( writes[1].size(), 3 );
+    EXPECT_EQ( writes[1][2].priority, 4 );
+
+    EXPECT_EQ( completions.result( 0 ), 1 );
+    EXPECT_EQ( completions.result( 1 ), 1 );
+    EXPECT_EQ( completions.result( 2 ), 2 );
+}
+
+TEST( AsyncStorageQueue, FullQueueRejects ) {
+    auto storage = std::make_shared<GatedStorage>();
+    Completions completions;
+    AsyncStorage unitUnderTest( storage, 2, FullQueuePolicy::Reject );
+
+    unitUnderTest.saveEventAsync( createEvent( 1 ), completions.add() );
+    storage->waitForWriter();
+
+    unitUnderTest.saveEventAsync( createEvent( 2 ), completions.add() );
+    unitUnderTest.saveEventAsync( createEvent( 3 ), completions.add() );
+    unitUnderTest.saveEventAsync( createEvent( 4 ), completions.add() );
+
+    // rejected event is completed at once
+    EXPECT_EQ( completions.result( 3 ), 0 );
+    EXPECT_FALSE( unitUnderTest.saveEvent( createEvent( 5 ) ) );
+    EXPECT_EQ( unitUnderTest.getQueueDepth(), 2 );
+
+    storage->open();
+}
+
+TEST( AsyncStorageQueue, FullQueueShedsLowPriority ) {
+    auto storage = std::make_shared<GatedStorage>();
+    Completions completions;
+    {
+        AsyncStorage unitUnderTest( storage, 2, FullQueuePolicy::ShedLowPriority );
+
+        unitUnderTest.saveEventAsync( createEvent( 9 ), completions.add() );
+        storage->waitForWriter();
+
+        unitUnderTest.saveEventAsync( createEvent( 1 ), completions.add() );
+        unitUnderTest.saveEventAsync( createEvent( 5 ), completions.add() );
+
+        // event with priority 1 makes space
+        unitUnderTest.saveEventAsync( createEvent( 3 ), completions.add() );
+        EXPECT_EQ( completions.result( 1 ), 0 );
+
+        // there is no event with lower priority
+        unitUnderTest.saveEventAsync( createEvent( 2 ), completions.add() );
+        EXPECT_EQ( completions.result( 4 ), 0 );
+
+        // two events do not fit even after shedding of event with priority 3, so nothing is shed
+        unitUnderTest.saveEventsAsync( { createEvent( 4 ), createEvent( 4 ) }, completions.add() );
+        EXPECT_EQ( completions.result( 5 ), 0 );
+        EXPECT_EQ( unitUnderTest.getQueueDepth(), 2 );
+
+        storage->open();
+    }
+
+    EXPECT_EQ( completions.result( 2 ), 1 );
+    EXPECT_EQ( completions.result( 3 ), 1 );
+}
+
+TEST( AsyncStorageQueue, FullQueueBlocks ) {
+    auto storage = std::make_shared<GatedStorage>();
+    Completions completions;
+    AsyncStorage unitUnderTest( storage, 1, FullQueuePolicy::Block );
+
+    unitUnderTest.saveEventAsync( createEvent( 1 ), completions.add() );
+    storage->waitForWriter();
+    unitUnderTest.saveEventAsync( createEvent( 2 ), completions.add() );
+
+    auto blockedSave = std::async( std::launch::async, [&unitUnderTest]{ return unitUnderTest.saveEvent( createEvent( 3 ) ); } );
+    EXPECT_EQ( blockedSave.wait_for( std::chrono::milliseconds( 50 ) ), std::future_status::timeout );
+
+    storage->open();
+    EXPECT_TRUE( blockedSave.get() );
+    EXPECT_EQ( completions.result( 1 ), 1 );
+}
@@ -0,0 +1,308 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "EventsStorage/IEventsStorage.h"
+
+#include <cassert>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+//! Tests which every implementation of IEventsStorage has to pass
+/*!
+ *  Test of storage instantiates them with traits of the storage:
+ *  struct Traits {
+ *      static std::unique_ptr<IEventsStorage> open(); // opens storage in persistent test location
+ *      static void remove(); // removes storage from test location
+ *  };
+ *  INSTANTIATE_TYPED_TEST_CASE_P( Name, StorageConformance, Traits );
+ */
+template<typename _StorageTraits>
+class StorageConformance : public ::testing::Test {
+public:
+    void SetUp() override {
+        assert(!m_storage);
+        _StorageTraits::remove();
+        m_storage = _StorageTraits::open();
+        ASSERT_TRUE( m_storage );
+        setInlineCallbackExecutor();
+    }
+
+    void TearDown() override {
+        m_storage.reset();
+        _StorageTraits::remove();
+    }
+
+    Challenge::EventsStorage::IEventsStorage& getStorage() { assert(m_storage); return *m_storage; }
+
+    void reopenStorage() {
+        m_storage.reset();
+        m_storage = _StorageTraits::open();
+        ASSERT_TRUE( m_storage );
+        setInlineCallbackExecutor();
+    }
+
+private:
+    //! Callbacks are fired before saveEvent returns, so tests can check them immediately
+    void setInlineCallbackExecutor() {
+        m_storage->setCallbackExecutor( []( std::function<void()> _task ){ _task(); } );
+    }
+
+    std::unique_ptr<Challenge::EventsStorage::IEventsStorage> m_storage;
+};
+
+TYPED_TEST_CASE_P( StorageConformance );
+
+TYPED_TEST_P( StorageConformance, SaveEvent ) {
+    auto timeStamp = std::chrono::system_clock::now();
+    Challenge::EventData eventToSave{ timeStamp, "text", 0 };
+
+    auto result = this->getStorage().saveEvent( eventToSave );
+    EXPECT_TRUE( result );
+}
+
+TYPED_TEST_P( StorageConformance, SaveEvents ) {
+    using Challenge::EventsStorage::IEventsStorage;
+
+    ASSERT_EQ( this->getStorage().saveEvents( {} ), 0 );
+
+    auto numberOfNotifications = 0;
+    uint64_t notifiedNumberOfEvents = 0;
+    this->getStorage().registerEventAddedCallback( [&]( uint64_t _numberOfEvents ){
+        ++numberOfNotifications;
+        notifiedNumberOfEvents = _numberOfEvents;
+    }, this );
+
+    auto timeStamp = std::chrono::system_clock::now();
+    this->getStorage().saveEvent( { timeStamp, "text0", 0 } );
+
+    IEventsStorage::Events eventsToSave;
+    for ( uint32_t priority = 1; priority < 4; ++priority ) {
+        eventsToSave.push_back( { timeStamp, "text" + std::to_string( priority ), priority } );
+    }
+    ASSERT_EQ( this->getStorage().saveEvents( eventsToSave ), eventsToSave.size() );
+
+    // whole batch is notified at once
+    ASSERT_EQ( numberOfNotifications, 2 );
+    ASSERT_EQ( notifiedNumberOfEvents, 4 );
+    ASSERT_EQ( this->getStorage().getNumberOfEvents().value(), 4 );
+
+    this->reopenStorage();
+
+    auto events = this->getStorage().getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( events.value().size(), 4 );
+    for ( uint32_t priority = 0; priority < 4; ++priority ) {
+        ASSERT_EQ( events.value()[priority].priority, priority );
+        ASSERT_EQ( events.value()[priority].text, "text" + std::to_string( priority ) );
+    }
+}
+
+TYPED_TEST_P( StorageConformance, GetNumberOfEvents ) {
+    auto zeroEvents = this->getStorage().getNumberOfEvents();
+    ASSERT_TRUE(zeroEvents.has_value());
+    ASSERT_EQ(zeroEvents.value(), 0);
+
+    auto timeStamp = std::chrono::system_clock::now();
+    Challenge::EventData eventToSave1{ timeStamp, "text1", 0 };
+    Challenge::EventData eventToSave2{ timeStamp, "text2", 0 };
+    Challenge::EventData eventToSave3{ timeStamp, "text3", 0 };
+
+    this->getStorage().saveEvent( eventToSave1 );
+    this->getStorage().saveEvent( eventToSave2 );
+    this->getStorage().saveEvent( eventToSave3 );
+
+    auto threeEvents = this->getStorage().getNumberOfEvents();
+    ASSERT_TRUE( threeEvents.has_value() );
+    ASSERT_EQ( threeEvents.value(), 3 );
+}
+
+TYPED_TEST_P( StorageConformance, EventsArePersistent ) {
+    auto timeStamp = std::chrono::system_clock::now();
+    Challenge::EventData eventToSave1{ timeStamp, "text1", 1 };
+    Challenge::EventData eventToSave2{ timeStamp, "text2", 2 };
+    this->getStorage().saveEvent( eventToSave1 );
+    this->getStorage().saveEvent( eventToSave2 );
+
+    this->reopenStorage();
+
+    auto numberOfEvents = this->getStorage().getNumberOfEvents();
+    ASSERT_TRUE( numberOfEvents.has_value() );
+    ASSERT_EQ( numberOfEvents.value(), 2 );
+
+    // storage continues after saved events
+    Challenge::EventData eventToSave3{ timeStamp, "text3", 3 };
+    ASSERT_TRUE( this->getStorage().saveEvent( eventToSave3 ) );
+
+    auto events = this->getStorage().getSavedEvents( Challenge::EventsStorage::IEventsStorage::FIRST_EVENT_NUMBER, Challenge::EventsStorage::IEventsStorage::LAST_EVENT_NUMBER );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( events.value().size(), 3 );
+    ASSERT_EQ( events.value()[0].text, "text1" );
+    ASSERT_EQ( events.value()[1].text, "text2" );
+    ASSERT_EQ( events.value()[2].text, "text3" );
+}
+
+TYPED_TEST_P( StorageConformance, EventDataArePreserved ) {
+    using namespace std::chrono;
+    // storage keeps time with precision of milliseconds
+    time_point<system_clock> timeStamp( duration_cast<system_clock::duration>( milliseconds( 1'500'000'000'123 ) ) );
+    Challenge::EventData eventToSave{ timeStamp, "text of event \xC5\xBC\xC3\xB3\xC5\x82w", 0xFFFFFFFF };
+
+    ASSERT_TRUE( this->getStorage().saveEvent( eventToSave ) );
+
+    auto events = this->getStorage().getSavedEvents( 0, 0 );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( events.value().size(), 1 );
+    ASSERT_EQ( events.value()[0].timeStamp, timeStamp );
+    ASSERT_EQ( events.value()[0].priority, 0xFFFFFFFF );
+    ASSERT_EQ( events.value()[0].text, eventToSave.text );
+}
+
+TYPED_TEST_P( StorageConformance, GetSavedEvents ) {
+    using Challenge::EventsStorage::IEventsStorage;
+
+    auto zeroEvents = this->getStorage().getSavedEvents(IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER);
+    ASSERT_TRUE(zeroEvents.has_value());
+    ASSERT_TRUE(zeroEvents.value().empty() );
+
+    auto timeStamp = std::chrono::system_clock::now();
+    Challenge::EventData eventToSave1{ timeStamp, "text1", 0 };
+    Challenge::EventData eventToSave2{ timeStamp, "text2", 1 };
+    Challenge::EventData eventToSave3{ timeStamp, "text3", 2 };
+
+    this->getStorage().saveEvent( eventToSave1 );
+    this->getStorage().saveEvent( eventToSave2 );
+    this->getStorage().saveEvent( eventToSave3 );
+
+    auto threeEvents = this->getStorage().getSavedEvents(IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER);
+    ASSERT_TRUE( threeEvents.has_value() );
+    ASSERT_EQ( threeEvents.value().size(), 3 );
+
+    auto event0 = this->getStorage().getSavedEvents(0, 0);
+    ASSERT_TRUE( event0.has_value() );
+    ASSERT_EQ( event0.value().size(), 1 );
+    ASSERT_EQ( event0.value().front().priority, 0 );
+
+    auto event1and1 = this->getStorage().getSavedEvents(1, 1);
+    ASSERT_TRUE( event1and1.has_value() );
+    ASSERT_EQ( event1and1.value().size(), 1 );
+    ASSERT_EQ( event1and1.value()[0].priority, 1 );
+
+    auto event1and2 = this->getStorage().getSavedEvents(1, 2);
+    ASSERT_TRUE( event1and2.has_value() );
+    ASSERT_EQ( event1and2.value().size(), 2 );
+    ASSERT_EQ( event1and2.value()[0].priority, 1 );
+    ASSERT_EQ( event1and2.value()[1].priority, 2 );
+
+    auto outOfRange = this->getStorage().getSavedEvents(3, 10);
+    ASSERT_TRUE( outOfRange.has_value() );
+    ASSERT_TRUE( outOfRange.value().empty() );
+
+    auto wrongRange = this->getStorage().getSavedEvents(3, 1);
+    ASSERT_FALSE( wrongRange.has_value() );
+}
+
+TYPED_TEST_P( StorageConformance, VisitSavedEvents ) {
+    using Challenge::EventsStorage::IEventsStorage;
+
+    std::vector<std::pair<std::size_t, bool>> chunks;
+    auto collectChunks = [&chunks]( const IEventsStorage::Events& _events, bool _isLastChunk ) {
+        chunks.emplace_back( _events.size(), _isLastChunk );
+        return true;
+    };
+
+    // empty storage gives one empty last chunk
+    ASSERT_TRUE( this->getStorage().visitSavedEvents(IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER, 2, collectChunks) );
+    ASSERT_EQ( chunks.size(), 1 );
+    ASSERT_EQ( chunks[0], std::make_pair( std::size_t(0), true ) );
+
+    auto timeStamp = std::chrono::system_clock::now();
+    for ( uint32_t priority = 0; priority < 5; ++priority ) {
+        Challenge::EventData eventToSave{ timeStamp, "text", priority };
+        this->getStorage().saveEvent( eventToSave );
+    }
+
+    chunks.clear();
+    ASSERT_TRUE( this->getStorage().visitSavedEvents(IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER, 2, collectChunks) );
+    ASSERT_EQ( chunks.size(), 3 );
+    ASSERT_EQ( chunks[0], std::make_pair( std::size_t(2), false ) );
+    ASSERT_EQ( chunks[1], std::make_pair( std::size_t(2), false ) );
+    ASSERT_EQ( chunks[2], std::make_pair( std::size_t(1), true ) );
+
+    // range fits exactly into chunks
+    chunks.clear();
+    ASSERT_TRUE( this->getStorage().visitSavedEvents(1, 4, 2, collectChunks) );
+    ASSERT_EQ( chunks.size(), 2 );
+    ASSERT_EQ( chunks[0], std::make_pair( std::size_t(2), false ) );
+    ASSERT_EQ( chunks[1], std::make_pair( std::size_t(2), true ) );
+
+    // events are passed in order
+    std::vector<uint32_t> priorities;
+    this->getStorage().visitSavedEvents(1, 3, 1, [&priorities]( const IEventsStorage::Events& _events, bool ) {
+        for ( auto& event : _events ) {
+            priorities.push_back( event.priority );
+        }
+        return true;
+    });
+    ASSERT_EQ( priorities, std::vector<uint32_t>({1, 2, 3}) );
+
+    // visitor stops reading
+    auto numberOfCalls = 0;
+    ASSERT_TRUE( this->getStorage().visitSavedEvents(IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER, 1,
+            [&numberOfCalls]( const IEventsStorage::Events&, bool ) { ++numberOfCalls; return false; }) );
+    ASSERT_EQ( numberOfCalls, 1 );
+
+    // wrong range
+    ASSERT_FALSE( this->getStorage().visitSavedEvents(3, 1, 2, collectChunks) );
+}
+
+TYPED_TEST_P( StorageConformance, SavedEventsCallback ) {
+    auto zeroEvents = this->getStorage().getNumberOfEvents();
+    ASSERT_TRUE(zeroEvents.has_value());
+    ASSERT_EQ(zeroEvents.value(), 0);
+
+    auto timeStamp = std::chrono::system_clock::now();
+    Challenge::EventData eventToSave1{ timeStamp, "text1", 0 };
+    Challenge::EventData eventToSave2{ timeStamp, "text2", 0 };
+    Challenge::EventData eventToSave3{ timeStamp, "text3", 0 };
+
+    auto callback1FireCounter = 0;
+    auto callback2FireCounter = 0;
+    uint64_t notifiedNumberOfEvents = 0;
+    auto newEventSavedCallback1 = [&callback1FireCounter, &notifiedNumberOfEvents]( uint64_t _numberOfEvents ){
+        ++callback1FireCounter;
+        notifiedNumberOfEvents = _numberOfEvents;
+    };
+    auto newEventSavedCallback2 = [&callback2FireCounter]( uint64_t ){ ++callback2FireCounter; };
+
+    this->getStorage().registerEventAddedCallback(newEventSavedCallback1, this);
+    this->getStorage().registerEventAddedCallback(newEventSavedCallback2, nullptr);
+    this->getStorage().saveEvent( eventToSave1 );
+    ASSERT_EQ( callback1FireCounter, 1 );
+    ASSERT_EQ( callback2FireCounter, 1 );
+    ASSERT_EQ( notifiedNumberOfEvents, 1 );
+
+    this->getStorage().registerEventAddedCallback(nullptr, nullptr);
+    this->getStorage().saveEvent( eventToSave2 );
+    ASSERT_EQ( callback1FireCounter, 2 );
+    ASSERT_EQ( callback2FireCounter, 1 );
+    ASSERT_EQ( notifiedNumberOfEvents, 2 );
+
+
+    this->getStorage().registerEventAddedCallback(nullptr, this);
+    this->getStorage().saveEvent( eventToSave3 );
+    ASSERT_EQ( callback1FireCounter, 2 );
+    ASSERT_EQ( callback2FireCounter, 1 );
+}
+
+REGISTER_TYPED_TEST_CASE_P( StorageConformance,
+        SaveEvent,
+        SaveEvents,
+        GetNumberOfEvents,
+        EventsArePersistent,
+        EventDataArePreserved,
+        GetSavedEvents,
+        VisitSavedEvents,
+        SavedEventsCallback );
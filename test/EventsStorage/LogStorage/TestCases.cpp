@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include "LogStorage.h"
+
+#include "Conformance/StorageConformance.h"
+
+#include <experimental/filesystem>
+
+
+using namespace Challenge::EventsStorage;
+
+namespace {
+    constexpr auto TEST_STORAGE_PATH =  "/tmp/energotest.log";
+
+    struct LogStorageTraits {
+        static std::unique_ptr<IEventsStorage> open() { return std::make_unique<LogStorage>( TEST_STORAGE_PATH ); }
+        static void remove() { std::experimental::filesystem::remove_all( TEST_STORAGE_PATH ); }
+    };
+
+    Challenge::EventData createEvent( uint32_t _priority ) {
+        return Challenge::EventData{ std::chrono::system_clock::now(), "event " + std::to_string( _priority ), _priority };
+    }
+} // namespace
+
+INSTANTIATE_TYPED_TEST_CASE_P( Log, StorageConformance, LogStorageTraits );
+
+TEST( LogStorageCreation, CreateStorage ) {
+    LogStorageTraits::remove();
+    EXPECT_NO_THROW( LogStorage{ TEST_STORAGE_PATH } );
+    EXPECT_TRUE( std::experimental::filesystem::is_directory( TEST_STORAGE_PATH ) );
+    LogStorageTraits::remove();
+
+    // relative path will throw
+    EXPECT_THROW( LogStorage( "../tmp/log"), std::runtime_error );
+
+    // unexisted parent directory will throw
+    EXPECT_THROW( LogStorage( "/unexisted_path/unexisted_path/blalala/tmp/log" ), std::runtime_error );
+
+    // segment has to contain at least one record
+    EXPECT_THROW( ( LogStorage{ TEST_STORAGE_PATH, LogStorage::Settings{ 8, false } } ), std::runtime_error );
+    LogStorageTraits::remove();
+}
+
+TEST( LogStorageSegments, EventsAreSpreadAcrossSegments ) {
+    constexpr auto numberOfEvents = 10'000; // more than initial capacity of index
+    LogStorageTraits::remove();
+    {
+        LogStorage storage( TEST_STORAGE_PATH, LogStorage::Settings{ 4096, false } );
+        for ( uint32_t event = 0; event < numberOfEvents; ++event ) {
+            ASSERT_TRUE( storage.saveEvent( createEvent( event ) ) );
+        }
+    }
+
+    ASSERT_TRUE( std::experimental::filesystem::exists( std::string(TEST_STORAGE_PATH) + "/segment-1.log" ) );
+
+    {
+        LogStorage storage( TEST_STORAGE_PATH, LogStorage::Settings{ 4096, false } );
+        ASSERT_EQ( storage.getNumberOfEvents().value(), numberOfEvents );
+
+        auto events = storage.getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER );
+        ASSERT_TRUE( events.has_value() );
+        ASSERT_EQ( events.value().size(), numberOfEvents );
+        for ( uint32_t event = 0; event < numberOfEvents; ++event ) {
+            ASSERT_EQ( events.value()[event].priority, event );
+            ASSERT_EQ( events.value()[event].text, "event " + std::to_string( event ) );
+        }
+
+        // lookup by event number
+        auto lastEvent = storage.getSavedEvents( numberOfEvents - 1, numberOfEvents - 1 );
+        ASSERT_TRUE( lastEvent.has_value() );
+        ASSERT_EQ( lastEvent.value().size(), 1 );
+        ASSERT_EQ( lastEvent.value().front().priority, numberOfEvents - 1 );
+    }
+    LogStorageTraits::remove();
+}
+
+TEST( LogStorageSegments, TooBigEventIsRejected ) {
+    LogStorageTraits::remove();
+    {
+        LogStorage storage( TEST_STORAGE_PATH, LogStorage::Settings{ 64, false } );
+        Challenge::EventData bigEvent{ std::chrono::system_clock::now(), std::string( 64, 'x' ), 0 };
+        ASSERT_FALSE( storage.saveEvent( bigEvent ) );
+        ASSERT_EQ( storage.getNumberOfEvents().value(), 0 );
+
+        ASSERT_TRUE( storage.saveEvent( createEvent( 1 ) ) );
+        ASSERT_EQ( storage.getNumberOfEvents().value(), 1 );
+    }
+    LogStorageTraits::remove();
+}
+
+TEST( LogStorageSegments, BatchIsSpreadAcrossSegments ) {
+    constexpr auto numberOfEvents = 1'000;
+    LogStorageTraits::remove();
+    {
+        LogStorage storage( TEST_STORAGE_PATH, LogStorage::Settings{ 4096, true } );
+        IEventsStorage::Events events;
+        for ( uint32_t event = 0; event < numberOfEvents; ++event ) {
+            events.push_back( createEvent( event ) );
+        }
+
+        // event which does not fit into segment stops the batch
+        events.insert( events.begin() + 500, Challenge::EventData{ std::chrono::system_clock::now(), std::string( 4096, 'x' ), 0 } );
+        ASSERT_EQ( storage.saveEvents( events ), 500 );
+
+        events.erase( events.begin(), events.begin() + 501 );
+        ASSERT_EQ( storage.saveEvents( events ), numberOfEvents - 500 );
+    }
+
+    {
+        LogStorage storage( TEST_STORAGE_PATH, LogStorage::Settings{ 4096, true } );
+        auto events = storage.getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER );
+        ASSERT_TRUE( events.has_value() );
+        ASSERT_EQ( events.value().size(), numberOfEvents );
+        for ( uint32_t event = 0; event < numberOfEvents; ++event ) {
+            ASSERT_EQ( events.value()[event].text, "event " + std::to_string( event ) );
+        }
+    }
+    LogStorageTraits::remove();
+}
+
+TEST( LogStorageFactory, CreateWithAppendLogEngine ) {
+    LogStorageTraits::remove();
+    auto storage = IEventsStorage::create( AppendLogEngine{ TEST_STORAGE_PATH } );
+    ASSERT_TRUE( storage );
+    ASSERT_TRUE( storage->saveEvent( createEvent( 0 ) ) );
+    storage.reset();
+
+    ASSERT_FALSE( IEventsStorage::create( AppendLogEngine{ "relative/path" } ) );
+    LogStorageTraits::remove();
+}
@@ -2,34 +2,38 @@
 
 #include "SqliteStorage.h"
 
+#include "Conformance/StorageConformance.h"
+
+#include <QtSql/QSqlQuery>
+
+#include <atomic>
 #include <experimental/filesystem>
+#include <future>
+#include <optional>
+#include <thread>
 
 
 using namespace Challenge::EventsStorage;
 
-class SqliteStorageTest : public ::testing::Test {
-public:
-    static constexpr auto TEST_DB_PATH =  "/tmp/energotest.db";
+namespace {
+    constexpr auto TEST_DB_PATH =  "/tmp/energotest.db";
 
-    SqliteStorageTest() { std::experimental::filesystem::remove(TEST_DB_PATH); }
+    struct SqliteStorageTraits {
+        static std::unique_ptr<IEventsStorage> open() { return std::make_unique<SqliteStorage>( TEST_DB_PATH ); }
+        static void remove() { std::experimental::filesystem::remove( TEST_DB_PATH ); }
+    };
 
+    //! Range reads are served by pool of read-only connections
+    struct SqliteReadersStorageTraits {
+        static std::unique_ptr<IEventsStorage> open() {
+            return std::make_unique<SqliteStorage>( TEST_DB_PATH, SqliteStorage::GroupCommitSettings{}, SqliteStorage::TuningSettings::fast() );
+        }
+        static void remove() { std::experimental::filesystem::remove( TEST_DB_PATH ); }
+    };
+} // namespace
 
-    void SetUp() override {
-        assert(!m_storage);
-        std::experimental::filesystem::remove(TEST_DB_PATH);
-        m_storage.reset( new SqliteStorage(TEST_DB_PATH) );
-    }
-
-    void TearDown() override {
-        assert(m_storage);
-        m_storage.reset();
-        std::experimental::filesystem::remove(TEST_DB_PATH);
-    }
-
-    SqliteStorage& getStorage() { assert(m_storage); return *m_storage; }
-private:
-    std::shared_ptr< SqliteStorage > m_storage;
-};
+INSTANTIATE_TYPED_TEST_CASE_P( Sqlite, StorageConformance, SqliteStorageTraits );
+INSTANTIATE_TYPED_TEST_CASE_P( SqliteReaders, StorageConformance, SqliteReadersStorageTraits );
 
 TEST( SqliteStorageCreation, CreateDatabase ) {
     EXPECT_NO_THROW( SqliteStorage() );
@@ -41,100 +45,306 @@ TEST( SqliteStorageCreation, CreateDatabase ) {
     EXPECT_THROW( SqliteStorage( "/unexisted_path/unexisted_path/blalala/tmp/db" ), std::runtime_error );
 }
 
-TEST_F( SqliteStorageTest, SaveEvent ) {
-    auto timeStamp = std::chrono::system_clock::now();
-    Challenge::EventData eventToSave{ timeStamp, "text", 0 };
+TEST( SqliteStorageGroupCommit, ConcurrentSaves ) {
+    constexpr auto numberOfThreads = 4;
+    constexpr auto eventsPerThread = 50;
+
+    std::experimental::filesystem::remove(TEST_DB_PATH);
+    {
+        SqliteStorage storage( TEST_DB_PATH, SqliteStorage::GroupCommitSettings{ 8, std::chrono::milliseconds(2) } );
+
+        std::atomic<uint32_t> callbackFireCounter{0};
+        storage.setCallbackExecutor( []( std::function<void()> _task ){ _task(); } );
+        storage.registerEventAddedCallback( [&callbackFireCounter]( uint64_t ){ ++callbackFireCounter; }, nullptr );
+
+        std::atomic<uint32_t> savedEvents{0};
+        std::vector<std::thread> producers;
+        for ( auto thread = 0; thread < numberOfThreads; ++thread ) {
+            producers.emplace_back( [&storage, &savedEvents, thread] {
+                for ( auto event = 0; event < eventsPerThread; ++event ) {
+                    Challenge::EventData eventToSave{ std::chrono::system_clock::now(), "text", static_cast<uint32_t>(thread) };
+                    if ( storage.saveEvent( eventToSave ) ) {
+                        ++savedEvents;
+                    }
+                }
+            });
+        }
+
+        for ( auto& producer : producers ) {
+            producer.join();
+        }
+
+        ASSERT_EQ( savedEvents, numberOfThreads * eventsPerThread );
+
+        auto numberOfEvents = storage.getNumberOfEvents();
+        ASSERT_TRUE( numberOfEvents.has_value() );
+        ASSERT_EQ( numberOfEvents.value(), numberOfThreads * eventsPerThread );
+
+        // bursts of saved events are notified once
+        ASSERT_GE( callbackFireCounter, 1 );
+        ASSERT_LE( callbackFireCounter, numberOfThreads * eventsPerThread );
+    }
+    std::experimental::filesystem::remove(TEST_DB_PATH);
+}
+
+TEST( SqliteStorageGroupCommit, SingleSaveIsNotDelayedByBatchSize ) {
+    SqliteStorage storage( SqliteStorage::GroupCommitSettings{ 64, std::chrono::milliseconds(1) } );
 
-    auto result = getStorage().saveEvent( eventToSave );
-    EXPECT_TRUE( result );
+    Challenge::EventData eventToSave{ std::chrono::system_clock::now(), "text", 0 };
+    ASSERT_TRUE( storage.saveEvent( eventToSave ) );
+
+    auto events = storage.getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( events.value().size(), 1 );
+    ASSERT_EQ( events.value().front().text, "text" );
 }
 
-TEST_F( SqliteStorageTest, GetNumberOfEvents ) {
-    auto zeroEvents = getStorage().getNumberOfEvents();
-    ASSERT_TRUE(zeroEvents.has_value());
-    ASSERT_EQ(zeroEvents.value(), 0);
+TEST( SqliteStorageGroupCommit, AsyncSavesOfOneThreadShareTransaction ) {
+    constexpr auto numberOfEvents = 8;
+    SqliteStorage storage( SqliteStorage::GroupCommitSettings{ numberOfEvents, std::chrono::seconds(1) } );
+
+    // executor of server saves next event while ACK of previous one waits for commit
+    std::atomic<uint32_t> savedEvents{0};
+    std::promise<void> areAllSaved;
+    for ( auto event = 0; event < numberOfEvents; ++event ) {
+        storage.saveEventAsync( Challenge::EventData{ std::chrono::system_clock::now(), "text", 0 }, [&]( std::size_t _numberOfSavedEvents ){
+            if ( ( savedEvents += _numberOfSavedEvents ) == numberOfEvents ) {
+                areAllSaved.set_value();
+            }
+        });
+    }
+    areAllSaved.get_future().wait();
 
-    auto timeStamp = std::chrono::system_clock::now();
-    Challenge::EventData eventToSave1{ timeStamp, "text1", 0 };
-    Challenge::EventData eventToSave2{ timeStamp, "text2", 0 };
-    Challenge::EventData eventToSave3{ timeStamp, "text3", 0 };
+    const auto statistics = storage.getStatistics();
+    ASSERT_EQ( statistics.savedEvents, numberOfEvents );
+    ASSERT_EQ( statistics.transactions, 1 );
+}
 
-    getStorage().saveEvent( eventToSave1 );
-    getStorage().saveEvent( eventToSave2 );
-    getStorage().saveEvent( eventToSave3 );
+TEST( SqliteStorageGroupCommit, FullQueueOfWriterRejects ) {
+    // batch waits for next events, so queued events are not taken by writer until deadline
+    SqliteStorage storage( SqliteStorage::GroupCommitSettings{ 64, std::chrono::milliseconds(100), 2, FullQueuePolicy::Reject } );
+
+    std::promise<std::size_t> queuedResult;
+    storage.saveEventsAsync( { Challenge::EventData{ std::chrono::system_clock::now(), "first", 0 }
+                             , Challenge::EventData{ std::chrono::system_clock::now(), "second", 0 } }, [&]( std::size_t _numberOfSavedEvents ){
+        queuedResult.set_value( _numberOfSavedEvents );
+    });
+
+    // rejected event is completed before return, without waiting for writer
+    std::optional<std::size_t> rejectedResult;
+    storage.saveEventAsync( Challenge::EventData{ std::chrono::system_clock::now(), "rejected", 0 }, [&]( std::size_t _numberOfSavedEvents ){
+        rejectedResult = _numberOfSavedEvents;
+    });
+    ASSERT_EQ( rejectedResult, 0 );
+
+    ASSERT_EQ( queuedResult.get_future().get(), 2 );
+    ASSERT_TRUE( storage.saveEvent( Challenge::EventData{ std::chrono::system_clock::now(), "third", 0 } ) );
+    ASSERT_EQ( storage.getNumberOfEvents(), 3 );
+}
 
-    auto threeEvents = getStorage().getNumberOfEvents();
-    ASSERT_TRUE( threeEvents.has_value() );
-    ASSERT_EQ( threeEvents.value(), 3 );
+TEST( SqliteStorageGroupCommit, QueueOfWriterCannotBeEmpty ) {
+    EXPECT_THROW( SqliteStorage( SqliteStorage::GroupCommitSettings{ 64, std::chrono::milliseconds(0), 0 } ), std::runtime_error );
 }
 
-TEST_F( SqliteStorageTest, GetSavedEvents ) {
-    auto zeroEvents = getStorage().getSavedEvents(IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER);
-    ASSERT_TRUE(zeroEvents.has_value());
-    ASSERT_TRUE(zeroEvents.value().empty() );
-
-    auto timeStamp = std::chrono::system_clock::now();
-    Challenge::EventData eventToSave1{ timeStamp, "text1", 0 };
-    Challenge::EventData eventToSave2{ timeStamp, "text2", 1 };
-    Challenge::EventData eventToSave3{ timeStamp, "text3", 2 };
-
-    getStorage().saveEvent( eventToSave1 );
-    getStorage().saveEvent( eventToSave2 );
-    getStorage().saveEvent( eventToSave3 );
-
-    auto threeEvents = getStorage().getSavedEvents(IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER);
-    ASSERT_TRUE( threeEvents.has_value() );
-    ASSERT_EQ( threeEvents.value().size(), 3 );
-
-    auto event0 = getStorage().getSavedEvents(0, 0);
-    ASSERT_TRUE( event0.has_value() );
-    ASSERT_EQ( event0.value().size(), 1 );
-    ASSERT_EQ( event0.value().front().priority, 0 );
-
-    auto event1and1 = getStorage().getSavedEvents(1, 1);
-    ASSERT_TRUE( event1and1.has_value() );
-    ASSERT_EQ( event1and1.value().size(), 1 );
-    ASSERT_EQ( event1and1.value()[0].priority, 1 );
-
-    auto event1and2 = getStorage().getSavedEvents(1, 2);
-    ASSERT_TRUE( event1and2.has_value() );
-    ASSERT_EQ( event1and2.value().size(), 2 );
-    ASSERT_EQ( event1and2.value()[0].priority, 1 );
-    ASSERT_EQ( event1and2.value()[1].priority, 2 );
-
-    auto wrongRange = getStorage().getSavedEvents(3, 1);
-    ASSERT_FALSE( wrongRange.has_value() );
+TEST( SqliteStorageSequence, LegacyDatabaseIsMigrated ) {
+    std::experimental::filesystem::remove(TEST_DB_PATH);
+    {
+        auto legacyDatabase = QSqlDatabase::addDatabase( "QSQLITE", "legacy" );
+        legacyDatabase.setDatabaseName( TEST_DB_PATH );
+        ASSERT_TRUE( legacyDatabase.open() );
+        {
+            QSqlQuery query( legacyDatabase );
+            ASSERT_TRUE( query.exec( "CREATE TABLE events (id INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE NOT NULL, text TEXT NOT NULL, timestamp INTEGER NOT NULL, priority INTEGER NOT NULL)" ) );
+            ASSERT_TRUE( query.exec( "INSERT INTO events(text,timestamp,priority) VALUES('text0',0,0),('text1',0,1),('text2',0,2)" ) );
+            // gap in ids
+            ASSERT_TRUE( query.exec( "DELETE FROM events WHERE id = 2" ) );
+        }
+        legacyDatabase.close();
+    }
+    QSqlDatabase::removeDatabase( "legacy" );
+
+    {
+        SqliteStorage storage( TEST_DB_PATH );
+        ASSERT_EQ( storage.getNumberOfEvents().value(), 2 );
+
+        auto events = storage.getSavedEvents( 0, 1 );
+        ASSERT_TRUE( events.has_value() );
+        ASSERT_EQ( events.value().size(), 2 );
+        ASSERT_EQ( events.value()[0].priority, 0 );
+        ASSERT_EQ( events.value()[1].priority, 2 );
+
+        Challenge::EventData eventToSave{ std::chrono::system_clock::now(), "text3", 3 };
+        ASSERT_TRUE( storage.saveEvent( eventToSave ) );
+
+        auto lastEvent = storage.getSavedEvents( 2, 2 );
+        ASSERT_TRUE( lastEvent.has_value() );
+        ASSERT_EQ( lastEvent.value().size(), 1 );
+        ASSERT_EQ( lastEvent.value().front().priority, 3 );
+    }
+    std::experimental::filesystem::remove(TEST_DB_PATH);
 }
 
-TEST_F( SqliteStorageTest, savedEventsCallback ) {
-    auto zeroEvents = getStorage().getNumberOfEvents();
-    ASSERT_TRUE(zeroEvents.has_value());
-    ASSERT_EQ(zeroEvents.value(), 0);
-
-    auto timeStamp = std::chrono::system_clock::now();
-    Challenge::EventData eventToSave1{ timeStamp, "text1", 0 };
-    Challenge::EventData eventToSave2{ timeStamp, "text2", 0 };
-    Challenge::EventData eventToSave3{ timeStamp, "text3", 0 };
-
-    auto callback1FireCounter = 0;
-    auto callback2FireCounter = 0;
-    auto newEventSavedCallback1 = [&callback1FireCounter](){ ++callback1FireCounter; };
-    auto newEventSavedCallback2 = [&callback2FireCounter](){ ++callback2FireCounter; };
-
-    getStorage().registerEventAddedCallback(newEventSavedCallback1, this);
-    getStorage().registerEventAddedCallback(newEventSavedCallback2, nullptr);
-    getStorage().saveEvent( eventToSave1 );
-    ASSERT_EQ( callback1FireCounter, 1 );
-    ASSERT_EQ( callback2FireCounter, 1 );
-
-    getStorage().registerEventAddedCallback(nullptr, nullptr);
-    getStorage().saveEvent( eventToSave2 );
-    ASSERT_EQ( callback1FireCounter, 2 );
-    ASSERT_EQ( callback2FireCounter, 1 );
-
-
-    getStorage().registerEventAddedCallback(nullptr, this);
-    getStorage().saveEvent( eventToSave3 );
-    ASSERT_EQ( callback1FireCounter, 2 );
-    ASSERT_EQ( callback2FireCounter, 1 );
-}
\ No newline at end of file
+TEST( SqliteStorageSequence, EventsRemovedOutsideOfStorageKeepNumbers ) {
+    std::experimental::filesystem::remove(TEST_DB_PATH);
+    {
+        SqliteStorage storage( TEST_DB_PATH );
+        for ( uint32_t priority = 0; priority < 4; ++priority ) {
+            Challenge::EventData eventToSave{ std::chrono::system_clock::now(), "text", priority };
+            ASSERT_TRUE( storage.saveEvent( eventToSave ) );
+        }
+    }
+
+    {
+        auto database = QSqlDatabase::addDatabase( "QSQLITE", "external" );
+        database.setDatabaseName( TEST_DB_PATH );
+        ASSERT_TRUE( database.open() );
+        {
+            QSqlQuery query( database );
+            ASSERT_TRUE( query.exec( "DELETE FROM events WHERE priority = 1" ) );
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase( "external" );
+
+    {
+        // migrated database is not numbered again, so the removed event stays a gap
+        SqliteStorage storage( TEST_DB_PATH );
+        ASSERT_EQ( storage.getNumberOfEvents().value(), 4 );
+
+        auto events = storage.getSavedEvents( 1, 2 );
+        ASSERT_TRUE( events.has_value() );
+        ASSERT_EQ( events.value().size(), 1 );
+        ASSERT_EQ( events.value()[0].priority, 2 );
+
+        Challenge::EventData eventToSave{ std::chrono::system_clock::now(), "text", 4 };
+        ASSERT_TRUE( storage.saveEvent( eventToSave ) );
+
+        auto lastEvent = storage.getSavedEvents( 4, 4 );
+        ASSERT_TRUE( lastEvent.has_value() );
+        ASSERT_EQ( lastEvent.value().size(), 1 );
+        ASSERT_EQ( lastEvent.value().front().priority, 4 );
+    }
+    std::experimental::filesystem::remove(TEST_DB_PATH);
+}
+
+TEST( SqliteStorageTuning, ProfilesOpenDatabase ) {
+    for ( const auto& tuning : { SqliteStorage::TuningSettings::compatible()
+                               , SqliteStorage::TuningSettings::durable()
+                               , SqliteStorage::TuningSettings::fast() } ) {
+        std::experimental::filesystem::remove(TEST_DB_PATH);
+        {
+            SqliteStorage storage( TEST_DB_PATH, SqliteStorage::GroupCommitSettings{}, tuning );
+
+            Challenge::EventData eventToSave{ std::chrono::system_clock::now(), "text", 0 };
+            ASSERT_TRUE( storage.saveEvent( eventToSave ) );
+
+            auto events = storage.getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER );
+            ASSERT_TRUE( events.has_value() );
+            ASSERT_EQ( events.value().size(), 1 );
+
+            // write ahead log is kept next to database while it is open
+            const bool isWal = tuning.journalMode == SqliteStorage::TuningSettings::JournalMode::Wal;
+            ASSERT_EQ( std::experimental::filesystem::exists( std::string( TEST_DB_PATH ) + "-wal" ), isWal );
+        }
+        std::experimental::filesystem::remove(TEST_DB_PATH);
+    }
+
+    EXPECT_NO_THROW( SqliteStorage( SqliteStorage::GroupCommitSettings{}, SqliteStorage::TuningSettings::fast() ) );
+}
+
+TEST( SqliteStorageTuning, PreparedStatementsAreReused ) {
+    SqliteStorage storage;
+
+    for ( uint32_t priority = 0; priority < 10; ++priority ) {
+        Challenge::EventData eventToSave{ std::chrono::system_clock::now(), std::to_string( priority ), priority };
+        ASSERT_TRUE( storage.saveEvent( eventToSave ) );
+
+        // reading between writes must not keep statement of read active
+        auto events = storage.getSavedEvents( priority, priority );
+        ASSERT_TRUE( events.has_value() );
+        ASSERT_EQ( events.value().size(), 1 );
+        ASSERT_EQ( events.value().front().priority, priority );
+    }
+
+    ASSERT_TRUE( storage.saveEvents( { { std::chrono::system_clock::now(), "a", 1 }, { std::chrono::system_clock::now(), "b", 2 } } ) );
+    auto events = storage.getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( events.value().size(), 12 );
+    ASSERT_EQ( events.value().back().text, "b" );
+}
+
+TEST( SqliteStorageReaders, ReadersRequireWriteAheadLog ) {
+    std::experimental::filesystem::remove(TEST_DB_PATH);
+
+    auto tuning = SqliteStorage::TuningSettings::compatible();
+    tuning.numberOfReaders = 2;
+    EXPECT_THROW( SqliteStorage( TEST_DB_PATH, SqliteStorage::GroupCommitSettings{}, tuning ), std::runtime_error );
+
+    // database in memory has no readers
+    EXPECT_NO_THROW( SqliteStorage( SqliteStorage::GroupCommitSettings{}, tuning ) );
+
+    std::experimental::filesystem::remove(TEST_DB_PATH);
+}
+
+TEST( SqliteStorageReaders, ConcurrentReadsDuringWrites ) {
+    constexpr auto NUMBER_OF_READING_THREADS = 8;
+    constexpr uint64_t NUMBER_OF_EVENTS = 200;
+
+    std::experimental::filesystem::remove(TEST_DB_PATH);
+    {
+        auto tuning = SqliteStorage::TuningSettings::fast();
+        tuning.numberOfReaders = 3;
+        SqliteStorage storage( TEST_DB_PATH, SqliteStorage::GroupCommitSettings{}, tuning );
+
+        std::atomic<bool> isWritingDone{ false };
+        std::thread writer( [&storage, &isWritingDone]{
+            for ( uint32_t event = 0; event < NUMBER_OF_EVENTS; ++event ) {
+                storage.saveEvent( Challenge::EventData{ std::chrono::system_clock::now(), std::to_string( event ), event } );
+            }
+            isWritingDone = true;
+        });
+
+        // every read sees committed prefix of events in order of saving
+        std::atomic<uint32_t> numberOfFailures{ 0 };
+        std::vector<std::thread> readers;
+        for ( auto reader = 0; reader < NUMBER_OF_READING_THREADS; ++reader ) {
+            readers.emplace_back( [&storage, &isWritingDone, &numberOfFailures, reader]{
+                do {
+                    std::vector<uint32_t> priorities;
+                    const auto collectPriorities = [&priorities]( const IEventsStorage::Events& _events, bool ) {
+                        for ( const auto& event : _events ) {
+                            priorities.push_back( event.priority );
+                        }
+                        return true;
+                    };
+
+                    bool isRead = false;
+                    if ( reader % 2 == 0 ) {
+                        auto events = storage.getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER );
+                        isRead = events.has_value() && collectPriorities( events.value(), true );
+                    } else {
+                        isRead = storage.visitSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER, 7, collectPriorities );
+                    }
+
+                    for ( uint32_t priority = 0; priority < priorities.size(); ++priority ) {
+                        isRead = isRead && priorities[priority] == priority;
+                    }
+                    if ( !isRead ) {
+                        ++numberOfFailures;
+                    }
+                } while ( !isWritingDone );
+            });
+        }
+
+        writer.join();
+        for ( auto& reader : readers ) {
+            reader.join();
+        }
+
+        ASSERT_EQ( numberOfFailures, 0 );
+        auto events = storage.getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER );
+        ASSERT_TRUE( events.has_value() );
+        ASSERT_EQ( events.value().size(), NUMBER_OF_EVENTS );
+    }
+    std::experimental::filesystem::remove(TEST_DB_PATH);
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+
+#include "TailCacheStorage.h"
+#include "LogStorage.h"
+
+#include "Conformance/StorageConformance.h"
+
+#include <experimental/filesystem>
+#include <vector>
+
+
+using namespace Challenge::EventsStorage;
+
+namespace {
+    constexpr auto TEST_STORAGE_PATH =  "/tmp/energotest.cache.log";
+
+    struct TailCacheStorageTraits {
+        static std::unique_ptr<IEventsStorage> open() {
+            return std::make_unique<TailCacheStorage>( std::make_shared<LogStorage>( TEST_STORAGE_PATH ), 1024, 1024 * 1024 );
+        }
+        static void remove() { std::experimental::filesystem::remove_all( TEST_STORAGE_PATH ); }
+    };
+
+    //! Most of ranges are partially evicted
+    struct SmallTailCacheStorageTraits {
+        static std::unique_ptr<IEventsStorage> open() {
+            return std::make_unique<TailCacheStorage>( std::make_shared<LogStorage>( TEST_STORAGE_PATH ), 2, 1024 * 1024 );
+        }
+        static void remove() { std::experimental::filesystem::remove_all( TEST_STORAGE_PATH ); }
+    };
+
+    Challenge::EventData createEvent( uint32_t _priority ) {
+        return Challenge::EventData{ std::chrono::system_clock::now(), "event " + std::to_string( _priority ), _priority };
+    }
+
+    //! Storage in memory, which counts reads
+    class CountingStorage : public IEventsStorage {
+    public:
+        bool saveEvent( const Challenge::EventData& _event ) override { m_events.push_back( _event ); return true; }
+
+        std::optional<Events> getSavedEvents( uint64_t _firstEvent, uint64_t _lastEvent ) const override {
+            ++m_numberOfReads;
+            Events events;
+            for ( auto event = _firstEvent; event <= _lastEvent && event < m_events.size(); ++event ) {
+                events.push_back( m_events[event] );
+            }
+            return events;
+        }
+
+        std::optional<uint64_t> getNumberOfEvents() const override { return m_events.size(); }
+        bool registerEventAddedCallback( EventSavedCallback, void* ) override { return false; }
+        void setCallbackExecutor( CallbackExecutor ) override {}
+
+        uint32_t numberOfReads() const { return m_numberOfReads; }
+
+    private:
+        Events m_events;
+        mutable uint32_t m_numberOfReads = 0;
+    };
+
+    std::vector<uint32_t> priorities( const IEventsStorage::Events& _events ) {
+        std::vector<uint32_t> priorities;
+        for ( const auto& event : _events ) {
+            priorities.push_back( event.priority );
+        }
+        return priorities;
+    }
+} // namespace
+
+INSTANTIATE_TYPED_TEST_CASE_P( TailCache, StorageConformance, TailCacheStorageTraits );
+INSTANTIATE_TYPED_TEST_CASE_P( SmallTailCache, StorageConformance, SmallTailCacheStorageTraits );
+
+TEST( TailCacheStorageCreation, CreateStorage ) {
+    EXPECT_THROW( TailCacheStorage( nullptr, 16, 1024 ), std::runtime_error );
+    EXPECT_THROW( TailCacheStorage( std::make_shared<CountingStorage>(), 0, 1024 ), std::runtime_error );
+    EXPECT_THROW( TailCacheStorage( std::make_shared<CountingStorage>(), 16, 0 ), std::runtime_error );
+}
+
+TEST( TailCacheStorageReads, TailReadServedFromCache ) {
+    auto storage = std::make_shared<CountingStorage>();
+    TailCacheStorage unitUnderTest( storage, 16, 1024 * 1024 );
+
+    for ( uint32_t priority = 0; priority < 10; ++priority ) {
+        ASSERT_TRUE( unitUnderTest.saveEvent( createEvent( priority ) ) );
+    }
+
+    auto events = unitUnderTest.getSavedEvents( 7, IEventsStorage::LAST_EVENT_NUMBER );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( priorities( events.value() ), std::vector<uint32_t>({ 7, 8, 9 }) );
+    ASSERT_EQ( events.value().front().text, "event 7" );
+
+    // range behind the last event is empty
+    events = unitUnderTest.getSavedEvents( 10, IEventsStorage::LAST_EVENT_NUMBER );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_TRUE( events.value().empty() );
+
+    std::vector<uint32_t> visitedPriorities;
+    ASSERT_TRUE( unitUnderTest.visitSavedEvents( 3, 6, 3, [&visitedPriorities]( const IEventsStorage::Events& _events, bool ) {
+        auto chunkPriorities = priorities( _events );
+        visitedPriorities.insert( visitedPriorities.end(), chunkPriorities.begin(), chunkPriorities.end() );
+        return true;
+    }) );
+    ASSERT_EQ( visitedPriorities, std::vector<uint32_t>({ 3, 4, 5, 6 }) );
+
+    ASSERT_EQ( storage->numberOfReads(), 0 );
+    ASSERT_EQ( unitUnderTest.getStatistics().hits, 3 );
+    ASSERT_EQ( unitUnderTest.getStatistics().misses, 0 );
+}
+
+TEST( TailCacheStorageReads, EvictedEventsReadFromStorage ) {
+    auto storage = std::make_shared<CountingStorage>();
+    TailCacheStorage unitUnderTest( storage, 4, 1024 * 1024 );
+
+    ASSERT_EQ( unitUnderTest.saveEvents( { createEvent( 0 ), createEvent( 1 ), createEvent( 2 ) } ), 3 );
+    for ( uint32_t priority = 3; priority < 10; ++priority ) {
+        ASSERT_TRUE( unitUnderTest.saveEvent( createEvent( priority ) ) );
+    }
+
+    auto events = unitUnderTest.getSavedEvents( 5, 9 );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( priorities( events.value() ), std::vector<uint32_t>({ 5, 6, 7, 8, 9 }) );
+    ASSERT_EQ( storage->numberOfReads(), 1 );
+
+    events = unitUnderTest.getSavedEvents( 6, 9 );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( priorities( events.value() ), std::vector<uint32_t>({ 6, 7, 8, 9 }) );
+    ASSERT_EQ( storage->numberOfReads(), 1 );
+
+    ASSERT_EQ( unitUnderTest.getStatistics().hits, 1 );
+    ASSERT_EQ( unitUnderTest.getStatistics().misses, 1 );
+}
+
+TEST( TailCacheStorageReads, EvictedByBytes ) {
+    auto storage = std::make_shared<CountingStorage>();
+    const auto sizeOfEvent = sizeof( Challenge::EventData ) + createEvent( 0 ).text.size();
+    TailCacheStorage unitUnderTest( storage, 16, 2 * sizeOfEvent );
+
+    for ( uint32_t priority = 0; priority < 5; ++priority ) {
+        ASSERT_TRUE( unitUnderTest.saveEvent( createEvent( priority ) ) );
+    }
+
+    ASSERT_TRUE( unitUnderTest.getSavedEvents( 3, 4 ).has_value() );
+    ASSERT_EQ( storage->numberOfReads(), 0 );
+
+    ASSERT_TRUE( unitUnderTest.getSavedEvents( 2, 4 ).has_value() );
+    ASSERT_EQ( storage->numberOfReads(), 1 );
+}
+
+TEST( TailCacheStorageReads, EventsSavedBeforeAreNotCached ) {
+    auto storage = std::make_shared<CountingStorage>();
+    for ( uint32_t priority = 0; priority < 3; ++priority ) {
+        storage->saveEvent( createEvent( priority ) );
+    }
+
+    TailCacheStorage unitUnderTest( storage, 16, 1024 * 1024 );
+    ASSERT_TRUE( unitUnderTest.saveEvent( createEvent( 3 ) ) );
+
+    auto events = unitUnderTest.getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( priorities( events.value() ), std::vector<uint32_t>({ 0, 1, 2, 3 }) );
+    ASSERT_EQ( storage->numberOfReads(), 1 );
+
+    events = unitUnderTest.getSavedEvents( 3, IEventsStorage::LAST_EVENT_NUMBER );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( priorities( events.value() ), std::vector<uint32_t>({ 3 }) );
+    ASSERT_EQ( storage->numberOfReads(), 1 );
+}
+
+TEST( TailCacheStorageReads, EventsSavedAroundCacheAreReadFromStorage ) {
+    auto storage = std::make_shared<CountingStorage>();
+    TailCacheStorage unitUnderTest( storage, 16, 1024 * 1024 );
+    ASSERT_TRUE( unitUnderTest.saveEvent( createEvent( 0 ) ) );
+
+    // cache cannot know, that storage has more events
+    storage->saveEvent( createEvent( 1 ) );
+
+    auto events = unitUnderTest.getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( priorities( events.value() ), std::vector<uint32_t>({ 0, 1 }) );
+    ASSERT_EQ( storage->numberOfReads(), 1 );
+
+    // numbers of cached events are not known any more, so cache is not used
+    ASSERT_TRUE( unitUnderTest.saveEvent( createEvent( 2 ) ) );
+    events = unitUnderTest.getSavedEvents( 2, 2 );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( priorities( events.value() ), std::vector<uint32_t>({ 2 }) );
+    ASSERT_EQ( storage->numberOfReads(), 2 );
+}
+
+TEST( TailCacheStorageReads, AsyncSavesAreCached ) {
+    auto storage = std::make_shared<CountingStorage>();
+    TailCacheStorage unitUnderTest( storage, 16, 1024 * 1024 );
+
+    std::vector<std::size_t> completions;
+    unitUnderTest.saveEventAsync( createEvent( 0 ), [&completions]( std::size_t _numberOfSavedEvents ){
+        completions.push_back( _numberOfSavedEvents );
+    });
+    unitUnderTest.saveEventsAsync( { createEvent( 1 ), createEvent( 2 ) }, [&completions]( std::size_t _numberOfSavedEvents ){
+        completions.push_back( _numberOfSavedEvents );
+    });
+    ASSERT_EQ( completions, std::vector<std::size_t>({ 1, 2 }) );
+
+    auto events = unitUnderTest.getSavedEvents( IEventsStorage::FIRST_EVENT_NUMBER, IEventsStorage::LAST_EVENT_NUMBER );
+    ASSERT_TRUE( events.has_value() );
+    ASSERT_EQ( priorities( events.value() ), std::vector<uint32_t>({ 0, 1, 2 }) );
+    ASSERT_EQ( storage->numberOfReads(), 0 );
+}
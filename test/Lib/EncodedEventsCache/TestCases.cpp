@@ -0,0 +1,97 @@
+#include "Lib/EncodedEventsCache/EncodedEventsCache.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace Challenge;
+
+namespace {
+    EncodedEventsCache::Entry createEntry( uint8_t _value, std::size_t _size = 4 ) {
+        return std::make_shared<const std::vector<std::byte>>( _size, std::byte{ _value } );
+    }
+
+    std::vector<uint8_t> values( const EncodedEventsCache::Entries& _entries ) {
+        std::vector<uint8_t> values;
+        for ( const auto& entry : _entries ) {
+            values.push_back( static_cast<uint8_t>( entry->front() ) );
+        }
+        return values;
+    }
+} // namespace
+
+TEST( EncodedEventsCache, CreateCache ) {
+    EXPECT_THROW( EncodedEventsCache( 0, 1024 ), std::runtime_error );
+    EXPECT_THROW( EncodedEventsCache( 16, 0 ), std::runtime_error );
+}
+
+TEST( EncodedEventsCache, CachedRangeIsHit ) {
+    EncodedEventsCache unitUnderTest( 16, 1024 );
+    for ( uint8_t event = 3; event < 8; ++event ) {
+        unitUnderTest.put( event, createEntry( event ) );
+    }
+
+    auto entries = unitUnderTest.get( 4, 6 );
+    ASSERT_TRUE( entries.has_value() );
+    ASSERT_EQ( values( entries.value() ), std::vector<uint8_t>({ 4, 5, 6 }) );
+
+    ASSERT_FALSE( unitUnderTest.get( 2, 4 ).has_value() );
+    ASSERT_FALSE( unitUnderTest.get( 7, 8 ).has_value() );
+
+    ASSERT_EQ( unitUnderTest.getStatistics().hits, 1 );
+    ASSERT_EQ( unitUnderTest.getStatistics().misses, 2 );
+}
+
+TEST( EncodedEventsCache, OldestEntriesAreEvicted ) {
+    EncodedEventsCache unitUnderTest( 3, 1024 );
+    for ( uint8_t event = 0; event < 5; ++event ) {
+        unitUnderTest.put( event, createEntry( event ) );
+    }
+
+    ASSERT_FALSE( unitUnderTest.get( 1, 4 ).has_value() );
+    auto entries = unitUnderTest.get( 2, 4 );
+    ASSERT_TRUE( entries.has_value() );
+    ASSERT_EQ( values( entries.value() ), std::vector<uint8_t>({ 2, 3, 4 }) );
+}
+
+TEST( EncodedEventsCache, OldestEntriesAreEvictedByBytes ) {
+    EncodedEventsCache unitUnderTest( 16, 10 );
+    unitUnderTest.put( 0, createEntry( 0 ) );
+    unitUnderTest.put( 1, createEntry( 1 ) );
+    unitUnderTest.put( 2, createEntry( 2 ) );
+
+    ASSERT_FALSE( unitUnderTest.get( 0, 2 ).has_value() );
+    ASSERT_TRUE( unitUnderTest.get( 1, 2 ).has_value() );
+
+    // entry greater than limit is not kept at all
+    unitUnderTest.put( 3, createEntry( 3, 11 ) );
+    ASSERT_FALSE( unitUnderTest.get( 3, 3 ).has_value() );
+}
+
+TEST( EncodedEventsCache, CachedEntryIsNotChanged ) {
+    EncodedEventsCache unitUnderTest( 16, 1024 );
+    unitUnderTest.put( 5, createEntry( 5 ) );
+    unitUnderTest.put( 6, createEntry( 6 ) );
+
+    unitUnderTest.put( 5, createEntry( 50 ) );
+    unitUnderTest.put( 4, createEntry( 4 ) );
+
+    auto entries = unitUnderTest.get( 5, 6 );
+    ASSERT_TRUE( entries.has_value() );
+    ASSERT_EQ( values( entries.value() ), std::vector<uint8_t>({ 5, 6 }) );
+    ASSERT_FALSE( unitUnderTest.get( 4, 4 ).has_value() );
+}
+
+TEST( EncodedEventsCache, EntryBehindRangeStartsRangeAgain ) {
+    EncodedEventsCache unitUnderTest( 16, 1024 );
+    unitUnderTest.put( 0, createEntry( 0 ) );
+    unitUnderTest.put( 1, createEntry( 1 ) );
+
+    unitUnderTest.put( 10, createEntry( 10 ) );
+
+    ASSERT_FALSE( unitUnderTest.get( 0, 0 ).has_value() );
+    auto entries = unitUnderTest.get( 10, 10 );
+    ASSERT_TRUE( entries.has_value() );
+    ASSERT_EQ( values( entries.value() ), std::vector<uint8_t>({ 10 }) );
+}
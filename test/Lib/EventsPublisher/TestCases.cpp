@@ -0,0 +1,150 @@
+#include "Lib/EventsPublisher/EventsPublisher.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace Challenge;
+
+namespace {
+    //! Executor which keeps tasks until test runs them
+    class QueuedExecutor {
+    public:
+        EventsPublisher::Executor executor() {
+            return [this]( std::function<void()> _task ){ m_tasks.push_back( _task ); };
+        }
+
+        void runTasks() {
+            auto tasks = std::move( m_tasks );
+            m_tasks.clear();
+            for ( auto& task : tasks ) {
+                task();
+            }
+        }
+
+        std::size_t numberOfTasks() const { return m_tasks.size(); }
+
+    private:
+        std::vector<std::function<void()>> m_tasks;
+    };
+} // namespace
+
+TEST( EventsPublisherTest, BurstIsCoalesced ) {
+    QueuedExecutor executor;
+    EventsPublisher publisher( executor.executor() );
+
+    std::vector<uint64_t> notifications1;
+    std::vector<uint64_t> notifications2;
+    int key1 = 0, key2 = 0;
+    ASSERT_TRUE( publisher.subscribe( [&notifications1]( uint64_t _number ){ notifications1.push_back( _number ); }, &key1 ) );
+    ASSERT_TRUE( publisher.subscribe( [&notifications2]( uint64_t _number ){ notifications2.push_back( _number ); }, &key2 ) );
+
+    publisher.publish( 1 );
+    publisher.publish( 2 );
+    publisher.publish( 3 );
+    // only one dispatch is scheduled for burst
+    ASSERT_EQ( executor.numberOfTasks(), 1 );
+    ASSERT_TRUE( notifications1.empty() );
+
+    executor.runTasks();
+    ASSERT_EQ( notifications1, std::vector<uint64_t>({3}) );
+    ASSERT_EQ( notifications2, std::vector<uint64_t>({3}) );
+
+    publisher.publish( 4 );
+    ASSERT_EQ( executor.numberOfTasks(), 1 );
+    executor.runTasks();
+    ASSERT_EQ( notifications1, std::vector<uint64_t>({3, 4}) );
+}
+
+TEST( EventsPublisherTest, NumberDoesNotGoBack ) {
+    QueuedExecutor executor;
+    EventsPublisher publisher( executor.executor() );
+
+    std::vector<uint64_t> notifications;
+    publisher.subscribe( [&notifications]( uint64_t _number ){ notifications.push_back( _number ); }, nullptr );
+
+    publisher.publish( 5 );
+    publisher.publish( 4 );
+    executor.runTasks();
+    ASSERT_EQ( notifications, std::vector<uint64_t>({5}) );
+
+    // nothing new to notify
+    publisher.publish( 5 );
+    executor.runTasks();
+    ASSERT_EQ( notifications, std::vector<uint64_t>({5}) );
+}
+
+TEST( EventsPublisherTest, Unsubscribe ) {
+    QueuedExecutor executor;
+    EventsPublisher publisher( executor.executor() );
+
+    auto counter = 0;
+    publisher.subscribe( [&counter]( uint64_t ){ ++counter; }, &counter );
+    ASSERT_FALSE( publisher.subscribe( [&counter]( uint64_t ){ counter += 10; }, &counter ) );
+
+    publisher.publish( 1 );
+    executor.runTasks();
+    ASSERT_EQ( counter, 10 );
+
+    ASSERT_TRUE( publisher.subscribe( nullptr, &counter ) );
+    publisher.publish( 2 );
+    executor.runTasks();
+    ASSERT_EQ( counter, 10 );
+}
+
+TEST( EventsPublisherTest, PublishFromSubscriberWithInlineExecutor ) {
+    EventsPublisher publisher( []( std::function<void()> _task ){ _task(); } );
+
+    std::vector<uint64_t> notifications;
+    publisher.subscribe( [&]( uint64_t _number ){
+        notifications.push_back( _number );
+        if ( _number < 3 ) {
+            publisher.publish( _number + 1 );
+        }
+    }, nullptr );
+
+    publisher.publish( 1 );
+    ASSERT_EQ( notifications, std::vector<uint64_t>({1, 2, 3}) );
+}
+
+TEST( EventsPublisherTest, TaskAfterDestructionDoesNothing ) {
+    QueuedExecutor executor;
+    auto counter = 0;
+    {
+        EventsPublisher publisher( executor.executor() );
+        publisher.subscribe( [&counter]( uint64_t ){ ++counter; }, nullptr );
+        publisher.publish( 1 );
+    }
+    executor.runTasks();
+    ASSERT_EQ( counter, 0 );
+}
+
+TEST( EventsPublisherTest, OwnThreadDispatch ) {
+    using namespace std::chrono_literals;
+
+    EventsPublisher publisher;
+
+    std::atomic<uint64_t> notifiedNumber{ 0 };
+    const auto publisherThread = std::this_thread::get_id();
+    std::atomic<bool> isCalledOnOtherThread{ true };
+    publisher.subscribe( [&]( uint64_t _number ){
+        isCalledOnOtherThread = isCalledOnOtherThread && std::this_thread::get_id() != publisherThread;
+        notifiedNumber = _number;
+    }, nullptr );
+
+    for ( uint64_t number = 1; number <= 100; ++number ) {
+        publisher.publish( number );
+    }
+
+    for ( auto iteration = 0; iteration < 1000 && notifiedNumber != 100; ++iteration ) {
+        std::this_thread::sleep_for( 1ms );
+    }
+    ASSERT_EQ( notifiedNumber, 100 );
+    ASSERT_TRUE( isCalledOnOtherThread );
+
+    publisher.subscribe( nullptr, nullptr );
+}
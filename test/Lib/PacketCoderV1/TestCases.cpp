@@ -9,7 +9,10 @@
 
 #include <gtest/gtest.h>
 
+#include <tuple>
+
 using namespace Challenge::PacketCoderV1;
+using Challenge::BytesView;
 
 TEST( PacketCoderV1, createHandshakeInvite ) {
     PacketFactory unitUnderTest;
@@ -177,6 +180,17 @@ TEST( PacketCoderV1, createNewEventsNotification ) {
     ASSERT_EQ( packet->nboNumberOfEvents, ntohll( 17ul ) );
 }
 
+TEST( PacketCoderV1, setServerPacketHandshakeId ) {
+    PacketFactory unitUnderTest;
+    auto notification = unitUnderTest.createNewEventsNotification( 12, 17 );
+    PacketFactory::setServerPacketHandshakeId( notification, 13 );
+    ASSERT_EQ( notification, unitUnderTest.createNewEventsNotification( 13, 17 ) );
+
+    auto ack = unitUnderTest.createAck( 5, 12 );
+    PacketFactory::setServerPacketHandshakeId( ack, 13 );
+    ASSERT_EQ( ack, unitUnderTest.createAck( 5, 13 ) );
+}
+
 TEST( PacketCoderV1, packetDecoderWrongSizeOfBytes ) {
     ASSERT_THROW( DecodedPacket( DecodedPacket::PacketBytes{} ), std::runtime_error );
 }
@@ -257,6 +271,22 @@ TEST( PacketCoderV1, packetDecoderDecodeAck ) {
     ASSERT_EQ( packet->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId, htonl( 6 ) );
 }
 
+TEST( PacketCoderV1, packetDecoderDecodeNack ) {
+    PacketFactory factory;
+    auto packetBytes = factory.createNack( 12, 6 );
+
+    DecodedPacket unitUnderTest( std::move(packetBytes) );
+
+    ASSERT_TRUE( std::holds_alternative<const Server::Nack*>(unitUnderTest.decodedPacket()));
+
+    auto packet = std::get<const Server::Nack*>(unitUnderTest.decodedPacket());
+
+    ASSERT_EQ( packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.type, static_cast<uint8_t>( EventsTypes::NACK ) );
+    ASSERT_EQ( packet->serverResponsePacketHeader.serverV1PacketHeader.v1PacketHeader.appPacketHeader.nboPacketLength, htons( sizeof( Server::Nack) ) );
+    ASSERT_EQ( packet->serverResponsePacketHeader.nboClientPacketNumber, htonl( 12 ) );
+    ASSERT_EQ( packet->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId, htonl( 6 ) );
+}
+
 TEST( PacketCoderV1, packetDecoderDecodeNumberOfEventsRequest ) {
     PacketFactory factory;
     auto packetBytes = factory.createNumberOfEventsRequest( 12, 6 );
@@ -385,7 +415,7 @@ TEST( PacketCoderV1, bytesStream ) {
     unitUnderTest.pushBytes( newEventsPkt );
     auto response1 = unitUnderTest.getPacket();
     ASSERT_TRUE( response1.has_value() );
-    ASSERT_EQ( response1, newEventsPkt );
+    ASSERT_EQ( response1.value(), BytesView( newEventsPkt ) );
     ASSERT_FALSE( unitUnderTest.getPacket().has_value() );
 
     unitUnderTest.pushBytes( newEventsPkt );
@@ -393,15 +423,17 @@ TEST( PacketCoderV1, bytesStream ) {
     unitUnderTest.pushBytes( handshakeInvite );
     auto response2_1 = unitUnderTest.getPacket();
     ASSERT_TRUE( response2_1.has_value() );
-    ASSERT_EQ( response2_1, newEventsPkt );
+    ASSERT_EQ( response2_1.value(), BytesView( newEventsPkt ) );
     auto response2_2 = unitUnderTest.getPacket();
     ASSERT_TRUE( response2_2.has_value() );
-    ASSERT_EQ( response2_2, ackPkt );
+    ASSERT_EQ( response2_2.value(), BytesView( ackPkt ) );
     auto response2_3 = unitUnderTest.getPacket();
     ASSERT_TRUE( response2_3.has_value() );
-    ASSERT_EQ( response2_3, handshakeInvite );
+    ASSERT_EQ( response2_3.value(), BytesView( handshakeInvite ) );
     ASSERT_FALSE( unitUnderTest.getPacket().has_value() );
+    ASSERT_EQ( unitUnderTest.size(), 0 );
 
+    // packet longer than received bytes waits for rest of bytes
     auto malformedPacket = reinterpret_cast<Challenge::Communication::ApplicationProtocol::PacketHeader*>(ackPkt.data());
     malformedPacket->nboPacketLength = htons( 50000 );
     unitUnderTest.pushBytes( newEventsPkt );
@@ -409,8 +441,262 @@ TEST( PacketCoderV1, bytesStream ) {
     unitUnderTest.pushBytes( handshakeInvite );
     auto response3_1 = unitUnderTest.getPacket();
     ASSERT_TRUE( response3_1.has_value() );
-    ASSERT_EQ( response3_1, newEventsPkt );
+    ASSERT_EQ( response3_1.value(), BytesView( newEventsPkt ) );
     auto response3_2 = unitUnderTest.getPacket();
     ASSERT_FALSE( response3_2.has_value() );
+    ASSERT_EQ( unitUnderTest.size(), ackPkt.size() + handshakeInvite.size() );
+}
+
+TEST( PacketCoderV1, bytesStreamKeepsIncompletePackets ) {
+    PacketFactory factory;
+    auto newEventsPkt = factory.createNewEventsNotification( 12, 17 );
+    auto ackPkt = factory.createAck(3,5);
+
+    BytesStream::Bytes bytes( newEventsPkt );
+    bytes.insert( bytes.end(), ackPkt.begin(), ackPkt.end() );
+
+    // every byte is received separately
+    BytesStream unitUnderTest;
+    std::vector<BytesStream::Bytes> packets;
+    for ( auto byte : bytes ) {
+        unitUnderTest.pushBytes( BytesView( &byte, 1 ) );
+        for ( auto packet = unitUnderTest.getPacket(); packet.has_value(); packet = unitUnderTest.getPacket() ) {
+            packets.push_back( packet.value().toBytes() );
+        }
+    }
+
+    ASSERT_EQ( packets.size(), 2 );
+    ASSERT_EQ( packets[0], newEventsPkt );
+    ASSERT_EQ( packets[1], ackPkt );
+    ASSERT_EQ( unitUnderTest.size(), 0 );
+
+    // packet split between two receives
+    unitUnderTest.pushBytes( BytesView( bytes.data(), newEventsPkt.size() + 3 ) );
+    ASSERT_EQ( unitUnderTest.getPacket().value(), BytesView( newEventsPkt ) );
+    ASSERT_FALSE( unitUnderTest.getPacket().has_value() );
+    unitUnderTest.pushBytes( BytesView( bytes.data() + newEventsPkt.size() + 3, ackPkt.size() - 3 ) );
+    ASSERT_EQ( unitUnderTest.getPacket().value(), BytesView( ackPkt ) );
+}
+
+TEST( PacketCoderV1, bytesStreamPushBytesFrom ) {
+    PacketFactory factory;
+    auto newEventsPkt = factory.createNewEventsNotification( 12, 17 );
+    auto ackPkt = factory.createAck(3,5);
+
+    BytesStream unitUnderTest;
+    unitUnderTest.pushBytes( newEventsPkt );
+    ASSERT_EQ( unitUnderTest.getPacket().value(), BytesView( newEventsPkt ) );
+
+    // reader appends to buffer of stream, returned packet is dropped before
+    auto result = unitUnderTest.pushBytesFrom( [&ackPkt]( BytesStream::Bytes& _buffer ) {
+        _buffer.insert( _buffer.end(), ackPkt.begin(), ackPkt.end() );
+        return ackPkt.size();
+    });
+
+    ASSERT_EQ( result, ackPkt.size() );
+    ASSERT_EQ( unitUnderTest.size(), ackPkt.size() );
+    ASSERT_EQ( unitUnderTest.getPacket().value(), BytesView( ackPkt ) );
+    ASSERT_FALSE( unitUnderTest.getPacket().has_value() );
+}
+
+TEST( PacketCoderV1, bytesStreamDropsMalformedStream ) {
+    PacketFactory factory;
+    auto ackPkt = factory.createAck(3,5);
+
+    // length shorter than header
+    auto malformedPacket = reinterpret_cast<Challenge::Communication::ApplicationProtocol::PacketHeader*>(ackPkt.data());
+    malformedPacket->nboPacketLength = htons( 1 );
+
+    BytesStream unitUnderTest;
+    unitUnderTest.pushBytes( ackPkt );
+    ASSERT_FALSE( unitUnderTest.getPacket().has_value() );
+    ASSERT_EQ( unitUnderTest.size(), 0 );
+}
+
+TEST( PacketCoderV1, packetDecoderViewPointsToBorrowedBytes ) {
+    PacketFactory factory;
+    auto ackPkt = factory.createAck( 12, 6 );
+
+    DecodedPacketView unitUnderTest( ackPkt );
+
+    ASSERT_TRUE( std::holds_alternative<const Server::Ack*>(unitUnderTest.decodedPacket()));
+    ASSERT_EQ( reinterpret_cast<const std::byte*>(std::get<const Server::Ack*>(unitUnderTest.decodedPacket())), ackPkt.data() );
+    ASSERT_EQ( unitUnderTest.bytes(), BytesView( ackPkt ) );
+
+    ASSERT_THROW( DecodedPacketView( BytesView( ackPkt.data(), ackPkt.size() - 1 ) ), std::runtime_error );
+}
+
+TEST( PacketCoderV1, packetDecoderCopyPointsToOwnBytes ) {
+    PacketFactory factory;
+    auto ackPkt = factory.createAck( 12, 6 );
+
+    DecodedPacketView view( ackPkt );
+    DecodedPacket original( view );
+    auto originalPacket = std::get<const Server::Ack*>(original.decodedPacket());
+    ASSERT_NE( reinterpret_cast<const std::byte*>(originalPacket), ackPkt.data() );
+
+    auto copy = original;
+    auto copiedPacket = std::get<const Server::Ack*>(copy.decodedPacket());
+    ASSERT_NE( copiedPacket, originalPacket );
+    ASSERT_EQ( copy.view().bytes(), original.view().bytes() );
+
+    std::vector<DecodedPacket> packets;
+    packets.push_back( std::move(copy) );
+    packets.push_back( original );
+    for ( auto& packet : packets ) {
+        auto ack = std::get<const Server::Ack*>(packet.decodedPacket());
+        ASSERT_EQ( reinterpret_cast<const std::byte*>(ack), packet.view().bytes().data() );
+        ASSERT_EQ( ntohl(ack->serverResponsePacketHeader.nboClientPacketNumber), 12 );
+    }
+}
+
+TEST( PacketCoderV1, packetDecoderDecodeSendEvents ) {
+    PacketFactory factory;
+    const auto timeStamp = std::chrono::system_clock::now();
+    const PacketFactory::Events events{ { timeStamp, "ABC", 1 }, { timeStamp, "", 2 }, { timeStamp, "DEFG", 3 } };
+
+    auto packetBytes = factory.createSendEvents( 4, 9, events.begin(), events.end() );
+    ASSERT_TRUE( packetBytes.has_value() );
+    ASSERT_EQ( packetBytes.value().size(), sizeof(Client::SendEvents) + 3 * sizeof(Client::SendEventsEntry) + 7 );
+
+    DecodedPacket unitUnderTest( packetBytes.value() );
+    ASSERT_TRUE( std::holds_alternative<const Client::SendEvents*>(unitUnderTest.decodedPacket()));
+    auto packet = std::get<const Client::SendEvents*>(unitUnderTest.decodedPacket());
+
+    ASSERT_EQ( packet->clientV1HeaderWithHandshake.clientV1PacketHeader.nboClientPacketNumber, htonl( 4 ) );
+    ASSERT_EQ( packet->clientV1HeaderWithHandshake.nboHandshakeId, htonl( 9 ) );
+    ASSERT_EQ( ntohs(packet->nboNumberOfEvents), 3 );
+
+    std::vector<std::pair<std::string, uint32_t>> decodedEvents;
+    visitEntries( *packet, [&decodedEvents]( const Client::SendEventsEntry& _entry ) {
+        decodedEvents.emplace_back( std::string( reinterpret_cast<const char*>(_entry.text), ntohs(_entry.nboLengthOfText) ), ntohl(_entry.nboPriority) );
+    });
+    ASSERT_EQ( decodedEvents, ( std::vector<std::pair<std::string, uint32_t>>{ {"ABC", 1}, {"", 2}, {"DEFG", 3} } ) );
+
+    // number of events does not match length of packet
+    auto malformedBytes = packetBytes.value();
+    reinterpret_cast<Client::SendEvents*>(malformedBytes.data())->nboNumberOfEvents = htons( 4 );
+    ASSERT_THROW( DecodedPacket{ malformedBytes }, std::runtime_error );
+    reinterpret_cast<Client::SendEvents*>(malformedBytes.data())->nboNumberOfEvents = htons( 2 );
+    ASSERT_THROW( DecodedPacket{ malformedBytes }, std::runtime_error );
+}
+
+TEST( PacketCoderV1, createSendEventsLimitedByPacketLength ) {
+    const auto timeStamp = std::chrono::system_clock::now();
+    const PacketFactory::Events events( 3, { timeStamp, std::string( 30'000, 'x' ), 1 } );
+
+    ASSERT_EQ( PacketFactory::countEventsFittingSendEvents( events.begin(), events.end() ), 2 );
+    ASSERT_EQ( PacketFactory::countEventsFittingSendEvents( events.begin() + 2, events.end() ), 1 );
+
+    PacketFactory factory;
+    ASSERT_FALSE( factory.createSendEvents( 1, 1, events.begin(), events.end() ).has_value() );
+    ASSERT_TRUE( factory.createSendEvents( 1, 1, events.begin(), events.begin() + 2 ).has_value() );
+}
+
+TEST( PacketCoderV1, packetDecoderDecodeSendEventsAck ) {
+    PacketFactory factory;
+    auto packetBytes = factory.createSendEventsAck( 12, 6, 300 );
+
+    DecodedPacket unitUnderTest( std::move(packetBytes) );
+    ASSERT_TRUE( std::holds_alternative<const Server::SendEventsAck*>(unitUnderTest.decodedPacket()));
+
+    auto packet = std::get<const Server::SendEventsAck*>(unitUnderTest.decodedPacket());
+    ASSERT_EQ( packet->serverResponsePacketHeader.nboClientPacketNumber, htonl( 12 ) );
+    ASSERT_EQ( packet->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId, htonl( 6 ) );
+    ASSERT_EQ( ntohs(packet->nboNumberOfSavedEvents), 300 );
+}
+
+TEST( PacketCoderV1, packetDecoderDecodeSavedEventsPackedResponse ) {
+    using namespace std::chrono;
+    PacketFactory factory;
+    const time_point<system_clock> timeStamp( duration_cast<system_clock::duration>( milliseconds( 1'500'000'000'123 ) ) );
+    const PacketFactory::Events events{ { timeStamp, "ABC", 1 }, { timeStamp, "", 2 } };
+
+    auto packetBytes = factory.createSavedEventsPackedResponse( 4, 9, true, events.begin(), events.end() );
+    ASSERT_TRUE( packetBytes.has_value() );
+
+    DecodedPacket unitUnderTest( packetBytes.value() );
+    ASSERT_TRUE( std::holds_alternative<const Server::SavedEventsPackedResponse*>(unitUnderTest.decodedPacket()));
+    auto packet = std::get<const Server::SavedEventsPackedResponse*>(unitUnderTest.decodedPacket());
+
+    ASSERT_EQ( packet->serverResponsePacketHeader.nboClientPacketNumber, htonl( 4 ) );
+    ASSERT_EQ( packet->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId, htonl( 9 ) );
+    ASSERT_EQ( packet->isLastPacket, 1 );
+
+    std::vector<std::tuple<uint64_t, std::string, uint32_t>> decodedEvents;
+    visitEntries( *packet, [&decodedEvents]( const Server::SavedEventsEntry& _entry ) {
+        decodedEvents.emplace_back(
+                  ntohll(_entry.nboMillisecondsFromEpoch)
+                , std::string( reinterpret_cast<const char*>(_entry.text), ntohs(_entry.nboLengthOfText) )
+                , ntohl(_entry.nboPriority) );
+    });
+    ASSERT_EQ( decodedEvents, ( std::vector<std::tuple<uint64_t, std::string, uint32_t>>{ {1'500'000'000'123, "ABC", 1}, {1'500'000'000'123, "", 2} } ) );
+
+    // empty last packet
+    auto emptyPacketBytes = factory.createSavedEventsPackedResponse( 4, 9, true, events.end(), events.end() ).value();
+    DecodedPacket emptyPacket( emptyPacketBytes );
+    ASSERT_EQ( std::get<const Server::SavedEventsPackedResponse*>(emptyPacket.decodedPacket())->nboNumberOfEvents, 0 );
+
+    // too many events for packet
+    const PacketFactory::Events bigEvents( 3, { timeStamp, std::string( 30'000, 'x' ), 1 } );
+    ASSERT_EQ( PacketFactory::countEventsFittingSavedEventsPackedResponse( bigEvents.begin(), bigEvents.end() ), 2 );
+    ASSERT_FALSE( factory.createSavedEventsPackedResponse( 1, 1, true, bigEvents.begin(), bigEvents.end() ).has_value() );
+}
+
+TEST( PacketCoderV1, createHandshakeWithVersion ) {
+    PacketFactory unitUnderTest;
+
+    auto inviteBytes = unitUnderTest.createHandshakeInvite( 7, 2 );
+    ASSERT_EQ( inviteBytes.size(), sizeof(Client::HandshakeInviteWithVersion) );
+    auto invite = reinterpret_cast<const Client::HandshakeInviteWithVersion*>(inviteBytes.data());
+    ASSERT_EQ( invite->packetHeader.v1PacketHeader.appPacketHeader.nboPacketLength, htons( sizeof(Client::HandshakeInviteWithVersion) ) );
+    ASSERT_EQ( invite->nboMaxProtocolVersion, htons( 2 ) );
+
+    // server which knows only version 1 decodes it as HandshakeInvite
+    DecodedPacket decodedInvite( inviteBytes );
+    ASSERT_TRUE( std::holds_alternative<const Client::HandshakeInvite*>(decodedInvite.decodedPacket()));
+
+    auto ackBytes = unitUnderTest.createAck( 7, 3, 2 );
+    ASSERT_EQ( ackBytes.size(), sizeof(Server::AckWithVersion) );
+    auto ack = reinterpret_cast<const Server::AckWithVersion*>(ackBytes.data());
+    ASSERT_EQ( ack->serverResponsePacketHeader.serverV1PacketHeader.nboHandshakeId, htonl( 3 ) );
+    ASSERT_EQ( ack->nboProtocolVersion, htons( 2 ) );
+
+    DecodedPacket decodedAck( ackBytes );
+    ASSERT_TRUE( std::holds_alternative<const Server::Ack*>(decodedAck.decodedPacket()));
+}
+
+TEST( PacketCoderV1, bytesStreamSplitsExtendedPackets ) {
+    using Challenge::Communication::ApplicationProtocol::ExtendedPacketHeader;
+    using Challenge::Communication::ApplicationProtocol::EXTENDED_PACKET_LENGTH;
+    using Challenge::Communication::ApplicationProtocol::MAX_PACKET_LENGTH;
+    using FrameHeader = Challenge::Communication::ApplicationProtocol::PacketHeader;
 
-}
\ No newline at end of file
+    PacketFactory factory;
+    auto ackPkt = factory.createAck(3,5);
+
+    // packet with extended header longer than 65535 bytes
+    BytesStream::Bytes extendedPkt( 70'000 );
+    auto extendedHeader = reinterpret_cast<ExtendedPacketHeader*>(extendedPkt.data());
+    extendedHeader->packetHeader.nboPacketLength = htons( EXTENDED_PACKET_LENGTH );
+    extendedHeader->packetHeader.nboProtocolVersion = htons( 2 );
+    extendedHeader->nboPacketLength = htonl( extendedPkt.size() );
+
+    BytesStream unitUnderTest;
+    unitUnderTest.pushBytes( BytesView( extendedPkt.data(), sizeof(FrameHeader) ) );
+    ASSERT_FALSE( unitUnderTest.getPacket().has_value() );
+    unitUnderTest.pushBytes( BytesView( extendedPkt.data() + sizeof(FrameHeader), 40'000 ) );
+    ASSERT_FALSE( unitUnderTest.getPacket().has_value() );
+    unitUnderTest.pushBytes( BytesView( extendedPkt.data() + sizeof(FrameHeader) + 40'000, extendedPkt.size() - sizeof(FrameHeader) - 40'000 ) );
+    unitUnderTest.pushBytes( ackPkt );
+
+    ASSERT_EQ( unitUnderTest.getPacket().value(), BytesView( extendedPkt ) );
+    ASSERT_EQ( unitUnderTest.getPacket().value(), BytesView( ackPkt ) );
+    ASSERT_EQ( unitUnderTest.size(), 0 );
+
+    // extended length longer than limit
+    extendedHeader->nboPacketLength = htonl( MAX_PACKET_LENGTH + 1 );
+    unitUnderTest.pushBytes( extendedPkt );
+    ASSERT_FALSE( unitUnderTest.getPacket().has_value() );
+    ASSERT_EQ( unitUnderTest.size(), 0 );
+}
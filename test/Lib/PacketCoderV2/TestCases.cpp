@@ -0,0 +1,230 @@
+#include "Lib/PacketCoderV2/PacketFactory.h"
+#include "Lib/PacketCoderV2/Packets.h"
+#include "Lib/PacketCoderV2/PacketDecoder.h"
+#include "Lib/PacketCoderV1/PacketDecoder.h"
+#include "Lib/PacketCoderV1/PacketFactory.h"
+#include "Lib/PacketCoderV1/BytesStream.h"
+
+#include "Lib/Uint64/BytsOrderUint64.h"
+
+#include "Communication/ApplicationProtocol/FrameHeader.h"
+
+#include <gtest/gtest.h>
+
+#include <tuple>
+
+using namespace Challenge::PacketCoderV2;
+using Challenge::BytesView;
+using Challenge::Communication::ApplicationProtocol::MAX_PACKET_LENGTH;
+
+TEST( PacketCoderV2, createSendEvent ) {
+    PacketFactory unitUnderTest;
+    const std::string text( 100'000, 'x' );
+
+    auto packetBytes = unitUnderTest.createSendEvent( 4, 9, text, 3 );
+    ASSERT_TRUE( packetBytes.has_value() );
+    ASSERT_EQ( packetBytes.value().size(), sizeof(Client::SendEvent) + text.length() );
+
+    auto packet = reinterpret_cast<const Client::SendEvent*>(packetBytes.value().data());
+    const auto& header = packet->clientV2HeaderWithHandshake.clientV2PacketHeader.v2PacketHeader;
+    ASSERT_EQ( header.appPacketHeader.packetHeader.nboPacketLength, 0 );
+    ASSERT_EQ( header.appPacketHeader.packetHeader.nboProtocolVersion, htons( 2 ) );
+    ASSERT_EQ( header.appPacketHeader.nboPacketLength, htonl( packetBytes.value().size() ) );
+    ASSERT_EQ( header.type, static_cast<uint8_t>(EventsTypes::SEND_EVENT) );
+
+    DecodedPacket decodedPacket( packetBytes.value() );
+    ASSERT_TRUE( std::holds_alternative<const Client::SendEvent*>(decodedPacket.decodedPacket()));
+    auto decoded = std::get<const Client::SendEvent*>(decodedPacket.decodedPacket());
+    ASSERT_EQ( decoded->clientV2HeaderWithHandshake.clientV2PacketHeader.nboClientPacketNumber, htonl( 4 ) );
+    ASSERT_EQ( decoded->clientV2HeaderWithHandshake.nboHandshakeId, htonl( 9 ) );
+    ASSERT_EQ( ntohl(decoded->nboPriority), 3 );
+    ASSERT_EQ( std::string( reinterpret_cast<const char*>(decoded->text), ntohl(decoded->nboLengthOfText) ), text );
+
+    ASSERT_FALSE( unitUnderTest.createSendEvent( 4, 9, std::string( MAX_PACKET_LENGTH, 'x' ), 3 ).has_value() );
+}
+
+TEST( PacketCoderV2, packetsV2AreNotDecodedAsV1 ) {
+    PacketFactory factory;
+    auto packetBytes = factory.createSendEventsAck( 1, 2, 3 );
+
+    ASSERT_TRUE( isPacketV2( packetBytes ) );
+    ASSERT_THROW( Challenge::PacketCoderV1::DecodedPacketView{ packetBytes }, std::runtime_error );
+
+    // stream splits packets of both versions
+    Challenge::PacketCoderV1::BytesStream stream;
+    stream.pushBytes( packetBytes );
+    ASSERT_EQ( stream.getPacket().value(), BytesView( packetBytes ) );
+}
+
+TEST( PacketCoderV2, packetDecoderWrongPackets ) {
+    PacketFactory factory;
+    auto packetBytes = factory.createSendEventsAck( 1, 2, 3 );
+
+    // length does not match
+    auto shorterBytes = packetBytes;
+    shorterBytes.pop_back();
+    ASSERT_THROW( DecodedPacket{ shorterBytes }, std::runtime_error );
+
+    // type which is sent only in version 1
+    auto wrongTypeBytes = packetBytes;
+    const_cast<uint8_t&>( reinterpret_cast<PacketHeader<EventsTypes::SEND_EVENTS_ACK>*>(wrongTypeBytes.data())->type ) = static_cast<uint8_t>(EventsTypes::ACK);
+    ASSERT_THROW( DecodedPacket{ wrongTypeBytes }, std::runtime_error );
+
+    ASSERT_THROW( DecodedPacket{ PacketFactory::PacketBytes( 3 ) }, std::runtime_error );
+}
+
+TEST( PacketCoderV2, packetDecoderDecodeSendEvents ) {
+    PacketFactory factory;
+    const auto timeStamp = std::chrono::system_clock::now();
+    const PacketFactory::Events events{ { timeStamp, std::string( 70'000, 'A' ), 1 }, { timeStamp, "", 2 }, { timeStamp, "DEFG", 3 } };
+
+    auto packetBytes = factory.createSendEvents( 4, 9, events.begin(), events.end() );
+    ASSERT_TRUE( packetBytes.has_value() );
+    ASSERT_EQ( packetBytes.value().size(), sizeof(Client::SendEvents) + 3 * sizeof(Client::SendEventsEntry) + 70'004 );
+
+    DecodedPacket unitUnderTest( packetBytes.value() );
+    ASSERT_TRUE( std::holds_alternative<const Client::SendEvents*>(unitUnderTest.decodedPacket()));
+    auto packet = std::get<const Client::SendEvents*>(unitUnderTest.decodedPacket());
+
+    ASSERT_EQ( packet->clientV2HeaderWithHandshake.clientV2PacketHeader.nboClientPacketNumber, htonl( 4 ) );
+    ASSERT_EQ( packet->clientV2HeaderWithHandshake.nboHandshakeId, htonl( 9 ) );
+    ASSERT_EQ( ntohl(packet->nboNumberOfEvents), 3 );
+
+    std::vector<std::pair<std::string, uint32_t>> decodedEvents;
+    visitEntries( *packet, [&decodedEvents]( const Client::SendEventsEntry& _entry ) {
+        decodedEvents.emplace_back( std::string( reinterpret_cast<const char*>(_entry.text), ntohl(_entry.nboLengthOfText) ), ntohl(_entry.nboPriority) );
+    });
+    ASSERT_EQ( decodedEvents, ( std::vector<std::pair<std::string, uint32_t>>{ {std::string( 70'000, 'A' ), 1}, {"", 2}, {"DEFG", 3} } ) );
+
+    // number of events does not match length of packet
+    auto malformedBytes = packetBytes.value();
+    reinterpret_cast<Client::SendEvents*>(malformedBytes.data())->nboNumberOfEvents = htonl( 4 );
+    ASSERT_THROW( DecodedPacket{ malformedBytes }, std::runtime_error );
+    reinterpret_cast<Client::SendEvents*>(malformedBytes.data())->nboNumberOfEvents = htonl( 2 );
+    ASSERT_THROW( DecodedPacket{ malformedBytes }, std::runtime_error );
+}
+
+TEST( PacketCoderV2, countEventsLimitedByMaxPacketLength ) {
+    const auto timeStamp = std::chrono::system_clock::now();
+    const PacketFactory::Events events( 3, { timeStamp, std::string( 30'000, 'x' ), 1 } );
+
+    ASSERT_EQ( PacketFactory::countEventsFittingSendEvents( events.begin(), events.end(), MAX_PACKET_LENGTH ), 3 );
+    ASSERT_EQ( PacketFactory::countEventsFittingSendEvents( events.begin(), events.end(), 65'535 ), 2 );
+    ASSERT_EQ( PacketFactory::countEventsFittingSavedEventsPackedResponse( events.begin(), events.end(), 40'000 ), 1 );
+    ASSERT_EQ( PacketFactory::countEventsFittingSavedEventsPackedResponse( events.begin(), events.end(), 100 ), 0 );
+}
+
+TEST( PacketCoderV2, packetDecoderDecodeSendEventsAck ) {
+    PacketFactory factory;
+    auto packetBytes = factory.createSendEventsAck( 12, 6, 100'000 );
+
+    DecodedPacket unitUnderTest( std::move(packetBytes) );
+    ASSERT_TRUE( std::holds_alternative<const Server::SendEventsAck*>(unitUnderTest.decodedPacket()));
+
+    auto packet = std::get<const Server::SendEventsAck*>(unitUnderTest.decodedPacket());
+    ASSERT_EQ( packet->serverResponsePacketHeader.nboClientPacketNumber, htonl( 12 ) );
+    ASSERT_EQ( packet->serverResponsePacketHeader.serverV2PacketHeader.nboHandshakeId, htonl( 6 ) );
+    ASSERT_EQ( ntohl(packet->nboNumberOfSavedEvents), 100'000 );
+}
+
+TEST( PacketCoderV2, packetDecoderDecodeSavedEventsPackedResponse ) {
+    using namespace std::chrono;
+    PacketFactory factory;
+    const time_point<system_clock> timeStamp( duration_cast<system_clock::duration>( milliseconds( 1'500'000'000'123 ) ) );
+    const PacketFactory::Events events{ { timeStamp, "ABC", 1 }, { timeStamp, std::string( 70'000, 'x' ), 2 } };
+
+    auto packetBytes = factory.createSavedEventsPackedResponse( 4, 9, false, events.begin(), events.end() );
+    ASSERT_TRUE( packetBytes.has_value() );
+
+    DecodedPacketView unitUnderTest( packetBytes.value() );
+    ASSERT_TRUE( std::holds_alternative<const Server::SavedEventsPackedResponse*>(unitUnderTest.decodedPacket()));
+    auto packet = std::get<const Server::SavedEventsPackedResponse*>(unitUnderTest.decodedPacket());
+
+    ASSERT_EQ( packet->serverResponsePacketHeader.nboClientPacketNumber, htonl( 4 ) );
+    ASSERT_EQ( packet->serverResponsePacketHeader.serverV2PacketHeader.nboHandshakeId, htonl( 9 ) );
+    ASSERT_EQ( packet->isLastPacket, 0 );
+
+    std::vector<std::tuple<uint64_t, std::string, uint32_t>> decodedEvents;
+    visitEntries( *packet, [&decodedEvents]( const Server::SavedEventsEntry& _entry ) {
+        decodedEvents.emplace_back(
+                  ntohll(_entry.nboMillisecondsFromEpoch)
+                , std::string( reinterpret_cast<const char*>(_entry.text), ntohl(_entry.nboLengthOfText) )
+                , ntohl(_entry.nboPriority) );
+    });
+    ASSERT_EQ( decodedEvents, ( std::vector<std::tuple<uint64_t, std::string, uint32_t>>{ {1'500'000'000'123, "ABC", 1}, {1'500'000'000'123, std::string( 70'000, 'x' ), 2} } ) );
+
+    // copy of view owns its bytes
+    DecodedPacket copy( unitUnderTest );
+    ASSERT_NE( copy.view().bytes().data(), unitUnderTest.bytes().data() );
+
+    // empty last packet
+    auto emptyPacketBytes = factory.createSavedEventsPackedResponse( 4, 9, true, events.end(), events.end() ).value();
+    DecodedPacket emptyPacket( emptyPacketBytes );
+    ASSERT_EQ( std::get<const Server::SavedEventsPackedResponse*>(emptyPacket.decodedPacket())->nboNumberOfEvents, 0 );
+}
+
+TEST( PacketCoderV2, responsesFromEncodedEntriesEqualToResponsesFromEvents ) {
+    using namespace std::chrono;
+    const time_point<system_clock> timeStamp( duration_cast<system_clock::duration>( milliseconds( 1'500'000'000'123 ) ) );
+    const PacketFactory::Events events{ { timeStamp, "ABC", 1 }, { timeStamp, "", 2 }, { timeStamp, std::string( 300, 'x' ), 3 } };
+
+    PacketFactory::EncodedEntries entries;
+    for ( const auto& event : events ) {
+        entries.push_back( std::make_shared<const PacketFactory::PacketBytes>( PacketFactory::createSavedEventsEntry( event ) ) );
+    }
+
+    PacketFactory factory;
+    ASSERT_EQ( factory.createSavedEventsPackedResponse( 4, 9, true, entries.begin(), entries.end() )
+             , factory.createSavedEventsPackedResponse( 4, 9, true, events.begin(), events.end() ) );
+
+    Challenge::PacketCoderV1::PacketFactory factoryV1;
+    ASSERT_EQ( factory.createSavedEventsPackedResponseV1( 4, 9, false, entries.begin(), entries.end() )
+             , factoryV1.createSavedEventsPackedResponse( 4, 9, false, events.begin(), events.end() ) );
+    ASSERT_EQ( factory.createSavedEventsResponseV1( 4, 9, true, *entries[2] )
+             , factoryV1.createSavedEventsResponse( 4, 9, true, 1'500'000'000'123, 3, events[2].text ) );
+
+    // empty last packet
+    ASSERT_EQ( factory.createSavedEventsPackedResponse( 4, 9, true, entries.end(), entries.end() )
+             , factory.createSavedEventsPackedResponse( 4, 9, true, events.end(), events.end() ) );
+}
+
+TEST( PacketCoderV2, encodedEntriesLimitedByMaxPacketLength ) {
+    const auto timeStamp = std::chrono::system_clock::now();
+    const auto entry = std::make_shared<const PacketFactory::PacketBytes>( PacketFactory::createSavedEventsEntry( { timeStamp, std::string( 30'000, 'x' ), 1 } ) );
+    const PacketFactory::EncodedEntries entries( 3, entry );
+
+    ASSERT_EQ( PacketFactory::countEntriesFittingSavedEventsPackedResponse( entries.begin(), entries.end(), MAX_PACKET_LENGTH ), 3 );
+    ASSERT_EQ( PacketFactory::countEntriesFittingSavedEventsPackedResponse( entries.begin(), entries.end(), 40'000 ), 1 );
+    ASSERT_EQ( PacketFactory::countEntriesFittingSavedEventsPackedResponseV1( entries.begin(), entries.end() ), 2 );
+
+    PacketFactory factory;
+    ASSERT_FALSE( factory.createSavedEventsPackedResponseV1( 4, 9, true, entries.begin(), entries.end() ).has_value() );
+
+    // text of version 1 is truncated, so packet does not exceed 65535 bytes
+    const auto longEntry = std::make_shared<const PacketFactory::PacketBytes>( PacketFactory::createSavedEventsEntry( { timeStamp, std::string( 70'000, 'x' ), 1 } ) );
+    const auto response = factory.createSavedEventsResponseV1( 4, 9, true, *longEntry );
+    ASSERT_TRUE( response.has_value() );
+    ASSERT_LE( response.value().size(), std::numeric_limits<uint16_t>::max() );
+
+    const PacketFactory::EncodedEntries longEntries( 2, longEntry );
+    ASSERT_EQ( PacketFactory::countEntriesFittingSavedEventsPackedResponseV1( longEntries.begin(), longEntries.end() ), 1 );
+    ASSERT_TRUE( factory.createSavedEventsPackedResponseV1( 4, 9, true, longEntries.begin(), longEntries.begin() + 1 ).has_value() );
+}
+
+TEST( PacketCoderV2, truncatedTextOfVersion1KeepsWholeCharacters ) {
+    // every character of text has two bytes in UTF-8
+    std::string text;
+    for ( auto character = 0; character < 35'000; ++character ) {
+        text += "\xC3\xA9";
+    }
+    const auto entry = PacketFactory::createSavedEventsEntry( { std::chrono::system_clock::now(), text, 1 } );
+
+    const auto response = PacketFactory().createSavedEventsResponseV1( 4, 9, true, entry );
+    ASSERT_TRUE( response.has_value() );
+
+    auto packet = reinterpret_cast<const Challenge::PacketCoderV1::Server::SavedEventsResponse*>( response.value().data() );
+    const auto textLength = ntohs(packet->nboLengthOfText);
+    ASSERT_EQ( response.value().size(), sizeof(Challenge::PacketCoderV1::Server::SavedEventsResponse) + textLength );
+    ASSERT_GT( textLength, 65'000 );
+    ASSERT_EQ( textLength % 2, 0 );
+}
@@ -2,6 +2,8 @@
 
 #include <QCoreApplication>
 #include <QHostAddress>
+#include <QLocalServer>
+#include <QLocalSocket>
 #include <QTcpServer>
 #include <QTcpSocket>
 
@@ -95,6 +97,24 @@ TEST_F( QtTcpConnectionHelperTest, ReceivePayload ) {
     ASSERT_EQ( noDataReceived->size(), 0 );
 }
 
+TEST_F( QtTcpConnectionHelperTest, ReceiveIntoBuffer ) {
+    QtTcpConnectionHelper connectionUnderTest( &getServerSocket() );
+
+    QtTcpConnectionHelper::Payload buffer = { std::byte('X') };
+
+    sendBytesFromClient(3); // 'A', 'B', 'C'
+    auto numberOfReceived = connectionUnderTest.receiveInto( buffer );
+
+    ASSERT_TRUE( numberOfReceived.has_value() );
+    ASSERT_EQ( numberOfReceived.value(), 3 );
+    ASSERT_EQ( buffer, QtTcpConnectionHelper::Payload( { std::byte('X'), std::byte('A'), std::byte('B'), std::byte('C') } ) );
+
+    auto noDataReceived = connectionUnderTest.receiveInto( buffer );
+    ASSERT_TRUE( noDataReceived.has_value() );
+    ASSERT_EQ( noDataReceived.value(), 0 );
+    ASSERT_EQ( buffer.size(), 4 );
+}
+
 TEST_F( QtTcpConnectionHelperTest, ReceivePayloadFailed ) {
     QtTcpConnectionHelper connectionUnderTest( &getServerSocket() );
 
@@ -120,6 +140,29 @@ TEST_F( QtTcpConnectionHelperTest, OnNewDataCallbackFired ) {
     ASSERT_TRUE( callbackFired );
 }
 
+TEST_F( QtTcpConnectionHelperTest, OnNewDataCallbackReplacedByItself ) {
+    QtTcpConnectionHelper connectionUnderTest( &getServerSocket() );
+
+    int firstCallbackFired = 0;
+    int secondCallbackFired = 0;
+    auto secondCallback = [&secondCallbackFired](){
+        secondCallbackFired++;
+    };
+    auto firstCallback = [&](){
+        connectionUnderTest.registerNewDataReadyToReadCallback( secondCallback );
+        // captures of the replaced callback have to be still accessible
+        firstCallbackFired++;
+    };
+
+    ASSERT_FALSE( connectionUnderTest.registerNewDataReadyToReadCallback( firstCallback ) );
+
+    sendBytesFromClient(1);
+    sendBytesFromClient(1);
+
+    ASSERT_EQ( firstCallbackFired, 1 );
+    ASSERT_EQ( secondCallbackFired, 1 );
+}
+
 TEST_F( QtTcpConnectionHelperTest, OnConnectionExpiredCallback ) {
     QtTcpConnectionHelper connectionUnderTest( &getServerSocket() );
 
@@ -155,4 +198,56 @@ TEST_F( QtTcpConnectionHelperTest, SendPayload ) {
     ASSERT_EQ( std::byte( char( receivedData[2] ) ), std::byte('C') );
 }
 
+TEST_F( QtTcpConnectionHelperTest, SendCoalescedUntilFlush ) {
+    QtTcpConnectionHelper connectionUnderTest( &getServerSocket() );
+
+    ASSERT_TRUE( connectionUnderTest.send( { std::byte('A') } ).has_value() );
+    ASSERT_TRUE( connectionUnderTest.send( { std::byte('B'), std::byte('C') } ).has_value() );
+
+    // without event loop iteration nothing is written
+    ASSERT_FALSE( getClientSocket().waitForReadyRead(100) );
+
+    ASSERT_TRUE( connectionUnderTest.flush() );
+    getClientSocket().waitForReadyRead(500);
+    auto receivedData = getClientSocket().readAll();
+
+    ASSERT_EQ( receivedData, QByteArray("ABC") );
+}
+
+TEST_F( QtTcpConnectionHelperTest, SendFlushedAtThreshold ) {
+    QtTcpConnectionHelper connectionUnderTest( &getServerSocket() );
+
+    QtTcpConnectionHelper::Payload dataToSend( QtTcpConnectionHelper::FLUSH_THRESHOLD, std::byte('A') );
+    ASSERT_TRUE( connectionUnderTest.send( dataToSend ).has_value() );
+
+    ASSERT_TRUE( getClientSocket().waitForReadyRead(500) );
+}
+
+TEST_F( QtTcpConnectionHelperTest, LocalSocket ) {
+    constexpr auto SOCKET_PATH = "/tmp/challenge.test.socket";
+
+    QLocalServer::removeServer( SOCKET_PATH );
+    QLocalServer server;
+    ASSERT_TRUE( server.listen( SOCKET_PATH ) );
+
+    QLocalSocket clientSocket;
+    clientSocket.connectToServer( SOCKET_PATH );
+    ASSERT_TRUE( clientSocket.waitForConnected( 500 ) );
+    ASSERT_TRUE( server.waitForNewConnection( 500 ) );
+
+    QtTcpConnectionHelper connectionUnderTest( QPointer( server.nextPendingConnection() ) );
+    ASSERT_TRUE( connectionUnderTest.isValid() );
+
+    clientSocket.write( "ABC", 3 );
+    clientSocket.waitForBytesWritten( 500 );
+
+    QtTcpConnectionHelper::Payload buffer;
+    ASSERT_EQ( connectionUnderTest.receiveInto( buffer ).value(), 3 );
+    ASSERT_EQ( buffer, QtTcpConnectionHelper::Payload( { std::byte('A'), std::byte('B'), std::byte('C') } ) );
+
+    ASSERT_TRUE( connectionUnderTest.send( { std::byte('D') } ).has_value() );
+    ASSERT_TRUE( connectionUnderTest.flush() );
+    ASSERT_TRUE( clientSocket.waitForReadyRead( 500 ) );
+    ASSERT_EQ( clientSocket.readAll(), QByteArray("D") );
+}
 
@@ -0,0 +1,218 @@
+#include "Lib/SharedMemoryChannel/SharedMemoryChannel.h"
+#include "Lib/SharedMemoryChannel/SharedMemoryRing.h"
+
+#include <QCoreApplication>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+using namespace Challenge;
+
+namespace {
+    //! Ring with own memory
+    class TestRing {
+    public:
+        explicit TestRing( std::size_t _capacity ) : m_data( _capacity ), m_ring( m_control, m_data.data(), _capacity ) {}
+
+        SharedMemoryRing& ring() { return m_ring; }
+        //! Control is written also by peer, so test may move its counters anywhere
+        SharedMemoryRing::Control& control() { return m_control; }
+
+    private:
+        SharedMemoryRing::Control m_control;
+        std::vector<std::byte> m_data;
+        SharedMemoryRing m_ring;
+    };
+
+    std::vector<std::byte> bytes( const std::string& _text ) {
+        std::vector<std::byte> result;
+        for ( auto character : _text ) {
+            result.push_back( std::byte( character ) );
+        }
+        return result;
+    }
+} // namespace
+
+TEST( SharedMemoryRing, CapacityMustBePowerOfTwo ) {
+    SharedMemoryRing::Control control;
+    std::vector<std::byte> data( 12 );
+
+    EXPECT_THROW( SharedMemoryRing( control, data.data(), 12 ), std::runtime_error );
+    EXPECT_THROW( SharedMemoryRing( control, data.data(), 0 ), std::runtime_error );
+    EXPECT_NO_THROW( SharedMemoryRing( control, data.data(), 8 ) );
+}
+
+TEST( SharedMemoryRing, WriteAndReadWrapped ) {
+    TestRing testRing( 8 );
+    auto& ring = testRing.ring();
+
+    std::vector<std::byte> received;
+    ASSERT_TRUE( ring.isEmpty() );
+    ASSERT_EQ( ring.write( bytes( "ABCDEF" ) ), 6 );
+    ASSERT_FALSE( ring.isEmpty() );
+    ASSERT_EQ( ring.readInto( received ), 6 );
+    ASSERT_TRUE( ring.isEmpty() );
+
+    // bytes are wrapped at the end of buffer
+    ASSERT_EQ( ring.write( bytes( "GHIJK" ) ), 5 );
+    ASSERT_EQ( ring.readInto( received ), 5 );
+    ASSERT_EQ( received, bytes( "ABCDEFGHIJK" ) );
+    ASSERT_EQ( ring.readInto( received ), 0 );
+}
+
+TEST( SharedMemoryRing, FullRingWakesProducer ) {
+    TestRing testRing( 8 );
+    auto& ring = testRing.ring();
+
+    ASSERT_EQ( ring.write( bytes( "0123456789" ) ), 8 );
+    ASSERT_EQ( ring.write( bytes( "89" ) ), 0 );
+    ASSERT_FALSE( ring.waitForSpace() );
+
+    std::vector<std::byte> received;
+    ASSERT_EQ( ring.readInto( received ), 8 );
+    ASSERT_TRUE( ring.takeWaitingProducer() );
+    ASSERT_FALSE( ring.takeWaitingProducer() );
+
+    ASSERT_TRUE( ring.waitForSpace() );
+    ASSERT_EQ( ring.write( bytes( "89" ) ), 2 );
+}
+
+TEST( SharedMemoryRing, HeadOutOfBoundsCorruptsRing ) {
+    TestRing testRing( 8 );
+    auto& ring = testRing.ring();
+
+    // producer claims more bytes than capacity
+    testRing.control().head.store( 9 );
+
+    std::vector<std::byte> received;
+    ASSERT_EQ( ring.readInto( received ), 0 );
+    ASSERT_TRUE( ring.isCorrupted() );
+    ASSERT_TRUE( received.empty() );
+    ASSERT_EQ( ring.write( bytes( "A" ) ), 0 );
+}
+
+TEST( SharedMemoryRing, TailOutOfBoundsCorruptsRing ) {
+    TestRing testRing( 8 );
+    auto& ring = testRing.ring();
+
+    ASSERT_EQ( ring.write( bytes( "AB" ) ), 2 );
+    // consumer claims to have read bytes which were not written
+    testRing.control().tail.store( 3 );
+
+    ASSERT_EQ( ring.write( bytes( "CD" ) ), 0 );
+    ASSERT_TRUE( ring.isCorrupted() );
+}
+
+TEST( SharedMemoryRing, ProducerKeepsOwnHead ) {
+    TestRing testRing( 8 );
+    auto& ring = testRing.ring();
+
+    ASSERT_EQ( ring.write( bytes( "AB" ) ), 2 );
+    // head moved back in shared memory does not make producer overwrite unread bytes
+    testRing.control().head.store( 0 );
+    ASSERT_EQ( ring.write( bytes( "CD" ) ), 2 );
+
+    std::vector<std::byte> received;
+    ASSERT_EQ( ring.readInto( received ), 4 );
+    ASSERT_EQ( received, bytes( "ABCD" ) );
+    ASSERT_FALSE( ring.isCorrupted() );
+}
+
+class SharedMemoryChannelTest : public ::testing::Test {
+public:
+    void SetUp() override {
+        char const* params[] = { "app" };
+        auto countParams = 1;
+        m_app.reset( new QCoreApplication( countParams, const_cast<char**>(params) ) );
+
+        int sockets[2];
+        ASSERT_EQ( ::socketpair( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets ), 0 );
+
+        // server passes shared memory before client waits for it
+        m_server = std::make_unique<SharedMemoryChannel>( sockets[0], SharedMemoryChannel::Side::Server );
+        m_client = std::make_unique<SharedMemoryChannel>( sockets[1], SharedMemoryChannel::Side::Client );
+    }
+
+    void TearDown() override {
+        m_client.reset();
+        m_server.reset();
+        m_app.reset();
+    }
+
+    std::unique_ptr<SharedMemoryChannel>& server() { return m_server; }
+    std::unique_ptr<SharedMemoryChannel>& client() { return m_client; }
+
+private:
+    std::shared_ptr< QCoreApplication > m_app;
+    std::unique_ptr<SharedMemoryChannel> m_server;
+    std::unique_ptr<SharedMemoryChannel> m_client;
+};
+
+TEST( SharedMemoryChannel, SharedMemoryNotReceived ) {
+    int sockets[2];
+    ASSERT_EQ( ::socketpair( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets ), 0 );
+    ::close( sockets[0] );
+
+    EXPECT_THROW( SharedMemoryChannel( sockets[1], SharedMemoryChannel::Side::Client ), std::runtime_error );
+}
+
+TEST_F( SharedMemoryChannelTest, SendAndReceive ) {
+    ASSERT_TRUE( server()->isValid() );
+    ASSERT_TRUE( client()->isValid() );
+
+    ASSERT_EQ( client()->send( bytes( "ABC" ) ).value(), 3 );
+    ASSERT_TRUE( client()->flush() );
+
+    SharedMemoryChannel::Payload buffer = bytes( "X" );
+    ASSERT_EQ( server()->receiveInto( buffer ).value(), 3 );
+    ASSERT_EQ( buffer, bytes( "XABC" ) );
+    ASSERT_EQ( server()->receiveInto( buffer ).value(), 0 );
+
+    ASSERT_EQ( server()->send( bytes( "DE" ) ).value(), 2 );
+    auto received = client()->receive();
+    ASSERT_TRUE( received.has_value() );
+    ASSERT_EQ( received.value(), bytes( "DE" ) );
+}
+
+TEST_F( SharedMemoryChannelTest, SendBiggerThanRing ) {
+    SharedMemoryChannel::Payload payload( SharedMemoryChannel::RING_CAPACITY + 10, std::byte('A') );
+    payload.back() = std::byte('B');
+
+    // rest of payload waits until server frees the ring
+    ASSERT_EQ( client()->send( payload ).value(), payload.size() );
+
+    SharedMemoryChannel::Payload buffer;
+    ASSERT_EQ( server()->receiveInto( buffer ).value(), SharedMemoryChannel::RING_CAPACITY );
+
+    ASSERT_TRUE( client()->flush() );
+    ASSERT_EQ( server()->receiveInto( buffer ).value(), 10 );
+    ASSERT_EQ( buffer, payload );
+}
+
+TEST_F( SharedMemoryChannelTest, FullPendingBufferInvalidatesChannel ) {
+    // first part of payload is written to ring, so rest of stream cannot be sent later
+    const SharedMemoryChannel::Payload payload( SharedMemoryChannel::RING_CAPACITY + SharedMemoryChannel::MAX_PENDING_SIZE + 1, std::byte('A') );
+
+    ASSERT_FALSE( client()->send( payload ).has_value() );
+    ASSERT_FALSE( client()->isValid() );
+    ASSERT_FALSE( client()->send( bytes( "B" ) ).has_value() );
+}
+
+TEST_F( SharedMemoryChannelTest, PeerClosed ) {
+    ASSERT_TRUE( server()->send( bytes( "A" ) ).has_value() );
+    server().reset();
+
+    // data written before peer closed are still delivered
+    auto received = client()->receive();
+    ASSERT_TRUE( received.has_value() );
+    ASSERT_EQ( received.value(), bytes( "A" ) );
+
+    ASSERT_FALSE( client()->receive().has_value() );
+    ASSERT_FALSE( client()->isValid() );
+    ASSERT_FALSE( client()->send( bytes( "B" ) ).has_value() );
+}
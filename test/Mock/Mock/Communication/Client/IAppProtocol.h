@@ -8,8 +8,12 @@ namespace Challenge::Communication::Client::Mock {
     class IProtocolExecutor : public Challenge::Communication::Client::IProtocolExecutor{
     public:
         MOCK_METHOD2( sendEvent, bool(const std::string&, uint32_t) );
+        MOCK_METHOD1( sendEvents, std::optional<std::size_t>(const Events&) );
         MOCK_METHOD1( registerNewEventAddedCallback, bool(Challenge::Communication::Client::IProtocolExecutor::NewEventAddedCallback) ) ;
         MOCK_METHOD2( getSavedEvents, std::optional<Events>(uint64_t, uint64_t) );
         MOCK_METHOD0( getNumberOfSavedEvents, std::optional<uint64_t>() );
+        MOCK_METHOD2( sendEventAsync, std::future<bool>(const std::string&, uint32_t) );
+        MOCK_METHOD2( getSavedEventsAsync, std::future<std::optional<Events>>(uint64_t, uint64_t) );
+        MOCK_METHOD0( getNumberOfSavedEventsAsync, std::future<std::optional<uint64_t>>() );
     };
 }
@@ -10,5 +10,6 @@ namespace Challenge::Communication::Client::Mock {
         MOCK_CONST_METHOD0( isValid, bool() );
         MOCK_CONST_METHOD0( identifier, const Identifier&() );
         MOCK_CONST_METHOD0( connection, ITransportConnection&() );
+        MOCK_CONST_METHOD0( protocolVersion, uint16_t() );
     };
 }
\ No newline at end of file
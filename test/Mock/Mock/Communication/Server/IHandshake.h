@@ -19,6 +19,7 @@ namespace Challenge::Communication::Server::Mock {
         MOCK_CONST_METHOD0( identifier, const Identifier&() );
         MOCK_CONST_METHOD0( isValid,  bool() );
         MOCK_CONST_METHOD0( connection, Server::ITransportConnection&() );
+        MOCK_CONST_METHOD0( protocolVersion, uint16_t() );
 
         static std::shared_ptr<HandshakeStartMethodMock> getStartMock();
 
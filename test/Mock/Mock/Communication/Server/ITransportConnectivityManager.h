@@ -25,8 +25,9 @@ namespace Challenge::Communication::Server::Mock {
 } // namespace Challenge::Communication::Server::Mock
 
 namespace Challenge::Communication::Server {
-    inline std::unique_ptr<ITransportConnectivityManager>
-    ITransportConnectivityManager::create() {
+    template<typename... _Args>
+    std::unique_ptr<ITransportConnectivityManager>
+    ITransportConnectivityManager::create(_Args...) {
         return Mock::ITransportConnectivityManager::getFactoryMock().create();
     }
 }
@@ -15,9 +15,11 @@ namespace Challenge::EventsStorage::Mock {
     class IEventsStorage: public EventsStorage::IEventsStorage {
     public:
         MOCK_METHOD1(saveEvent, bool(const EventData&));
+        MOCK_METHOD1(saveEvents, std::size_t(const Events&));
         MOCK_CONST_METHOD2(getSavedEvents, std::optional<Events>(uint64_t, uint64_t));
         MOCK_CONST_METHOD0(getNumberOfEvents, std::optional<uint64_t>() );
         MOCK_METHOD2(registerEventAddedCallback, bool(EventSavedCallback, void*));
+        MOCK_METHOD1(setCallbackExecutor, void(CallbackExecutor));
 
         static std::shared_ptr<StorageFactoryMethodMock> getFactoryMock();
 